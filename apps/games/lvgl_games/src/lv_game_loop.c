@@ -0,0 +1,325 @@
+/**
+ * @file lv_game_loop.c
+ * @brief Fixed timestep game loop with frame budget accounting for the LVGL games
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_game_loop.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LV_GAME_LOOP_HIST_BUCKETS  8    // <1, <2, <4, <8, <16, <32, <64 and >=64 ms
+#define LV_GAME_LOOP_DEGRADE_CNT   3    // frames over budget in a row before degrading
+#define LV_GAME_LOOP_RECOVER_CNT   30   // frames under 3/4 of the budget in a row before recovering
+#define LV_GAME_LOOP_REPORT_PERIOD 5000 // ms between two histogram reports
+
+#if LVGL_VERSION_MAJOR < 9
+#define lv_malloc lv_mem_alloc
+#define lv_free   lv_mem_free
+#endif
+
+#define LV_GAME_LOOP_REPORT (LV_USE_PERF_MONITOR && LV_USE_PERF_MONITOR_LOG_MODE)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    LV_GAME_LOOP_HIST_UPDATE,
+    LV_GAME_LOOP_HIST_RENDER,
+    LV_GAME_LOOP_HIST_FLUSH,
+    LV_GAME_LOOP_HIST_FRAME,
+    LV_GAME_LOOP_HIST_NUM,
+} lv_game_loop_hist_id_t;
+
+typedef struct {
+    uint32_t cnt[LV_GAME_LOOP_HIST_BUCKETS];
+    uint32_t sum;
+    uint32_t max;
+} lv_game_loop_hist_t;
+
+struct _lv_game_loop_t {
+    lv_game_loop_cfg_t cfg;
+    lv_timer_t *timer;
+    uint32_t last_tick;
+    uint32_t acc_ms;
+    uint32_t update_ms; // update time since the last refresh
+    bool degraded;
+    uint8_t over_cnt;
+    uint8_t under_cnt;
+#if LVGL_VERSION_MAJOR == 9
+    lv_display_t *disp;
+    bool rendering;
+    uint32_t refr_start;
+    uint32_t render_start;
+    uint32_t flush_start;
+    uint32_t flush_ms; // flush and flush wait time of the current refresh
+#endif
+    lv_game_loop_hist_t hist[LV_GAME_LOOP_HIST_NUM];
+    uint32_t report_tick;
+    uint32_t steps_dropped;
+    uint32_t anims_skipped;
+};
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void game_loop_timer_cb(lv_timer_t *t);
+static void game_loop_frame_done(lv_game_loop_t *loop, uint32_t frame_ms);
+static void game_loop_hist_add(lv_game_loop_hist_t *hist, uint32_t ms);
+#if LVGL_VERSION_MAJOR == 9
+static void game_loop_disp_event_cb(lv_event_t *e);
+#endif
+#if LV_GAME_LOOP_REPORT
+static void game_loop_report(lv_game_loop_t *loop);
+#endif
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_game_loop_t *lv_game_loop_create(const lv_game_loop_cfg_t *cfg)
+{
+    lv_game_loop_t *loop;
+
+    if (cfg == NULL || cfg->update_cb == NULL || cfg->step_ms == 0) {
+        return NULL;
+    }
+
+    loop = lv_malloc(sizeof(lv_game_loop_t));
+    if (loop == NULL) {
+        return NULL;
+    }
+    lv_memset(loop, 0, sizeof(lv_game_loop_t));
+
+    loop->cfg = *cfg;
+    if (loop->cfg.max_catch_up == 0) {
+        loop->cfg.max_catch_up = LV_GAME_LOOP_CATCH_UP_DEF;
+    }
+
+    loop->timer = lv_timer_create(game_loop_timer_cb, cfg->step_ms, loop);
+    if (loop->timer == NULL) {
+        lv_free(loop);
+        return NULL;
+    }
+
+#if LVGL_VERSION_MAJOR == 9
+    loop->disp = lv_display_get_default();
+    if (loop->disp) {
+        lv_display_add_event_cb(loop->disp, game_loop_disp_event_cb, LV_EVENT_ALL, loop);
+    }
+#endif
+
+    loop->last_tick = lv_tick_get();
+    loop->report_tick = loop->last_tick;
+
+    return loop;
+}
+
+void lv_game_loop_delete(lv_game_loop_t *loop)
+{
+    if (loop == NULL) {
+        return;
+    }
+
+#if LV_GAME_LOOP_REPORT
+    game_loop_report(loop);
+#endif
+
+#if LVGL_VERSION_MAJOR == 9
+    if (loop->disp) {
+        lv_display_remove_event_cb_with_user_data(loop->disp, game_loop_disp_event_cb, loop);
+    }
+#endif
+
+    lv_timer_del(loop->timer);
+    lv_free(loop);
+}
+
+void *lv_game_loop_get_user_data(lv_game_loop_t *loop)
+{
+    return loop->cfg.user_data;
+}
+
+bool lv_game_loop_is_degraded(lv_game_loop_t *loop)
+{
+    return loop->degraded;
+}
+
+lv_anim_t *lv_game_loop_anim_start(lv_game_loop_t *loop, lv_anim_t *a)
+{
+    if (loop && loop->degraded) {
+        // 1 ms instead of 0 keeps the path callbacks away from a zero length range
+        lv_anim_set_time(a, 1);
+        lv_anim_set_delay(a, 0);
+        lv_anim_set_playback_time(a, 0);
+        lv_anim_set_repeat_count(a, 1);
+        loop->anims_skipped++;
+    }
+
+    return lv_anim_start(a);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void game_loop_timer_cb(lv_timer_t *t)
+{
+    lv_game_loop_t *loop = (lv_game_loop_t *)t->user_data;
+    uint32_t steps, start, elaps;
+
+    loop->acc_ms += lv_tick_elaps(loop->last_tick);
+    loop->last_tick = lv_tick_get();
+
+    // run the steps owed since the last call, a long stall is dropped instead of
+    // replayed so the game slows down rather than stalling again on the catch up
+    steps = loop->acc_ms / loop->cfg.step_ms;
+    if (steps > loop->cfg.max_catch_up) {
+        loop->steps_dropped += steps - loop->cfg.max_catch_up;
+        steps = loop->cfg.max_catch_up;
+        loop->acc_ms = 0;
+    } else {
+        loop->acc_ms -= steps * loop->cfg.step_ms;
+    }
+
+    if (steps) {
+        start = lv_tick_get();
+        while (steps--) {
+            loop->cfg.update_cb(loop);
+        }
+        elaps = lv_tick_elaps(start);
+        game_loop_hist_add(&loop->hist[LV_GAME_LOOP_HIST_UPDATE], elaps);
+        loop->update_ms += elaps;
+    }
+
+#if LVGL_VERSION_MAJOR != 9
+    // no refresh events, budget the update time alone
+    game_loop_frame_done(loop, loop->update_ms);
+    loop->update_ms = 0;
+#endif
+
+#if LV_GAME_LOOP_REPORT
+    if (lv_tick_elaps(loop->report_tick) >= LV_GAME_LOOP_REPORT_PERIOD) {
+        game_loop_report(loop);
+    }
+#endif
+}
+
+static void game_loop_frame_done(lv_game_loop_t *loop, uint32_t frame_ms)
+{
+    game_loop_hist_add(&loop->hist[LV_GAME_LOOP_HIST_FRAME], frame_ms);
+
+    if (loop->cfg.frame_budget_ms == 0) {
+        return;
+    }
+
+    if (frame_ms > loop->cfg.frame_budget_ms) {
+        loop->under_cnt = 0;
+        if (!loop->degraded && ++loop->over_cnt >= LV_GAME_LOOP_DEGRADE_CNT) {
+            loop->degraded = true;
+            loop->over_cnt = 0;
+        }
+    } else if (frame_ms * 4 <= loop->cfg.frame_budget_ms * 3) {
+        loop->over_cnt = 0;
+        if (loop->degraded && ++loop->under_cnt >= LV_GAME_LOOP_RECOVER_CNT) {
+            loop->degraded = false;
+            loop->under_cnt = 0;
+        }
+    }
+}
+
+static void game_loop_hist_add(lv_game_loop_hist_t *hist, uint32_t ms)
+{
+    uint32_t bucket = 0;
+
+    while (bucket < LV_GAME_LOOP_HIST_BUCKETS - 1 && ms >= (1u << bucket)) {
+        bucket++;
+    }
+
+    hist->cnt[bucket]++;
+    hist->sum += ms;
+    if (ms > hist->max) {
+        hist->max = ms;
+    }
+}
+
+#if LVGL_VERSION_MAJOR == 9
+static void game_loop_disp_event_cb(lv_event_t *e)
+{
+    lv_game_loop_t *loop = (lv_game_loop_t *)lv_event_get_user_data(e);
+    uint32_t render_ms;
+
+    switch (lv_event_get_code(e)) {
+    case LV_EVENT_REFR_START:
+        loop->refr_start = lv_tick_get();
+        loop->flush_ms = 0;
+        loop->rendering = false;
+        break;
+    case LV_EVENT_RENDER_START:
+        loop->render_start = lv_tick_get();
+        loop->rendering = true;
+        break;
+    case LV_EVENT_FLUSH_START:
+    case LV_EVENT_FLUSH_WAIT_START:
+        loop->flush_start = lv_tick_get();
+        break;
+    case LV_EVENT_FLUSH_FINISH:
+    case LV_EVENT_FLUSH_WAIT_FINISH:
+        loop->flush_ms += lv_tick_elaps(loop->flush_start);
+        break;
+    case LV_EVENT_RENDER_READY:
+        // partial rendering flushes in between, keep only the drawing time
+        render_ms = lv_tick_elaps(loop->render_start);
+        render_ms = render_ms > loop->flush_ms ? render_ms - loop->flush_ms : 0;
+        game_loop_hist_add(&loop->hist[LV_GAME_LOOP_HIST_RENDER], render_ms);
+        break;
+    case LV_EVENT_REFR_READY:
+        // a refresh without invalid areas draws nothing and is not a frame
+        if (loop->rendering) {
+            game_loop_hist_add(&loop->hist[LV_GAME_LOOP_HIST_FLUSH], loop->flush_ms);
+            game_loop_frame_done(loop, loop->update_ms + lv_tick_elaps(loop->refr_start));
+            loop->update_ms = 0;
+            loop->rendering = false;
+        }
+        break;
+    default:
+        break;
+    }
+}
+#endif
+
+#if LV_GAME_LOOP_REPORT
+static void game_loop_report(lv_game_loop_t *loop)
+{
+    static const char *name[LV_GAME_LOOP_HIST_NUM] = {"update", "render", "flush", "frame"};
+    lv_game_loop_hist_t *hist;
+    uint32_t i, num;
+
+    for (i = 0; i < LV_GAME_LOOP_HIST_NUM; i++) {
+        hist = &loop->hist[i];
+        num = hist->cnt[0] + hist->cnt[1] + hist->cnt[2] + hist->cnt[3] + hist->cnt[4] + hist->cnt[5] +
+              hist->cnt[6] + hist->cnt[7];
+        if (num == 0) {
+            continue;
+        }
+
+        LV_LOG("game loop %-6s ms <1:%" LV_PRIu32 " <2:%" LV_PRIu32 " <4:%" LV_PRIu32 " <8:%" LV_PRIu32
+               " <16:%" LV_PRIu32 " <32:%" LV_PRIu32 " <64:%" LV_PRIu32 " >=64:%" LV_PRIu32 ", avg %" LV_PRIu32
+               " max %" LV_PRIu32 "\n",
+               name[i], hist->cnt[0], hist->cnt[1], hist->cnt[2], hist->cnt[3], hist->cnt[4], hist->cnt[5],
+               hist->cnt[6], hist->cnt[7], hist->sum / num, hist->max);
+    }
+
+    LV_LOG("game loop budget %" LV_PRIu32 " ms, degraded %d, steps dropped %" LV_PRIu32
+           ", anims skipped %" LV_PRIu32 "\n",
+           loop->cfg.frame_budget_ms, loop->degraded, loop->steps_dropped, loop->anims_skipped);
+
+    lv_memset(loop->hist, 0, sizeof(loop->hist));
+    loop->steps_dropped = 0;
+    loop->anims_skipped = 0;
+    loop->report_tick = lv_tick_get();
+}
+#endif
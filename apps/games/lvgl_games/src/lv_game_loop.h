@@ -0,0 +1,97 @@
+/**
+ * @file lv_game_loop.h
+ * @brief Fixed timestep game loop with frame budget accounting for the LVGL games
+ *
+ * The loop runs the game logic from an LVGL timer in fixed steps, catching up after
+ * a slow frame so game speed does not depend on the frame rate. It measures the
+ * update, render and flush time of every frame into histograms, printed through the
+ * LVGL log when the monitor runs in log mode (ENABLE_LVGL_MONITOR_LOG). When frames
+ * keep exceeding the budget the loop is marked degraded and cosmetic animations
+ * started with lv_game_loop_anim_start() jump to their end instead of playing.
+ *
+ * Render and flush times come from the display events of LVGL v9, on v8 only the
+ * update time is measured.
+ */
+
+#ifndef LV_GAME_LOOP_H
+#define LV_GAME_LOOP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LV_GAME_LOOP_CATCH_UP_DEF 4 // steps run at most per timer call when max_catch_up is 0
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct _lv_game_loop_t lv_game_loop_t;
+
+typedef void (*lv_game_loop_update_cb_t)(lv_game_loop_t *loop);
+
+typedef struct {
+    uint32_t step_ms;         // game logic timestep
+    uint32_t frame_budget_ms; // update + render + flush time allowed per frame, 0 never degrades
+    uint8_t max_catch_up;     // steps run at most per timer call, the rest of a stall is dropped
+    lv_game_loop_update_cb_t update_cb;
+    void *user_data;
+} lv_game_loop_cfg_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create a game loop and start calling update_cb every step_ms
+ * @param cfg       loop configuration
+ * @return          the loop, NULL when out of memory
+ */
+lv_game_loop_t *lv_game_loop_create(const lv_game_loop_cfg_t *cfg);
+
+/**
+ * Stop a game loop and print its last report
+ * @param loop      the loop
+ */
+void lv_game_loop_delete(lv_game_loop_t *loop);
+
+/**
+ * Get the user data of the loop configuration
+ * @param loop      the loop
+ * @return          the user data
+ */
+void *lv_game_loop_get_user_data(lv_game_loop_t *loop);
+
+/**
+ * Check whether frames keep exceeding the frame budget
+ * @param loop      the loop
+ * @return          true while the loop is degraded, games should skip cosmetic work
+ */
+bool lv_game_loop_is_degraded(lv_game_loop_t *loop);
+
+/**
+ * Start a cosmetic animation, while the loop is degraded it jumps to its end value
+ * on the next animation tick. The ready callback still runs, so animations that
+ * clean up objects when they finish can use it too.
+ * @param loop      the loop
+ * @param a         an initialized animation, not repeating infinitely
+ * @return          the started animation, as lv_anim_start()
+ */
+lv_anim_t *lv_game_loop_anim_start(lv_game_loop_t *loop, lv_anim_t *a);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_GAME_LOOP_H*/
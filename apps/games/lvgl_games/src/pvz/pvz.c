@@ -1,5 +1,6 @@
 #include "lvgl.h"
 #include "stdlib.h"
+#include "lv_game_loop.h"
 
 #define max_zb_count             30   // ��ʬ�������
 #define max_quantity             15   // ÿ��ֲ���������
@@ -20,6 +21,8 @@
 #define jiguang_price            200
 #define dici_price               150
 #define start_money              1000
+#define zidan_refr_period        20   // bullet move and hit test step ms
+#define frame_budget             40   // ms per frame before cosmetic animations are skipped
 
 static int chanzi_btn_select;
 static lv_obj_t *jiguangdou_btn, *start_btn, *gameover_btn;
@@ -41,7 +44,7 @@ static lv_timer_t *timer_newshine;
 static lv_timer_t *timer_zidan_fly;
 static lv_timer_t *timer_hit_test;
 static lv_timer_t *timer_car_test;
-static lv_timer_t *timer_zidan_refr_pos;
+static lv_game_loop_t *game_loop;
 static lv_obj_t *mini_btn;
 static lv_obj_t *bar_btn;
 
@@ -248,7 +251,7 @@ static void nuclear_anim_cb(void *var, int32_t v);
 static void zb_dead_anim(zb_type *xzb);
 static void carzb_boom_anim_cb(void *var, int32_t v);
 static void anim_zb_dead_start_cb(lv_anim_t *a);
-static void timer_zidan_refr_pos_cb(lv_timer_t *t);
+static void zidan_refr_pos_cb(lv_game_loop_t *loop);
 static void jumpzb_jump_cb(void *var, int32_t v);
 static void btn_cliked_cb(lv_event_t *e);
 static void carzb_del_cb(zb_type *xzb);
@@ -420,7 +423,14 @@ static void game_start(lv_event_t *e)
 
     timer_newzb = lv_timer_create(zb_create_cb, zb_period, 0);
     timer_newshine = lv_timer_create(newshine_cb, shine_period, 0);
-    timer_zidan_refr_pos = lv_timer_create(timer_zidan_refr_pos_cb, 20, 0);
+
+    lv_game_loop_cfg_t loop_cfg = {
+        .step_ms = zidan_refr_period,
+        .frame_budget_ms = frame_budget,
+        .update_cb = zidan_refr_pos_cb,
+    };
+    game_loop = lv_game_loop_create(&loop_cfg);
+
     timer_car_test = lv_timer_create(timer_car_test_cb, 1000, 0);
     lv_timer_ready(timer_newshine);
 }
@@ -494,7 +504,7 @@ static void carzb_del_cb(zb_type *xzb)
     lv_anim_set_values(&a, 0, 15);
     lv_anim_set_user_data(&a, xzb);
     lv_anim_set_ready_cb(&a, anim_zb_delect_cb);
-    lv_anim_start(&a);
+    lv_game_loop_anim_start(game_loop, &a);
 }
 
 static void zb_dead_anim(zb_type *xzb)
@@ -521,7 +531,7 @@ static void zb_dead_anim(zb_type *xzb)
     lv_anim_set_values(&a, 0, 200);
     lv_anim_set_user_data(&a, xzb);
     lv_anim_set_ready_cb(&a, anim_zb_delect_cb);
-    lv_anim_start(&a);
+    lv_game_loop_anim_start(game_loop, &a);
 }
 
 static void nuclear_anim_cb(void *var, int32_t v)
@@ -547,7 +557,7 @@ static void nuclear_delete_cb(lv_anim_t *a)
     lv_anim_set_ready_cb(&a1, nuclear_boom_delete_cb);
     lv_anim_set_time(&a1, 1000);
     lv_anim_set_values(&a1, 0, 20);
-    lv_anim_start(&a1);
+    lv_game_loop_anim_start(game_loop, &a1);
 
     for (i = 0; i < max_zb_count; i++) {
         if (zb_matrix[i].blood > 0) {
@@ -599,7 +609,7 @@ static void cherry_delete_cb(lv_anim_t *a)
     lv_anim_set_ready_cb(&a1, boom_delete_cb);
     lv_anim_set_time(&a1, 500);
     lv_anim_set_values(&a1, 0, 1);
-    lv_anim_start(&a1);
+    lv_game_loop_anim_start(game_loop, &a1);
 
     for (i = 0; i < max_zb_count; i++) {
         if (zb_matrix[i].blood > 0 && lv_obj_get_x(zb_matrix[i].zb) - x < 80 &&
@@ -887,7 +897,7 @@ static void add_zidan_cb(lv_timer_t *t)
     }
 }
 
-static void timer_zidan_refr_pos_cb(lv_timer_t *t)
+static void zidan_refr_pos_cb(lv_game_loop_t *loop)
 {
     int i, j;
 
@@ -911,15 +921,17 @@ static void timer_zidan_refr_pos_cb(lv_timer_t *t)
                             zb_matrix[j].blood--;
                             zidan[i].alive = 0;
 
-                            lv_obj_t *zidan_split = lv_img_create(map1);
-                            lv_img_set_src(zidan_split, &zidan_split_img);
-                            lv_obj_set_pos(zidan_split, lv_obj_get_x(zidan[i].zidan) - 8,
-                                           lv_obj_get_y(zidan[i].zidan) - 8);
+                            if (!lv_game_loop_is_degraded(loop)) {
+                                lv_obj_t *zidan_split = lv_img_create(map1);
+                                lv_img_set_src(zidan_split, &zidan_split_img);
+                                lv_obj_set_pos(zidan_split, lv_obj_get_x(zidan[i].zidan) - 8,
+                                               lv_obj_get_y(zidan[i].zidan) - 8);
 #if LVGL_VERSION_MAJOR == 9
-                            lv_obj_delete_delayed(zidan_split, 500);
+                                lv_obj_delete_delayed(zidan_split, 500);
 #else
-                            lv_obj_del_delayed(zidan_split, 500);
+                                lv_obj_del_delayed(zidan_split, 500);
 #endif
+                            }
                             lv_obj_del(zidan[i].zidan);
 
                             if (zb_matrix[j].blood == 0) {
@@ -934,7 +946,7 @@ static void timer_zidan_refr_pos_cb(lv_timer_t *t)
                                 lv_anim_set_exec_cb(&a1, hit_zb_cb);
                                 lv_anim_set_time(&a1, 150);
                                 lv_anim_set_values(&a1, 0, 1);
-                                lv_anim_start(&a1);
+                                lv_game_loop_anim_start(loop, &a1);
                             }
 
                             break;
@@ -1846,7 +1858,8 @@ static void exit_game_cb(lv_event_t *e)
     lv_anim_del_all();
     lv_timer_del(timer_newzb);
     lv_timer_del(timer_newshine);
-    lv_timer_del(timer_zidan_refr_pos);
+    lv_game_loop_delete(game_loop);
+    game_loop = NULL;
     lv_timer_del(timer_car_test);
     init_all();
     lv_obj_del(screen);
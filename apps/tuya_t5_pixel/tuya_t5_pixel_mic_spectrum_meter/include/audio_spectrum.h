@@ -0,0 +1,100 @@
+/**
+ * @file audio_spectrum.h
+ * @brief Fixed-point audio spectrum analyzer built on the TFLM signal library
+ *
+ * Feeds 16-bit PCM through a Hann window, a 512-point int16 real FFT and a
+ * triangular filter bank with mel or logarithmic band spacing, then converts the
+ * band energies to 0-255 display levels with peak hold. Everything after the
+ * one-off table setup runs in integer arithmetic.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __AUDIO_SPECTRUM_H__
+#define __AUDIO_SPECTRUM_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define AUDIO_SPECTRUM_FFT_SIZE  512
+#define AUDIO_SPECTRUM_BANDS_MAX 32
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef uint8_t AUDIO_SPECTRUM_SCALE_E;
+#define AUDIO_SPECTRUM_SCALE_MEL 0x00
+#define AUDIO_SPECTRUM_SCALE_LOG 0x01
+
+typedef struct {
+    uint32_t sample_rate;          // Hz
+    uint16_t hop_size;             // samples between two spectra, at most AUDIO_SPECTRUM_FFT_SIZE
+    uint8_t band_num;              // 1 - AUDIO_SPECTRUM_BANDS_MAX
+    AUDIO_SPECTRUM_SCALE_E scale;  // band spacing
+    uint16_t freq_min;             // Hz, lower edge of the first band
+    uint16_t freq_max;             // Hz, upper edge of the last band, at most sample_rate / 2
+    uint8_t db_floor;              // band energy shown as level 0
+    uint8_t db_ceil;               // band energy shown as level 255
+    uint8_t fall_speed;            // level drop per spectrum, 0 = no smoothing
+    uint8_t peak_hold;             // spectra a peak is held before it falls
+    uint8_t peak_fall_speed;       // peak drop per spectrum once released
+} AUDIO_SPECTRUM_CFG_T;
+
+typedef struct {
+    uint8_t band_num;
+    uint8_t level[AUDIO_SPECTRUM_BANDS_MAX]; // 0-255
+    uint8_t peak[AUDIO_SPECTRUM_BANDS_MAX];  // 0-255
+} AUDIO_SPECTRUM_RESULT_T;
+
+typedef void *AUDIO_SPECTRUM_HANDLE_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+/**
+ * @brief Creates a spectrum analyzer.
+ *
+ * @param cfg Analyzer configuration.
+ * @param handle Returned analyzer handle.
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET audio_spectrum_create(const AUDIO_SPECTRUM_CFG_T *cfg, AUDIO_SPECTRUM_HANDLE_T *handle);
+
+/**
+ * @brief Destroys a spectrum analyzer.
+ *
+ * @param handle Analyzer handle.
+ */
+void audio_spectrum_destroy(AUDIO_SPECTRUM_HANDLE_T handle);
+
+/**
+ * @brief Feeds PCM samples, computing a spectrum every hop_size samples.
+ *
+ * @param handle Analyzer handle.
+ * @param pcm 16-bit mono samples.
+ * @param sample_num Number of samples.
+ * @return Number of spectra computed, the result holds the latest one.
+ */
+uint32_t audio_spectrum_feed(AUDIO_SPECTRUM_HANDLE_T handle, const int16_t *pcm, uint32_t sample_num);
+
+/**
+ * @brief Gets the band levels and peaks of the latest spectrum.
+ *
+ * @param handle Analyzer handle.
+ * @param result Returned levels.
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET audio_spectrum_get_result(AUDIO_SPECTRUM_HANDLE_T handle, AUDIO_SPECTRUM_RESULT_T *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AUDIO_SPECTRUM_H__ */
@@ -0,0 +1,323 @@
+/**
+ * @file audio_spectrum.cpp
+ * @brief Fixed-point audio spectrum analyzer built on the TFLM signal library
+ *
+ * The window, FFT auto scaling, int16 RFFT, filter bank accumulation and log stages
+ * come from tflm_portable/signal. This file only owns the sample history, builds the
+ * Hann window and the filter bank tables once at create time, and turns log band
+ * energies into display levels.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "tal_log.h"
+#include "tal_memory.h"
+
+#include "audio_spectrum.h"
+
+#include "signal/src/complex.h"
+#include "signal/src/fft_auto_scale.h"
+#include "signal/src/filter_bank.h"
+#include "signal/src/filter_bank_log.h"
+#include "signal/src/rfft.h"
+#include "signal/src/window.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define SPECTRUM_BIN_NUM     (AUDIO_SPECTRUM_FFT_SIZE / 2 + 1)
+#define WINDOW_BITS          14 // Hann window in Q14
+#define FILTERBANK_BITS      12 // filter bank weights in Q12
+#define LOG_SCALE            1024
+#define LOG_SCALE_PER_SHIFT  1420 // 2 * ln(2) * LOG_SCALE, energy grows by 4 per auto scale bit
+#define LOG_SCALE_PER_DB_X10 2358 // LOG_SCALE / (10 / ln(10)) * 10
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    AUDIO_SPECTRUM_CFG_T cfg;
+
+    int16_t window[AUDIO_SPECTRUM_FFT_SIZE];
+    int16_t history[AUDIO_SPECTRUM_FFT_SIZE];
+    int16_t work[AUDIO_SPECTRUM_FFT_SIZE];
+    Complex<int16_t> fft_out[SPECTRUM_BIN_NUM];
+    uint32_t power[SPECTRUM_BIN_NUM];
+    void *rfft;
+    uint16_t pending;
+
+    // filter bank tables, one entry more than bands (see FilterbankAccumulateChannels)
+    tflite::tflm_signal::FilterbankConfig fb_cfg;
+    int16_t fb_freq_starts[AUDIO_SPECTRUM_BANDS_MAX + 1];
+    int16_t fb_weight_starts[AUDIO_SPECTRUM_BANDS_MAX + 1];
+    int16_t fb_widths[AUDIO_SPECTRUM_BANDS_MAX + 1];
+    int16_t fb_weights[SPECTRUM_BIN_NUM];
+    int16_t fb_unweights[SPECTRUM_BIN_NUM];
+    uint64_t fb_out[AUDIO_SPECTRUM_BANDS_MAX + 1];
+    uint32_t fb_energy[AUDIO_SPECTRUM_BANDS_MAX];
+    int16_t fb_log[AUDIO_SPECTRUM_BANDS_MAX];
+
+    int32_t log_floor;
+    int32_t log_range;
+    uint8_t level[AUDIO_SPECTRUM_BANDS_MAX];
+    uint8_t peak[AUDIO_SPECTRUM_BANDS_MAX];
+    uint8_t peak_hold_cnt[AUDIO_SPECTRUM_BANDS_MAX];
+} AUDIO_SPECTRUM_T;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static float __hz_to_mel(float hz)
+{
+    return 1127.0f * logf(1.0f + hz / 700.0f);
+}
+
+static float __mel_to_hz(float mel)
+{
+    return 700.0f * (expf(mel / 1127.0f) - 1.0f);
+}
+
+static void __spectrum_init_window(AUDIO_SPECTRUM_T *sp)
+{
+    const float two_pi = 6.28318530718f;
+
+    // periodic hann, its overlapped copies sum to a constant
+    for (int n = 0; n < AUDIO_SPECTRUM_FFT_SIZE; n++) {
+        float w = 0.5f * (1.0f - cosf(two_pi * n / AUDIO_SPECTRUM_FFT_SIZE));
+        sp->window[n] = (int16_t)(w * ((1 << WINDOW_BITS) - 1) + 0.5f);
+    }
+}
+
+/*
+ * Band k (1..band_num) is a triangle rising over bins [edge[k-1], edge[k]) and
+ * falling over [edge[k], edge[k+1]). Segment s = [edge[s], edge[s+1]) carries the
+ * falling weights of band s and, as unweights, the rising part of band s + 1.
+ */
+static OPERATE_RET __spectrum_init_filterbank(AUDIO_SPECTRUM_T *sp)
+{
+    const AUDIO_SPECTRUM_CFG_T *cfg = &sp->cfg;
+    int32_t edge[AUDIO_SPECTRUM_BANDS_MAX + 2];
+    int32_t edge_num = cfg->band_num + 2;
+    float lo = cfg->freq_min, hi = cfg->freq_max, f = 0.0f;
+    int32_t weight_pos = 0;
+
+    if (AUDIO_SPECTRUM_SCALE_LOG == cfg->scale && lo < 1.0f) {
+        lo = 1.0f;
+    }
+
+    for (int32_t i = 0; i < edge_num; i++) {
+        float t = (float)i / (edge_num - 1);
+        if (AUDIO_SPECTRUM_SCALE_LOG == cfg->scale) {
+            f = lo * powf(hi / lo, t);
+        } else {
+            f = __mel_to_hz(__hz_to_mel(lo) + t * (__hz_to_mel(hi) - __hz_to_mel(lo)));
+        }
+
+        edge[i] = (int32_t)(f * AUDIO_SPECTRUM_FFT_SIZE / cfg->sample_rate + 0.5f);
+        // narrow low bands still get one bin of their own
+        if (i > 0 && edge[i] <= edge[i - 1]) {
+            edge[i] = edge[i - 1] + 1;
+        }
+    }
+
+    if (edge[edge_num - 1] >= SPECTRUM_BIN_NUM) {
+        PR_ERR("%d bands do not fit in %d-%d Hz", cfg->band_num, cfg->freq_min, cfg->freq_max);
+        return OPRT_INVALID_PARM;
+    }
+
+    for (int32_t s = 0; s <= cfg->band_num; s++) {
+        int32_t width = edge[s + 1] - edge[s];
+
+        sp->fb_freq_starts[s] = (int16_t)edge[s];
+        sp->fb_weight_starts[s] = (int16_t)weight_pos;
+        sp->fb_widths[s] = (int16_t)width;
+
+        for (int32_t j = 0; j < width; j++) {
+            int16_t weight = (int16_t)((1 << FILTERBANK_BITS) - (j << FILTERBANK_BITS) / width);
+            sp->fb_weights[weight_pos + j] = weight;
+            sp->fb_unweights[weight_pos + j] = (int16_t)((1 << FILTERBANK_BITS) - weight);
+        }
+        weight_pos += width;
+    }
+
+    sp->fb_cfg.num_channels = cfg->band_num;
+    sp->fb_cfg.channel_frequency_starts = sp->fb_freq_starts;
+    sp->fb_cfg.channel_weight_starts = sp->fb_weight_starts;
+    sp->fb_cfg.channel_widths = sp->fb_widths;
+    sp->fb_cfg.weights = sp->fb_weights;
+    sp->fb_cfg.unweights = sp->fb_unweights;
+
+    return OPRT_OK;
+}
+
+static uint8_t __spectrum_to_level(AUDIO_SPECTRUM_T *sp, int32_t log_value)
+{
+    int32_t level = (log_value - sp->log_floor) * 255 / sp->log_range;
+
+    if (level < 0) {
+        return 0;
+    }
+
+    return (level > 255) ? 255 : (uint8_t)level;
+}
+
+static void __spectrum_update_levels(AUDIO_SPECTRUM_T *sp, int scale_bits)
+{
+    const AUDIO_SPECTRUM_CFG_T *cfg = &sp->cfg;
+
+    for (int32_t i = 0; i < cfg->band_num; i++) {
+        // undo the auto scale gain in the log domain
+        uint8_t level = __spectrum_to_level(sp, sp->fb_log[i] - scale_bits * LOG_SCALE_PER_SHIFT);
+
+        if (level < sp->level[i] && cfg->fall_speed) {
+            level = (sp->level[i] - level > cfg->fall_speed) ? (sp->level[i] - cfg->fall_speed) : level;
+        }
+        sp->level[i] = level;
+
+        if (level >= sp->peak[i]) {
+            sp->peak[i] = level;
+            sp->peak_hold_cnt[i] = cfg->peak_hold;
+        } else if (sp->peak_hold_cnt[i]) {
+            sp->peak_hold_cnt[i]--;
+        } else {
+            sp->peak[i] = (sp->peak[i] - level > cfg->peak_fall_speed) ? (sp->peak[i] - cfg->peak_fall_speed) : level;
+        }
+    }
+}
+
+static void __spectrum_compute(AUDIO_SPECTRUM_T *sp)
+{
+    int scale_bits = 0;
+
+    tflm_signal::ApplyWindow(sp->history, sp->window, AUDIO_SPECTRUM_FFT_SIZE, WINDOW_BITS, sp->work);
+    scale_bits = tflite::tflm_signal::FftAutoScale(sp->work, AUDIO_SPECTRUM_FFT_SIZE, sp->work);
+    tflm_signal::RfftInt16Apply(sp->rfft, sp->work, sp->fft_out);
+
+    for (int32_t i = 0; i < SPECTRUM_BIN_NUM; i++) {
+        int32_t re = sp->fft_out[i].real, im = sp->fft_out[i].imag;
+        sp->power[i] = (uint32_t)(re * re) + (uint32_t)(im * im);
+    }
+
+    tflite::tflm_signal::FilterbankAccumulateChannels(&sp->fb_cfg, sp->power, sp->fb_out);
+
+    // element 0 is scratch
+    for (int32_t i = 0; i < sp->cfg.band_num; i++) {
+        uint64_t energy = sp->fb_out[i + 1] >> FILTERBANK_BITS;
+        sp->fb_energy[i] = (energy > UINT32_MAX) ? UINT32_MAX : (uint32_t)energy;
+    }
+
+    tflite::tflm_signal::FilterbankLog(sp->fb_energy, sp->cfg.band_num, LOG_SCALE, 0, sp->fb_log);
+
+    __spectrum_update_levels(sp, scale_bits);
+}
+
+OPERATE_RET audio_spectrum_create(const AUDIO_SPECTRUM_CFG_T *cfg, AUDIO_SPECTRUM_HANDLE_T *handle)
+{
+    OPERATE_RET rt = OPRT_OK;
+    AUDIO_SPECTRUM_T *sp = NULL;
+    size_t rfft_size = 0;
+
+    if (NULL == cfg || NULL == handle || 0 == cfg->sample_rate || 0 == cfg->band_num ||
+        cfg->band_num > AUDIO_SPECTRUM_BANDS_MAX || 0 == cfg->hop_size || cfg->hop_size > AUDIO_SPECTRUM_FFT_SIZE ||
+        cfg->freq_min >= cfg->freq_max || cfg->freq_max > cfg->sample_rate / 2 || cfg->db_floor >= cfg->db_ceil) {
+        return OPRT_INVALID_PARM;
+    }
+
+    sp = (AUDIO_SPECTRUM_T *)tal_malloc(sizeof(AUDIO_SPECTRUM_T));
+    if (NULL == sp) {
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(sp, 0, sizeof(AUDIO_SPECTRUM_T));
+    sp->cfg = *cfg;
+
+    rfft_size = tflm_signal::RfftInt16GetNeededMemory(AUDIO_SPECTRUM_FFT_SIZE);
+    sp->rfft = tal_malloc(rfft_size);
+    if (NULL == sp->rfft) {
+        tal_free(sp);
+        return OPRT_MALLOC_FAILED;
+    }
+
+    if (NULL == tflm_signal::RfftInt16Init(AUDIO_SPECTRUM_FFT_SIZE, sp->rfft, rfft_size)) {
+        rt = OPRT_COM_ERROR;
+        goto __ERR;
+    }
+
+    TUYA_CALL_ERR_GOTO(__spectrum_init_filterbank(sp), __ERR);
+    __spectrum_init_window(sp);
+
+    sp->log_floor = cfg->db_floor * LOG_SCALE_PER_DB_X10 / 10;
+    sp->log_range = (cfg->db_ceil - cfg->db_floor) * LOG_SCALE_PER_DB_X10 / 10;
+
+    *handle = (AUDIO_SPECTRUM_HANDLE_T)sp;
+
+    return OPRT_OK;
+
+__ERR:
+    tal_free(sp->rfft);
+    tal_free(sp);
+
+    return rt;
+}
+
+void audio_spectrum_destroy(AUDIO_SPECTRUM_HANDLE_T handle)
+{
+    AUDIO_SPECTRUM_T *sp = (AUDIO_SPECTRUM_T *)handle;
+
+    if (NULL == sp) {
+        return;
+    }
+
+    tal_free(sp->rfft);
+    tal_free(sp);
+}
+
+uint32_t audio_spectrum_feed(AUDIO_SPECTRUM_HANDLE_T handle, const int16_t *pcm, uint32_t sample_num)
+{
+    AUDIO_SPECTRUM_T *sp = (AUDIO_SPECTRUM_T *)handle;
+    uint32_t spectrum_cnt = 0, copy_num = 0;
+
+    if (NULL == sp || NULL == pcm) {
+        return 0;
+    }
+
+    while (sample_num) {
+        copy_num = sp->cfg.hop_size - sp->pending;
+        if (copy_num > sample_num) {
+            copy_num = sample_num;
+        }
+
+        memmove(sp->history, &sp->history[copy_num], (AUDIO_SPECTRUM_FFT_SIZE - copy_num) * sizeof(int16_t));
+        memcpy(&sp->history[AUDIO_SPECTRUM_FFT_SIZE - copy_num], pcm, copy_num * sizeof(int16_t));
+
+        pcm += copy_num;
+        sample_num -= copy_num;
+        sp->pending += copy_num;
+
+        if (sp->pending == sp->cfg.hop_size) {
+            __spectrum_compute(sp);
+            sp->pending = 0;
+            spectrum_cnt++;
+        }
+    }
+
+    return spectrum_cnt;
+}
+
+OPERATE_RET audio_spectrum_get_result(AUDIO_SPECTRUM_HANDLE_T handle, AUDIO_SPECTRUM_RESULT_T *result)
+{
+    AUDIO_SPECTRUM_T *sp = (AUDIO_SPECTRUM_T *)handle;
+
+    if (NULL == sp || NULL == result) {
+        return OPRT_INVALID_PARM;
+    }
+
+    result->band_num = sp->cfg.band_num;
+    memcpy(result->level, sp->level, sp->cfg.band_num);
+    memcpy(result->peak, sp->peak, sp->cfg.band_num);
+
+    return OPRT_OK;
+}
@@ -2,9 +2,10 @@
  * @file spectrum_meter.c
  * @brief Microphone input to FFT spectrum meter on 32x32 LED pixel display
  *
- * This demo reads 16kHz mono audio input, performs FFT analysis, and displays
- * the spectrum on a 32x32 LED matrix. The display shows 8 frequency bands,
- * each 4 pixels wide, with height representing magnitude.
+ * This demo reads 16kHz mono audio input, runs it through the fixed-point
+ * audio spectrum analyzer (512-point RFFT, mel bands, peak hold) and displays
+ * the spectrum on a 32x32 LED matrix. The display shows 16 frequency bands,
+ * each 2 pixels wide, with height representing magnitude.
  */
 
 #include "tal_api.h"
@@ -14,23 +15,19 @@
 #include "board_com_api.h"
 #include "board_pixel_api.h"
 #include "tdl_audio_manage.h"
+#include "tdl_pixel_matrix.h"
 #include "tuya_ringbuf.h"
+#include "audio_spectrum.h"
 
 #include <string.h>
-#include <math.h>
 #include <stdlib.h>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
 /***********************************************************
 ************************macro define************************
 ***********************************************************/
 
 #define LED_PIXELS_TOTAL_NUM 1027
-#define COLOR_RESOLUTION     1000u
-#define BRIGHTNESS           0.02f // 10% brightness
+#define MATRIX_BRIGHTNESS    5 // 2% brightness (0-255)
 #define MATRIX_WIDTH         32
 #define MATRIX_HEIGHT        32
 
@@ -46,32 +43,29 @@
 #define AUDIO_CODEC_NAME "audio" // Audio codec device name (can be overridden in config)
 #endif
 
-// FFT configuration
-#define FFT_SIZE   128 // Number of samples for FFT (8ms at 16kHz) - reduced for performance
-#define NUM_BANDS  8
-#define BAND_WIDTH 4 // Pixels per band
-
-// Frequency band definitions (Hz)
-// Band 0: 0-500, Band 1: 500-1000, Band 2: 1000-2000, Band 3: 2000-3000
-// Band 4: 3000-4000, Band 5: 4000-5000, Band 6: 5000-6000, Band 7: 6000-8000
-static const float g_freq_band_start[NUM_BANDS] = {0.0f, 500.0f, 1000.0f, 2000.0f, 3000.0f, 4000.0f, 5000.0f, 6000.0f};
-static const float g_freq_band_end[NUM_BANDS] = {500.0f, 1000.0f, 2000.0f, 3000.0f, 4000.0f, 5000.0f, 6000.0f, 8000.0f};
+// Spectrum configuration: 512-point RFFT every 256 samples (16ms), mel spaced bands
+#define SPECTRUM_HOP_SIZE 256
+#define NUM_BANDS         16
+#define BAND_WIDTH        2  // Pixels per band
+#define BAND_FREQ_MIN     60 // Hz
+#define BAND_FREQ_MAX     8000
+#define LEVEL_DB_FLOOR    20 // band energy shown as an empty bar
+#define LEVEL_DB_CEIL     60 // band energy shown as a full bar
 
 /***********************************************************
 ***********************variable define**********************
 ***********************************************************/
 
 static PIXEL_HANDLE_T g_pixels_handle = NULL;
+static PIXEL_MATRIX_HANDLE_T g_matrix_handle = NULL;
+static AUDIO_SPECTRUM_HANDLE_T g_spectrum_handle = NULL;
 
 static TDL_AUDIO_HANDLE_T g_audio_handle = NULL;
 static TUYA_RINGBUFF_T g_audio_ringbuf = NULL;
 static MUTEX_HANDLE g_audio_rb_mutex = NULL;
 
-static int16_t g_audio_buffer[FFT_SIZE];
-static float g_fft_real[FFT_SIZE];
-static float g_fft_imag[FFT_SIZE];
-static float g_band_magnitude[NUM_BANDS];
-static float g_band_peak[NUM_BANDS]; // Peak hold for visual effect
+// Bar colors per band and row, hue shifted from the bottom to the top of the matrix
+static uint8_t g_bar_color[NUM_BANDS][MATRIX_HEIGHT][3];
 
 // Audio statistics for logging
 static uint32_t g_audio_frames_received = 0;
@@ -83,257 +77,95 @@ static uint32_t g_last_log_time = 0;
 ********************function declaration********************
 ***********************************************************/
 
-static void spectrum_display(void);
+static void spectrum_display(AUDIO_SPECTRUM_RESULT_T *result);
 
 static void audio_frame_callback(TDL_AUDIO_FRAME_FORMAT_E type, TDL_AUDIO_STATUS_E status, uint8_t *data, uint32_t len);
-static void process_audio_fft(uint8_t *audio_data, uint32_t data_len);
-static void compute_fft(void);
-static void calculate_band_magnitudes(void);
-static float hann_window(int n, int N);
+static void process_audio_spectrum(uint8_t *audio_data, uint32_t data_len);
+static void bar_color_init(void);
 
 /***********************************************************
 ***********************function define**********************
 ***********************************************************/
 
+/**
+ * @brief Precompute bar colors
+ *
+ * Pure colors per band (red, orange, yellow, green, cyan, blue, purple, magenta...),
+ * shifted by -10 degrees at the bottom to +10 degrees at the top of the matrix.
+ */
+static void bar_color_init(void)
+{
+    for (int band = 0; band < NUM_BANDS; band++) {
+        float base_hue = (float)band / (float)NUM_BANDS * 360.0f; // 0-360 degrees
+
+        for (int row = 0; row < MATRIX_HEIGHT; row++) {
+            float gradient = (float)(MATRIX_HEIGHT - 1 - row) / (float)(MATRIX_HEIGHT - 1);
+            float hue_shift = -10.0f + gradient * 20.0f;
+            uint32_t r, g, b;
+
+            board_pixel_hsv_to_rgb(base_hue + hue_shift, 1.0f, 1.0f, &r, &g, &b);
+            g_bar_color[band][row][0] = (uint8_t)r;
+            g_bar_color[band][row][1] = (uint8_t)g;
+            g_bar_color[band][row][2] = (uint8_t)b;
+        }
+    }
+}
+
 /**
  * @brief Display spectrum on LED matrix
  */
-static void spectrum_display(void)
+static void spectrum_display(AUDIO_SPECTRUM_RESULT_T *result)
 {
-    if (g_pixels_handle == NULL) {
+    if (g_matrix_handle == NULL) {
         return;
     }
 
     // Clear all pixels
-    PIXEL_COLOR_T off_color = {0};
-    tdl_pixel_set_single_color(g_pixels_handle, 0, LED_PIXELS_TOTAL_NUM, &off_color);
-
-    // Update peak decay (every frame, decay peaks by 0.8 pixels for very fast drop)
-    for (int i = 0; i < NUM_BANDS; i++) {
-        if (g_band_peak[i] > 0.0f) {
-            g_band_peak[i] -= 0.8f; // Very fast decay - drops 0.8 pixels per frame
-            if (g_band_peak[i] < 0.0f) {
-                g_band_peak[i] = 0.0f;
-            }
-        }
-    }
+    tdl_pixel_matrix_fill(g_matrix_handle, 0, 0, 0);
 
     // Display each frequency band
-    for (int band = 0; band < NUM_BANDS; band++) {
-        // Calculate bar height (0-32 pixels)
-        float magnitude = g_band_magnitude[band];
-        int bar_height = (int)(magnitude * MATRIX_HEIGHT);
-        if (bar_height > MATRIX_HEIGHT) {
-            bar_height = MATRIX_HEIGHT;
-        }
-        if (bar_height < 0) {
-            bar_height = 0;
-        }
-
-        // Update peak hold
-        if (bar_height > g_band_peak[band]) {
-            g_band_peak[band] = (float)bar_height;
-        }
+    for (int band = 0; band < result->band_num && band < NUM_BANDS; band++) {
+        // Bar and peak height (0-32 pixels) from the 0-255 levels
+        int bar_height = (result->level[band] * MATRIX_HEIGHT + 127) / 255;
+        int peak_height = (result->peak[band] * MATRIX_HEIGHT + 127) / 255;
 
-        // Calculate column range for this band (4 pixels wide)
+        // Calculate column range for this band
         int col_start = band * BAND_WIDTH;
         int col_end = col_start + BAND_WIDTH;
-        // Ensure we don't exceed matrix width
         if (col_end > MATRIX_WIDTH) {
             col_end = MATRIX_WIDTH;
         }
 
-        // Color based on frequency band (hue from red to blue)
-        // Pure colors: red, orange, yellow, green, cyan, blue, purple, magenta
-        float base_hue = (float)band / (float)NUM_BANDS * 360.0f; // 0-360 degrees
-        float saturation = 1.0f;                                  // Full saturation for vibrant colors
-        float value = 1.0f;                                       // Full brightness
-
-        // Draw the bar from bottom (y=31) upward with gradient
-        for (int col = col_start; col < col_end && col < MATRIX_WIDTH; col++) {
-            // Draw magnitude bar with hue shift gradient
-            for (int row = MATRIX_HEIGHT - 1; row >= MATRIX_HEIGHT - bar_height && row >= 0; row--) {
-                // Calculate gradient: 0.0 at bottom, 1.0 at top
-                int row_in_bar = MATRIX_HEIGHT - 1 - row;
-                float gradient = 0.0f;
-                if (bar_height > 1) {
-                    gradient = (float)row_in_bar / (float)(bar_height - 1);
-                }
-                // Hue shift: shift by -10 degrees at bottom to +10 degrees at top
-                // This creates a subtle color transition while staying close to the base color
-                float hue_shift = -10.0f + gradient * 20.0f;
-                float shifted_hue = base_hue + hue_shift;
-
-                // Convert HSV to RGB with hue shift but constant saturation and value
-                uint32_t r, g, b;
-                board_pixel_hsv_to_rgb(shifted_hue, saturation, value, &r, &g, &b);
-
-                // Apply brightness scaling
-                PIXEL_COLOR_T gradient_color = {.red = (uint32_t)(r * COLOR_RESOLUTION * BRIGHTNESS / 255),
-                                                .green = (uint32_t)(g * COLOR_RESOLUTION * BRIGHTNESS / 255),
-                                                .blue = (uint32_t)(b * COLOR_RESOLUTION * BRIGHTNESS / 255),
-                                                .warm = 0,
-                                                .cold = 0};
-
-                uint32_t led_index = board_pixel_matrix_coord_to_led_index((uint32_t)col, (uint32_t)row);
-                if (led_index < LED_PIXELS_TOTAL_NUM) {
-                    tdl_pixel_set_single_color(g_pixels_handle, led_index, 1, &gradient_color);
-                }
-            }
-
-            // Draw peak indicator (white dot at peak position)
-            int peak_pos = MATRIX_HEIGHT - 1 - (int)g_band_peak[band];
-            if (peak_pos >= 0 && peak_pos < MATRIX_HEIGHT) {
-                PIXEL_COLOR_T peak_color = {.red = (uint32_t)(COLOR_RESOLUTION * BRIGHTNESS),
-                                            .green = (uint32_t)(COLOR_RESOLUTION * BRIGHTNESS),
-                                            .blue = (uint32_t)(COLOR_RESOLUTION * BRIGHTNESS),
-                                            .warm = 0,
-                                            .cold = 0};
-                uint32_t peak_led_index = board_pixel_matrix_coord_to_led_index((uint32_t)col, (uint32_t)peak_pos);
-                if (peak_led_index < LED_PIXELS_TOTAL_NUM) {
-                    tdl_pixel_set_single_color(g_pixels_handle, peak_led_index, 1, &peak_color);
-                }
+        for (int col = col_start; col < col_end; col++) {
+            // Draw the bar from bottom (y=31) upward
+            for (int row = MATRIX_HEIGHT - 1; row >= MATRIX_HEIGHT - bar_height; row--) {
+                uint8_t *color = g_bar_color[band][row];
+                tdl_pixel_matrix_set_pixel(g_matrix_handle, col, row, color[0], color[1], color[2]);
             }
-        }
-    }
-
-    tdl_pixel_dev_refresh(g_pixels_handle);
-}
-
-/**
- * @brief Hann window function
- */
-static float hann_window(int n, int N)
-{
-    return 0.5f * (1.0f - cosf(2.0f * M_PI * (float)n / (float)(N - 1)));
-}
-
-/**
- * @brief Compute FFT using optimized DFT - only compute bins we need
- */
-static void compute_fft(void)
-{
-    // Pre-compute window function values
-    static float window[FFT_SIZE];
-    static bool window_computed = false;
-    if (!window_computed) {
-        for (int n = 0; n < FFT_SIZE; n++) {
-            window[n] = hann_window(n, FFT_SIZE);
-        }
-        window_computed = true;
-    }
-
-    // Apply window and compute only needed frequency bins
-    // We only need bins up to ~8kHz (bin 64 for 16kHz sample rate with 128-point FFT)
-    int max_bin = FFT_SIZE / 2; // Nyquist frequency
 
-    for (int k = 0; k < max_bin; k++) {
-        float real_sum = 0.0f;
-        float imag_sum = 0.0f;
-        float k_angle_scale = -2.0f * M_PI * (float)k / (float)FFT_SIZE;
-
-        for (int n = 0; n < FFT_SIZE; n++) {
-            float windowed = (float)g_audio_buffer[n] * window[n];
-            float angle = k_angle_scale * (float)n;
-            real_sum += windowed * cosf(angle);
-            imag_sum += windowed * sinf(angle);
+            // Draw peak indicator (white dot above the bar, clipped at the top)
+            tdl_pixel_matrix_set_pixel(g_matrix_handle, col, MATRIX_HEIGHT - 1 - peak_height, 255, 255, 255);
         }
-
-        g_fft_real[k] = real_sum;
-        g_fft_imag[k] = imag_sum;
     }
 
-    // Clear unused bins
-    for (int k = max_bin; k < FFT_SIZE; k++) {
-        g_fft_real[k] = 0.0f;
-        g_fft_imag[k] = 0.0f;
-    }
+    tdl_pixel_matrix_present(g_matrix_handle);
 }
 
 /**
- * @brief Calculate magnitude for each frequency band
+ * @brief Feed audio data to the spectrum analyzer and show new spectra
  */
-static void calculate_band_magnitudes(void)
+static void process_audio_spectrum(uint8_t *audio_data, uint32_t data_len)
 {
-    float freq_resolution = (float)SAMPLE_RATE / (float)FFT_SIZE; // ~62.5 Hz per bin
-
-    for (int band = 0; band < NUM_BANDS; band++) {
-        float band_start_hz = g_freq_band_start[band];
-        float band_end_hz = g_freq_band_end[band];
-
-        int bin_start = (int)(band_start_hz / freq_resolution);
-        int bin_end = (int)(band_end_hz / freq_resolution);
-
-        if (bin_start >= FFT_SIZE)
-            bin_start = FFT_SIZE - 1;
-        if (bin_end >= FFT_SIZE)
-            bin_end = FFT_SIZE - 1;
-        if (bin_start < 0)
-            bin_start = 0;
-        if (bin_end < bin_start)
-            bin_end = bin_start;
-
-        // Calculate average magnitude in this band
-        float magnitude_sum = 0.0f;
-        int bin_count = 0;
-
-        for (int bin = bin_start; bin <= bin_end; bin++) {
-            float magnitude = sqrtf(g_fft_real[bin] * g_fft_real[bin] + g_fft_imag[bin] * g_fft_imag[bin]);
-            magnitude_sum += magnitude;
-            bin_count++;
-        }
-
-        float avg_magnitude = (bin_count > 0) ? (magnitude_sum / (float)bin_count) : 0.0f;
-
-        // Normalize and apply logarithmic scaling for better visualization
-        // Scale to 0-1 range with some compression
-        float normalized = avg_magnitude / 10000.0f; // Adjust this divisor based on your audio levels
-        if (normalized > 1.0f)
-            normalized = 1.0f;
-        if (normalized < 0.0f)
-            normalized = 0.0f;
-
-        // Apply logarithmic scaling for better visual response
-        normalized = log10f(1.0f + normalized * 9.0f); // Maps 0-1 to 0-1 with log curve
+    AUDIO_SPECTRUM_RESULT_T result;
 
-        g_band_magnitude[band] = normalized;
-    }
-}
-
-/**
- * @brief Process audio data and perform FFT
- */
-static void process_audio_fft(uint8_t *audio_data, uint32_t data_len)
-{
-    // Convert bytes to samples (16-bit PCM, mono)
-    uint32_t num_samples = data_len / BYTES_PER_SAMPLE;
-    if (num_samples > FFT_SIZE) {
-        num_samples = FFT_SIZE;
+    // 16-bit PCM, mono
+    if (0 == audio_spectrum_feed(g_spectrum_handle, (const int16_t *)audio_data, data_len / BYTES_PER_SAMPLE)) {
+        return;
     }
 
-    // Convert PCM bytes to int16 samples
-    int16_t *pcm_samples = (int16_t *)audio_data;
-
-    // Shift buffer and add new samples
-    // Keep last FFT_SIZE samples in buffer
-    if (num_samples >= FFT_SIZE) {
-        // Replace entire buffer
-        memcpy(g_audio_buffer, pcm_samples, FFT_SIZE * sizeof(int16_t));
-    } else {
-        // Shift existing samples left
-        memmove(g_audio_buffer, &g_audio_buffer[num_samples], (FFT_SIZE - num_samples) * sizeof(int16_t));
-        // Add new samples at the end
-        memcpy(&g_audio_buffer[FFT_SIZE - num_samples], pcm_samples, num_samples * sizeof(int16_t));
+    if (OPRT_OK == audio_spectrum_get_result(g_spectrum_handle, &result)) {
+        spectrum_display(&result);
     }
-
-    // Perform FFT
-    compute_fft();
-
-    // Calculate band magnitudes
-    calculate_band_magnitudes();
-
-    // Update display
-    spectrum_display();
 }
 
 /**
@@ -449,8 +281,8 @@ static void audio_processing_task(void *args)
                              g_audio_frames_processed, available, read_len, min_sample, max_sample, avg_level);
                 }
 
-                // Single FFT and display update
-                process_audio_fft(audio_buffer, read_len);
+                // Spectrum and display update
+                process_audio_spectrum(audio_buffer, read_len);
             } else {
                 PR_WARN("Failed to read full frame: expected=%d, got=%d", FRAME_SIZE_BYTES, read_len);
             }
@@ -492,7 +324,7 @@ static void user_main(void)
     PR_NOTICE("Tuya T5AI Pixel Spectrum Meter");
     PR_NOTICE("==========================================");
     PR_NOTICE("16kHz mono audio input to FFT spectrum");
-    PR_NOTICE("32x32 LED display with 8 frequency bands");
+    PR_NOTICE("32x32 LED display with 16 frequency bands");
     PR_NOTICE("==========================================");
 
     // Initialize hardware
@@ -511,6 +343,40 @@ static void user_main(void)
     }
     PR_NOTICE("Pixel LED initialized: %d pixels", LED_PIXELS_TOTAL_NUM);
 
+    PIXEL_MATRIX_CFG_T matrix_cfg = {
+        .width = MATRIX_WIDTH,
+        .height = MATRIX_HEIGHT,
+        .start_index = 0,
+        .layout = PIXEL_MATRIX_LAYOUT_SERPENTINE,
+        .gamma = 1.0f,
+        .brightness = MATRIX_BRIGHTNESS,
+    };
+    rt = tdl_pixel_matrix_create(g_pixels_handle, &matrix_cfg, &g_matrix_handle);
+    if (OPRT_OK != rt) {
+        PR_ERR("Failed to create pixel matrix: %d", rt);
+        return;
+    }
+    bar_color_init();
+
+    AUDIO_SPECTRUM_CFG_T spectrum_cfg = {
+        .sample_rate = SAMPLE_RATE,
+        .hop_size = SPECTRUM_HOP_SIZE,
+        .band_num = NUM_BANDS,
+        .scale = AUDIO_SPECTRUM_SCALE_MEL,
+        .freq_min = BAND_FREQ_MIN,
+        .freq_max = BAND_FREQ_MAX,
+        .db_floor = LEVEL_DB_FLOOR,
+        .db_ceil = LEVEL_DB_CEIL,
+        .fall_speed = 24,
+        .peak_hold = 8,
+        .peak_fall_speed = 6,
+    };
+    rt = audio_spectrum_create(&spectrum_cfg, &g_spectrum_handle);
+    if (OPRT_OK != rt) {
+        PR_ERR("Failed to create spectrum analyzer: %d", rt);
+        return;
+    }
+
     // Initialize audio ring buffer
     rt = tuya_ring_buff_create(AUDIO_RINGBUF_SIZE, OVERFLOW_PSRAM_STOP_TYPE, &g_audio_ringbuf);
     if (OPRT_OK != rt) {
@@ -546,11 +412,6 @@ static void user_main(void)
     }
     PR_NOTICE("Audio device opened and started");
 
-    // Initialize band magnitude arrays
-    memset(g_band_magnitude, 0, sizeof(g_band_magnitude));
-    memset(g_band_peak, 0, sizeof(g_band_peak));
-    memset(g_audio_buffer, 0, sizeof(g_audio_buffer));
-
     // Start audio processing task
     THREAD_CFG_T thrd_param = {.stackDepth = 4096, .priority = THREAD_PRIO_2, .thrdname = "audio_proc"};
 
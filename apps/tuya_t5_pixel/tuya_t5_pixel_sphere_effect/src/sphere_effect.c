@@ -3,7 +3,8 @@
  * @brief 3D rotating sphere effect on 32x32 LED pixel display
  *
  * This demo creates a virtual 3D space (32x32x32) with a rotating sphere.
- * The sphere is projected onto a 2D LED matrix with color gradients.
+ * The sphere is a point cloud rotated, projected and depth sorted with the fixed-point
+ * renderer and drawn onto a 2D LED matrix with color gradients.
  */
 
 #include "tal_api.h"
@@ -15,6 +16,8 @@
 #include "tdl_audio_manage.h"
 #include "tuya_ringbuf.h"
 #include "tdl_button_manage.h"
+#include "tdl_pixel_matrix.h"
+#include "tdl_pixel_render3d.h"
 
 #include <string.h>
 #include <math.h>
@@ -30,11 +33,25 @@
 ***********************************************************/
 
 #define LED_PIXELS_TOTAL_NUM 1027
-#define COLOR_RESOLUTION     1000u
-#define BRIGHTNESS           0.1f // 2% brightness
+#define MATRIX_BRIGHTNESS    26 // 10% brightness (0-255)
 #define MATRIX_WIDTH         32
 #define MATRIX_HEIGHT        32
 
+// The LEDs expect GRB order, so red and green are swapped in the frame buffer
+#define FRAME_R 1
+#define FRAME_G 0
+#define FRAME_B 2
+
+#define FRAME_TIME_MS 20 // ~50 FPS
+
+#if defined(ENABLE_EXT_RAM) && (ENABLE_EXT_RAM == 1)
+#define SPHERE_MALLOC tal_psram_malloc
+#else
+#define SPHERE_MALLOC tal_malloc
+#endif
+
+#define FRAME_PIXEL(frame, x, y) (&(frame)[((y) * MATRIX_WIDTH + (x)) * PIXEL_MATRIX_BPP])
+
 // 3D space configuration
 #define SPACE_SIZE      32
 #define SPHERE_RADIUS   16.0f
@@ -46,6 +63,9 @@
 #define MAX_ROTATION_SPEED  15.0f // Maximum rotation speed with audio boost
 #define UV_SPEED_MULTIPLIER 2.0f  // How much UV power affects speed (1.0 = no effect, 2.0 = doubles speed)
 
+// Sphere surface points, dense enough to leave no holes up to ~1.2x radius
+#define SPHERE_POINT_NUM 8192
+
 // Audio configuration
 #define SAMPLE_RATE        16000
 #define CHANNELS           1
@@ -67,6 +87,14 @@
 ***********************************************************/
 
 static PIXEL_HANDLE_T g_pixels_handle = NULL;
+static PIXEL_MATRIX_HANDLE_T g_matrix_handle = NULL;
+static PIXEL_R3D_HANDLE_T g_r3d_handle = NULL;
+
+// Sphere point cloud, each point keeps the hue of its model position as palette index
+static PIXEL_R3D_VEC_T *g_sphere_points = NULL; // model space, radius SPHERE_RADIUS
+static PIXEL_R3D_VEC_T *g_sphere_view = NULL;   // rotated points of the current frame
+static uint8_t *g_sphere_hue = NULL;
+static PIXEL_R3D_COLOR_T g_sphere_palette[PIXEL_R3D_PALETTE_SIZE];
 
 // Audio processing
 static TDL_AUDIO_HANDLE_T g_audio_handle = NULL;
@@ -77,20 +105,6 @@ static MUTEX_HANDLE g_uv_power_mutex = NULL;
 static int16_t g_audio_buffer[AUDIO_BUFFER_SIZE];
 static float g_audio_power = 0.0f; // Audio power (0.0-1.0), protected by mutex
 
-// Double buffering for smooth rendering
-// Render thread writes to back buffer, display thread reads from front buffer
-#define NUM_BUFFERS 2
-static struct {
-    uint8_t r[MATRIX_WIDTH][MATRIX_HEIGHT]; // Pre-calculated RGB values
-    uint8_t g[MATRIX_WIDTH][MATRIX_HEIGHT];
-    uint8_t b[MATRIX_WIDTH][MATRIX_HEIGHT];
-    bool ready; // Buffer is ready for display
-} g_render_buffers[NUM_BUFFERS];
-
-static int g_front_buffer = 0;             // Currently displayed buffer
-static int g_back_buffer = 1;              // Currently being rendered to
-static MUTEX_HANDLE g_buffer_mutex = NULL; // Protect buffer swapping
-
 // Rotation state - random rotation around multiple axes
 static float g_rotation_angle_x = 0.0f; // Rotation angle around X axis
 static float g_rotation_angle_y = 0.0f; // Rotation angle around Y axis
@@ -146,26 +160,26 @@ static struct {
 ***********************************************************/
 
 static OPERATE_RET pixel_led_init(void);
+static OPERATE_RET sphere_model_init(void);
 // static void sphere_display(void);
-static void render_sphere_3d(int buffer_idx);
-static void display_sphere_fast(void);
-static float calculate_sphere_hue(float x, float y, float z, float audio_power);
+static void render_sphere_3d(uint8_t *frame);
+static float calculate_sphere_hue(float dx, float dy, float dz);
 // static float calculate_hot_spot_intensity(float x, float y, float z, int *hotspot_idx);
 // static void update_rotation_axes(void);
 static void update_audio_reactive_effects(float audio_power);
 static void initialize_hot_spots(void);
 static void sphere_rendering_task(void *args);
-static void sphere_display_task(void *args);
 
 // Rendering engines
-static void render_voxel_gradient_core(int buffer_idx, float radius, float audio_power, bool mic_responsive,
+static void update_sphere_palette(float audio_power, bool mic_responsive, float white_fade_factor);
+static void render_voxel_gradient_core(uint8_t *frame, float radius, float audio_power, bool mic_responsive,
                                        float white_fade_factor);
-static void render_idle_state(int buffer_idx);
-static void render_start_state(int buffer_idx);
-static void render_processing_state(int buffer_idx);
-static void render_responding_state(int buffer_idx);
-static void render_transition_to_idle_state(int buffer_idx);
-static void render_running_ring(int buffer_idx, float angle1, float angle2);
+static void render_idle_state(uint8_t *frame);
+static void render_start_state(uint8_t *frame);
+static void render_processing_state(uint8_t *frame);
+static void render_responding_state(uint8_t *frame);
+static void render_transition_to_idle_state(uint8_t *frame);
+static void render_running_ring(uint8_t *frame, float angle1, float angle2);
 static void update_voice_state_machine(void);
 static void transition_to_state(voice_state_t new_state);
 
@@ -197,9 +211,73 @@ static OPERATE_RET pixel_led_init(void)
     }
 
     PR_NOTICE("Pixel LED initialized: %d pixels", LED_PIXELS_TOTAL_NUM);
+
+    PIXEL_MATRIX_CFG_T matrix_cfg = {
+        .width = MATRIX_WIDTH,
+        .height = MATRIX_HEIGHT,
+        .start_index = 0,
+        .layout = PIXEL_MATRIX_LAYOUT_SERPENTINE,
+        .gamma = 1.0f,
+        .brightness = MATRIX_BRIGHTNESS,
+    };
+    rt = tdl_pixel_matrix_create(g_pixels_handle, &matrix_cfg, &g_matrix_handle);
+    if (OPRT_OK != rt) {
+        PR_ERR("Failed to create pixel matrix: %d", rt);
+        return rt;
+    }
+
+    PIXEL_R3D_CFG_T r3d_cfg = {
+        .width = MATRIX_WIDTH,
+        .height = MATRIX_HEIGHT,
+        .point_max = SPHERE_POINT_NUM,
+    };
+    rt = tdl_pixel_r3d_create(&r3d_cfg, &g_r3d_handle);
+    if (OPRT_OK != rt) {
+        PR_ERR("Failed to create 3D renderer: %d", rt);
+        return rt;
+    }
+
     return rt;
 }
 
+/**
+ * @brief Build the sphere point cloud
+ *
+ * Points are spread evenly over the sphere surface on a Fibonacci lattice. Their hue
+ * only depends on the model position, so it is computed once here and the per-frame
+ * color changes are applied to the palette instead.
+ */
+static OPERATE_RET sphere_model_init(void)
+{
+    const float golden_angle = (float)M_PI * (3.0f - sqrtf(5.0f));
+    const float scale = SPHERE_RADIUS * PIXEL_R3D_COORD_ONE;
+
+    g_sphere_points = (PIXEL_R3D_VEC_T *)SPHERE_MALLOC(SPHERE_POINT_NUM * sizeof(PIXEL_R3D_VEC_T));
+    g_sphere_view = (PIXEL_R3D_VEC_T *)SPHERE_MALLOC(SPHERE_POINT_NUM * sizeof(PIXEL_R3D_VEC_T));
+    g_sphere_hue = (uint8_t *)SPHERE_MALLOC(SPHERE_POINT_NUM);
+    if (g_sphere_points == NULL || g_sphere_view == NULL || g_sphere_hue == NULL) {
+        PR_ERR("Failed to allocate sphere points");
+        return OPRT_MALLOC_FAILED;
+    }
+
+    for (int i = 0; i < SPHERE_POINT_NUM; i++) {
+        float y = 1.0f - 2.0f * ((float)i + 0.5f) / (float)SPHERE_POINT_NUM;
+        float ring = sqrtf(1.0f - y * y);
+        float theta = golden_angle * (float)i;
+        float x = cosf(theta) * ring;
+        float z = sinf(theta) * ring;
+
+        g_sphere_points[i].x = (int16_t)lroundf(x * scale);
+        g_sphere_points[i].y = (int16_t)lroundf(y * scale);
+        g_sphere_points[i].z = (int16_t)lroundf(z * scale);
+
+        float hue = calculate_sphere_hue(x, y, z);
+        g_sphere_hue[i] = (uint8_t)((int)(hue * PIXEL_R3D_PALETTE_SIZE / 360.0f) & (PIXEL_R3D_PALETTE_SIZE - 1));
+    }
+
+    return OPRT_OK;
+}
+
 /**
  * @brief Initialize hot spots on the sphere with specific colors
  * Colors: Blue, Green, Magenta, Light Purple
@@ -339,18 +417,12 @@ static void update_audio_reactive_effects(float audio_power)
 // }
 
 /**
- * @brief Calculate hue for a point on the sphere surface (audio-reactive full color spectrum)
- * @param x, y, z: 3D coordinates (rotated, sphere surface coordinates)
- * @param audio_power: Current audio power (0-1)
+ * @brief Calculate the base hue of a point on the sphere surface (full color spectrum)
+ * @param dx, dy, dz: Position relative to the sphere center, in model space
  * @return Hue value in degrees (0-360)
  */
-static float calculate_sphere_hue(float x, float y, float z, float audio_power)
+static float calculate_sphere_hue(float dx, float dy, float dz)
 {
-    // Map sphere position to hue using spherical coordinates
-    float dx = x - SPHERE_CENTER_X;
-    float dy = y - SPHERE_CENTER_Y;
-    float dz = z - SPHERE_CENTER_Z;
-
     // Calculate spherical coordinates
     float azimuth = atan2f(dx, dz);
     if (azimuth < 0.0f) {
@@ -365,9 +437,6 @@ static float calculate_sphere_hue(float x, float y, float z, float audio_power)
     float base_hue = (azimuth / (2.0f * M_PI)) * 360.0f;
     float hue = base_hue + (elevation_normalized - 0.5f) * 180.0f;
 
-    // Audio-reactive hue shift - full spectrum
-    hue += g_hue_shift * 0.5f; // Smooth hue shift for color morphing
-
     // Keep hue in 0-360 range
     while (hue >= 360.0f)
         hue -= 360.0f;
@@ -416,7 +485,7 @@ static void update_voice_state_machine(void)
 /**
  * @brief Render 3D sphere - routes to appropriate engine based on state
  */
-static void render_sphere_3d(int buffer_idx)
+static void render_sphere_3d(uint8_t *frame)
 {
     voice_state_t current_state;
     if (g_voice_state_mutex != NULL) {
@@ -432,35 +501,79 @@ static void render_sphere_3d(int buffer_idx)
 
     switch (current_state) {
     case VOICE_STATE_IDLE:
-        render_idle_state(buffer_idx);
+        render_idle_state(frame);
         break;
     case VOICE_STATE_START:
-        render_start_state(buffer_idx);
+        render_start_state(frame);
         break;
     case VOICE_STATE_PROCESSING:
-        render_processing_state(buffer_idx);
+        render_processing_state(frame);
         break;
     case VOICE_STATE_RESPONDING:
-        render_responding_state(buffer_idx);
+        render_responding_state(frame);
         break;
     case VOICE_STATE_TRANSITION_TO_IDLE:
-        render_transition_to_idle_state(buffer_idx);
+        render_transition_to_idle_state(frame);
         break;
     default:
-        render_idle_state(buffer_idx);
+        render_idle_state(frame);
         break;
     }
 }
 
 /**
- * @brief Helper function: Render voxel gradient sphere with configurable parameters
- * @param buffer_idx Buffer index to render to
+ * @brief Update the sphere palette: hue rotation, saturation, brightness and white fade
+ * @param audio_power Audio power for reactivity
+ * @param mic_responsive Whether brightness should react to mic RMS
+ * @param white_fade_factor Factor to fade to white (0.0 = no fade, 1.0 = fully white)
+ */
+static void update_sphere_palette(float audio_power, bool mic_responsive, float white_fade_factor)
+{
+    // Smooth color morphing - hue shift and random offset rotate the whole palette
+    float hue_offset = g_hue_shift + g_random_hue_offset * 0.2f;
+
+    // Dynamic saturation - lower saturation creates white/pastel tones
+    float saturation = 0.6f + audio_power * 0.4f; // 0.6 to 1.0 base saturation
+
+    // Brightness handling - mic responsive or fixed
+    float brightness;
+    if (mic_responsive) {
+        // Responsive to mic RMS - brightness reacts to audio
+        brightness = 0.5f + audio_power * 0.5f; // 0.5x to 1.0x brightness
+    } else {
+        // Less reactive - fixed brightness
+        brightness = 0.7f;
+    }
+    float white = 255.0f * brightness * white_fade_factor;
+
+    for (int i = 0; i < PIXEL_R3D_PALETTE_SIZE; i++) {
+        uint32_t r, g, b;
+        board_pixel_hsv_to_rgb((float)i * 360.0f / PIXEL_R3D_PALETTE_SIZE + hue_offset, saturation, brightness, &r,
+                               &g, &b);
+
+        // Blend between colored and white based on white_fade_factor
+        if (white_fade_factor > 0.001f) {
+            r = (uint32_t)(r * (1.0f - white_fade_factor) + white);
+            g = (uint32_t)(g * (1.0f - white_fade_factor) + white);
+            b = (uint32_t)(b * (1.0f - white_fade_factor) + white);
+        }
+
+        // Palette entries are stored in frame (GRB) order
+        g_sphere_palette[i].red = (uint8_t)g;
+        g_sphere_palette[i].green = (uint8_t)r;
+        g_sphere_palette[i].blue = (uint8_t)b;
+    }
+}
+
+/**
+ * @brief Helper function: Render gradient sphere with configurable parameters
+ * @param frame Frame buffer to render to
  * @param radius Sphere radius
  * @param audio_power Audio power for reactivity
  * @param mic_responsive Whether brightness should react to mic RMS
  * @param white_fade_factor Factor to fade to white (0.0 = no fade, 1.0 = fully white)
  */
-static void render_voxel_gradient_core(int buffer_idx, float radius, float audio_power, bool mic_responsive,
+static void render_voxel_gradient_core(uint8_t *frame, float radius, float audio_power, bool mic_responsive,
                                        float white_fade_factor)
 {
     // audio_power is passed as parameter, use it directly
@@ -494,164 +607,44 @@ static void render_voxel_gradient_core(int buffer_idx, float radius, float audio
     }
     effect2_last_time = current_time;
 
-    // Pre-calculate rotation matrices - only Z axis rotation for effect 2
-
-    float cos_z = cosf(effect2_rotation_z);
-    float sin_z = sinf(effect2_rotation_z);
-
-    float radius_sq = current_radius * current_radius;
-
-    // Temporary buffers
-    static float temp_brightness[MATRIX_WIDTH][MATRIX_HEIGHT];
-    static float temp_hue[MATRIX_WIDTH][MATRIX_HEIGHT];
-    memset(temp_brightness, 0, sizeof(temp_brightness));
-    memset(temp_hue, 0, sizeof(temp_hue));
-
-    // Iterate through Z layers (voxel approach)
-    for (int z = 0; z < SPACE_SIZE; z++) {
-        float z_world = (float)z;
-        float dz = z_world - SPHERE_CENTER_Z;
-
-        for (int y = 0; y < MATRIX_HEIGHT; y++) {
-            for (int x = 0; x < MATRIX_WIDTH; x++) {
-                float x_world = (float)x;
-                float y_world = (float)y;
-                float dx = x_world - SPHERE_CENTER_X;
-                float dy = y_world - SPHERE_CENTER_Y;
-
-                // Rotate point around Z axis only (simplified rotation for effect 2)
-                // Z-axis rotation: z stays same, x and y rotate around z
-                float rx = dx * cos_z - dy * sin_z;
-                float ry = dx * sin_z + dy * cos_z;
-                float rz = dz;
-
-                // Check if inside sphere
-                float dist_sq = rx * rx + ry * ry + rz * rz;
-                if (dist_sq <= radius_sq) {
-                    // float dist = sqrtf(dist_sq);
-                    // float nx = rx / current_radius;
-                    // float ny = ry / current_radius;
-                    float nz = rz / current_radius;
-
-                    // Top-down view - brightness based on normal Z component (facing up)
-                    // No depth factor - all rotations based on sphere center
-                    float brightness = fmaxf(0.0f, nz * 0.5f + 0.5f);
-
-                    // Audio power as intensity boost (multiplicative, not just additive)
-                    float audio_intensity_boost = 0.4f + audio_power * 1.6f; // 0.4x to 2.0x boost
-                    brightness *= audio_intensity_boost;
-
-                    // Hue based on position with gradient - smooth color transition and morphing
-                    // Full color spectrum (0-360 degrees) - no limits
-                    float hue = calculate_sphere_hue(rx + SPHERE_CENTER_X, ry + SPHERE_CENTER_Y, rz + SPHERE_CENTER_Z,
-                                                     audio_power);
-                    // Smooth color morphing - use hue shift for prolonged transitions
-                    hue += g_hue_shift * 0.5f;         // Smooth hue shift for color morphing
-                    hue += g_random_hue_offset * 0.2f; // Random hue offset for color variation
-                    // No time-based pixel-level randomness - only smooth global transitions
-
-                    // Wrap to 0-360 range
-                    while (hue >= 360.0f)
-                        hue -= 360.0f;
-                    while (hue < 0.0f)
-                        hue += 360.0f;
-
-                    // Accumulate (summation)
-                    temp_brightness[x][y] += brightness;
-                    // Weighted average hue
-                    if (temp_brightness[x][y] > 0.001f) {
-                        float weight = brightness / (temp_brightness[x][y] + 0.001f);
-                        temp_hue[x][y] = temp_hue[x][y] * (1.0f - weight) + hue * weight;
-                    }
-                }
-            }
-        }
-    }
-
-    // Normalize and render
-    float max_brightness = 0.0f;
-    for (int y = 0; y < MATRIX_HEIGHT; y++) {
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
-            if (temp_brightness[x][y] > max_brightness) {
-                max_brightness = temp_brightness[x][y];
-            }
-        }
-    }
-
-    if (max_brightness > 0.001f) {
-        for (int y = 0; y < MATRIX_HEIGHT; y++) {
-            for (int x = 0; x < MATRIX_WIDTH; x++) {
-                float brightness = temp_brightness[x][y] / max_brightness;
-                if (brightness > 1.0f)
-                    brightness = 1.0f;
-                float hue = temp_hue[x][y];
-                while (hue >= 360.0f)
-                    hue -= 360.0f;
-                while (hue < 0.0f)
-                    hue += 360.0f;
-
-                uint32_t r, g, b;
-                // Dynamic saturation for white/pink effects - lower saturation creates white/pastel tones
-                // Higher brightness areas can have lower saturation for white effect
-                float base_saturation = 0.6f + audio_power * 0.4f; // 0.6 to 1.0 base saturation
-                // Reduce saturation in brighter areas to create white/pink tones
-                float white_factor =
-                    (brightness > 0.7f) ? (brightness - 0.7f) * 0.5f : 0.0f; // Reduce sat in bright areas
-                float saturation = base_saturation * (1.0f - white_factor);  // Lower sat = more white
-                if (saturation < 0.2f)
-                    saturation = 0.2f; // Minimum saturation to avoid pure gray
-
-                // Brightness handling - mic responsive or fixed
-                float final_brightness;
-                if (mic_responsive) {
-                    // Responsive to mic RMS - brightness reacts to audio
-                    final_brightness = brightness * (0.5f + audio_power * 0.5f); // 0.5x to 1.0x brightness
-                } else {
-                    // Less reactive - fixed brightness
-                    final_brightness = brightness * 0.7f;
-                }
-
-                // Apply white fade if needed
-                if (white_fade_factor > 0.001f) {
-                    board_pixel_hsv_to_rgb(hue, saturation, final_brightness, &r, &g, &b);
-                    // Blend between colored and white based on white_fade_factor
-                    float white_r = 255 * final_brightness;
-                    float white_g = 255 * final_brightness;
-                    float white_b = 255 * final_brightness;
-                    g_render_buffers[buffer_idx].r[x][y] =
-                        (uint8_t)(r * (1.0f - white_fade_factor) + white_r * white_fade_factor);
-                    g_render_buffers[buffer_idx].g[x][y] =
-                        (uint8_t)(g * (1.0f - white_fade_factor) + white_g * white_fade_factor);
-                    g_render_buffers[buffer_idx].b[x][y] =
-                        (uint8_t)(b * (1.0f - white_fade_factor) + white_b * white_fade_factor);
-                } else {
-                    board_pixel_hsv_to_rgb(hue, saturation, final_brightness, &r, &g, &b);
-                    g_render_buffers[buffer_idx].r[x][y] = (uint8_t)r;
-                    g_render_buffers[buffer_idx].g[x][y] = (uint8_t)g;
-                    g_render_buffers[buffer_idx].b[x][y] = (uint8_t)b;
-                }
-            }
-        }
-    } else {
-        memset(g_render_buffers[buffer_idx].r, 0, sizeof(g_render_buffers[buffer_idx].r));
-        memset(g_render_buffers[buffer_idx].g, 0, sizeof(g_render_buffers[buffer_idx].g));
-        memset(g_render_buffers[buffer_idx].b, 0, sizeof(g_render_buffers[buffer_idx].b));
+    memset(frame, 0, MATRIX_WIDTH * MATRIX_HEIGHT * PIXEL_MATRIX_BPP);
+    if (g_r3d_handle == NULL || g_sphere_points == NULL) {
+        return;
     }
 
-    g_render_buffers[buffer_idx].ready = true;
+    // Rotate the model around the Z axis only (simplified rotation for effect 2)
+    PIXEL_R3D_MAT_T rotation;
+    tdl_pixel_r3d_rotation(&rotation, 0, 0, PIXEL_R3D_ANGLE_FROM_RAD(-effect2_rotation_z));
+    tdl_pixel_r3d_transform(&rotation, g_sphere_points, g_sphere_view, SPHERE_POINT_NUM);
+
+    // Top-down view - brightness follows the normal Z component, from 0.5 at the rim to 1.0 facing up
+    PIXEL_R3D_VIEW_T view = {
+        .center_x = (int16_t)(SPHERE_CENTER_X * PIXEL_R3D_COORD_ONE),
+        .center_y = (int16_t)(SPHERE_CENTER_Y * PIXEL_R3D_COORD_ONE),
+        .scale = (uint16_t)(current_radius / SPHERE_RADIUS * PIXEL_R3D_COORD_ONE),
+        .focal = 0,
+        .depth_near = (int16_t)(SPHERE_RADIUS * PIXEL_R3D_COORD_ONE),
+        .depth_far = (int16_t)(-SPHERE_RADIUS * PIXEL_R3D_COORD_ONE),
+        .shade_far = 0,
+        .blend = PIXEL_R3D_BLEND_REPLACE,
+    };
+    tdl_pixel_r3d_set_view(g_r3d_handle, &view);
+
+    update_sphere_palette(audio_power, mic_responsive, white_fade_factor);
+    tdl_pixel_r3d_splat(g_r3d_handle, frame, g_sphere_view, g_sphere_hue, SPHERE_POINT_NUM, g_sphere_palette);
 }
 
 /**
  * @brief Render PROCESSING state: voxel gradient + red running ring
  */
-static void render_processing_state(int buffer_idx)
+static void render_processing_state(uint8_t *frame)
 {
     // Processing state should not react to sound intensity
     // Pass 0.0f for audio_power to disable all audio-reactive effects
     float audio_power = 0.0f;
 
     // Render voxel gradient (not mic responsive, no white fade, no audio reaction)
-    render_voxel_gradient_core(buffer_idx, SPHERE_RADIUS, audio_power, false, 0.0f);
+    render_voxel_gradient_core(frame, SPHERE_RADIUS, audio_power, false, 0.0f);
 
     // Add two white running rings
     float ring_speed = 0.3f; // radians per frame (increased from 0.1f for faster rotation)
@@ -666,13 +659,13 @@ static void render_processing_state(int buffer_idx)
         g_running_ring_angle2 += 2.0f * M_PI;
     }
 
-    render_running_ring(buffer_idx, g_running_ring_angle, g_running_ring_angle2);
+    render_running_ring(frame, g_running_ring_angle, g_running_ring_angle2);
 }
 
 /**
  * @brief Render RESPONDING state: voxel gradient without ring, mic responsive
  */
-static void render_responding_state(int buffer_idx)
+static void render_responding_state(uint8_t *frame)
 {
     // Get audio power
     float audio_power = 0.0f;
@@ -684,16 +677,16 @@ static void render_responding_state(int buffer_idx)
     }
 
     // Render voxel gradient (mic responsive, no white fade, no ring)
-    render_voxel_gradient_core(buffer_idx, SPHERE_RADIUS, audio_power, true, 0.0f);
+    render_voxel_gradient_core(frame, SPHERE_RADIUS, audio_power, true, 0.0f);
 
     // Add white hotspot that reacts to speech intensity
-    // render_white_hotspot(buffer_idx, audio_power);
+    // render_white_hotspot(frame, audio_power);
 }
 
 /**
  * @brief Render TRANSITION_TO_IDLE state: voxel gradient fading to white, zooming out
  */
-static void render_transition_to_idle_state(int buffer_idx)
+static void render_transition_to_idle_state(uint8_t *frame)
 {
     // Get audio power
     float audio_power = 0.0f;
@@ -733,18 +726,16 @@ static void render_transition_to_idle_state(int buffer_idx)
     g_current_radius = current_radius;
 
     // Render voxel gradient with white fade (not mic responsive during transition)
-    render_voxel_gradient_core(buffer_idx, current_radius, audio_power, false, white_fade_factor);
+    render_voxel_gradient_core(frame, current_radius, audio_power, false, white_fade_factor);
 }
 
 /**
  * @brief Render idle state: breathing white circle at center only
  */
-static void render_idle_state(int buffer_idx)
+static void render_idle_state(uint8_t *frame)
 {
     // Clear buffer (all black)
-    memset(g_render_buffers[buffer_idx].r, 0, sizeof(g_render_buffers[buffer_idx].r));
-    memset(g_render_buffers[buffer_idx].g, 0, sizeof(g_render_buffers[buffer_idx].g));
-    memset(g_render_buffers[buffer_idx].b, 0, sizeof(g_render_buffers[buffer_idx].b));
+    memset(frame, 0, MATRIX_WIDTH * MATRIX_HEIGHT * PIXEL_MATRIX_BPP);
 
     float center_x = SPHERE_CENTER_X;
     float center_y = SPHERE_CENTER_Y;
@@ -778,21 +769,20 @@ static void render_idle_state(int buffer_idx)
                     edge_falloff = 0.0f;
 
                 float final_brightness = brightness * edge_falloff;
-                g_render_buffers[buffer_idx].r[x][y] = (uint8_t)(255 * final_brightness);
-                g_render_buffers[buffer_idx].g[x][y] = (uint8_t)(255 * final_brightness);
-                g_render_buffers[buffer_idx].b[x][y] = (uint8_t)(255 * final_brightness);
+                uint8_t *pixel = FRAME_PIXEL(frame, x, y);
+                pixel[FRAME_R] = (uint8_t)(255 * final_brightness);
+                pixel[FRAME_G] = (uint8_t)(255 * final_brightness);
+                pixel[FRAME_B] = (uint8_t)(255 * final_brightness);
             }
             // Everything else stays black (already cleared above)
         }
     }
-
-    g_render_buffers[buffer_idx].ready = true;
 }
 
 /**
  * @brief Render START state: red circle that grows with audio RMS (5px to 32x32)
  */
-static void render_start_state(int buffer_idx)
+static void render_start_state(uint8_t *frame)
 {
     // Get audio power (RMS) for responsiveness
     float audio_power = 0.0f;
@@ -804,9 +794,7 @@ static void render_start_state(int buffer_idx)
     }
 
     // Clear buffer (all black)
-    memset(g_render_buffers[buffer_idx].r, 0, sizeof(g_render_buffers[buffer_idx].r));
-    memset(g_render_buffers[buffer_idx].g, 0, sizeof(g_render_buffers[buffer_idx].g));
-    memset(g_render_buffers[buffer_idx].b, 0, sizeof(g_render_buffers[buffer_idx].b));
+    memset(frame, 0, MATRIX_WIDTH * MATRIX_HEIGHT * PIXEL_MATRIX_BPP);
 
     float center_x = SPHERE_CENTER_X;
     float center_y = SPHERE_CENTER_Y;
@@ -890,9 +878,10 @@ static void render_start_state(int buffer_idx)
                 float final_brightness = brightness * edge_falloff;
 
                 // Red LED only
-                g_render_buffers[buffer_idx].r[x][y] = (uint8_t)(255 * final_brightness);
-                g_render_buffers[buffer_idx].g[x][y] = 0;
-                g_render_buffers[buffer_idx].b[x][y] = 0;
+                uint8_t *pixel = FRAME_PIXEL(frame, x, y);
+                pixel[FRAME_R] = (uint8_t)(255 * final_brightness);
+                pixel[FRAME_G] = 0;
+                pixel[FRAME_B] = 0;
             }
             // Everything else stays black
         }
@@ -900,14 +889,12 @@ static void render_start_state(int buffer_idx)
 
     // Update global radius for smooth transitions to next state
     g_current_radius = current_radius;
-
-    g_render_buffers[buffer_idx].ready = true;
 }
 
 /**
  * @brief Render red running ring at 32x32 1px circle
  */
-static void render_running_ring(int buffer_idx, float angle1, float angle2)
+static void render_running_ring(uint8_t *frame, float angle1, float angle2)
 {
     float center_x = SPHERE_CENTER_X;
     float center_y = SPHERE_CENTER_Y;
@@ -956,18 +943,13 @@ static void render_running_ring(int buffer_idx, float angle1, float angle2)
             // Render if brightness > 0
             if (brightness > 0.0f) {
                 // Overlay white rings on existing buffer (additive blending)
-                uint8_t existing_r = g_render_buffers[buffer_idx].r[x][y];
-                uint8_t existing_g = g_render_buffers[buffer_idx].g[x][y];
-                uint8_t existing_b = g_render_buffers[buffer_idx].b[x][y];
+                uint8_t *pixel = FRAME_PIXEL(frame, x, y);
 
                 // Add white rings with brightness (equal RGB for white)
                 uint8_t ring_brightness = (uint8_t)(255 * brightness);
-                g_render_buffers[buffer_idx].r[x][y] =
-                    (existing_r + ring_brightness > 255) ? 255 : (existing_r + ring_brightness);
-                g_render_buffers[buffer_idx].g[x][y] =
-                    (existing_g + ring_brightness > 255) ? 255 : (existing_g + ring_brightness);
-                g_render_buffers[buffer_idx].b[x][y] =
-                    (existing_b + ring_brightness > 255) ? 255 : (existing_b + ring_brightness);
+                for (int c = 0; c < PIXEL_MATRIX_BPP; c++) {
+                    pixel[c] = (pixel[c] + ring_brightness > 255) ? 255 : (pixel[c] + ring_brightness);
+                }
             }
         }
     }
@@ -1090,59 +1072,6 @@ static void button_ok_callback(char *name, TDL_BUTTON_TOUCH_EVENT_E event, void
     }
 }
 
-/**
- * @brief Fast display update - just copies pre-rendered RGB buffer to LEDs
- * This runs in a separate high-priority thread for smooth animation
- */
-static void display_sphere_fast(void)
-{
-    if (g_pixels_handle == NULL) {
-        return;
-    }
-
-    // Lock buffer mutex to safely swap buffers
-    if (g_buffer_mutex != NULL && tal_mutex_lock(g_buffer_mutex) == OPRT_OK) {
-        // Check if back buffer is ready, swap if so
-        if (g_render_buffers[g_back_buffer].ready) {
-            // Swap buffers
-            int temp = g_front_buffer;
-            g_front_buffer = g_back_buffer;
-            g_back_buffer = temp;
-            g_render_buffers[g_back_buffer].ready = false; // Mark as being rendered
-        }
-        tal_mutex_unlock(g_buffer_mutex);
-    }
-
-    // Clear all pixels
-    PIXEL_COLOR_T off_color = {0};
-    tdl_pixel_set_single_color(g_pixels_handle, 0, LED_PIXELS_TOTAL_NUM, &off_color);
-
-    // Fast display - just copy pre-calculated RGB values
-    for (int y = 0; y < MATRIX_HEIGHT; y++) {
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
-            uint8_t r = g_render_buffers[g_front_buffer].r[x][y];
-            uint8_t g_val = g_render_buffers[g_front_buffer].g[x][y];
-            uint8_t b = g_render_buffers[g_front_buffer].b[x][y];
-
-            // Apply brightness scaling
-            // Note: If LEDs show GRB order instead of RGB, swap channels here
-            // For now, keeping standard RGB mapping - if red shows as green, swap r and g_val
-            PIXEL_COLOR_T pixel_color = {.red = (uint32_t)(g_val * COLOR_RESOLUTION * BRIGHTNESS / 255),
-                                         .green = (uint32_t)(r * COLOR_RESOLUTION * BRIGHTNESS / 255),
-                                         .blue = (uint32_t)(b * COLOR_RESOLUTION * BRIGHTNESS / 255),
-                                         .warm = 0,
-                                         .cold = 0};
-
-            uint32_t led_index = board_pixel_matrix_coord_to_led_index((uint32_t)x, (uint32_t)y);
-            if (led_index < LED_PIXELS_TOTAL_NUM) {
-                tdl_pixel_set_single_color(g_pixels_handle, led_index, 1, &pixel_color);
-            }
-        }
-    }
-
-    tdl_pixel_dev_refresh(g_pixels_handle);
-}
-
 // /**
 //  * @brief Update rotation axes - smooth constant rotation (no randomness)
 //  */
@@ -1161,8 +1090,8 @@ static void display_sphere_fast(void)
 // }
 
 /**
- * @brief Sphere rendering task - SLOW calculations in separate thread
- * This thread does all the heavy 3D math and pre-calculates RGB values
+ * @brief Sphere rendering task - 3D math and drawing in a separate thread
+ * The matrix thread encodes and sends the presented frames to the LEDs
  */
 static void sphere_rendering_task(void *args)
 {
@@ -1230,37 +1159,19 @@ static void sphere_rendering_task(void *args)
         }
         g_last_update_time = current_time;
 
-        // Render 3D sphere to back buffer (SLOW - can take time)
-        // Only render if back buffer is not ready (not being displayed)
-        if (!g_render_buffers[g_back_buffer].ready) {
-            render_sphere_3d(g_back_buffer);
+        // Render 3D sphere into the frame being drawn, then hand it over for display.
+        // Present waits until the previous frame has been sent to the LEDs.
+        SYS_TIME_T frame_start = tal_system_get_millisecond();
+        uint8_t *frame = tdl_pixel_matrix_get_frame(g_matrix_handle);
+        if (frame != NULL) {
+            render_sphere_3d(frame);
+            tdl_pixel_matrix_present(g_matrix_handle);
         }
 
-        // Small sleep to yield CPU
-        tal_system_sleep(1);
-    }
-}
-
-/**
- * @brief Sphere display task - FAST updates in separate high-priority thread
- * This thread just copies pre-rendered buffers to LEDs for smooth animation
- */
-static void sphere_display_task(void *args)
-{
-    PR_NOTICE("Sphere display task started");
-
-    while (1) {
-        uint32_t frame_start = tal_time_get_posix();
-
-        // Fast display - just copy pre-calculated RGB buffer
-        display_sphere_fast();
-
-        // Maintain ~50 FPS for smooth animation
-        uint32_t frame_time = tal_time_get_posix() - frame_start;
-        uint32_t target_frame_time = 20; // ~50 FPS (20ms per frame)
-
-        if (frame_time < target_frame_time) {
-            tal_system_sleep(target_frame_time - frame_time);
+        // Maintain ~50 FPS and leave the rest of the frame time to audio processing
+        uint32_t frame_time = (uint32_t)(tal_system_get_millisecond() - frame_start);
+        if (frame_time < FRAME_TIME_MS) {
+            tal_system_sleep(FRAME_TIME_MS - frame_time);
         } else {
             tal_system_sleep(1); // Minimal sleep if frame took too long
         }
@@ -1456,14 +1367,6 @@ static void user_main(void)
     }
     PR_NOTICE("UV power mutex created");
 
-    // Create mutex for buffer swapping
-    rt = tal_mutex_create_init(&g_buffer_mutex);
-    if (OPRT_OK != rt) {
-        PR_ERR("Failed to create buffer mutex: %d", rt);
-        return;
-    }
-    PR_NOTICE("Buffer mutex created");
-
     // Create mutex for voice state machine
     rt = tal_mutex_create_init(&g_voice_state_mutex);
     if (OPRT_OK != rt) {
@@ -1472,16 +1375,13 @@ static void user_main(void)
     }
     PR_NOTICE("Voice state mutex created");
 
-    // Initialize double buffers
-    for (int i = 0; i < NUM_BUFFERS; i++) {
-        memset(g_render_buffers[i].r, 0, sizeof(g_render_buffers[i].r));
-        memset(g_render_buffers[i].g, 0, sizeof(g_render_buffers[i].g));
-        memset(g_render_buffers[i].b, 0, sizeof(g_render_buffers[i].b));
-        g_render_buffers[i].ready = false;
+    // Build the sphere point cloud
+    rt = sphere_model_init();
+    if (OPRT_OK != rt) {
+        PR_ERR("Sphere model initialization failed: %d", rt);
+        return;
     }
-    g_front_buffer = 0;
-    g_back_buffer = 1;
-    PR_NOTICE("Double buffers initialized");
+    PR_NOTICE("Sphere model initialized: %d points", SPHERE_POINT_NUM);
 
     // Wait a bit to ensure audio driver registration is complete
     tal_system_sleep(200);
@@ -1557,7 +1457,7 @@ static void user_main(void)
     }
     PR_NOTICE("Audio processing thread started");
 
-    // Start sphere rendering task (SLOW - does 3D calculations)
+    // Start sphere rendering task (does 3D calculations and presents frames)
     THREAD_CFG_T render_thrd_param = {.stackDepth = 4096, .priority = THREAD_PRIO_3, .thrdname = "sphere_render"};
     THREAD_HANDLE render_thrd = NULL;
     rt = tal_thread_create_and_start(&render_thrd, NULL, NULL, sphere_rendering_task, NULL, &render_thrd_param);
@@ -1567,16 +1467,6 @@ static void user_main(void)
     }
     PR_NOTICE("Sphere rendering thread started");
 
-    // Start sphere display task (FAST - high priority for smooth animation)
-    THREAD_CFG_T display_thrd_param = {.stackDepth = 4096, .priority = THREAD_PRIO_1, .thrdname = "sphere_display"};
-    THREAD_HANDLE display_thrd = NULL;
-    rt = tal_thread_create_and_start(&display_thrd, NULL, NULL, sphere_display_task, NULL, &display_thrd_param);
-    if (OPRT_OK != rt) {
-        PR_ERR("Failed to start sphere display thread: %d", rt);
-        return;
-    }
-    PR_NOTICE("Sphere display thread started (high priority)");
-
     PR_NOTICE("==========================================");
     PR_NOTICE("Sphere Effect Ready!");
     PR_NOTICE("==========================================");
@@ -128,8 +128,8 @@
 	/* Set the number of draw unit.
      * > 1 requires an operating system enabled in `LV_USE_OS`
      * > 1 means multiply threads will render the screen in parallel */
-#if defined(ENABLE_LVGL_OS_FREERTOS) && (ENABLE_LVGL_OS_FREERTOS == 1)
-    #define LV_DRAW_SW_DRAW_UNIT_CNT    1
+#if defined(ENABLE_LVGL_OS_FREERTOS) && (ENABLE_LVGL_OS_FREERTOS == 1) && defined(LVGL_DRAW_UNIT_CNT)
+    #define LV_DRAW_SW_DRAW_UNIT_CNT    LVGL_DRAW_UNIT_CNT
 #else
     #define LV_DRAW_SW_DRAW_UNIT_CNT    1
 #endif
@@ -227,8 +227,12 @@
  * Logging
  *-----------*/
 
-/*Enable the log module*/
+/*Enable the log module, the monitor log mode prints through it*/
+#if defined(ENABLE_LVGL_MONITOR_LOG) && (ENABLE_LVGL_MONITOR_LOG == 1)
+#define LV_USE_LOG 1
+#else
 #define LV_USE_LOG 0
+#endif
 #if LV_USE_LOG
 
     /*How important log should be added:
@@ -309,12 +313,21 @@
 /*Default cache size in bytes.
  *Used by image decoders such as `lv_lodepng` to keep the decoded image in the memory.
  *If size is not set to 0, the decoder will fail to decode when the cache is full.
- *If size is 0, the cache function is not enabled and the decoded mem will be released immediately after use.*/
+ *If size is 0, the cache function is not enabled and the decoded mem will be released immediately after use.
+ *Set from LVGL_IMAGE_CACHE_SIZE (KB), 0 by default.*/
+#if defined(LVGL_IMAGE_CACHE_SIZE)
+#define LV_CACHE_DEF_SIZE       (LVGL_IMAGE_CACHE_SIZE * 1024)
+#else
 #define LV_CACHE_DEF_SIZE       0
+#endif
 
 /*Default number of image header cache entries. The cache is used to store the headers of images
  *The main logic is like `LV_CACHE_DEF_SIZE` but for image headers.*/
+#if defined(LVGL_IMAGE_HEADER_CACHE_CNT)
+#define LV_IMAGE_HEADER_CACHE_DEF_CNT LVGL_IMAGE_HEADER_CACHE_CNT
+#else
 #define LV_IMAGE_HEADER_CACHE_DEF_CNT 0
+#endif
 
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
@@ -878,7 +891,11 @@
         #define LV_USE_PERF_MONITOR_POS LV_ALIGN_BOTTOM_RIGHT
 
         /*0: Displays performance data on the screen, 1: Prints performance data using log.*/
+        #if defined(ENABLE_LVGL_MONITOR_LOG) && (ENABLE_LVGL_MONITOR_LOG == 1)
+        #define LV_USE_PERF_MONITOR_LOG_MODE 1
+        #else
         #define LV_USE_PERF_MONITOR_LOG_MODE 0
+        #endif
     #endif
 
     /*1: Show the used memory and the memory fragmentation
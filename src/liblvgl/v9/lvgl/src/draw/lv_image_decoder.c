@@ -323,6 +323,9 @@ static lv_image_decoder_t * image_decoder_get_info(const void * src, lv_image_he
         search_key.src = src;
 
         lv_cache_entry_t * entry = lv_cache_acquire(img_header_cache_p, &search_key, NULL);
+        // Modified by TUYA Start
+        _lv_image_cache_count(true, entry != NULL);
+        // Modified by TUYA End
 
         if(entry) {
             lv_image_header_cache_data_t * cached_data = lv_cache_entry_get_data(entry);
@@ -456,6 +459,9 @@ static lv_result_t try_cache(lv_image_decoder_dsc_t * dsc)
     search_key.src = dsc->src;
 
     lv_cache_entry_t * entry = lv_cache_acquire(cache, &search_key, NULL);
+    // Modified by TUYA Start
+    _lv_image_cache_count(false, entry != NULL);
+    // Modified by TUYA End
 
     if(entry) {
         lv_image_cache_data_t * cached_data = lv_cache_entry_get_data(entry);
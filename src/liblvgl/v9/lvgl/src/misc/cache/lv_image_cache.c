@@ -9,6 +9,7 @@
 #include "../lv_assert.h"
 #include "lv_image_cache.h"
 #include "../../core/lv_global.h"
+#include "../../stdlib/lv_string.h"
 /*********************
  *      DEFINES
  *********************/
@@ -29,6 +30,13 @@
 /**********************
  *  STATIC VARIABLES
  **********************/
+// Modified by TUYA Start
+/*Plain counters: lookups from parallel draw units may race, which is fine for statistics*/
+static uint32_t cache_hit_cnt;
+static uint32_t cache_miss_cnt;
+static uint32_t header_cache_hit_cnt;
+static uint32_t header_cache_miss_cnt;
+// Modified by TUYA End
 
 /**********************
  *      MACROS
@@ -107,3 +115,46 @@ void lv_image_header_cache_resize(uint32_t new_size, bool evict_now)
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+// Modified by TUYA Start
+void lv_image_cache_get_stat(lv_image_cache_stat_t * stat)
+{
+    LV_ASSERT_NULL(stat);
+
+    lv_memzero(stat, sizeof(lv_image_cache_stat_t));
+    stat->hit = cache_hit_cnt;
+    stat->miss = cache_miss_cnt;
+    stat->header_hit = header_cache_hit_cnt;
+    stat->header_miss = header_cache_miss_cnt;
+
+#if LV_CACHE_DEF_SIZE > 0
+    stat->size = lv_cache_get_size(img_cache_p, NULL);
+    stat->max_size = lv_cache_get_max_size(img_cache_p, NULL);
+#endif
+
+#if LV_IMAGE_HEADER_CACHE_DEF_CNT > 0
+    stat->header_cnt = lv_cache_get_size(img_header_cache_p, NULL);
+    stat->header_max_cnt = lv_cache_get_max_size(img_header_cache_p, NULL);
+#endif
+}
+
+void lv_image_cache_reset_stat(void)
+{
+    cache_hit_cnt = 0;
+    cache_miss_cnt = 0;
+    header_cache_hit_cnt = 0;
+    header_cache_miss_cnt = 0;
+}
+
+void _lv_image_cache_count(bool is_header, bool is_hit)
+{
+    if(is_header) {
+        if(is_hit) header_cache_hit_cnt++;
+        else header_cache_miss_cnt++;
+    }
+    else {
+        if(is_hit) cache_hit_cnt++;
+        else cache_miss_cnt++;
+    }
+}
+// Modified by TUYA End
@@ -22,6 +22,18 @@ extern "C" {
 /**********************
  *      TYPEDEFS
  **********************/
+// Modified by TUYA Start
+typedef struct {
+    uint32_t hit;               /**< decoded image found in the cache*/
+    uint32_t miss;              /**< image had to be decoded*/
+    uint32_t header_hit;        /**< image header found in the cache*/
+    uint32_t header_miss;       /**< image header had to be read by a decoder*/
+    uint32_t size;              /**< bytes of decoded images in the cache*/
+    uint32_t max_size;          /**< byte budget of the decoded image cache*/
+    uint32_t header_cnt;        /**< image headers in the cache*/
+    uint32_t header_max_cnt;    /**< capacity of the image header cache*/
+} lv_image_cache_stat_t;
+// Modified by TUYA End
 
 /**********************
  * GLOBAL PROTOTYPES
@@ -54,6 +66,26 @@ void lv_image_header_cache_drop(const void * src);
  */
 void lv_image_header_cache_resize(uint32_t new_size, bool evict_now);
 
+// Modified by TUYA Start
+/**
+ * Get the image cache hit/miss counters and current usage.
+ * @param stat      filled with the statistics
+ */
+void lv_image_cache_get_stat(lv_image_cache_stat_t * stat);
+
+/**
+ * Reset the image cache hit/miss counters.
+ */
+void lv_image_cache_reset_stat(void);
+
+/**
+ * Count a lookup in the image (header) cache. Called by the image decoder.
+ * @param is_header true: image header cache, false: decoded image cache
+ * @param is_hit    true: the entry was found in the cache
+ */
+void _lv_image_cache_count(bool is_header, bool is_hit);
+// Modified by TUYA End
+
 /*************************
  *    GLOBAL VARIABLES
  *************************/
@@ -34,6 +34,9 @@
  *********************/
 
 #define ulMAX_COUNT 10U
+#ifndef LV_OS_SMP_CORE_CNT
+    #define LV_OS_SMP_CORE_CNT 2 /* cores of the SMP platforms (T5AI) the draw threads are spread over */
+#endif
 #ifndef pcTASK_NAME
     #define pcTASK_NAME "lvglDraw"
 #endif
@@ -85,6 +88,7 @@ lv_result_t lv_thread_init(lv_thread_t * pxThread, lv_thread_prio_t xSchedPriori
     OPERATE_RET ret = OPRT_OK;
 
 #if defined(ENABLE_SMP) && (ENABLE_SMP == 1)
+        // spread the draw threads over the cores, more draw units than cores share them
         static uint32_t coreID = 0;
         ret = tkl_thread_smp_create(&pxThread->xTaskHandle,
                                 coreID,
@@ -93,8 +97,7 @@ lv_result_t lv_thread_init(lv_thread_t * pxThread, lv_thread_prio_t xSchedPriori
                                 xSchedPriority,
                                 prvRunThread,
                                 (void *)pxThread);
-        if (coreID < (LV_DRAW_SW_DRAW_UNIT_CNT - 1))
-            coreID++;
+        coreID = (coreID + 1) % LV_OS_SMP_CORE_CNT;
 #else 
         ret = tkl_thread_create(&pxThread->xTaskHandle,
                                 pcTASK_NAME,
@@ -16,6 +16,7 @@
 #include "tkl_memory.h"
 #include "tal_api.h"
 #include "tdl_display_manage.h"
+#include "tdl_display_draw.h"
 
 #if defined(ENABLE_DMA2D) && (ENABLE_DMA2D == 1)
 #include "tkl_dma2d.h"
@@ -41,6 +42,14 @@
 
 #define USE_TAL_DMA2D 1
 
+#if defined(LVGL_MONO_THRESHOLD)
+#define DISP_MONO_THRESHOLD   LVGL_MONO_THRESHOLD
+#else
+#define DISP_MONO_THRESHOLD   0
+#endif
+
+#define DISP_MONO_RAW_MAX     0x8FFF // legacy mapping, set pixels whose raw rgb565 value is at most this
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -65,6 +74,10 @@ static lv_color_format_t __disp_get_lv_color_format(TUYA_DISPLAY_PIXEL_FMT_E pix
 
 static uint8_t __disp_get_pixels_size_bytes(TUYA_DISPLAY_PIXEL_FMT_E pixel_fmt);
 
+static void __disp_pack_init(lv_display_t *disp);
+
+static bool __disp_is_direct_mode_supported(TDL_DISP_DEV_INFO_T *info);
+
 #if defined(ENABLE_DMA2D) && (ENABLE_DMA2D == 1)
 static void __disp_dma2d_init(void);
 #endif
@@ -84,7 +97,19 @@ static TDL_DISP_FRAME_BUFF_T *sg_p_display_fb = NULL;
 
 static uint8_t *sg_rotate_buf = NULL;
 
+static TDL_DISP_RECT_T sg_disp_dirty_areas[TDL_DISP_AREA_MAX_NUM];
+static uint8_t sg_disp_dirty_num = 0;
+static bool sg_is_disp_dirty_full = false;
+
 static MUTEX_HANDLE sg_disp_flush_mutex = NULL;
+
+/* monochrome / I2 panels: rgb565 rows are packed by a bulk converter resolved at init */
+static TDL_DISP_ROW_CONVERT_CB sg_disp_pack_cb = NULL;
+static TDL_DISP_CONVERT_CFG_T sg_disp_pack_cfg;
+static uint8_t *sg_disp_pack_row = NULL;
+
+/* direct mode: LVGL renders straight into the two panel frame buffers */
+static bool sg_is_direct_mode = false;
 /**********************
  *      MACROS
  **********************/
@@ -115,6 +140,18 @@ void lv_port_disp_init(char *device)
     PR_NOTICE("lv_color_format:%d", color_format);
     lv_display_set_color_format(disp, color_format);
 
+    if (TUYA_PIXEL_FMT_MONOCHROME == sg_display_info.fmt || TUYA_PIXEL_FMT_I2 == sg_display_info.fmt) {
+        __disp_pack_init(disp);
+    }
+
+    if (sg_is_direct_mode) {
+        /* LVGL keeps the two buffers in sync itself by copying the areas it redrew */
+        lv_display_set_buffers(disp, sg_disp_fb_arr[0].fb->frame, sg_disp_fb_arr[1].fb->frame,\
+                               sg_disp_fb_arr[0].fb->len, LV_DISPLAY_RENDER_MODE_DIRECT);
+        PR_NOTICE("lvgl direct render mode");
+        return;
+    }
+
     /* Example 2
      * Two buffers for partial rendering
      * In flush_cb DMA or similar hardware should be used to update the display in the background.*/
@@ -458,6 +495,25 @@ static TDL_DISP_FRAME_BUFF_T *disp_get_free_frame_buff(void)
 
     return NULL;
 }
+static void disp_wait_frame_buff_free(TDL_DISP_FRAME_BUFF_T *fb)
+{
+    for (uint8_t i = 0; i < sg_disp_fb_num; i++) {
+        if(sg_disp_fb_arr[i].fb != fb) {
+            continue;
+        }
+
+        while (sg_disp_fb_arr[i].is_used) {
+            sg_is_wait_disp_free_fb = true;
+            // re-check after raising the flag, the buffer may have been released in between
+            if (0 == sg_disp_fb_arr[i].is_used) {
+                break;
+            }
+            tal_semaphore_wait(sg_disp_fb_free_sem, SEM_WAIT_FOREVER);
+        }
+        return;
+    }
+}
+
 static void disp_set_frame_buff_used(TDL_DISP_FRAME_BUFF_T *fb)
 {
     if(NULL == fb) {
@@ -501,6 +557,10 @@ static void disp_frame_buff_init(TUYA_DISPLAY_PIXEL_FMT_E fmt, uint16_t width, u
     sg_disp_fb_num = 1 + (has_vram ? 0 : 1);
 #endif
 
+    if (sg_is_direct_mode) {
+        sg_disp_fb_num = 2;
+    }
+
     for (uint8_t i = 0; i < sg_disp_fb_num; i++) {
         sg_disp_fb_arr[i].is_used = 0;
 
@@ -565,6 +625,8 @@ static void disp_init(char *device)
 
     tdl_disp_set_brightness(sg_tdl_disp_hdl, 100); // Set brightness to 100%
 
+    sg_is_direct_mode = __disp_is_direct_mode_supported(&sg_display_info);
+
     disp_frame_buff_init(sg_display_info.fmt, sg_display_info.width, \
                          sg_display_info.height, sg_display_info.has_vram);
 
@@ -620,6 +682,102 @@ static uint8_t __disp_get_pixels_size_bytes(TUYA_DISPLAY_PIXEL_FMT_E pixel_fmt)
     }
 }
 
+static bool __disp_is_direct_mode_supported(TDL_DISP_DEV_INFO_T *info)
+{
+#if defined(ENABLE_LVGL_DIRECT_MODE) && (ENABLE_LVGL_DIRECT_MODE == 1)
+    // LVGL must be able to draw the panel format as is: no packing, byte swap or rotation
+    if (TUYA_PIXEL_FMT_RGB565 != info->fmt && TUYA_PIXEL_FMT_RGB888 != info->fmt) {
+        PR_NOTICE("direct mode not supported for pixel fmt %d, use partial mode", info->fmt);
+        return false;
+    }
+
+    if (info->is_swap || TUYA_DISPLAY_ROTATION_0 != info->rotation) {
+        PR_NOTICE("direct mode needs an unswapped, unrotated panel, use partial mode");
+        return false;
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*
+ * Packs a rgb565 row with the mapping of the former per-pixel flush, so monochrome
+ * panels keep their look unless LVGL_MONO_THRESHOLD selects the luma converter.
+ */
+static void __disp_row_rgb565_to_mono_raw(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t row,
+                                          const TDL_DISP_CONVERT_CFG_T *cfg)
+{
+    const uint16_t *src16 = (const uint16_t *)src;
+    uint32_t x = 0, n = 0;
+    uint8_t byte = 0;
+
+    LV_UNUSED(row);
+    LV_UNUSED(cfg);
+
+    while (x < width) {
+        n = (width - x < 8) ? (width - x) : 8;
+        byte = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            byte |= (src16[x + i] <= DISP_MONO_RAW_MAX) << i;
+        }
+        *dst++ = byte;
+        x += n;
+    }
+}
+
+/*
+ * Widens invalidated areas to whole bytes of the packed frame buffer, so that flushes
+ * can be packed straight into it.
+ */
+static void __disp_pack_rounder_event_cb(lv_event_t *e)
+{
+    lv_display_t *disp = (lv_display_t *)lv_event_get_target(e);
+    lv_area_t *area = (lv_area_t *)lv_event_get_param(e);
+    int32_t align = (TUYA_PIXEL_FMT_MONOCHROME == sg_display_info.fmt) ? 8 : 4;
+    lv_display_rotation_t rotation = lv_display_get_rotation(disp);
+
+    // panel x runs along the logical y axis when the display is rotated by 90/270
+    if (LV_DISPLAY_ROTATION_90 == rotation || LV_DISPLAY_ROTATION_270 == rotation) {
+        area->y1 &= ~(align - 1);
+        area->y2 = LV_MIN(area->y2 | (align - 1), lv_display_get_vertical_resolution(disp) - 1);
+    } else {
+        area->x1 &= ~(align - 1);
+        area->x2 = LV_MIN(area->x2 | (align - 1), lv_display_get_horizontal_resolution(disp) - 1);
+    }
+}
+
+static void __disp_pack_init(lv_display_t *disp)
+{
+    uint32_t max_len = LV_MAX(sg_display_info.width, sg_display_info.height);
+
+    sg_disp_pack_cb = tdl_disp_get_row_convert(TUYA_PIXEL_FMT_RGB565, sg_display_info.fmt);
+    if (NULL == sg_disp_pack_cb) {
+        return;
+    }
+
+    // scratch row for areas that do not start or end on a byte boundary
+    sg_disp_pack_row = (uint8_t *)LV_MEM_CUSTOM_ALLOC((max_len * 2 + 7) / 8);
+    if (NULL == sg_disp_pack_row) {
+        PR_ERR("malloc failed");
+        sg_disp_pack_cb = NULL;
+        return;
+    }
+
+    memset(&sg_disp_pack_cfg, 0, sizeof(TDL_DISP_CONVERT_CFG_T));
+    sg_disp_pack_cfg.threshold = (DISP_MONO_THRESHOLD) ? DISP_MONO_THRESHOLD : 0x80;
+#if defined(ENABLE_LVGL_MONO_DITHER) && (ENABLE_LVGL_MONO_DITHER == 1)
+    sg_disp_pack_cfg.is_dither = true;
+#else
+    if (0 == DISP_MONO_THRESHOLD && TUYA_PIXEL_FMT_MONOCHROME == sg_display_info.fmt) {
+        sg_disp_pack_cb = __disp_row_rgb565_to_mono_raw;
+    }
+#endif
+
+    lv_display_add_event_cb(disp, __disp_pack_rounder_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+}
+
 static void __disp_mono_write_point(uint32_t x, uint32_t y, bool enable, TDL_DISP_FRAME_BUFF_T *fb)
 {
     if(NULL == fb || x >= fb->width || y >= fb->height) {
@@ -651,6 +809,57 @@ static void __disp_i2_write_point(uint32_t x, uint32_t y, uint8_t color, TDL_DIS
     fb->frame[write_byte_index] = cleared | ((color & 0x03) << write_bit);
 }
 
+/*
+ * Copies the low `bits` bits of a packed LSB-first row into dst starting at bit `bit_off`,
+ * leaving the surrounding bits untouched.
+ */
+static void __disp_packed_row_merge(uint8_t *dst, const uint8_t *src, uint32_t bit_off, uint32_t bits)
+{
+    uint32_t n = 0;
+    uint16_t val = 0, mask = 0;
+
+    dst += bit_off / 8;
+    bit_off %= 8;
+
+    for (uint32_t i = 0; i < bits; i += 8, dst++) {
+        n = (bits - i < 8) ? (bits - i) : 8;
+        mask = (uint16_t)(((1u << n) - 1) << bit_off);
+        val = (uint16_t)(src[i / 8] << bit_off) & mask;
+
+        dst[0] = (dst[0] & ~(mask & 0xFF)) | (val & 0xFF);
+        if (mask >> 8) {
+            dst[1] = (dst[1] & ~(mask >> 8)) | (val >> 8);
+        }
+    }
+}
+
+static void __disp_pack_framebuffer(const lv_area_t * area, uint8_t * px_map, TDL_DISP_FRAME_BUFF_T *fb)
+{
+    uint8_t bpp = (TUYA_PIXEL_FMT_MONOCHROME == fb->fmt) ? 1 : 2;
+    uint32_t fb_stride = fb->width * bpp / 8;
+    uint32_t width = lv_area_get_width(area);
+    uint32_t bit_off = area->x1 * bpp, bits = width * bpp;
+    bool is_aligned = (0 == (bit_off % 8) && 0 == (bits % 8));
+    uint8_t *dst_row = NULL;
+
+    if (area->x1 < 0 || area->y1 < 0 || area->x2 >= fb->width || area->y2 >= fb->height) {
+        PR_ERR("area (%d,%d)-(%d,%d) out of bounds", area->x1, area->y1, area->x2, area->y2);
+        return;
+    }
+
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        dst_row = fb->frame + y * fb_stride;
+        if (is_aligned) {
+            // whole bytes: pack straight into the frame buffer
+            sg_disp_pack_cb(px_map, dst_row + bit_off / 8, width, y, &sg_disp_pack_cfg);
+        } else {
+            sg_disp_pack_cb(px_map, sg_disp_pack_row, width, y, &sg_disp_pack_cfg);
+            __disp_packed_row_merge(dst_row, sg_disp_pack_row, bit_off, bits);
+        }
+        px_map += width * sizeof(uint16_t);
+    }
+}
+
 static void __disp_fill_display_framebuffer(const lv_area_t * area, uint8_t * px_map, \
                                             lv_color_format_t cf, TDL_DISP_FRAME_BUFF_T *fb)
 {
@@ -661,11 +870,13 @@ static void __disp_fill_display_framebuffer(const lv_area_t * area, uint8_t * px
         return;
     }
     
-    if(fb->fmt == TUYA_PIXEL_FMT_MONOCHROME) {
+    if(sg_disp_pack_cb && (fb->fmt == TUYA_PIXEL_FMT_MONOCHROME || fb->fmt == TUYA_PIXEL_FMT_I2)) {
+        __disp_pack_framebuffer(area, px_map, fb);
+    }else if(fb->fmt == TUYA_PIXEL_FMT_MONOCHROME) {
         for(y = area->y1 ; y <= area->y2; y++) {
             for(x = area->x1; x <= area->x2; x++) {
                 uint16_t *px_map_u16 = (uint16_t *)px_map;
-                bool enable = (px_map_u16[offset++]> 0x8FFF) ? false : true;
+                bool enable = (px_map_u16[offset++]> DISP_MONO_RAW_MAX) ? false : true;
                 __disp_mono_write_point(x, y, enable, fb);
             }
         }
@@ -717,12 +928,90 @@ static void __disp_framebuffer_memcpy(TDL_DISP_DEV_INFO_T *dev_info,\
 #endif
 }
 
+static void __disp_add_dirty_area(const lv_area_t *area)
+{
+    if (sg_is_disp_dirty_full) {
+        return;
+    }
+
+    if (sg_disp_dirty_num >= TDL_DISP_AREA_MAX_NUM) {
+        sg_disp_dirty_num = tdl_disp_area_coalesce(sg_disp_dirty_areas, sg_disp_dirty_num);
+        if (sg_disp_dirty_num >= TDL_DISP_AREA_MAX_NUM) {
+            sg_is_disp_dirty_full = true;
+            return;
+        }
+    }
+
+    sg_disp_dirty_areas[sg_disp_dirty_num].x0 = area->x1;
+    sg_disp_dirty_areas[sg_disp_dirty_num].y0 = area->y1;
+    sg_disp_dirty_areas[sg_disp_dirty_num].x1 = area->x2;
+    sg_disp_dirty_areas[sg_disp_dirty_num].y1 = area->y2;
+    sg_disp_dirty_num++;
+}
+
+static void __disp_flush_dirty_areas(TDL_DISP_FRAME_BUFF_T *fb)
+{
+    if (sg_is_disp_dirty_full || 0 == sg_disp_dirty_num) {
+        tdl_disp_dev_flush(sg_tdl_disp_hdl, fb);
+    } else {
+        tdl_disp_dev_flush_area(sg_tdl_disp_hdl, fb, sg_disp_dirty_areas, sg_disp_dirty_num);
+    }
+
+    sg_disp_dirty_num = 0;
+    sg_is_disp_dirty_full = false;
+}
+
+static TDL_DISP_FRAME_BUFF_T *__disp_direct_get_frame_buff(uint8_t *px_map, TDL_DISP_FRAME_BUFF_T **other)
+{
+    for (uint8_t i = 0; i < sg_disp_fb_num; i++) {
+        if (sg_disp_fb_arr[i].fb && sg_disp_fb_arr[i].fb->frame == px_map) {
+            *other = sg_disp_fb_arr[(i + 1) % sg_disp_fb_num].fb;
+            return sg_disp_fb_arr[i].fb;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * In direct mode px_map is the frame buffer LVGL has just drawn into. Once the last
+ * area is in, the buffer goes to the panel and LVGL moves on to the other one, which
+ * must no longer be scanned out or transferred.
+ */
+static void __disp_direct_mode_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    TDL_DISP_FRAME_BUFF_T *fb = NULL, *other_fb = NULL;
+
+    __disp_add_dirty_area(area);
+
+    if (false == lv_display_flush_is_last(disp)) {
+        return;
+    }
+
+    fb = __disp_direct_get_frame_buff(px_map, &other_fb);
+    if (NULL == fb) {
+        PR_ERR("direct mode buffer not found");
+        return;
+    }
+
+    disp_set_frame_buff_used(fb);
+    __disp_flush_dirty_areas(fb);
+
+    disp_wait_frame_buff_free(other_fb);
+}
+
 static void disp_deinit(void)
 {
     tdl_disp_dev_close(sg_tdl_disp_hdl);
     sg_tdl_disp_hdl = NULL;
 
     disp_frame_buff_deinit();
+
+    if (sg_disp_pack_row) {
+        LV_MEM_CUSTOM_FREE(sg_disp_pack_row);
+        sg_disp_pack_row = NULL;
+    }
+    sg_disp_pack_cb = NULL;
 }
 
 volatile bool disp_flush_enabled = true;
@@ -785,6 +1074,19 @@ static void disp_flush(lv_display_t * disp, const lv_area_t * area, uint8_t * px
         tal_mutex_lock(sg_disp_flush_mutex);
     }
 
+    if (sg_is_direct_mode) {
+        if (disp_flush_enabled) {
+            __disp_direct_mode_flush(disp, area, px_map);
+        }
+
+        lv_display_flush_ready(disp);
+
+        if (NULL != sg_disp_flush_mutex) {
+            tal_mutex_unlock(sg_disp_flush_mutex);
+        }
+        return;
+    }
+
     if (disp_flush_enabled) {
 
         lv_color_format_t cf = lv_display_get_color_format(disp);
@@ -819,10 +1121,12 @@ static void disp_flush(lv_display_t * disp, const lv_area_t * area, uint8_t * px
 
         __disp_fill_display_framebuffer(target_area, color_ptr, cf, sg_p_display_fb);
 
+        __disp_add_dirty_area(target_area);
+
         if (lv_display_flush_is_last(disp)) {
 
             disp_set_frame_buff_used(sg_p_display_fb);
-            tdl_disp_dev_flush(sg_tdl_disp_hdl, sg_p_display_fb);
+            __disp_flush_dirty_areas(sg_p_display_fb);
 
             TDL_DISP_FRAME_BUFF_T *next_fb = disp_get_free_frame_buff();
             if(next_fb &&  next_fb != sg_p_display_fb) {
@@ -11,12 +11,73 @@
 #include "tkl_mutex.h"
 #include "tkl_semaphore.h"
 
+#if (LV_CACHE_DEF_SIZE > 0) || (LV_IMAGE_HEADER_CACHE_DEF_CNT > 0)
+#include <stdlib.h>
+#include "tal_cli.h"
+#define LV_VENDOR_IMAGE_CACHE_CLI 1
+#endif
+
+#define LV_VENDOR_IDLE_WAIT_MAX 500 /* ms, keeps the gui watchdog fed while idle */
+
 static TKL_THREAD_HANDLE g_disp_thread_handle = NULL;
 static TKL_MUTEX_HANDLE g_disp_mutex = NULL;
 static TKL_SEM_HANDLE lvgl_sem = NULL;
+static TKL_SEM_HANDLE lvgl_wakeup_sem = NULL;
 static uint8_t lvgl_task_state = STATE_INIT;
 static bool lv_vendor_initialized = false;
 
+#if LV_USE_LOG
+extern void lv_port_log_print(lv_log_level_t level, const char *buf);
+#endif
+
+#if LV_VENDOR_IMAGE_CACHE_CLI
+static void cli_lv_cache(int argc, char *argv[])
+{
+    char buf[128];
+    lv_image_cache_stat_t stat;
+    uint32_t lookups = 0;
+
+    if (argc >= 2 && 0 == strcmp(argv[1], "reset")) {
+        lv_image_cache_reset_stat();
+        return;
+    }
+
+    if (argc >= 2 && 0 == strcmp(argv[1], "drop")) {
+        lv_vendor_disp_lock();
+        lv_image_cache_drop(NULL);
+        lv_vendor_disp_unlock();
+        return;
+    }
+
+    if (argc >= 3 && 0 == strcmp(argv[1], "size")) {
+        lv_vendor_disp_lock();
+        lv_image_cache_resize((uint32_t)atoi(argv[2]) * 1024, true);
+        lv_vendor_disp_unlock();
+        return;
+    }
+
+    lv_image_cache_get_stat(&stat);
+
+    lookups = stat.hit + stat.miss;
+    snprintf(buf, sizeof(buf), "image: %u/%u bytes, hit %u, miss %u (%u%%)",
+             (unsigned)stat.size, (unsigned)stat.max_size, (unsigned)stat.hit, (unsigned)stat.miss,
+             (unsigned)(lookups ? (stat.hit * 100ULL / lookups) : 0));
+    tal_cli_echo(buf);
+
+    lookups = stat.header_hit + stat.header_miss;
+    snprintf(buf, sizeof(buf), "header: %u/%u entries, hit %u, miss %u (%u%%)",
+             (unsigned)stat.header_cnt, (unsigned)stat.header_max_cnt, (unsigned)stat.header_hit,
+             (unsigned)stat.header_miss, (unsigned)(lookups ? (stat.header_hit * 100ULL / lookups) : 0));
+    tal_cli_echo(buf);
+}
+#endif
+
+#if LV_VENDOR_IMAGE_CACHE_CLI
+static const cli_cmd_t s_lv_cache_cli_cmd[] = {
+    {"lv_cache", "lvgl image cache: lv_cache [reset | drop | size <KB>]", cli_lv_cache},
+};
+#endif
+
 static uint32_t lv_tick_get_callback(void)
 {
     return (uint32_t)tkl_system_get_millisecond();
@@ -32,6 +93,24 @@ void lv_vendor_disp_unlock(void)
     tkl_mutex_unlock(g_disp_mutex);
 }
 
+/*
+ * Called by LVGL whenever a timer becomes ready earlier than the task loop expects:
+ * a timer is created, resumed or reset, or an area is invalidated.
+ */
+static void lv_vendor_timer_resume_cb(void *data)
+{
+    LV_UNUSED(data);
+
+    lv_vendor_wakeup();
+}
+
+void lv_vendor_wakeup(void)
+{
+    if (lvgl_wakeup_sem) {
+        tkl_semaphore_post(lvgl_wakeup_sem);
+    }
+}
+
 void lv_vendor_init(void *device)
 {
     if (lv_vendor_initialized) {
@@ -41,6 +120,10 @@ void lv_vendor_init(void *device)
 
     lv_init();
 
+#if LV_USE_LOG
+    lv_log_register_print_cb(lv_port_log_print);
+#endif
+
     lv_port_disp_init(device);
 
     lv_port_indev_init(device);
@@ -57,6 +140,17 @@ void lv_vendor_init(void *device)
         return;
     }
 
+    if (OPRT_OK != tkl_semaphore_create_init(&lvgl_wakeup_sem, 0, 1)) {
+        LV_LOG_ERROR("%s wakeup semaphore init failed\n", __func__);
+        return;
+    }
+
+    lv_timer_handler_set_resume_cb(lv_vendor_timer_resume_cb, NULL);
+
+#if LV_VENDOR_IMAGE_CACHE_CLI
+    tal_cli_cmd_register(s_lv_cache_cli_cmd, CNTSOF(s_lv_cache_cli_cmd));
+#endif
+
     lv_vendor_initialized = true;
 
     LV_LOG_INFO("%s complete\n", __func__);
@@ -77,15 +171,20 @@ static void lv_tast_entry(void *arg)
 
         #if CONFIG_LVGL_TASK_SLEEP_TIME_CUSTOMIZE
             sleep_time = CONFIG_LVGL_TASK_SLEEP_TIME;
+            tkl_system_sleep(sleep_time);
         #else
-            if (sleep_time > 500) {
-                sleep_time = 500;
-            } else if (sleep_time < 4) {
-                sleep_time = 4;
+            // sleep until the next timer is due, or until a new timer, an invalidation or
+            // lv_vendor_wakeup() makes work ready earlier; when idle only wake up to feed the watchdog.
+            // The indev read timers stay due every period, input is polled as before
+            if (sleep_time > LV_VENDOR_IDLE_WAIT_MAX) {
+                sleep_time = LV_VENDOR_IDLE_WAIT_MAX;
+            } else if (sleep_time < 1) {
+                sleep_time = 1;
             }
+
+            tkl_semaphore_wait(lvgl_wakeup_sem, sleep_time);
         #endif
 
-        tkl_system_sleep(sleep_time);
         // Modified by TUYA Start
         extern void tuya_app_gui_feed_watchdog(void);
         tuya_app_gui_feed_watchdog();
@@ -131,6 +230,8 @@ void lv_vendor_stop(void)
 
     lvgl_task_state = STATE_STOP;
 
+    lv_vendor_wakeup();
+
     tkl_semaphore_wait(lvgl_sem, TKL_SEM_WAIT_FOREVER);
 
     LV_LOG_INFO("%s complete\n", __func__);
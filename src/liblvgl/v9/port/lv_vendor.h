@@ -22,6 +22,13 @@ void lv_vendor_start(uint32_t lvgl_task_pri, uint32_t lvgl_stack_size);
 void lv_vendor_stop(void);
 void lv_vendor_disp_lock(void);
 void lv_vendor_disp_unlock(void);
+/*
+ * wake the LVGL task early, for work that LVGL does not see through its timers.
+ * Input is not such work: the touchpad and encoder are polled by the indev read
+ * timers, the task always wakes for them, so input latency is still bounded by
+ * the indev read period (LV_INDEV_REFR_PERIOD) and a wakeup alone does not read them.
+ */
+void lv_vendor_wakeup(void);
 void lv_vendor_set_backlight(uint8_t brightness);
 
 #ifdef __cplusplus
@@ -17,11 +17,19 @@
 #include "tkl_gpio.h"
 #include "tkl_system.h"
 
+#include "tdl_display_draw.h"
 #include "tdd_display_spi.h"
 
 /***********************************************************
 ************************macro define************************
 ***********************************************************/
+#if defined(DISPLAY_SPI_BOUNCE_BUF_SIZE)
+#define TDD_DISP_SPI_BOUNCE_BUF_SIZE DISPLAY_SPI_BOUNCE_BUF_SIZE
+#else
+#define TDD_DISP_SPI_BOUNCE_BUF_SIZE 4096
+#endif
+
+#define TDD_DISP_SPI_BOUNCE_BUF_NUM  2
 
 /***********************************************************
 ***********************typedef define***********************
@@ -32,6 +40,8 @@ typedef struct {
     QUEUE_HANDLE  queue;
     THREAD_HANDLE spi_task;
     bool          is_task_running;    
+    uint8_t      *bounce_buf[TDD_DISP_SPI_BOUNCE_BUF_NUM];
+    uint32_t      bounce_size;
 }TDD_DISP_SPI_SYNC_T;
 
 typedef enum {
@@ -42,10 +52,13 @@ typedef enum {
 typedef struct {
     TDD_SPI_FRAME_EVENT_E event;
     TDL_DISP_FRAME_BUFF_T *frame_buff;
+    uint8_t                area_num; // 0 means the whole frame buffer
+    TDL_DISP_RECT_T        areas[TDL_DISP_AREA_MAX_NUM];
 }TDD_DISP_SPI_MSG_T;
 
 typedef struct {
     DISP_SPI_BASE_CFG_T         cfg;
+    bool                        is_swap;  // rgb565 byte swap is done by this driver
     const uint8_t              *init_seq;
 }DISP_SPI_DEV_T;
 
@@ -144,6 +157,38 @@ static OPERATE_RET __disp_spi_init(TUYA_SPI_NUM_E port, uint32_t spi_clk)
     return rt;
 }
 
+static OPERATE_RET __disp_spi_bounce_buf_init(TUYA_SPI_NUM_E port)
+{
+    TDD_DISP_SPI_SYNC_T *spi_sync = &sg_disp_spi_sync[port];
+    uint32_t size = TDD_DISP_SPI_BOUNCE_BUF_SIZE;
+    uint32_t dma_max_size = tkl_spi_get_max_dma_data_length();
+
+    if (spi_sync->bounce_size || 0 == size) {
+        return OPRT_OK;
+    }
+
+    if (dma_max_size && size > dma_max_size) {
+        size = dma_max_size;
+    }
+    size &= ~0x03; // keep whole rgb565 pixel pairs in every chunk
+
+    for (uint8_t i = 0; i < TDD_DISP_SPI_BOUNCE_BUF_NUM; i++) {
+        spi_sync->bounce_buf[i] = tal_malloc(size);
+        if (NULL == spi_sync->bounce_buf[i]) {
+            PR_ERR("spi bounce buf malloc failed, size:%d", size);
+            for (uint8_t j = 0; j < i; j++) {
+                tal_free(spi_sync->bounce_buf[j]);
+                spi_sync->bounce_buf[j] = NULL;
+            }
+            return OPRT_MALLOC_FAILED;
+        }
+    }
+
+    spi_sync->bounce_size = size;
+
+    return OPRT_OK;
+}
+
 static OPERATE_RET __disp_spi_manage_init(TUYA_SPI_NUM_E port, DISP_SPI_DEV_T *disp_spi_dev)
 {
     OPERATE_RET rt = OPRT_OK;
@@ -164,6 +209,8 @@ static OPERATE_RET __disp_spi_manage_init(TUYA_SPI_NUM_E port, DISP_SPI_DEV_T *d
         tal_queue_create_init(&(sg_disp_spi_sync[port].queue), sizeof(TDD_DISP_SPI_MSG_T), 4);
     }
 
+    TUYA_CALL_ERR_RETURN(__disp_spi_bounce_buf_init(port));
+
     if(NULL == sg_disp_spi_sync[port].spi_task) {
         THREAD_CFG_T thread_cfg = {4096, THREAD_PRIO_1, "spi_task"};
         TUYA_CALL_ERR_RETURN(tal_thread_create_and_start(&(sg_disp_spi_sync[port].spi_task), 
@@ -219,6 +266,77 @@ static OPERATE_RET __disp_spi_send(TUYA_SPI_NUM_E port, uint8_t *data, uint32_t
     return rt;
 }
 
+/*
+ * Streams a (possibly strided) block of pixel data. The data is gathered into the
+ * bounce buffers, byte-swapped there if required, and each chunk is prepared while
+ * the previous one is still on the bus.
+ */
+static OPERATE_RET __disp_spi_send_pixels(TUYA_SPI_NUM_E port, uint8_t *data, uint32_t stride,\
+                                          uint32_t line_len, uint32_t lines, bool is_swap)
+{
+    OPERATE_RET rt = OPRT_OK;
+    TDD_DISP_SPI_SYNC_T *spi_sync = &sg_disp_spi_sync[port];
+    uint32_t line = 0, line_offset = 0, fill_len = 0, copy_len = 0;
+    uint8_t idx = 0;
+    bool is_in_flight = false;
+
+    // contiguous data without conversion can be sent straight from the source
+    if (0 == spi_sync->bounce_size || (false == is_swap && stride == line_len)) {
+        if (stride == line_len) {
+            return __disp_spi_send(port, data, line_len * lines);
+        }
+
+        for (line = 0; line < lines; line++) {
+            TUYA_CALL_ERR_RETURN(__disp_spi_send(port, data + line * stride, line_len));
+        }
+        return rt;
+    }
+
+    while (line < lines) {
+        fill_len = 0;
+        while (fill_len < spi_sync->bounce_size && line < lines) {
+            copy_len = line_len - line_offset;
+            if (copy_len > spi_sync->bounce_size - fill_len) {
+                copy_len = spi_sync->bounce_size - fill_len;
+            }
+
+            memcpy(spi_sync->bounce_buf[idx] + fill_len, data + line * stride + line_offset, copy_len);
+            fill_len    += copy_len;
+            line_offset += copy_len;
+            if (line_offset >= line_len) {
+                line_offset = 0;
+                line++;
+            }
+        }
+
+        if (is_swap) {
+            tdl_disp_dev_rgb565_swap((uint16_t *)spi_sync->bounce_buf[idx], fill_len / 2);
+        }
+
+        if (is_in_flight) {
+            rt = tal_semaphore_wait(spi_sync->tx_sem, 100);
+            if (rt != OPRT_OK) {
+                PR_ERR("spi tx wait timeout, port:%d\r\n", port);
+                return rt;
+            }
+        }
+
+        TUYA_CALL_ERR_RETURN(tkl_spi_send(port, spi_sync->bounce_buf[idx], fill_len));
+        is_in_flight = true;
+
+        idx = (idx + 1) % TDD_DISP_SPI_BOUNCE_BUF_NUM;
+    }
+
+    if (is_in_flight) {
+        rt = tal_semaphore_wait(spi_sync->tx_sem, 100);
+        if (rt != OPRT_OK) {
+            PR_ERR("spi tx wait timeout, port:%d\r\n", port);
+        }
+    }
+
+    return rt;
+}
+
 static void __disp_spi_set_window(DISP_SPI_BASE_CFG_T *p_cfg, uint16_t x_start, uint16_t y_start,\
                                   uint16_t x_end, uint16_t y_end)
 {
@@ -257,6 +375,24 @@ static void __disp_spi_set_window(DISP_SPI_BASE_CFG_T *p_cfg, uint16_t x_start,
     }
 }
 
+static void __disp_spi_send_rect_data(DISP_SPI_BASE_CFG_T *p_cfg, uint8_t *data, uint32_t stride,\
+                                      uint32_t line_len, uint32_t lines, bool is_swap)
+{
+    if(p_cfg->cs_pin < TUYA_GPIO_NUM_MAX) {
+        tkl_gpio_write(p_cfg->cs_pin, TUYA_GPIO_LEVEL_LOW);
+    }
+
+    if(p_cfg->dc_pin < TUYA_GPIO_NUM_MAX) {
+        tkl_gpio_write(p_cfg->dc_pin, TUYA_GPIO_LEVEL_HIGH);
+    }
+
+    __disp_spi_send_pixels(p_cfg->port, data, stride, line_len, lines, is_swap);
+
+    if(p_cfg->cs_pin < TUYA_GPIO_NUM_MAX) {
+        tkl_gpio_write(p_cfg->cs_pin, TUYA_GPIO_LEVEL_HIGH);
+    }
+}
+
 static void __disp_spi_display_frame(DISP_SPI_DEV_T *disp_spi_dev, TDL_DISP_FRAME_BUFF_T *frame_buff)
 {
     uint16_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;
@@ -274,7 +410,41 @@ static void __disp_spi_display_frame(DISP_SPI_DEV_T *disp_spi_dev, TDL_DISP_FRAM
     __disp_spi_set_window(&disp_spi_dev->cfg, x0, y0, x1, y1);
 
     tdd_disp_spi_send_cmd(&disp_spi_dev->cfg, disp_spi_dev->cfg.cmd_ramwr);
-    tdd_disp_spi_send_data(&disp_spi_dev->cfg, frame_buff->frame, frame_buff->len);
+    __disp_spi_send_rect_data(&disp_spi_dev->cfg, frame_buff->frame, frame_buff->len,\
+                              frame_buff->len, 1, disp_spi_dev->is_swap);
+}
+
+static void __disp_spi_display_area(DISP_SPI_DEV_T *disp_spi_dev, TDL_DISP_FRAME_BUFF_T *frame_buff,\
+                                    TDL_DISP_RECT_T *areas, uint8_t area_num)
+{
+    uint32_t per_pixel_byte = 0, stride = 0, offset = 0;
+
+    if(disp_spi_dev == NULL ||frame_buff == NULL) {
+        PR_ERR("param null\r\n");
+        return;
+    }
+
+    per_pixel_byte = tdl_disp_get_fmt_bpp(frame_buff->fmt) / 8;
+    if(0 == per_pixel_byte) {
+        // packed sub-byte formats cannot be windowed on pixel boundaries
+        __disp_spi_display_frame(disp_spi_dev, frame_buff);
+        return;
+    }
+
+    stride = frame_buff->width * per_pixel_byte;
+
+    for(uint8_t i = 0; i < area_num; i++) {
+        __disp_spi_set_window(&disp_spi_dev->cfg, areas[i].x0, areas[i].y0, areas[i].x1, areas[i].y1);
+
+        tdd_disp_spi_send_cmd(&disp_spi_dev->cfg, disp_spi_dev->cfg.cmd_ramwr);
+
+        offset = (areas[i].y0 - frame_buff->y_start) * stride + \
+                 (areas[i].x0 - frame_buff->x_start) * per_pixel_byte;
+
+        __disp_spi_send_rect_data(&disp_spi_dev->cfg, frame_buff->frame + offset, stride,\
+                                  (areas[i].x1 - areas[i].x0 + 1) * per_pixel_byte,\
+                                  areas[i].y1 - areas[i].y0 + 1, disp_spi_dev->is_swap);
+    }
 }
 
 static void __disp_spi_task(void *args)
@@ -300,7 +470,11 @@ static void __disp_spi_task(void *args)
 
         switch(msg.event) {
         case TDD_SPI_FRAME_REQUEST: {
-            __disp_spi_display_frame(disp_spi_dev, msg.frame_buff);
+            if(msg.area_num) {
+                __disp_spi_display_area(disp_spi_dev, msg.frame_buff, msg.areas, msg.area_num);
+            }else {
+                __disp_spi_display_frame(disp_spi_dev, msg.frame_buff);
+            }
             if (msg.frame_buff != NULL && msg.frame_buff->free_cb) {
                 msg.frame_buff->free_cb(msg.frame_buff);
             }
@@ -374,6 +548,33 @@ static OPERATE_RET __tdd_display_spi_flush(TDD_DISP_DEV_HANDLE_T device, TDL_DIS
     return rt;
 }
 
+static OPERATE_RET __tdd_display_spi_flush_area(TDD_DISP_DEV_HANDLE_T device, TDL_DISP_FRAME_BUFF_T *frame_buff,\
+                                                TDL_DISP_RECT_T *areas, uint8_t area_num)
+{
+    OPERATE_RET rt = OPRT_OK;
+    DISP_SPI_DEV_T *disp_spi_dev = NULL;
+    TUYA_SPI_NUM_E port = 0;
+    TDD_DISP_SPI_MSG_T msg;
+
+    if (NULL == device || NULL == frame_buff || NULL == areas ||\
+        0 == area_num || area_num > TDL_DISP_AREA_MAX_NUM) {
+        return OPRT_INVALID_PARM;
+    }
+
+    disp_spi_dev = (DISP_SPI_DEV_T *)device;
+    port = disp_spi_dev->cfg.port;
+
+    memset(&msg, 0x00, sizeof(TDD_DISP_SPI_MSG_T));
+    msg.event      = TDD_SPI_FRAME_REQUEST;
+    msg.frame_buff = frame_buff;
+    msg.area_num   = area_num;
+    memcpy(msg.areas, areas, area_num * sizeof(TDL_DISP_RECT_T));
+
+    TUYA_CALL_ERR_RETURN(tal_queue_post(sg_disp_spi_sync[port].queue, &msg, SEM_WAIT_FOREVER));
+
+    return rt;
+}
+
 static OPERATE_RET __tdd_display_spi_close(TDD_DISP_DEV_HANDLE_T device)
 {
     DISP_SPI_DEV_T *disp_spi_dev = NULL;
@@ -601,22 +802,27 @@ OPERATE_RET tdd_disp_spi_device_register(char *name, TDD_DISP_SPI_CFG_T *spi)
     memcpy(&disp_spi_dev->cfg, &spi->cfg, sizeof(DISP_SPI_BASE_CFG_T));
 
     disp_spi_dev->init_seq       = spi->init_seq;
+#if (TDD_DISP_SPI_BOUNCE_BUF_SIZE > 0)
+    // the swap is folded into the bounce buffer copy, callers keep native byte order
+    disp_spi_dev->is_swap        = (spi->is_swap && TUYA_PIXEL_FMT_RGB565 == spi->cfg.pixel_fmt);
+#endif
 
     disp_spi_dev_info.type     = TUYA_DISPLAY_SPI;
     disp_spi_dev_info.width    = spi->cfg.width;
     disp_spi_dev_info.height   = spi->cfg.height;
     disp_spi_dev_info.fmt      = spi->cfg.pixel_fmt;
     disp_spi_dev_info.rotation = spi->rotation;
-    disp_spi_dev_info.is_swap  = spi->is_swap;
+    disp_spi_dev_info.is_swap  = (disp_spi_dev->is_swap) ? false : spi->is_swap;
     disp_spi_dev_info.has_vram = true;
 
     memcpy(&disp_spi_dev_info.bl, &spi->bl, sizeof(TUYA_DISPLAY_BL_CTRL_T));
     memcpy(&disp_spi_dev_info.power, &spi->power, sizeof(TUYA_DISPLAY_IO_CTRL_T));
 
     TDD_DISP_INTFS_T disp_spi_intfs = {
-        .open  = __tdd_display_spi_open,
-        .flush = __tdd_display_spi_flush,
-        .close = __tdd_display_spi_close,
+        .open       = __tdd_display_spi_open,
+        .flush      = __tdd_display_spi_flush,
+        .flush_area = __tdd_display_spi_flush_area,
+        .close      = __tdd_display_spi_close,
     };
 
     TUYA_CALL_ERR_RETURN(tdl_disp_device_register(name, (TDD_DISP_DEV_HANDLE_T)disp_spi_dev,\
@@ -0,0 +1,166 @@
+/**
+ * @file tdl_display_compose.h
+ * @brief Camera preview and vector overlay compositor for display frame buffers.
+ *
+ * The compositor draws a scaled camera preview and simple vector overlays (lines,
+ * filled circles, pose skeletons) straight into a display frame buffer, tracks the
+ * areas it touched, and flushes only those areas to the panel. It is meant for live
+ * previews that must run at camera rate without a full GUI redraw.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __TDL_DISPLAY_COMPOSE_H__
+#define __TDL_DISPLAY_COMPOSE_H__
+
+#include "tuya_cloud_types.h"
+#include "tdl_display_manage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+// COCO keypoint layout, as produced by MoveNet / PoseNet
+#define TDL_DISP_POSE_KEYPOINT_NUM 17
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    int16_t x;      // display coordinate
+    int16_t y;      // display coordinate
+    uint8_t score;  // confidence (0-255)
+} TDL_DISP_POSE_KEYPOINT_T;
+
+typedef struct {
+    TDL_DISP_FRAME_BUFF_T *fb;
+    bool                   is_swap;        // rgb565 frame buffer is byte swapped
+    bool                   is_dirty_full;
+    uint8_t                dirty_num;
+    TDL_DISP_RECT_T        dirty[TDL_DISP_AREA_MAX_NUM];
+    uint8_t               *row_buf;        // scratch row for scaled camera blits
+    uint32_t               row_buf_size;
+} TDL_DISP_COMPOSE_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+/**
+ * @brief Initializes a compositor.
+ *
+ * @param comp Pointer to the compositor.
+ * @param is_swap Whether RGB565 colors are written byte swapped (see TDL_DISP_DEV_INFO_T).
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET tdl_disp_compose_init(TDL_DISP_COMPOSE_T *comp, bool is_swap);
+
+/**
+ * @brief Releases the resources held by a compositor.
+ *
+ * @param comp Pointer to the compositor.
+ */
+void tdl_disp_compose_deinit(TDL_DISP_COMPOSE_T *comp);
+
+/**
+ * @brief Starts composing a new frame into the given frame buffer.
+ *
+ * Clears the dirty areas recorded for the previous frame.
+ *
+ * @param comp Pointer to the compositor.
+ * @param fb Target frame buffer (RGB565, RGB888, MONOCHROME or I2).
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET tdl_disp_compose_begin(TDL_DISP_COMPOSE_T *comp, TDL_DISP_FRAME_BUFF_T *fb);
+
+/**
+ * @brief Blits a YUV422 camera frame into a rectangle of the frame buffer.
+ *
+ * The image is scaled with nearest neighbour sampling. Supported for RGB565 and
+ * MONOCHROME frame buffers; monochrome destinations must start on a multiple of 8.
+ *
+ * @param comp Pointer to the compositor.
+ * @param yuv Camera frame (Y U Y V, or U Y V Y when is_uyvy is set).
+ * @param src_width Camera frame width, must be even.
+ * @param src_height Camera frame height.
+ * @param is_uyvy Whether the camera frame is U Y V Y.
+ * @param dst Destination rectangle, or NULL for the whole frame buffer.
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET tdl_disp_compose_blit_yuv422(TDL_DISP_COMPOSE_T *comp, const uint8_t *yuv,\
+                                         uint16_t src_width, uint16_t src_height,\
+                                         bool is_uyvy, TDL_DISP_RECT_T *dst);
+
+/**
+ * @brief Draws a line. Parts outside the frame buffer are clipped.
+ *
+ * @param comp Pointer to the compositor.
+ * @param x0 Start X coordinate.
+ * @param y0 Start Y coordinate.
+ * @param x1 End X coordinate.
+ * @param y1 End Y coordinate.
+ * @param thickness Line thickness in pixels.
+ * @param color Color value in the frame buffer format.
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET tdl_disp_compose_line(TDL_DISP_COMPOSE_T *comp, int32_t x0, int32_t y0,\
+                                  int32_t x1, int32_t y1, uint8_t thickness, uint32_t color);
+
+/**
+ * @brief Draws a filled circle. Parts outside the frame buffer are clipped.
+ *
+ * @param comp Pointer to the compositor.
+ * @param cx Center X coordinate.
+ * @param cy Center Y coordinate.
+ * @param radius Radius in pixels.
+ * @param color Color value in the frame buffer format.
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET tdl_disp_compose_circle_fill(TDL_DISP_COMPOSE_T *comp, int32_t cx, int32_t cy,\
+                                         uint16_t radius, uint32_t color);
+
+/**
+ * @brief Draws a 17-keypoint pose skeleton.
+ *
+ * Edges are drawn when both keypoints reach min_score, keypoints when they do.
+ *
+ * @param comp Pointer to the compositor.
+ * @param kpts Keypoints in COCO order (TDL_DISP_POSE_KEYPOINT_NUM entries).
+ * @param min_score Minimum keypoint confidence.
+ * @param edge_color Color of the skeleton edges.
+ * @param point_color Color of the keypoints.
+ * @param thickness Edge thickness in pixels.
+ * @param radius Keypoint radius in pixels.
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET tdl_disp_compose_skeleton(TDL_DISP_COMPOSE_T *comp, const TDL_DISP_POSE_KEYPOINT_T *kpts,\
+                                      uint8_t min_score, uint32_t edge_color, uint32_t point_color,\
+                                      uint8_t thickness, uint16_t radius);
+
+/**
+ * @brief Marks an area as changed, e.g. after drawing into the frame buffer directly.
+ *
+ * @param comp Pointer to the compositor.
+ * @param area Changed area (inclusive coordinates), or NULL for the whole frame buffer.
+ */
+void tdl_disp_compose_mark_dirty(TDL_DISP_COMPOSE_T *comp, TDL_DISP_RECT_T *area);
+
+/**
+ * @brief Sends the changed areas of the frame buffer to the display.
+ *
+ * Falls back to a full flush if the driver has no partial update support.
+ *
+ * @param comp Pointer to the compositor.
+ * @param disp_hdl Handle to the display device.
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET tdl_disp_compose_flush(TDL_DISP_COMPOSE_T *comp, TDL_DISP_HANDLE_T disp_hdl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TDL_DISPLAY_COMPOSE_H__ */
@@ -22,16 +22,28 @@ extern "C" {
 /***********************************************************
 ************************macro define************************
 ***********************************************************/
-typedef struct {
-    uint16_t x0;
-    uint16_t y0;
-    uint16_t x1;
-    uint16_t y1;
-} TDL_DISP_RECT_T;
 
 /***********************************************************
 ***********************typedef define***********************
 ***********************************************************/
+typedef struct {
+    uint8_t threshold;  // luma (0-255) below which a monochrome pixel is set
+    bool    is_dither;  // 4x4 ordered dither for monochrome/I2 output
+    bool    is_swap;    // rgb565 data on the rgb565 side of the conversion is byte swapped
+    bool    is_uyvy;    // yuv422 source is U Y V Y instead of Y U Y V
+} TDL_DISP_CONVERT_CFG_T;
+
+/**
+ * @brief Converts one row of pixels.
+ *
+ * @param src Source row.
+ * @param dst Destination row. Packed formats start at bit 0 of the first byte.
+ * @param width Number of pixels in the row.
+ * @param row Row index, used to select the dither pattern.
+ * @param cfg Conversion parameters.
+ */
+typedef void (*TDL_DISP_ROW_CONVERT_CB)(const uint8_t *src, uint8_t *dst, uint32_t width,\
+                                        uint32_t row, const TDL_DISP_CONVERT_CFG_T *cfg);
 
 
 /***********************************************************
@@ -114,6 +126,26 @@ uint32_t tdl_disp_convert_color_fmt(uint32_t color, TUYA_DISPLAY_PIXEL_FMT_E src
  */
 uint32_t tdl_disp_convert_rgb565_to_color(uint16_t rgb565, TUYA_DISPLAY_PIXEL_FMT_E fmt, uint32_t threshold);
 
+/**
+ * @brief Looks up the bulk row converter between two pixel formats.
+ *
+ * Resolve the converter once (e.g. when the display is opened) and call it for every row.
+ * Monochrome and I2 outputs set higher values for darker pixels, matching the panel drivers.
+ *
+ * @param src_fmt Source pixel format.
+ * @param dst_fmt Destination pixel format.
+ * @return The row converter, or NULL if the conversion is not supported.
+ */
+TDL_DISP_ROW_CONVERT_CB tdl_disp_get_row_convert(TUYA_DISPLAY_PIXEL_FMT_E src_fmt, TUYA_DISPLAY_PIXEL_FMT_E dst_fmt);
+
+/**
+ * @brief Looks up the bulk row converter from camera YUV422 to a display pixel format.
+ *
+ * @param dst_fmt Destination pixel format (RGB565 or MONOCHROME).
+ * @return The row converter, or NULL if the conversion is not supported.
+ */
+TDL_DISP_ROW_CONVERT_CB tdl_disp_get_yuv422_row_convert(TUYA_DISPLAY_PIXEL_FMT_E dst_fmt);
+
 #ifdef __cplusplus
 }
 #endif
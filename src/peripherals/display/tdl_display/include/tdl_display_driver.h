@@ -73,6 +73,8 @@ typedef struct {
 typedef struct {
     OPERATE_RET (*open)(TDD_DISP_DEV_HANDLE_T device);
     OPERATE_RET (*flush)(TDD_DISP_DEV_HANDLE_T device, TDL_DISP_FRAME_BUFF_T *frame_buff);
+    OPERATE_RET (*flush_area)(TDD_DISP_DEV_HANDLE_T device, TDL_DISP_FRAME_BUFF_T *frame_buff,\
+                              TDL_DISP_RECT_T *areas, uint8_t area_num); // optional, NULL if no window support
     OPERATE_RET (*close)(TDD_DISP_DEV_HANDLE_T device);
 } TDD_DISP_INTFS_T;
 
@@ -23,6 +23,7 @@ extern "C" {
 /***********************************************************
 ************************macro define************************
 ***********************************************************/
+#define TDL_DISP_AREA_MAX_NUM 8
 
 /***********************************************************
 ***********************typedef define***********************
@@ -59,6 +60,13 @@ struct TDL_DISP_FRAME_BUFF_T {
     uint8_t *frame;
 };
 
+typedef struct {
+    uint16_t x0;
+    uint16_t y0;
+    uint16_t x1;
+    uint16_t y1;
+} TDL_DISP_RECT_T;
+
 typedef struct {
     TUYA_DISPLAY_TYPE_E      type;
     TUYA_DISPLAY_ROTATION_E  rotation;
@@ -158,6 +166,36 @@ void tdl_disp_free_frame_buff(TDL_DISP_FRAME_BUFF_T *frame_buff);
  */
 OPERATE_RET tdl_disp_dev_flush(TDL_DISP_HANDLE_T disp_hdl, TDL_DISP_FRAME_BUFF_T *frame_buff);
 
+/**
+ * @brief Flushes only the dirty areas of a frame buffer to the display device.
+ *
+ * The areas are given in display coordinates (inclusive) and must lie within the frame
+ * buffer. Overlapping or adjacent areas are coalesced before being handed to the driver.
+ * Drivers that cannot program a window fall back to a full frame flush.
+ *
+ * @param disp_hdl Handle to the display device.
+ * @param frame_buff Pointer to the frame buffer containing pixel data to be displayed.
+ * @param areas Array of dirty areas, modified in place by the coalescing step.
+ * @param area_num Number of areas in the array (at most TDL_DISP_AREA_MAX_NUM).
+ *
+ * @return Returns OPRT_OK on success, or an appropriate error code if flushing fails.
+ */
+OPERATE_RET tdl_disp_dev_flush_area(TDL_DISP_HANDLE_T disp_hdl, TDL_DISP_FRAME_BUFF_T *frame_buff,\
+                                    TDL_DISP_RECT_T *areas, uint8_t area_num);
+
+/**
+ * @brief Merges overlapping, adjacent or cheaply combinable areas in place.
+ *
+ * Two areas are merged into their bounding box when they intersect, touch, or when the
+ * bounding box is no larger than the sum of both areas.
+ *
+ * @param areas Array of areas (inclusive coordinates).
+ * @param area_num Number of areas in the array.
+ *
+ * @return The number of areas remaining at the front of the array.
+ */
+uint8_t tdl_disp_area_coalesce(TDL_DISP_RECT_T *areas, uint8_t area_num);
+
 /**
  * @brief Closes and deinitializes a display device.
  *
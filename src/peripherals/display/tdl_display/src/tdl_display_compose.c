@@ -0,0 +1,616 @@
+/**
+ * @file tdl_display_compose.c
+ * @brief Camera preview and vector overlay compositor implementation.
+ *
+ * This file implements scaled YUV422 camera blits, Bresenham lines, filled circles
+ * and pose skeletons on top of the display frame buffer, together with dirty-area
+ * tracking so that only the changed parts of the frame are sent to the panel.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+#include "tal_api.h"
+
+#include "tdl_display_draw.h"
+#include "tdl_display_compose.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define COMPOSE_MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define COMPOSE_MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+#define COMPOSE_MONO_THRESHOLD 0x80
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    uint8_t a;
+    uint8_t b;
+} TDL_DISP_POSE_EDGE_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const TDL_DISP_POSE_EDGE_T sg_pose_edges[] = {
+    {0, 1},   {0, 2},   {1, 3},   {2, 4},    // face
+    {0, 5},   {0, 6},   {5, 6},              // neck and shoulders
+    {5, 7},   {7, 9},   {6, 8},   {8, 10},   // arms
+    {5, 11},  {6, 12},  {11, 12},            // torso
+    {11, 13}, {13, 15}, {12, 14}, {14, 16},  // legs
+};
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static bool __compose_is_ready(TDL_DISP_COMPOSE_T *comp)
+{
+    if (NULL == comp || NULL == comp->fb || NULL == comp->fb->frame || \
+        0 == comp->fb->width || 0 == comp->fb->height) {
+        return false;
+    }
+
+    return true;
+}
+
+static void __compose_add_dirty(TDL_DISP_COMPOSE_T *comp, int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    TDL_DISP_FRAME_BUFF_T *fb = comp->fb;
+    TDL_DISP_RECT_T *rect = NULL;
+
+    if (comp->is_dirty_full) {
+        return;
+    }
+
+    x0 = COMPOSE_MAX(x0, fb->x_start);
+    y0 = COMPOSE_MAX(y0, fb->y_start);
+    x1 = COMPOSE_MIN(x1, fb->x_start + fb->width - 1);
+    y1 = COMPOSE_MIN(y1, fb->y_start + fb->height - 1);
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+
+    if (comp->dirty_num >= TDL_DISP_AREA_MAX_NUM) {
+        comp->dirty_num = tdl_disp_area_coalesce(comp->dirty, comp->dirty_num);
+    }
+
+    if (comp->dirty_num >= TDL_DISP_AREA_MAX_NUM) {
+        // still no room: fold the new area into the one it grows the least
+        uint8_t best = 0;
+        uint32_t best_cost = UINT32_MAX, cost = 0;
+        for (uint8_t i = 0; i < comp->dirty_num; i++) {
+            rect = &comp->dirty[i];
+            cost = (uint32_t)(COMPOSE_MAX(x1, rect->x1) - COMPOSE_MIN(x0, rect->x0) + 1) * \
+                   (uint32_t)(COMPOSE_MAX(y1, rect->y1) - COMPOSE_MIN(y0, rect->y0) + 1) - \
+                   (uint32_t)(rect->x1 - rect->x0 + 1) * (rect->y1 - rect->y0 + 1);
+            if (cost < best_cost) {
+                best_cost = cost;
+                best = i;
+            }
+        }
+        rect = &comp->dirty[best];
+        rect->x0 = COMPOSE_MIN(x0, rect->x0);
+        rect->y0 = COMPOSE_MIN(y0, rect->y0);
+        rect->x1 = COMPOSE_MAX(x1, rect->x1);
+        rect->y1 = COMPOSE_MAX(y1, rect->y1);
+        return;
+    }
+
+    rect = &comp->dirty[comp->dirty_num++];
+    rect->x0 = (uint16_t)x0;
+    rect->y0 = (uint16_t)y0;
+    rect->x1 = (uint16_t)x1;
+    rect->y1 = (uint16_t)y1;
+}
+
+/*
+ * Writes a horizontal span. Coordinates are local to the frame buffer and
+ * already clipped.
+ */
+static void __compose_span(TDL_DISP_COMPOSE_T *comp, uint32_t x0, uint32_t x1, uint32_t y, uint32_t color)
+{
+    TDL_DISP_FRAME_BUFF_T *fb = comp->fb;
+    uint32_t x = 0;
+
+    switch (fb->fmt) {
+        case TUYA_PIXEL_FMT_RGB565: {
+            uint16_t *p_buf16 = (uint16_t *)fb->frame + y * fb->width;
+            uint16_t color_16 = (uint16_t)(color & 0xFFFF);
+            if (comp->is_swap) {
+                color_16 = WORD_SWAP(color_16);
+            }
+            for (x = x0; x <= x1; x++) {
+                p_buf16[x] = color_16;
+            }
+        }
+        break;
+        case TUYA_PIXEL_FMT_RGB888: {
+            uint8_t *p_buf = fb->frame + (y * fb->width + x0) * 3;
+            for (x = x0; x <= x1; x++) {
+                *p_buf++ =  color & 0xFF;         // B
+                *p_buf++ = (color >> 8) & 0xFF;   // G
+                *p_buf++ = (color >> 16) & 0xFF;  // R
+            }
+        }
+        break;
+        case TUYA_PIXEL_FMT_MONOCHROME: {
+            uint8_t *p_row = fb->frame + y * (fb->width / 8);
+            bool enable = (color) ? false : true;
+            for (x = x0; x <= x1; x++) {
+                if (enable) {
+                    p_row[x / 8] |= (1 << (x % 8));
+                } else {
+                    p_row[x / 8] &= ~(1 << (x % 8));
+                }
+            }
+        }
+        break;
+        case TUYA_PIXEL_FMT_I2: {
+            uint8_t *p_row = fb->frame + y * (fb->width / 4);
+            uint8_t shift = 0;
+            for (x = x0; x <= x1; x++) {
+                shift = (x % 4) * 2;
+                p_row[x / 4] = (p_row[x / 4] & ~(0x03 << shift)) | ((color & 0x03) << shift);
+            }
+        }
+        break;
+        default:
+        break;
+    }
+}
+
+/*
+ * Fills a rectangle given in display coordinates, clipping it to the frame buffer.
+ * Does not record a dirty area.
+ */
+static void __compose_fill(TDL_DISP_COMPOSE_T *comp, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
+{
+    TDL_DISP_FRAME_BUFF_T *fb = comp->fb;
+
+    x0 = COMPOSE_MAX(x0 - fb->x_start, 0);
+    y0 = COMPOSE_MAX(y0 - fb->y_start, 0);
+    x1 = COMPOSE_MIN(x1 - fb->x_start, (int32_t)fb->width - 1);
+    y1 = COMPOSE_MIN(y1 - fb->y_start, (int32_t)fb->height - 1);
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+
+    for (int32_t y = y0; y <= y1; y++) {
+        __compose_span(comp, x0, x1, y, color);
+    }
+}
+
+static bool __compose_is_fmt_supported(TUYA_DISPLAY_PIXEL_FMT_E fmt)
+{
+    switch (fmt) {
+        case TUYA_PIXEL_FMT_RGB565:
+        case TUYA_PIXEL_FMT_RGB888:
+        case TUYA_PIXEL_FMT_MONOCHROME:
+        case TUYA_PIXEL_FMT_I2:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Initializes a compositor.
+ *
+ * @param comp Pointer to the compositor.
+ * @param is_swap Whether RGB565 colors are written byte swapped (see TDL_DISP_DEV_INFO_T).
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET tdl_disp_compose_init(TDL_DISP_COMPOSE_T *comp, bool is_swap)
+{
+    if (NULL == comp) {
+        return OPRT_INVALID_PARM;
+    }
+
+    memset(comp, 0, sizeof(TDL_DISP_COMPOSE_T));
+    comp->is_swap = is_swap;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Releases the resources held by a compositor.
+ *
+ * @param comp Pointer to the compositor.
+ */
+void tdl_disp_compose_deinit(TDL_DISP_COMPOSE_T *comp)
+{
+    if (NULL == comp) {
+        return;
+    }
+
+    if (comp->row_buf) {
+        tal_free(comp->row_buf);
+    }
+
+    memset(comp, 0, sizeof(TDL_DISP_COMPOSE_T));
+}
+
+/**
+ * @brief Starts composing a new frame into the given frame buffer.
+ *
+ * Clears the dirty areas recorded for the previous frame.
+ *
+ * @param comp Pointer to the compositor.
+ * @param fb Target frame buffer (RGB565, RGB888, MONOCHROME or I2).
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET tdl_disp_compose_begin(TDL_DISP_COMPOSE_T *comp, TDL_DISP_FRAME_BUFF_T *fb)
+{
+    if (NULL == comp || NULL == fb || NULL == fb->frame) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (false == __compose_is_fmt_supported(fb->fmt)) {
+        PR_ERR("Unsupported pixel format for compose: %d", fb->fmt);
+        return OPRT_NOT_SUPPORTED;
+    }
+
+    comp->fb = fb;
+    comp->dirty_num = 0;
+    comp->is_dirty_full = false;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Blits a YUV422 camera frame into a rectangle of the frame buffer.
+ *
+ * The image is scaled with nearest neighbour sampling. Supported for RGB565 and
+ * MONOCHROME frame buffers; monochrome destinations must start on a multiple of 8.
+ *
+ * @param comp Pointer to the compositor.
+ * @param yuv Camera frame (Y U Y V, or U Y V Y when is_uyvy is set).
+ * @param src_width Camera frame width, must be even.
+ * @param src_height Camera frame height.
+ * @param is_uyvy Whether the camera frame is U Y V Y.
+ * @param dst Destination rectangle, or NULL for the whole frame buffer.
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET tdl_disp_compose_blit_yuv422(TDL_DISP_COMPOSE_T *comp, const uint8_t *yuv,\
+                                         uint16_t src_width, uint16_t src_height,\
+                                         bool is_uyvy, TDL_DISP_RECT_T *dst)
+{
+    TDL_DISP_FRAME_BUFF_T *fb = NULL;
+    TDL_DISP_ROW_CONVERT_CB convert_cb = NULL;
+    TDL_DISP_CONVERT_CFG_T cfg;
+    TDL_DISP_RECT_T rect;
+    uint32_t dst_w = 0, dst_h = 0, row_len = 0, row_bytes = 0, need = 0;
+    uint32_t step_x = 0, step_y = 0, pos = 0, sx = 0, sy = 0, last_sy = UINT32_MAX;
+    uint8_t y_idx = 0, u_idx = 0, mask = 0;
+    const uint8_t *src_row = NULL;
+    uint8_t *dst_row = NULL, *last_dst_row = NULL, *p_row = NULL, *p_out = NULL;
+
+    if (false == __compose_is_ready(comp) || NULL == yuv || \
+        src_width < 2 || (src_width & 0x01) || 0 == src_height) {
+        return OPRT_INVALID_PARM;
+    }
+
+    fb = comp->fb;
+
+    convert_cb = tdl_disp_get_yuv422_row_convert(fb->fmt);
+    if (NULL == convert_cb) {
+        PR_ERR("Unsupported pixel format for yuv422 blit: %d", fb->fmt);
+        return OPRT_NOT_SUPPORTED;
+    }
+
+    if (dst) {
+        rect = *dst;
+    } else {
+        rect.x0 = fb->x_start;
+        rect.y0 = fb->y_start;
+        rect.x1 = fb->x_start + fb->width - 1;
+        rect.y1 = fb->y_start + fb->height - 1;
+    }
+
+    if (rect.x0 > rect.x1 || rect.y0 > rect.y1 || \
+        rect.x0 < fb->x_start || rect.x1 >= fb->x_start + fb->width || \
+        rect.y0 < fb->y_start || rect.y1 >= fb->y_start + fb->height) {
+        PR_ERR("blit area out of bounds: x0=%d, y0=%d, x1=%d, y1=%d", rect.x0, rect.y0, rect.x1, rect.y1);
+        return OPRT_INVALID_PARM;
+    }
+
+    if (TUYA_PIXEL_FMT_MONOCHROME == fb->fmt && ((rect.x0 - fb->x_start) % 8)) {
+        return OPRT_NOT_SUPPORTED;
+    }
+
+    dst_w = rect.x1 - rect.x0 + 1;
+    dst_h = rect.y1 - rect.y0 + 1;
+    // the converters work on pixel pairs
+    row_len = (dst_w + 1) & ~0x01u;
+    need = row_len * 2;
+
+    if (need > comp->row_buf_size) {
+        if (comp->row_buf) {
+            tal_free(comp->row_buf);
+        }
+        comp->row_buf = tal_malloc(need);
+        if (NULL == comp->row_buf) {
+            comp->row_buf_size = 0;
+            return OPRT_MALLOC_FAILED;
+        }
+        comp->row_buf_size = need;
+    }
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.threshold = COMPOSE_MONO_THRESHOLD;
+    cfg.is_swap = comp->is_swap;
+    cfg.is_uyvy = is_uyvy;
+
+    y_idx = (is_uyvy) ? 1 : 0;
+    u_idx = (is_uyvy) ? 0 : 1;
+
+    // 16.16 fixed point source steps, sampling at pixel centers
+    step_x = ((uint32_t)src_width << 16) / dst_w;
+    step_y = ((uint32_t)src_height << 16) / dst_h;
+
+    // only rgb565 rows are copied whole, mono rows are merged bit wise below
+    row_bytes = dst_w * 2;
+
+    for (uint32_t y = 0; y < dst_h; y++) {
+        sy = (y * step_y + (step_y >> 1)) >> 16;
+        if (TUYA_PIXEL_FMT_RGB565 == fb->fmt) {
+            dst_row = fb->frame + ((rect.y0 - fb->y_start + y) * fb->width + (rect.x0 - fb->x_start)) * 2;
+        } else {
+            dst_row = fb->frame + (rect.y0 - fb->y_start + y) * (fb->width / 8) + (rect.x0 - fb->x_start) / 8;
+        }
+
+        // upscaled rows repeat the previous output; mono dither depends on the row so convert again
+        if (sy == last_sy && TUYA_PIXEL_FMT_RGB565 == fb->fmt) {
+            memcpy(dst_row, last_dst_row, row_bytes);
+            continue;
+        }
+
+        src_row = yuv + sy * src_width * 2;
+        // even rgb565 rows are converted straight into the frame buffer
+        p_row = (TUYA_PIXEL_FMT_RGB565 == fb->fmt && row_len == dst_w) ? dst_row : comp->row_buf;
+
+        if (dst_w == src_width) {
+            convert_cb(src_row, p_row, row_len, rect.y0 + y, &cfg);
+        } else {
+            // gather the sampled pixels into a scratch yuv422 row, chroma taken from the
+            // pair of the first pixel of every output pair
+            p_out = comp->row_buf;
+            pos = step_x >> 1;
+            for (uint32_t x = 0; x < row_len; x += 2, p_out += 4) {
+                sx = COMPOSE_MIN(pos >> 16, (uint32_t)src_width - 1);
+                p_out[y_idx]     = src_row[sx * 2 + y_idx];
+                p_out[u_idx]     = src_row[(sx & ~0x01u) * 2 + u_idx];
+                p_out[u_idx + 2] = src_row[(sx & ~0x01u) * 2 + u_idx + 2];
+                pos += step_x;
+                sx = COMPOSE_MIN(pos >> 16, (uint32_t)src_width - 1);
+                p_out[y_idx + 2] = src_row[sx * 2 + y_idx];
+                pos += step_x;
+            }
+            convert_cb(comp->row_buf, p_row, row_len, rect.y0 + y, &cfg);
+        }
+
+        if (TUYA_PIXEL_FMT_RGB565 == fb->fmt) {
+            if (p_row != dst_row) {
+                memcpy(dst_row, p_row, row_bytes);
+            }
+        } else {
+            // whole bytes are copied, a trailing partial byte only changes the bits inside the rect
+            memcpy(dst_row, p_row, dst_w / 8);
+            if (dst_w % 8) {
+                mask = (uint8_t)((1u << (dst_w % 8)) - 1);
+                dst_row[dst_w / 8] = (dst_row[dst_w / 8] & ~mask) | (p_row[dst_w / 8] & mask);
+            }
+        }
+        last_sy = sy;
+        last_dst_row = dst_row;
+    }
+
+    __compose_add_dirty(comp, rect.x0, rect.y0, rect.x1, rect.y1);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Draws a line. Parts outside the frame buffer are clipped.
+ *
+ * @param comp Pointer to the compositor.
+ * @param x0 Start X coordinate.
+ * @param y0 Start Y coordinate.
+ * @param x1 End X coordinate.
+ * @param y1 End Y coordinate.
+ * @param thickness Line thickness in pixels.
+ * @param color Color value in the frame buffer format.
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET tdl_disp_compose_line(TDL_DISP_COMPOSE_T *comp, int32_t x0, int32_t y0,\
+                                  int32_t x1, int32_t y1, uint8_t thickness, uint32_t color)
+{
+    int32_t dx = 0, dy = 0, sx = 0, sy = 0, err = 0, e2 = 0;
+    int32_t lo = 0, hi = 0;
+    bool is_x_major = false;
+
+    if (false == __compose_is_ready(comp)) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (0 == thickness) {
+        thickness = 1;
+    }
+
+    // brush spans across the minor axis
+    lo = (thickness - 1) / 2;
+    hi = thickness / 2;
+
+    dx = (x1 > x0) ? (x1 - x0) : (x0 - x1);
+    dy = (y1 > y0) ? (y0 - y1) : (y1 - y0);
+    sx = (x0 < x1) ? 1 : -1;
+    sy = (y0 < y1) ? 1 : -1;
+    err = dx + dy;
+    is_x_major = (dx >= -dy);
+
+    __compose_add_dirty(comp, COMPOSE_MIN(x0, x1) - hi, COMPOSE_MIN(y0, y1) - hi, \
+                              COMPOSE_MAX(x0, x1) + hi, COMPOSE_MAX(y0, y1) + hi);
+
+    while (1) {
+        if (is_x_major) {
+            __compose_fill(comp, x0, y0 - lo, x0, y0 + hi, color);
+        } else {
+            __compose_fill(comp, x0 - lo, y0, x0 + hi, y0, color);
+        }
+
+        if (x0 == x1 && y0 == y1) {
+            break;
+        }
+
+        e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Draws a filled circle. Parts outside the frame buffer are clipped.
+ *
+ * @param comp Pointer to the compositor.
+ * @param cx Center X coordinate.
+ * @param cy Center Y coordinate.
+ * @param radius Radius in pixels.
+ * @param color Color value in the frame buffer format.
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET tdl_disp_compose_circle_fill(TDL_DISP_COMPOSE_T *comp, int32_t cx, int32_t cy,\
+                                         uint16_t radius, uint32_t color)
+{
+    int32_t x = radius, y = 0, err = 1 - (int32_t)radius;
+
+    if (false == __compose_is_ready(comp)) {
+        return OPRT_INVALID_PARM;
+    }
+
+    __compose_add_dirty(comp, cx - radius, cy - radius, cx + radius, cy + radius);
+
+    // midpoint circle, emitting one horizontal span per row of each octant pair
+    while (x >= y) {
+        __compose_fill(comp, cx - x, cy + y, cx + x, cy + y, color);
+        __compose_fill(comp, cx - x, cy - y, cx + x, cy - y, color);
+        __compose_fill(comp, cx - y, cy + x, cx + y, cy + x, color);
+        __compose_fill(comp, cx - y, cy - x, cx + y, cy - x, color);
+
+        y++;
+        if (err < 0) {
+            err += 2 * y + 1;
+        } else {
+            x--;
+            err += 2 * (y - x) + 1;
+        }
+    }
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Draws a 17-keypoint pose skeleton.
+ *
+ * Edges are drawn when both keypoints reach min_score, keypoints when they do.
+ *
+ * @param comp Pointer to the compositor.
+ * @param kpts Keypoints in COCO order (TDL_DISP_POSE_KEYPOINT_NUM entries).
+ * @param min_score Minimum keypoint confidence.
+ * @param edge_color Color of the skeleton edges.
+ * @param point_color Color of the keypoints.
+ * @param thickness Edge thickness in pixels.
+ * @param radius Keypoint radius in pixels.
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET tdl_disp_compose_skeleton(TDL_DISP_COMPOSE_T *comp, const TDL_DISP_POSE_KEYPOINT_T *kpts,\
+                                      uint8_t min_score, uint32_t edge_color, uint32_t point_color,\
+                                      uint8_t thickness, uint16_t radius)
+{
+    OPERATE_RET rt = OPRT_OK;
+    const TDL_DISP_POSE_KEYPOINT_T *a = NULL, *b = NULL;
+
+    if (false == __compose_is_ready(comp) || NULL == kpts) {
+        return OPRT_INVALID_PARM;
+    }
+
+    for (uint8_t i = 0; i < CNTSOF(sg_pose_edges); i++) {
+        a = &kpts[sg_pose_edges[i].a];
+        b = &kpts[sg_pose_edges[i].b];
+        if (a->score < min_score || b->score < min_score) {
+            continue;
+        }
+        TUYA_CALL_ERR_RETURN(tdl_disp_compose_line(comp, a->x, a->y, b->x, b->y, thickness, edge_color));
+    }
+
+    for (uint8_t i = 0; i < TDL_DISP_POSE_KEYPOINT_NUM; i++) {
+        if (kpts[i].score < min_score) {
+            continue;
+        }
+        TUYA_CALL_ERR_RETURN(tdl_disp_compose_circle_fill(comp, kpts[i].x, kpts[i].y, radius, point_color));
+    }
+
+    return rt;
+}
+
+/**
+ * @brief Marks an area as changed, e.g. after drawing into the frame buffer directly.
+ *
+ * @param comp Pointer to the compositor.
+ * @param area Changed area (inclusive coordinates), or NULL for the whole frame buffer.
+ */
+void tdl_disp_compose_mark_dirty(TDL_DISP_COMPOSE_T *comp, TDL_DISP_RECT_T *area)
+{
+    if (false == __compose_is_ready(comp)) {
+        return;
+    }
+
+    if (NULL == area) {
+        comp->is_dirty_full = true;
+        return;
+    }
+
+    __compose_add_dirty(comp, area->x0, area->y0, area->x1, area->y1);
+}
+
+/**
+ * @brief Sends the changed areas of the frame buffer to the display.
+ *
+ * Falls back to a full flush if the driver has no partial update support.
+ *
+ * @param comp Pointer to the compositor.
+ * @param disp_hdl Handle to the display device.
+ * @return OPERATE_RET Operation result code.
+ */
+OPERATE_RET tdl_disp_compose_flush(TDL_DISP_COMPOSE_T *comp, TDL_DISP_HANDLE_T disp_hdl)
+{
+    OPERATE_RET rt = OPRT_OK;
+
+    if (false == __compose_is_ready(comp) || NULL == disp_hdl) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (comp->is_dirty_full) {
+        rt = tdl_disp_dev_flush(disp_hdl, comp->fb);
+    } else if (comp->dirty_num) {
+        rt = tdl_disp_dev_flush_area(disp_hdl, comp->fb, comp->dirty, comp->dirty_num);
+    } else if (comp->fb->free_cb) {
+        // nothing changed, hand the buffer back to its owner
+        comp->fb->free_cb(comp->fb);
+    }
+
+    comp->dirty_num = 0;
+    comp->is_dirty_full = false;
+
+    return rt;
+}
@@ -17,6 +17,10 @@
 /***********************************************************
 ************************macro define************************
 ***********************************************************/
+// tile edge in pixels, keeps the strided side of a 90/270 rotation inside the cache
+#define TDL_DISP_ROTATE_TILE 16
+
+#define RGB565_PAIR_SWAP(w) ((((w) & 0xff00ff00) >> 8) | (((w) & 0x00ff00ff) << 8))
 
 
 /***********************************************************
@@ -36,15 +40,24 @@ static void __rotate90_rgb888(uint8_t * src, uint8_t * dst, uint32_t src_width,
 {
     uint32_t src_stride = src_width * 3;
     uint32_t dst_stride = src_height * 3;
-    uint32_t src_index = 0, dst_index = 0;
-
-    for(uint32_t x = 0; x < src_width; ++x) {
-        for(uint32_t y = 0; y < src_height; ++y) {
-            src_index = y * src_stride + x * 3;
-            dst_index = (src_width - x - 1) * dst_stride + y * 3;
-            dst[dst_index] = src[src_index];       /*Red*/
-            dst[dst_index + 1] = src[src_index + 1]; /*Green*/
-            dst[dst_index + 2] = src[src_index + 2]; /*Blue*/
+    uint32_t x_end = 0, y_end = 0;
+    uint8_t *p_src = NULL, *p_dst = NULL;
+
+    for(uint32_t ty = 0; ty < src_height; ty += TDL_DISP_ROTATE_TILE) {
+        y_end = (ty + TDL_DISP_ROTATE_TILE < src_height) ? (ty + TDL_DISP_ROTATE_TILE) : src_height;
+        for(uint32_t tx = 0; tx < src_width; tx += TDL_DISP_ROTATE_TILE) {
+            x_end = (tx + TDL_DISP_ROTATE_TILE < src_width) ? (tx + TDL_DISP_ROTATE_TILE) : src_width;
+            for(uint32_t x = tx; x < x_end; ++x) {
+                p_src = src + ty * src_stride + x * 3;
+                p_dst = dst + (src_width - x - 1) * dst_stride + ty * 3;
+                for(uint32_t y = ty; y < y_end; ++y) {
+                    p_dst[0] = p_src[0];
+                    p_dst[1] = p_src[1];
+                    p_dst[2] = p_src[2];
+                    p_src += src_stride;
+                    p_dst += 3;
+                }
+            }
         }
     }
 }
@@ -70,15 +83,24 @@ static void __rotate270_rgb888(uint8_t * src, uint8_t * dst, uint32_t src_width,
 {
     uint32_t src_stride = src_width * 3;
     uint32_t dst_stride = src_height * 3;
-    uint32_t src_index = 0, dst_index = 0;
-
-    for(uint32_t x = 0; x < src_width; ++x) {
-        for(uint32_t y = 0; y < src_height; ++y) {
-            src_index = y * src_stride + x * 3;
-            dst_index = x * dst_stride + (src_height - y - 1) * 3;
-            dst[dst_index] = src[src_index];       /*Red*/
-            dst[dst_index + 1] = src[src_index + 1]; /*Green*/
-            dst[dst_index + 2] = src[src_index + 2]; /*Blue*/
+    uint32_t x_end = 0, y_end = 0;
+    uint8_t *p_src = NULL, *p_dst = NULL;
+
+    for(uint32_t ty = 0; ty < src_height; ty += TDL_DISP_ROTATE_TILE) {
+        y_end = (ty + TDL_DISP_ROTATE_TILE < src_height) ? (ty + TDL_DISP_ROTATE_TILE) : src_height;
+        for(uint32_t tx = 0; tx < src_width; tx += TDL_DISP_ROTATE_TILE) {
+            x_end = (tx + TDL_DISP_ROTATE_TILE < src_width) ? (tx + TDL_DISP_ROTATE_TILE) : src_width;
+            for(uint32_t x = tx; x < x_end; ++x) {
+                p_src = src + ty * src_stride + x * 3;
+                p_dst = dst + x * dst_stride + (src_height - ty - 1) * 3;
+                for(uint32_t y = ty; y < y_end; ++y) {
+                    p_dst[0] = p_src[0];
+                    p_dst[1] = p_src[1];
+                    p_dst[2] = p_src[2];
+                    p_src += src_stride;
+                    p_dst -= 3;
+                }
+            }
         }
     }
 }
@@ -106,7 +128,7 @@ static void __tdl_disp_draw_sw_rotate_rgb888(TUYA_DISPLAY_ROTATION_E rot, \
     }
 }
 
-static void __rotate270_rgb565(uint16_t * src, uint16_t * dst, uint32_t src_width, uint32_t src_height, bool is_swap)
+static void __rotate270_rgb565_by_pixel(uint16_t * src, uint16_t * dst, uint32_t src_width, uint32_t src_height, bool is_swap)
 {
     uint32_t src_stride = src_width;
     uint32_t dst_stride = src_height;
@@ -127,7 +149,7 @@ static void __rotate270_rgb565(uint16_t * src, uint16_t * dst, uint32_t src_widt
     }
 }
 
-static void __rotate180_rgb565(uint16_t * src, uint16_t * dst, uint32_t src_width, uint32_t src_height, bool is_swap)
+static void __rotate180_rgb565_by_pixel(uint16_t * src, uint16_t * dst, uint32_t src_width, uint32_t src_height, bool is_swap)
 {
     uint32_t src_stride = src_width;
     uint32_t dst_stride = src_width;
@@ -146,7 +168,7 @@ static void __rotate180_rgb565(uint16_t * src, uint16_t * dst, uint32_t src_widt
     }
 }
 
-static void __rotate90_rgb565(uint16_t * src, uint16_t * dst, uint32_t src_width, uint32_t src_height, bool is_swap)
+static void __rotate90_rgb565_by_pixel(uint16_t * src, uint16_t * dst, uint32_t src_width, uint32_t src_height, bool is_swap)
 {
     uint32_t src_stride = src_width;
     uint32_t dst_stride = src_height;
@@ -166,6 +188,111 @@ static void __rotate90_rgb565(uint16_t * src, uint16_t * dst, uint32_t src_width
     }
 }
 
+static bool __is_rgb565_pair_aligned(uint16_t * src, uint16_t * dst, uint32_t src_width, uint32_t src_height)
+{
+    return (0 == ((src_width | src_height) & 0x01)) && \
+           (0 == (((uintptr_t)src | (uintptr_t)dst) & 0x03));
+}
+
+/*
+ * The paired variants move 2x2 pixel blocks: two 32-bit reads from adjacent source
+ * rows become two 32-bit writes into adjacent destination rows. They require even
+ * dimensions and word aligned buffers, the by_pixel versions cover everything else.
+ */
+static void __rotate270_rgb565(uint16_t * src, uint16_t * dst, uint32_t src_width, uint32_t src_height, bool is_swap)
+{
+    uint32_t *src32 = (uint32_t *)src, *dst32 = (uint32_t *)dst;
+    uint32_t *p_dst0 = NULL, *p_dst1 = NULL;
+    uint32_t x_end = 0, y_end = 0, a = 0, b = 0, w0 = 0, w1 = 0;
+    uint32_t src_stride32 = src_width / 2, dst_stride32 = src_height / 2;
+
+    if(false == __is_rgb565_pair_aligned(src, dst, src_width, src_height)) {
+        __rotate270_rgb565_by_pixel(src, dst, src_width, src_height, is_swap);
+        return;
+    }
+
+    for(uint32_t ty = 0; ty < src_height; ty += TDL_DISP_ROTATE_TILE) {
+        y_end = (ty + TDL_DISP_ROTATE_TILE < src_height) ? (ty + TDL_DISP_ROTATE_TILE) : src_height;
+        for(uint32_t tx = 0; tx < src_width; tx += TDL_DISP_ROTATE_TILE) {
+            x_end = (tx + TDL_DISP_ROTATE_TILE < src_width) ? (tx + TDL_DISP_ROTATE_TILE) : src_width;
+            for(uint32_t x = tx; x < x_end; x += 2) {
+                // destination rows x and x+1, pixel pair at column (src_height - y - 2)
+                p_dst0 = dst32 + x * dst_stride32;
+                p_dst1 = p_dst0 + dst_stride32;
+                for(uint32_t y = ty; y < y_end; y += 2) {
+                    a = src32[y * src_stride32 + x / 2];
+                    b = src32[(y + 1) * src_stride32 + x / 2];
+                    w0 = (b & 0x0000FFFF) | (a << 16);
+                    w1 = (b >> 16) | (a & 0xFFFF0000);
+                    if(true == is_swap) {
+                        w0 = RGB565_PAIR_SWAP(w0);
+                        w1 = RGB565_PAIR_SWAP(w1);
+                    }
+                    p_dst0[(src_height - y - 2) / 2] = w0;
+                    p_dst1[(src_height - y - 2) / 2] = w1;
+                }
+            }
+        }
+    }
+}
+
+static void __rotate180_rgb565(uint16_t * src, uint16_t * dst, uint32_t src_width, uint32_t src_height, bool is_swap)
+{
+    uint32_t *src32 = (uint32_t *)src, *dst32 = (uint32_t *)dst;
+    uint32_t cnt32 = src_width * src_height / 2, w = 0;
+
+    if(false == __is_rgb565_pair_aligned(src, dst, src_width, src_height)) {
+        __rotate180_rgb565_by_pixel(src, dst, src_width, src_height, is_swap);
+        return;
+    }
+
+    // a 180 degree rotation is a reversal of the whole pixel sequence
+    for(uint32_t i = 0; i < cnt32; i++) {
+        w = (src32[i] >> 16) | (src32[i] << 16);
+        if(true == is_swap) {
+            w = RGB565_PAIR_SWAP(w);
+        }
+        dst32[cnt32 - 1 - i] = w;
+    }
+}
+
+static void __rotate90_rgb565(uint16_t * src, uint16_t * dst, uint32_t src_width, uint32_t src_height, bool is_swap)
+{
+    uint32_t *src32 = (uint32_t *)src, *dst32 = (uint32_t *)dst;
+    uint32_t *p_dst0 = NULL, *p_dst1 = NULL;
+    uint32_t x_end = 0, y_end = 0, a = 0, b = 0, w0 = 0, w1 = 0;
+    uint32_t src_stride32 = src_width / 2, dst_stride32 = src_height / 2;
+
+    if(false == __is_rgb565_pair_aligned(src, dst, src_width, src_height)) {
+        __rotate90_rgb565_by_pixel(src, dst, src_width, src_height, is_swap);
+        return;
+    }
+
+    for(uint32_t ty = 0; ty < src_height; ty += TDL_DISP_ROTATE_TILE) {
+        y_end = (ty + TDL_DISP_ROTATE_TILE < src_height) ? (ty + TDL_DISP_ROTATE_TILE) : src_height;
+        for(uint32_t tx = 0; tx < src_width; tx += TDL_DISP_ROTATE_TILE) {
+            x_end = (tx + TDL_DISP_ROTATE_TILE < src_width) ? (tx + TDL_DISP_ROTATE_TILE) : src_width;
+            for(uint32_t x = tx; x < x_end; x += 2) {
+                // destination rows (src_width - x - 1) and (src_width - x - 2), pixel pair at column y
+                p_dst0 = dst32 + (src_width - x - 1) * dst_stride32;
+                p_dst1 = p_dst0 - dst_stride32;
+                for(uint32_t y = ty; y < y_end; y += 2) {
+                    a = src32[y * src_stride32 + x / 2];
+                    b = src32[(y + 1) * src_stride32 + x / 2];
+                    w0 = (a & 0x0000FFFF) | (b << 16);
+                    w1 = (a >> 16) | (b & 0xFFFF0000);
+                    if(true == is_swap) {
+                        w0 = RGB565_PAIR_SWAP(w0);
+                        w1 = RGB565_PAIR_SWAP(w1);
+                    }
+                    p_dst0[y / 2] = w0;
+                    p_dst1[y / 2] = w1;
+                }
+            }
+        }
+    }
+}
+
 static void __tdl_disp_draw_sw_rotate_rgb565(TUYA_DISPLAY_ROTATION_E rot, \
                                             TDL_DISP_FRAME_BUFF_T *in_fb, \
                                             TDL_DISP_FRAME_BUFF_T *out_fb,
@@ -190,7 +317,7 @@ static void __tdl_disp_draw_sw_rotate_rgb565(TUYA_DISPLAY_ROTATION_E rot, \
     }
 }
 
-static void __rotate270_monochrome(uint8_t * src, uint8_t * dst, uint32_t src_width, uint32_t src_height)
+static void __rotate270_monochrome_by_pixel(uint8_t * src, uint8_t * dst, uint32_t src_width, uint32_t src_height)
 {
     uint32_t src_stride = (src_width+7)/8;
     uint32_t dst_stride = (src_height+7)/8;
@@ -215,7 +342,7 @@ static void __rotate270_monochrome(uint8_t * src, uint8_t * dst, uint32_t src_wi
     }
 }
 
-static void __rotate180_monochrome(uint8_t * src, uint8_t * dst, uint32_t src_width, uint32_t src_height)
+static void __rotate180_monochrome_by_pixel(uint8_t * src, uint8_t * dst, uint32_t src_width, uint32_t src_height)
 {
     uint32_t src_stride = (src_width+7)/8;
     uint32_t dst_stride = (src_width+7)/8;
@@ -240,7 +367,7 @@ static void __rotate180_monochrome(uint8_t * src, uint8_t * dst, uint32_t src_wi
     }
 }
 
-static void __rotate90_monochrome(uint8_t * src, uint8_t * dst, uint32_t src_width, uint32_t src_height)
+static void __rotate90_monochrome_by_pixel(uint8_t * src, uint8_t * dst, uint32_t src_width, uint32_t src_height)
 {
     uint32_t src_stride = (src_width+7)/8;
     uint32_t dst_stride = (src_height+7)/8;
@@ -265,6 +392,104 @@ static void __rotate90_monochrome(uint8_t * src, uint8_t * dst, uint32_t src_wid
     }
 }
 
+static uint8_t __bit_reverse8(uint8_t v)
+{
+    static const uint8_t nibble_rev[16] = {0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE,
+                                           0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF};
+
+    return (nibble_rev[v & 0x0F] << 4) | nibble_rev[v >> 4];
+}
+
+/*
+ * Transposes an 8x8 bit block. in[i] holds source row i (bit j is column j),
+ * out[j] receives column j with row i at bit i (or bit 7-i when reversed).
+ */
+static void __transpose8_monochrome(uint8_t in[8], uint8_t out[8], bool is_reverse)
+{
+    uint64_t x = 0, t = 0;
+
+    for(uint8_t i = 0; i < 8; i++) {
+        x |= (uint64_t)in[i] << (i * 8);
+    }
+
+    // Hacker's Delight transpose8: bit (8 * i + j) moves to bit (8 * j + i)
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+
+    for(uint8_t j = 0; j < 8; j++) {
+        out[j] = (is_reverse) ? __bit_reverse8((x >> (j * 8)) & 0xFF) : ((x >> (j * 8)) & 0xFF);
+    }
+}
+
+static void __rotate270_monochrome(uint8_t * src, uint8_t * dst, uint32_t src_width, uint32_t src_height)
+{
+    uint32_t src_stride = src_width / 8;
+    uint32_t dst_stride = src_height / 8;
+    uint8_t in[8], out[8];
+
+    if((src_width | src_height) & 0x07) {
+        __rotate270_monochrome_by_pixel(src, dst, src_width, src_height);
+        return;
+    }
+
+    // destination row (src_width - 1 - x), bit y
+    for(uint32_t by = 0; by < src_height; by += 8) {
+        for(uint32_t bx = 0; bx < src_width; bx += 8) {
+            for(uint8_t i = 0; i < 8; i++) {
+                in[i] = src[(by + i) * src_stride + bx / 8];
+            }
+            __transpose8_monochrome(in, out, false);
+            for(uint8_t j = 0; j < 8; j++) {
+                dst[(src_width - 1 - bx - j) * dst_stride + by / 8] = out[j];
+            }
+        }
+    }
+}
+
+static void __rotate180_monochrome(uint8_t * src, uint8_t * dst, uint32_t src_width, uint32_t src_height)
+{
+    uint32_t stride = src_width / 8;
+    uint32_t cnt = stride * src_height;
+
+    if(src_width & 0x07) {
+        __rotate180_monochrome_by_pixel(src, dst, src_width, src_height);
+        return;
+    }
+
+    for(uint32_t i = 0; i < cnt; i++) {
+        dst[cnt - 1 - i] = __bit_reverse8(src[i]);
+    }
+}
+
+static void __rotate90_monochrome(uint8_t * src, uint8_t * dst, uint32_t src_width, uint32_t src_height)
+{
+    uint32_t src_stride = src_width / 8;
+    uint32_t dst_stride = src_height / 8;
+    uint8_t in[8], out[8];
+
+    if((src_width | src_height) & 0x07) {
+        __rotate90_monochrome_by_pixel(src, dst, src_width, src_height);
+        return;
+    }
+
+    // destination row x, bit (src_height - 1 - y)
+    for(uint32_t by = 0; by < src_height; by += 8) {
+        for(uint32_t bx = 0; bx < src_width; bx += 8) {
+            for(uint8_t i = 0; i < 8; i++) {
+                in[i] = src[(by + i) * src_stride + bx / 8];
+            }
+            __transpose8_monochrome(in, out, true);
+            for(uint8_t j = 0; j < 8; j++) {
+                dst[(bx + j) * dst_stride + (src_height - 8 - by) / 8] = out[j];
+            }
+        }
+    }
+}
+
 static void __tdl_disp_draw_sw_rotate_mono(TUYA_DISPLAY_ROTATION_E rot, \
                                             TDL_DISP_FRAME_BUFF_T *in_fb, \
                                             TDL_DISP_FRAME_BUFF_T *out_fb)
@@ -13,6 +13,9 @@
 /***********************************************************
 ************************macro define************************
 ***********************************************************/
+#define RGB565_PAIR_SWAP(w) ((((w) & 0xff00ff00) >> 8) | (((w) & 0x00ff00ff) << 8))
+
+#define IS_ALIGNED4(p) (0 == ((uintptr_t)(p) & 0x03))
 
 
 /***********************************************************
@@ -40,9 +43,22 @@ typedef union {
     uint16_t whole;
 } TDL_DISP_RGB565_U;
 
+typedef struct {
+    TUYA_DISPLAY_PIXEL_FMT_E src_fmt;
+    TUYA_DISPLAY_PIXEL_FMT_E dst_fmt;
+    TDL_DISP_ROW_CONVERT_CB  cb;
+} TDL_DISP_ROW_CONVERT_T;
+
 /***********************************************************
 ***********************variable define**********************
 ***********************************************************/
+// 4x4 bayer matrix scaled to 0-255
+static const uint8_t sg_bayer4[4][4] = {
+    {  8, 136,  40, 168},
+    {200,  72, 232, 104},
+    { 56, 184,  24, 152},
+    {248, 120, 216,  88},
+};
 
 
 /***********************************************************
@@ -121,6 +137,260 @@ static uint32_t __disp_rgba888_to_color(TUYA_DISPLAY_PIXEL_FMT_E fmt, TDL_DISP_R
     return color;
 }
 
+/*
+ * Bulk row converters. Two rgb565 pixels are handled per 32-bit word: every channel
+ * is extracted and expanded for both 16-bit lanes with one mask/shift sequence.
+ */
+static inline uint32_t __rgb565_pair_to_rgb888(uint32_t pair, uint32_t *c1)
+{
+    uint32_t b = pair & 0x001F001F;
+    uint32_t g = (pair >> 5) & 0x003F003F;
+    uint32_t r = (pair >> 11) & 0x001F001F;
+
+    b = (b << 3) | (b >> 2);
+    g = (g << 2) | (g >> 4);
+    r = (r << 3) | (r >> 2);
+
+    *c1 = (b >> 16) | ((g >> 16) << 8) | ((r >> 16) << 16);
+
+    return (b & 0xFF) | ((g & 0xFF) << 8) | ((r & 0xFF) << 16);
+}
+
+static inline uint16_t __rgb888_to_rgb565(uint32_t c)
+{
+    return ((c >> 8) & 0xF800) | ((c >> 5) & 0x07E0) | ((c >> 3) & 0x001F);
+}
+
+// luma approximation (r + 2g + b) / 4 on 8-bit channels, computed from rgb565 fields
+static inline uint32_t __rgb565_luma(uint16_t c)
+{
+    return (((c >> 11) & 0x1F) + ((c >> 5) & 0x3F) + (c & 0x1F)) << 1;
+}
+
+static void __row_rgb565_to_rgb888(const uint8_t *src, uint8_t *dst, uint32_t width,\
+                                   uint32_t row, const TDL_DISP_CONVERT_CFG_T *cfg)
+{
+    const uint16_t *src16 = (const uint16_t *)src;
+    bool is_swap = (cfg && cfg->is_swap);
+    uint32_t x = 0, c0 = 0, c1 = 0, c2 = 0, c3 = 0, p0 = 0, p1 = 0;
+
+    if (IS_ALIGNED4(src) && IS_ALIGNED4(dst)) {
+        const uint32_t *src32 = (const uint32_t *)src;
+        uint32_t *dst32 = (uint32_t *)dst;
+
+        // 4 pixels: 2 words in, 3 words out
+        for (; x + 4 <= width; x += 4) {
+            p0 = *src32++;
+            p1 = *src32++;
+            if (is_swap) {
+                p0 = RGB565_PAIR_SWAP(p0);
+                p1 = RGB565_PAIR_SWAP(p1);
+            }
+            c0 = __rgb565_pair_to_rgb888(p0, &c1);
+            c2 = __rgb565_pair_to_rgb888(p1, &c3);
+            *dst32++ = c0 | (c1 << 24);
+            *dst32++ = (c1 >> 8) | (c2 << 16);
+            *dst32++ = (c2 >> 16) | (c3 << 8);
+        }
+    }
+
+    for (; x < width; x++) {
+        p0 = (is_swap) ? WORD_SWAP(src16[x]) : src16[x];
+        c0 = __rgb565_pair_to_rgb888(p0, &c1);
+        dst[x * 3]     = c0 & 0xFF;
+        dst[x * 3 + 1] = (c0 >> 8) & 0xFF;
+        dst[x * 3 + 2] = (c0 >> 16) & 0xFF;
+    }
+}
+
+static void __row_rgb888_to_rgb565(const uint8_t *src, uint8_t *dst, uint32_t width,\
+                                   uint32_t row, const TDL_DISP_CONVERT_CFG_T *cfg)
+{
+    uint16_t *dst16 = (uint16_t *)dst;
+    bool is_swap = (cfg && cfg->is_swap);
+    uint32_t x = 0, w0 = 0, w1 = 0, w2 = 0, p0 = 0, p1 = 0;
+    uint16_t c = 0;
+
+    if (IS_ALIGNED4(src) && IS_ALIGNED4(dst)) {
+        const uint32_t *src32 = (const uint32_t *)src;
+        uint32_t *dst32 = (uint32_t *)dst;
+
+        // 4 pixels: 3 words in, 2 words out
+        for (; x + 4 <= width; x += 4) {
+            w0 = *src32++;
+            w1 = *src32++;
+            w2 = *src32++;
+            p0 = __rgb888_to_rgb565(w0) | ((uint32_t)__rgb888_to_rgb565((w0 >> 24) | (w1 << 8)) << 16);
+            p1 = __rgb888_to_rgb565((w1 >> 16) | (w2 << 16)) | ((uint32_t)__rgb888_to_rgb565(w2 >> 8) << 16);
+            if (is_swap) {
+                p0 = RGB565_PAIR_SWAP(p0);
+                p1 = RGB565_PAIR_SWAP(p1);
+            }
+            *dst32++ = p0;
+            *dst32++ = p1;
+        }
+    }
+
+    for (; x < width; x++) {
+        c = __rgb888_to_rgb565(src[x * 3] | (src[x * 3 + 1] << 8) | (src[x * 3 + 2] << 16));
+        dst16[x] = (is_swap) ? WORD_SWAP(c) : c;
+    }
+}
+
+static void __row_rgb565_to_mono(const uint8_t *src, uint8_t *dst, uint32_t width,\
+                                 uint32_t row, const TDL_DISP_CONVERT_CFG_T *cfg)
+{
+    const uint16_t *src16 = (const uint16_t *)src;
+    const uint8_t *bayer = sg_bayer4[row & 0x03];
+    bool is_swap = (cfg && cfg->is_swap);
+    bool is_dither = (cfg && cfg->is_dither);
+    int32_t threshold = (cfg) ? cfg->threshold : 0x80;
+    int32_t thr[8];
+    uint32_t x = 0, n = 0;
+    uint16_t c = 0;
+    uint8_t byte = 0;
+
+    // per column threshold, the dither offset repeats every 4 pixels
+    for (uint8_t i = 0; i < 8; i++) {
+        thr[i] = (is_dither) ? (threshold + bayer[i & 0x03] - 128) : threshold;
+    }
+
+    while (x < width) {
+        n = (width - x < 8) ? (width - x) : 8;
+        byte = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            c = (is_swap) ? WORD_SWAP(src16[x + i]) : src16[x + i];
+            byte |= ((int32_t)__rgb565_luma(c) < thr[i]) << i;
+        }
+        *dst++ = byte;
+        x += n;
+    }
+}
+
+static void __row_rgb565_to_i2(const uint8_t *src, uint8_t *dst, uint32_t width,\
+                               uint32_t row, const TDL_DISP_CONVERT_CFG_T *cfg)
+{
+    const uint16_t *src16 = (const uint16_t *)src;
+    const uint8_t *bayer = sg_bayer4[row & 0x03];
+    bool is_swap = (cfg && cfg->is_swap);
+    bool is_dither = (cfg && cfg->is_dither);
+    int32_t offset[4];
+    int32_t d = 0;
+    uint32_t x = 0, n = 0;
+    uint16_t c = 0;
+    uint8_t byte = 0;
+
+    // dither offset spans one quantization step (85)
+    for (uint8_t i = 0; i < 4; i++) {
+        offset[i] = (is_dither) ? (((int32_t)bayer[i] * 85) >> 8) - 42 : 0;
+    }
+
+    while (x < width) {
+        n = (width - x < 4) ? (width - x) : 4;
+        byte = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            c = (is_swap) ? WORD_SWAP(src16[x + i]) : src16[x + i];
+            d = 255 - (int32_t)__rgb565_luma(c) + offset[i];
+            d = (d < 0) ? 0 : ((d > 255) ? 255 : d);
+            byte |= (((d * 3 + 128) >> 8) & 0x03) << (i * 2);
+        }
+        *dst++ = byte;
+        x += n;
+    }
+}
+
+static inline uint8_t __clamp_u8(int32_t v)
+{
+    return (v < 0) ? 0 : ((v > 255) ? 255 : v);
+}
+
+static inline uint16_t __yuv_to_rgb565(int32_t y, int32_t r_add, int32_t g_add, int32_t b_add)
+{
+    uint8_t r = __clamp_u8((y + r_add) >> 8);
+    uint8_t g = __clamp_u8((y + g_add) >> 8);
+    uint8_t b = __clamp_u8((y + b_add) >> 8);
+
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+static void __row_yuv422_to_rgb565(const uint8_t *src, uint8_t *dst, uint32_t width,\
+                                   uint32_t row, const TDL_DISP_CONVERT_CFG_T *cfg)
+{
+    uint16_t *dst16 = (uint16_t *)dst;
+    bool is_swap = (cfg && cfg->is_swap);
+    uint8_t y_idx = (cfg && cfg->is_uyvy) ? 1 : 0;
+    uint8_t u_idx = (cfg && cfg->is_uyvy) ? 0 : 1;
+    int32_t y0 = 0, y1 = 0, u = 0, v = 0, r_add = 0, g_add = 0, b_add = 0;
+    uint32_t pair = 0;
+
+    // BT.601 limited range, chroma terms computed once per pixel pair
+    for (uint32_t x = 0; x + 2 <= width; x += 2, src += 4) {
+        y0 = ((int32_t)src[y_idx] - 16) * 298;
+        y1 = ((int32_t)src[y_idx + 2] - 16) * 298;
+        u  = (int32_t)src[u_idx] - 128;
+        v  = (int32_t)src[u_idx + 2] - 128;
+
+        r_add = 409 * v + 128;
+        g_add = -100 * u - 208 * v + 128;
+        b_add = 516 * u + 128;
+
+        pair = __yuv_to_rgb565(y0, r_add, g_add, b_add) | \
+               ((uint32_t)__yuv_to_rgb565(y1, r_add, g_add, b_add) << 16);
+        if (is_swap) {
+            pair = RGB565_PAIR_SWAP(pair);
+        }
+
+        dst16[x]     = pair & 0xFFFF;
+        dst16[x + 1] = pair >> 16;
+    }
+
+    // an odd width ends on a half macropixel holding Y and U only, reuse the V
+    // of the previous pair, or neutral chroma on a one pixel row
+    if (width & 1) {
+        y0 = ((int32_t)src[y_idx] - 16) * 298;
+        u  = (int32_t)src[u_idx] - 128;
+
+        pair = __yuv_to_rgb565(y0, 409 * v + 128, -100 * u - 208 * v + 128, 516 * u + 128);
+        if (is_swap) {
+            pair = RGB565_PAIR_SWAP(pair);
+        }
+        dst16[width - 1] = pair & 0xFFFF;
+    }
+}
+
+static void __row_yuv422_to_mono(const uint8_t *src, uint8_t *dst, uint32_t width,\
+                                 uint32_t row, const TDL_DISP_CONVERT_CFG_T *cfg)
+{
+    const uint8_t *bayer = sg_bayer4[row & 0x03];
+    const uint8_t *p_y = src + ((cfg && cfg->is_uyvy) ? 1 : 0);
+    bool is_dither = (cfg && cfg->is_dither);
+    int32_t threshold = (cfg) ? cfg->threshold : 0x80;
+    int32_t thr[8];
+    uint32_t x = 0, n = 0;
+    uint8_t byte = 0;
+
+    for (uint8_t i = 0; i < 8; i++) {
+        thr[i] = (is_dither) ? (threshold + bayer[i & 0x03] - 128) : threshold;
+    }
+
+    while (x < width) {
+        n = (width - x < 8) ? (width - x) : 8;
+        byte = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            byte |= ((int32_t)p_y[(x + i) * 2] < thr[i]) << i;
+        }
+        *dst++ = byte;
+        x += n;
+    }
+}
+
+static const TDL_DISP_ROW_CONVERT_T sg_row_convert_table[] = {
+    {TUYA_PIXEL_FMT_RGB565, TUYA_PIXEL_FMT_RGB888,     __row_rgb565_to_rgb888},
+    {TUYA_PIXEL_FMT_RGB888, TUYA_PIXEL_FMT_RGB565,     __row_rgb888_to_rgb565},
+    {TUYA_PIXEL_FMT_RGB565, TUYA_PIXEL_FMT_MONOCHROME, __row_rgb565_to_mono},
+    {TUYA_PIXEL_FMT_RGB565, TUYA_PIXEL_FMT_I2,         __row_rgb565_to_i2},
+};
+
 
 /**
  * @brief Gets the bits per pixel for the specified display pixel format.
@@ -217,4 +487,44 @@ uint32_t tdl_disp_convert_rgb565_to_color(uint16_t rgb565, TUYA_DISPLAY_PIXEL_FM
     }
 
     return color;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Looks up the bulk row converter between two pixel formats.
+ *
+ * Resolve the converter once (e.g. when the display is opened) and call it for every row.
+ * Monochrome and I2 outputs set higher values for darker pixels, matching the panel drivers.
+ *
+ * @param src_fmt Source pixel format.
+ * @param dst_fmt Destination pixel format.
+ * @return The row converter, or NULL if the conversion is not supported.
+ */
+TDL_DISP_ROW_CONVERT_CB tdl_disp_get_row_convert(TUYA_DISPLAY_PIXEL_FMT_E src_fmt, TUYA_DISPLAY_PIXEL_FMT_E dst_fmt)
+{
+    for (uint32_t i = 0; i < CNTSOF(sg_row_convert_table); i++) {
+        if (sg_row_convert_table[i].src_fmt == src_fmt && \
+            sg_row_convert_table[i].dst_fmt == dst_fmt) {
+            return sg_row_convert_table[i].cb;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Looks up the bulk row converter from camera YUV422 to a display pixel format.
+ *
+ * @param dst_fmt Destination pixel format (RGB565 or MONOCHROME).
+ * @return The row converter, or NULL if the conversion is not supported.
+ */
+TDL_DISP_ROW_CONVERT_CB tdl_disp_get_yuv422_row_convert(TUYA_DISPLAY_PIXEL_FMT_E dst_fmt)
+{
+    switch (dst_fmt) {
+        case TUYA_PIXEL_FMT_RGB565:
+            return __row_yuv422_to_rgb565;
+        case TUYA_PIXEL_FMT_MONOCHROME:
+            return __row_yuv422_to_mono;
+        default:
+            return NULL;
+    }
+}
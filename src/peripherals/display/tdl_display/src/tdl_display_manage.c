@@ -151,6 +151,52 @@ static void __tdl_blacklight_deinit(TUYA_DISPLAY_BL_CTRL_T *bl_cfg)
 }
 
 
+static uint32_t __disp_area_size(TDL_DISP_RECT_T *area)
+{
+    return (uint32_t)(area->x1 - area->x0 + 1) * (area->y1 - area->y0 + 1);
+}
+
+static bool __disp_area_should_join(TDL_DISP_RECT_T *a, TDL_DISP_RECT_T *b)
+{
+    TDL_DISP_RECT_T join;
+
+    // intersecting or touching areas are always merged
+    if (a->x0 <= b->x1 + 1 && b->x0 <= a->x1 + 1 && \
+        a->y0 <= b->y1 + 1 && b->y0 <= a->y1 + 1) {
+        return true;
+    }
+
+    join.x0 = (a->x0 < b->x0) ? a->x0 : b->x0;
+    join.y0 = (a->y0 < b->y0) ? a->y0 : b->y0;
+    join.x1 = (a->x1 > b->x1) ? a->x1 : b->x1;
+    join.y1 = (a->y1 > b->y1) ? a->y1 : b->y1;
+
+    // a window costs a few commands, so prefer one window if it is not larger
+    return (__disp_area_size(&join) <= __disp_area_size(a) + __disp_area_size(b));
+}
+
+static bool __disp_area_clip(TDL_DISP_RECT_T *area, TDL_DISP_FRAME_BUFF_T *fb)
+{
+    uint16_t x_end = fb->x_start + fb->width - 1;
+    uint16_t y_end = fb->y_start + fb->height - 1;
+
+    if (area->x0 > area->x1 || area->y0 > area->y1) {
+        return false;
+    }
+
+    if (area->x0 > x_end || area->x1 < fb->x_start || \
+        area->y0 > y_end || area->y1 < fb->y_start) {
+        return false;
+    }
+
+    area->x0 = (area->x0 < fb->x_start) ? fb->x_start : area->x0;
+    area->y0 = (area->y0 < fb->y_start) ? fb->y_start : area->y0;
+    area->x1 = (area->x1 > x_end) ? x_end : area->x1;
+    area->y1 = (area->y1 > y_end) ? y_end : area->y1;
+
+    return true;
+}
+
 /**
  * @brief Finds a registered display device by its name.
  *
@@ -238,6 +284,108 @@ OPERATE_RET tdl_disp_dev_flush(TDL_DISP_HANDLE_T disp_hdl, TDL_DISP_FRAME_BUFF_T
     return OPRT_OK;
 }
 
+/**
+ * @brief Flushes only the dirty areas of a frame buffer to the display device.
+ *
+ * The areas are given in display coordinates (inclusive) and must lie within the frame
+ * buffer. Overlapping or adjacent areas are coalesced before being handed to the driver.
+ * Drivers that cannot program a window fall back to a full frame flush.
+ *
+ * @param disp_hdl Handle to the display device.
+ * @param frame_buff Pointer to the frame buffer containing pixel data to be displayed.
+ * @param areas Array of dirty areas, modified in place by the coalescing step.
+ * @param area_num Number of areas in the array (at most TDL_DISP_AREA_MAX_NUM).
+ *
+ * @return Returns OPRT_OK on success, or an appropriate error code if flushing fails.
+ */
+OPERATE_RET tdl_disp_dev_flush_area(TDL_DISP_HANDLE_T disp_hdl, TDL_DISP_FRAME_BUFF_T *frame_buff,\
+                                    TDL_DISP_RECT_T *areas, uint8_t area_num)
+{
+    OPERATE_RET rt = OPRT_OK;
+    DISPLAY_DEVICE_T *display_dev = NULL;
+    uint8_t i = 0, valid_num = 0;
+
+    if (NULL == disp_hdl || NULL == frame_buff) {
+        return OPRT_INVALID_PARM;
+    }
+
+    display_dev = (DISPLAY_DEVICE_T *)disp_hdl;
+
+    if (false == display_dev->is_open) {
+        return OPRT_COM_ERROR;
+    }
+
+    if (NULL == display_dev->intfs.flush_area || NULL == areas || \
+        0 == area_num || area_num > TDL_DISP_AREA_MAX_NUM) {
+        return tdl_disp_dev_flush(disp_hdl, frame_buff);
+    }
+
+    for (i = 0; i < area_num; i++) {
+        if (__disp_area_clip(&areas[i], frame_buff)) {
+            areas[valid_num++] = areas[i];
+        }
+    }
+
+    if (0 == valid_num) {
+        // nothing visible changed, hand the buffer back to its owner
+        if (frame_buff->free_cb) {
+            frame_buff->free_cb(frame_buff);
+        }
+        return OPRT_OK;
+    }
+
+    valid_num = tdl_disp_area_coalesce(areas, valid_num);
+
+    TUYA_CALL_ERR_RETURN(display_dev->intfs.flush_area(display_dev->tdd_hdl, frame_buff, areas, valid_num));
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Merges overlapping, adjacent or cheaply combinable areas in place.
+ *
+ * Two areas are merged into their bounding box when they intersect, touch, or when the
+ * bounding box is no larger than the sum of both areas.
+ *
+ * @param areas Array of areas (inclusive coordinates).
+ * @param area_num Number of areas in the array.
+ *
+ * @return The number of areas remaining at the front of the array.
+ */
+uint8_t tdl_disp_area_coalesce(TDL_DISP_RECT_T *areas, uint8_t area_num)
+{
+    uint8_t i = 0, j = 0;
+    bool is_merged = true;
+
+    if (NULL == areas) {
+        return 0;
+    }
+
+    // a merge can make the bounding box overlap areas already checked, so repeat until stable
+    while (is_merged) {
+        is_merged = false;
+        for (i = 0; i < area_num; i++) {
+            for (j = i + 1; j < area_num; j++) {
+                if (false == __disp_area_should_join(&areas[i], &areas[j])) {
+                    continue;
+                }
+
+                areas[i].x0 = (areas[i].x0 < areas[j].x0) ? areas[i].x0 : areas[j].x0;
+                areas[i].y0 = (areas[i].y0 < areas[j].y0) ? areas[i].y0 : areas[j].y0;
+                areas[i].x1 = (areas[i].x1 > areas[j].x1) ? areas[i].x1 : areas[j].x1;
+                areas[i].y1 = (areas[i].y1 > areas[j].y1) ? areas[i].y1 : areas[j].y1;
+
+                areas[j] = areas[area_num - 1];
+                area_num--;
+                j--;
+                is_merged = true;
+            }
+        }
+    }
+
+    return area_num;
+}
+
 /**
  * @brief Retrieves information about a registered display device.
  *
@@ -21,6 +21,7 @@
 ************************macro define************************
 ***********************************************************/
 #define COLOR_PRIMARY_MAX 5
+#define COLOR_PRIMARY_NUM 3
 
 /***********************************************************
 ***********************typedef define***********************
@@ -29,6 +30,11 @@
 /***********************************************************
 ***********************variable define**********************
 ***********************************************************/
+/* source channel of each output channel, indexed by RGB_ORDER_MODE_E */
+static const unsigned char sg_rgb_order_map[][COLOR_PRIMARY_NUM] = {
+    [RGB_ORDER] = {0, 1, 2}, [RBG_ORDER] = {0, 2, 1}, [GRB_ORDER] = {1, 0, 2},
+    [GBR_ORDER] = {1, 2, 0}, [BRG_ORDER] = {2, 0, 1}, [BGR_ORDER] = {2, 1, 0},
+};
 
 /***********************************************************
 ***********************function define**********************
@@ -112,6 +118,49 @@ OPERATE_RET tdd_rgb_line_seq_transform(unsigned short *data_buf, unsigned short
     return OPRT_OK;
 }
 
+/**
+ * @function:tdd_rgb_frame_transform_spi_data
+ * @brief: Reorder and convert a whole frame of R/G/B data to spi data
+ * @param[in]   code_lut            spi code table, see TDD_PIXEL_SPI_CODE_LUT
+ * @param[in]   rgb_order           chip line sequence
+ * @param[in]   data_buf            color data
+ * @param[in]   pixel_num           number of pixels
+ * @param[in]   color_num           color values per pixel in data_buf
+ * @param[out]  spi_buf             Converted SPI data
+ * @return: success -> OPRT_OK
+ */
+OPERATE_RET tdd_rgb_frame_transform_spi_data(const unsigned char (*code_lut)[ONE_BYTE_LEN], RGB_ORDER_MODE_E rgb_order,
+                                             unsigned short *data_buf, unsigned int pixel_num, unsigned char color_num,
+                                             unsigned char *spi_buf)
+{
+    unsigned int j = 0;
+    unsigned char first = 0, second = 0, third = 0;
+
+    if (NULL == code_lut || NULL == data_buf || NULL == spi_buf || color_num < COLOR_PRIMARY_NUM) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (rgb_order >= CNTSOF(sg_rgb_order_map)) {
+        return OPRT_INVALID_PARM;
+    }
+
+    first = sg_rgb_order_map[rgb_order][0];
+    second = sg_rgb_order_map[rgb_order][1];
+    third = sg_rgb_order_map[rgb_order][2];
+
+    // fixed size copies compile to word loads and stores
+    for (j = 0; j < pixel_num; j++) {
+        memcpy(spi_buf, code_lut[(unsigned char)data_buf[first]], ONE_BYTE_LEN);
+        memcpy(spi_buf + ONE_BYTE_LEN, code_lut[(unsigned char)data_buf[second]], ONE_BYTE_LEN);
+        memcpy(spi_buf + 2 * ONE_BYTE_LEN, code_lut[(unsigned char)data_buf[third]], ONE_BYTE_LEN);
+
+        spi_buf += COLOR_PRIMARY_NUM * ONE_BYTE_LEN;
+        data_buf += color_num;
+    }
+
+    return OPRT_OK;
+}
+
 /**
  * @function:tdd_pixel_create_tx_ctrl
  * @brief: Create a buffer to store sending control parameters
@@ -25,6 +25,30 @@ extern "C" {
 ***********************************************************/
 #define ONE_BYTE_LEN 8
 
+/*
+ * Compile-time SPI code table: entry N holds the ONE_BYTE_LEN SPI bytes that
+ * encode color byte N, MSB first, with code_0/code_1 as the 0 and 1 bit codes.
+ * Usage: static const unsigned char lut[256][ONE_BYTE_LEN] = TDD_PIXEL_SPI_CODE_LUT(c0, c1);
+ */
+#define __SPI_CODE_BIT(v, b, c0, c1) (((v) & (0x80 >> (b))) ? (c1) : (c0))
+#define __SPI_CODE_ENTRY(v, c0, c1)                                                                                  \
+    {__SPI_CODE_BIT(v, 0, c0, c1), __SPI_CODE_BIT(v, 1, c0, c1), __SPI_CODE_BIT(v, 2, c0, c1),                       \
+     __SPI_CODE_BIT(v, 3, c0, c1), __SPI_CODE_BIT(v, 4, c0, c1), __SPI_CODE_BIT(v, 5, c0, c1),                       \
+     __SPI_CODE_BIT(v, 6, c0, c1), __SPI_CODE_BIT(v, 7, c0, c1)}
+#define __SPI_CODE_ROW4(v, c0, c1)                                                                                   \
+    __SPI_CODE_ENTRY((v), c0, c1), __SPI_CODE_ENTRY((v) + 1, c0, c1), __SPI_CODE_ENTRY((v) + 2, c0, c1),             \
+        __SPI_CODE_ENTRY((v) + 3, c0, c1)
+#define __SPI_CODE_ROW16(v, c0, c1)                                                                                  \
+    __SPI_CODE_ROW4((v), c0, c1), __SPI_CODE_ROW4((v) + 4, c0, c1), __SPI_CODE_ROW4((v) + 8, c0, c1),                \
+        __SPI_CODE_ROW4((v) + 12, c0, c1)
+#define __SPI_CODE_ROW64(v, c0, c1)                                                                                  \
+    __SPI_CODE_ROW16((v), c0, c1), __SPI_CODE_ROW16((v) + 16, c0, c1), __SPI_CODE_ROW16((v) + 32, c0, c1),           \
+        __SPI_CODE_ROW16((v) + 48, c0, c1)
+
+#define TDD_PIXEL_SPI_CODE_LUT(code_0, code_1)                                                                       \
+    {__SPI_CODE_ROW64(0, code_0, code_1), __SPI_CODE_ROW64(64, code_0, code_1),                                      \
+     __SPI_CODE_ROW64(128, code_0, code_1), __SPI_CODE_ROW64(192, code_0, code_1)}
+
 /***********************************************************
 ****************************typedef define****************************
 *********************************************************************/
@@ -61,6 +85,22 @@ void tdd_rgb_transform_spi_data(unsigned char color_data, unsigned char chip_ic_
  */
 OPERATE_RET tdd_rgb_line_seq_transform(unsigned short *data_buf, unsigned short *spi_buf, RGB_ORDER_MODE_E rgb_order);
 
+/**
+ * @brief       Convert a frame of color data to SPI data in one pass
+ *
+ * @param[in]   code_lut            SPI code table built with TDD_PIXEL_SPI_CODE_LUT
+ * @param[in]   rgb_order           RGB color order of the chip
+ * @param[in]   data_buf            Color data, color_num values per pixel with R/G/B first
+ * @param[in]   pixel_num           Number of pixels to convert
+ * @param[in]   color_num           Number of values per pixel in data_buf
+ * @param[out]  spi_buf             Converted SPI data, pixel_num * 3 * ONE_BYTE_LEN bytes
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_rgb_frame_transform_spi_data(const unsigned char (*code_lut)[ONE_BYTE_LEN], RGB_ORDER_MODE_E rgb_order,
+                                             unsigned short *data_buf, unsigned int pixel_num, unsigned char color_num,
+                                             unsigned char *spi_buf);
+
 /**
  * @brief      Create buffer for transmission control parameters
  *
@@ -40,6 +40,8 @@
 ****************************variable define***************************
 *********************************************************************/
 static PIXEL_DRIVER_CONFIG_T driver_info;
+/* SPI data of every color byte, built at compile time */
+static const unsigned char sg_spi_code_lut[256][ONE_BYTE_LEN] = TDD_PIXEL_SPI_CODE_LUT(DRVICE_DATA_0, DRVICE_DATA_1);
 /*********************************************************************
 ****************************function define***************************
 *********************************************************************/
@@ -97,8 +99,7 @@ OPERATE_RET tdd_yx1903b_driver_send_data(DRIVER_HANDLE_T handle, unsigned short
 {
     OPERATE_RET ret = OPRT_OK;
     DRV_PIXEL_TX_CTRL_T *tx_ctrl = NULL;
-    unsigned short swap_buf[COLOR_PRIMARY_NUM] = {0};
-    unsigned int i = 0, j = 0, idx = 0;
+    unsigned int pixel_num = 0;
 
     if (NULL == handle || NULL == data_buf || 0 == buf_len) {
         return OPRT_INVALID_PARM;
@@ -106,14 +107,15 @@ OPERATE_RET tdd_yx1903b_driver_send_data(DRIVER_HANDLE_T handle, unsigned short
 
     tx_ctrl = (DRV_PIXEL_TX_CTRL_T *)handle;
 
-    for (j = 0; j < buf_len / COLOR_PRIMARY_NUM; j++) {
-        memset(swap_buf, 0, sizeof(swap_buf));
-        tdd_rgb_line_seq_transform(&data_buf[j * COLOR_PRIMARY_NUM], swap_buf, driver_info.line_seq);
-        for (i = 0; i < COLOR_PRIMARY_NUM; i++) {
-            tdd_rgb_transform_spi_data((unsigned char)swap_buf[i], DRVICE_DATA_0, DRVICE_DATA_1,
-                                       &tx_ctrl->tx_buffer[idx]);
-            idx += ONE_BYTE_LEN;
-        }
+    pixel_num = buf_len / COLOR_PRIMARY_NUM;
+    if (pixel_num > tx_ctrl->tx_buffer_len / (COLOR_PRIMARY_NUM * ONE_BYTE_LEN)) {
+        pixel_num = tx_ctrl->tx_buffer_len / (COLOR_PRIMARY_NUM * ONE_BYTE_LEN);
+    }
+
+    ret = tdd_rgb_frame_transform_spi_data(sg_spi_code_lut, driver_info.line_seq, data_buf, pixel_num, COLOR_PRIMARY_NUM,
+                                           tx_ctrl->tx_buffer);
+    if (OPRT_OK != ret) {
+        return ret;
     }
 
     ret = tkl_spi_send(driver_info.port, tx_ctrl->tx_buffer, tx_ctrl->tx_buffer_len);
@@ -0,0 +1,144 @@
+/**
+ * @file tdl_pixel_matrix.h
+ * @brief TDL layer frame buffer interface for LED pixel matrices
+ *
+ * This header file provides a 2D frame buffer on top of an opened LED pixel device.
+ * Applications draw RGB888 frames in matrix coordinates; the module maps them to the
+ * strip wiring (progressive or serpentine rows), applies a gamma and brightness table
+ * and refreshes the device from its own thread. Two frame buffers are used so the next
+ * frame can be drawn while the previous one is being transmitted.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __TDL_PIXEL_MATRIX_H__
+#define __TDL_PIXEL_MATRIX_H__
+
+#include "tdl_pixel_dev_manage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+******************************macro define****************************
+*********************************************************************/
+#define PIXEL_MATRIX_BPP 3 // bytes per pixel in the frame buffer, R G B
+
+/*********************************************************************
+****************************typedef define****************************
+*********************************************************************/
+typedef unsigned char PIXEL_MATRIX_LAYOUT_E;
+#define PIXEL_MATRIX_LAYOUT_PROGRESSIVE 0x00 // every row is wired left to right
+#define PIXEL_MATRIX_LAYOUT_SERPENTINE  0x01 // odd rows are wired right to left
+
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint32_t start_index;         // index of the first matrix led on the strip
+    PIXEL_MATRIX_LAYOUT_E layout;
+    float gamma;                  // 1.0 for linear output, typically 2.2
+    uint8_t brightness;           // 0-255, applied to every channel
+} PIXEL_MATRIX_CFG_T;
+
+typedef void *PIXEL_MATRIX_HANDLE_T;
+
+/*********************************************************************
+****************************function define***************************
+*********************************************************************/
+/**
+ * @brief        Create a matrix frame buffer on an opened pixel device
+ *
+ * @param[in]    pixel_hdl        Pixel device handle, must be opened
+ * @param[in]    cfg              Matrix configuration
+ * @param[out]   handle           Matrix handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_matrix_create(PIXEL_HANDLE_T pixel_hdl, PIXEL_MATRIX_CFG_T *cfg, PIXEL_MATRIX_HANDLE_T *handle);
+
+/**
+ * @brief        Destroy a matrix frame buffer, waiting for the frame in flight
+ *
+ * @param[in]    handle           Matrix handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_matrix_destroy(PIXEL_MATRIX_HANDLE_T handle);
+
+/**
+ * @brief        Get the frame buffer being drawn
+ *
+ * The buffer is width * height * PIXEL_MATRIX_BPP bytes, row by row, and holds a copy
+ * of the last presented frame. It stays valid until the next present.
+ *
+ * @param[in]    handle           Matrix handle
+ *
+ * @return frame buffer, NULL on error
+ */
+uint8_t *tdl_pixel_matrix_get_frame(PIXEL_MATRIX_HANDLE_T handle);
+
+/**
+ * @brief        Set a pixel of the frame being drawn
+ *
+ * @param[in]    handle           Matrix handle
+ * @param[in]    x                Column, pixels outside the matrix are ignored
+ * @param[in]    y                Row, pixels outside the matrix are ignored
+ * @param[in]    red              Red value (0-255)
+ * @param[in]    green            Green value (0-255)
+ * @param[in]    blue             Blue value (0-255)
+ *
+ * @return none
+ */
+void tdl_pixel_matrix_set_pixel(PIXEL_MATRIX_HANDLE_T handle, int32_t x, int32_t y, uint8_t red, uint8_t green,
+                                uint8_t blue);
+
+/**
+ * @brief        Fill the frame being drawn with one color
+ *
+ * @param[in]    handle           Matrix handle
+ * @param[in]    red              Red value (0-255)
+ * @param[in]    green            Green value (0-255)
+ * @param[in]    blue             Blue value (0-255)
+ *
+ * @return none
+ */
+void tdl_pixel_matrix_fill(PIXEL_MATRIX_HANDLE_T handle, uint8_t red, uint8_t green, uint8_t blue);
+
+/**
+ * @brief        Hand the drawn frame over for display
+ *
+ * Waits until the previous frame has been sent, then swaps the buffers and returns;
+ * the frame is encoded and transmitted by the matrix thread.
+ *
+ * @param[in]    handle           Matrix handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_matrix_present(PIXEL_MATRIX_HANDLE_T handle);
+
+/**
+ * @brief        Set the brightness, effective from the next presented frame
+ *
+ * @param[in]    handle           Matrix handle
+ * @param[in]    brightness       Brightness (0-255)
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_matrix_set_brightness(PIXEL_MATRIX_HANDLE_T handle, uint8_t brightness);
+
+/**
+ * @brief        Set the gamma, effective from the next presented frame
+ *
+ * @param[in]    handle           Matrix handle
+ * @param[in]    gamma            Gamma exponent, 1.0 for linear output
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_matrix_set_gamma(PIXEL_MATRIX_HANDLE_T handle, float gamma);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /*__TDL_PIXEL_MATRIX_H__*/
@@ -0,0 +1,176 @@
+/**
+ * @file tdl_pixel_render3d.h
+ * @brief TDL layer fixed-point 3D point renderer for LED pixel matrices
+ *
+ * This header file provides a small integer-only 3D pipeline for matrix effects:
+ * Q15 sine/cosine lookup, rotation matrices built from binary angles, batched point
+ * transforms and depth sorted splatting of point clouds into an RGB888 frame such as
+ * the one returned by tdl_pixel_matrix_get_frame(). Point colors come from a 256-entry
+ * palette, so per-frame color changes only touch the palette, not the points.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __TDL_PIXEL_RENDER3D_H__
+#define __TDL_PIXEL_RENDER3D_H__
+
+#include "tdl_pixel_matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+******************************macro define****************************
+*********************************************************************/
+#define PIXEL_R3D_Q15_ONE      32767   // 1.0 in Q15
+#define PIXEL_R3D_ANGLE_TURN   0x10000 // binary angle of one full turn, uint16_t angles wrap naturally
+#define PIXEL_R3D_COORD_SHIFT  8       // point coordinates are pixels in Q8
+#define PIXEL_R3D_COORD_ONE    (1 << PIXEL_R3D_COORD_SHIFT)
+#define PIXEL_R3D_PALETTE_SIZE 256
+#define PIXEL_R3D_POINT_MAX    0xFFFF
+
+#define PIXEL_R3D_ANGLE_FROM_RAD(rad) ((uint16_t)(int32_t)((rad) * (PIXEL_R3D_ANGLE_TURN / 6.28318530718f)))
+
+/*********************************************************************
+****************************typedef define****************************
+*********************************************************************/
+typedef unsigned char PIXEL_R3D_BLEND_E;
+#define PIXEL_R3D_BLEND_REPLACE 0x00 // nearer points overwrite farther ones
+#define PIXEL_R3D_BLEND_ADD     0x01 // points are summed, saturating at 255
+
+typedef struct {
+    int16_t x; // right on the matrix
+    int16_t y; // down on the matrix
+    int16_t z; // towards the viewer
+} PIXEL_R3D_VEC_T;
+
+typedef struct {
+    int16_t m[3][3]; // rotation, Q15
+    int16_t t[3];    // translation added after the rotation, Q8 pixels
+} PIXEL_R3D_MAT_T;
+
+typedef struct {
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+} PIXEL_R3D_COLOR_T;
+
+typedef struct {
+    int16_t center_x;   // matrix position of the view origin, Q8 pixels
+    int16_t center_y;
+    uint16_t scale;     // Q8, PIXEL_R3D_COORD_ONE maps one point unit to one matrix pixel
+    uint16_t focal;     // camera distance from z = 0 in pixels, 0 for orthographic projection
+    int16_t depth_near; // z (Q8) drawn at full brightness
+    int16_t depth_far;  // z (Q8) drawn at shade_far
+    uint8_t shade_far;  // brightness (0-255) at depth_far, 255 disables depth shading
+    PIXEL_R3D_BLEND_E blend;
+} PIXEL_R3D_VIEW_T;
+
+typedef struct {
+    uint16_t width;     // frame width in pixels
+    uint16_t height;    // frame height in pixels
+    uint32_t point_max; // points per splat, at most PIXEL_R3D_POINT_MAX
+} PIXEL_R3D_CFG_T;
+
+typedef void *PIXEL_R3D_HANDLE_T;
+
+/*********************************************************************
+****************************function define***************************
+*********************************************************************/
+/**
+ * @brief        Sine of a binary angle
+ *
+ * @param[in]    angle            Angle, PIXEL_R3D_ANGLE_TURN per turn
+ *
+ * @return sine in Q15
+ */
+int16_t tdl_pixel_r3d_sin(uint16_t angle);
+
+/**
+ * @brief        Cosine of a binary angle
+ *
+ * @param[in]    angle            Angle, PIXEL_R3D_ANGLE_TURN per turn
+ *
+ * @return cosine in Q15
+ */
+int16_t tdl_pixel_r3d_cos(uint16_t angle);
+
+/**
+ * @brief        Build a rotation around the X, then Y, then Z axis, without translation
+ *
+ * @param[out]   mat              Rotation matrix
+ * @param[in]    angle_x          Angle around the X axis
+ * @param[in]    angle_y          Angle around the Y axis
+ * @param[in]    angle_z          Angle around the Z axis
+ *
+ * @return none
+ */
+void tdl_pixel_r3d_rotation(PIXEL_R3D_MAT_T *mat, uint16_t angle_x, uint16_t angle_y, uint16_t angle_z);
+
+/**
+ * @brief        Transform a batch of points
+ *
+ * @param[in]    mat              Transform matrix
+ * @param[in]    in               Source points
+ * @param[out]   out              Transformed points, may be the same array as in
+ * @param[in]    num              Number of points
+ *
+ * @return none
+ */
+void tdl_pixel_r3d_transform(const PIXEL_R3D_MAT_T *mat, const PIXEL_R3D_VEC_T *in, PIXEL_R3D_VEC_T *out,
+                             uint32_t num);
+
+/**
+ * @brief        Create a point renderer
+ *
+ * @param[in]    cfg              Renderer configuration
+ * @param[out]   handle           Renderer handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_r3d_create(PIXEL_R3D_CFG_T *cfg, PIXEL_R3D_HANDLE_T *handle);
+
+/**
+ * @brief        Destroy a point renderer
+ *
+ * @param[in]    handle           Renderer handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_r3d_destroy(PIXEL_R3D_HANDLE_T handle);
+
+/**
+ * @brief        Set the projection, depth shading and blending used by the next splats
+ *
+ * @param[in]    handle           Renderer handle
+ * @param[in]    view             View configuration
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_r3d_set_view(PIXEL_R3D_HANDLE_T handle, PIXEL_R3D_VIEW_T *view);
+
+/**
+ * @brief        Project points and draw them far to near into a frame
+ *
+ * Every point lights one pixel with its palette color scaled by the depth shade.
+ * Points outside the frame or behind the camera are skipped. Points are ordered by
+ * depth at one pixel resolution with a counting sort, so the cost is linear in num.
+ *
+ * @param[in]    handle           Renderer handle
+ * @param[inout] frame            RGB888 frame, width * height * PIXEL_MATRIX_BPP bytes
+ * @param[in]    point            Points in view space
+ * @param[in]    color_idx        Palette index of every point
+ * @param[in]    num              Number of points, at most point_max
+ * @param[in]    palette          PIXEL_R3D_PALETTE_SIZE colors
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_r3d_splat(PIXEL_R3D_HANDLE_T handle, uint8_t *frame, const PIXEL_R3D_VEC_T *point,
+                                const uint8_t *color_idx, uint32_t num, const PIXEL_R3D_COLOR_T *palette);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /*__TDL_PIXEL_RENDER3D_H__*/
@@ -0,0 +1,414 @@
+/**
+ * @file tdl_pixel_matrix.c
+ * @brief TDL layer frame buffer implementation for LED pixel matrices
+ *
+ * This source file implements a double buffered 2D frame buffer on top of an LED pixel
+ * device. Presented frames are converted in one pass, through a precomputed led index
+ * map and a gamma/brightness table, into the device pixel buffer and refreshed from a
+ * dedicated thread, while the application draws the next frame.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+#include <string.h>
+#include <math.h>
+
+#include "tal_log.h"
+#include "tal_memory.h"
+#include "tal_thread.h"
+#include "tdl_pixel_matrix.h"
+
+/***********************************************************
+*************************private include********************
+***********************************************************/
+#include "tdl_pixel_struct.h"
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define PIXEL_MATRIX_THREAD_STACK (2 * 1024)
+#define PIXEL_MATRIX_FRAME_NUM    2
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    PIXEL_DEV_NODE_T *device;
+    uint16_t width;
+    uint16_t height;
+    uint32_t frame_size;
+
+    uint16_t *led_map;       // strip index of every matrix pixel, row by row
+    uint16_t color_lut[256]; // 8-bit value -> driver value, gamma and brightness applied
+    float gamma;
+    uint8_t brightness;
+
+    uint8_t *frame[PIXEL_MATRIX_FRAME_NUM];
+    uint8_t draw_idx;
+
+    BOOL_T is_stop;
+    SEM_HANDLE frame_sem; // a frame is waiting to be sent
+    SEM_HANDLE idle_sem;  // the matrix thread is done with the last frame
+    THREAD_HANDLE thread;
+} PIXEL_MATRIX_T;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static void __tdl_pixel_matrix_build_lut(PIXEL_MATRIX_T *matrix)
+{
+    float scale = (float)matrix->device->color_maximum * matrix->brightness / 255.0f;
+
+    for (uint32_t i = 0; i < 256; i++) {
+        matrix->color_lut[i] = (uint16_t)(powf(i / 255.0f, matrix->gamma) * scale + 0.5f);
+    }
+}
+
+static OPERATE_RET __tdl_pixel_matrix_build_map(PIXEL_MATRIX_T *matrix, uint32_t start_index,
+                                                PIXEL_MATRIX_LAYOUT_E layout)
+{
+    uint32_t x = 0, y = 0, led = 0;
+
+    matrix->led_map = (uint16_t *)tal_malloc(matrix->width * matrix->height * sizeof(uint16_t));
+    if (NULL == matrix->led_map) {
+        return OPRT_MALLOC_FAILED;
+    }
+
+    for (y = 0; y < matrix->height; y++) {
+        for (x = 0; x < matrix->width; x++) {
+            if (PIXEL_MATRIX_LAYOUT_SERPENTINE == layout && (y & 0x01)) {
+                led = start_index + y * matrix->width + (matrix->width - 1 - x);
+            } else {
+                led = start_index + y * matrix->width + x;
+            }
+            matrix->led_map[y * matrix->width + x] = (uint16_t)led;
+        }
+    }
+
+    return OPRT_OK;
+}
+
+static void __tdl_pixel_matrix_convert(PIXEL_MATRIX_T *matrix, const uint8_t *frame)
+{
+    PIXEL_DEV_NODE_T *device = matrix->device;
+    uint32_t pixel_cnt = matrix->width * matrix->height;
+    uint16_t *dst = NULL;
+
+    tal_mutex_lock(device->mutex);
+
+    for (uint32_t i = 0; i < pixel_cnt; i++) {
+        dst = &device->pixel_buffer[matrix->led_map[i] * device->color_num];
+        dst[0] = matrix->color_lut[frame[0]];
+        dst[1] = matrix->color_lut[frame[1]];
+        dst[2] = matrix->color_lut[frame[2]];
+        frame += PIXEL_MATRIX_BPP;
+    }
+
+    tal_mutex_unlock(device->mutex);
+}
+
+static void __tdl_pixel_matrix_task(void *args)
+{
+    PIXEL_MATRIX_T *matrix = (PIXEL_MATRIX_T *)args;
+    OPERATE_RET rt = OPRT_OK;
+
+    while (1) {
+        tal_semaphore_wait(matrix->frame_sem, SEM_WAIT_FOREVER);
+        if (matrix->is_stop) {
+            break;
+        }
+
+        // the frame that is not being drawn is the one to send
+        __tdl_pixel_matrix_convert(matrix, matrix->frame[matrix->draw_idx ^ 0x01]);
+
+        rt = tdl_pixel_dev_refresh((PIXEL_HANDLE_T)matrix->device);
+        if (OPRT_OK != rt) {
+            PR_ERR("pixel matrix refresh err:%d", rt);
+        }
+
+        tal_semaphore_post(matrix->idle_sem);
+    }
+
+    tal_semaphore_post(matrix->idle_sem);
+}
+
+static void __tdl_pixel_matrix_free(PIXEL_MATRIX_T *matrix)
+{
+    if (matrix->frame_sem) {
+        tal_semaphore_release(matrix->frame_sem);
+    }
+
+    if (matrix->idle_sem) {
+        tal_semaphore_release(matrix->idle_sem);
+    }
+
+    for (uint8_t i = 0; i < PIXEL_MATRIX_FRAME_NUM; i++) {
+        if (matrix->frame[i]) {
+            tal_free(matrix->frame[i]);
+        }
+    }
+
+    if (matrix->led_map) {
+        tal_free(matrix->led_map);
+    }
+
+    tal_free(matrix);
+}
+
+/**
+ * @brief        Create a matrix frame buffer on an opened pixel device
+ *
+ * @param[in]    pixel_hdl        Pixel device handle, must be opened
+ * @param[in]    cfg              Matrix configuration
+ * @param[out]   handle           Matrix handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_matrix_create(PIXEL_HANDLE_T pixel_hdl, PIXEL_MATRIX_CFG_T *cfg, PIXEL_MATRIX_HANDLE_T *handle)
+{
+    OPERATE_RET rt = OPRT_OK;
+    PIXEL_DEV_NODE_T *device = (PIXEL_DEV_NODE_T *)pixel_hdl;
+    PIXEL_MATRIX_T *matrix = NULL;
+    uint32_t pixel_cnt = 0;
+
+    if (NULL == device || NULL == cfg || NULL == handle || 0 == cfg->width || 0 == cfg->height) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (0 == device->flag.is_start) {
+        PR_ERR("pixel device is not open");
+        return OPRT_COM_ERROR;
+    }
+
+    pixel_cnt = cfg->width * cfg->height;
+    if (cfg->start_index + pixel_cnt > device->pixel_num || cfg->start_index + pixel_cnt > 0xFFFF) {
+        PR_ERR("matrix %dx%d at %d exceeds %d pixels", cfg->width, cfg->height, cfg->start_index, device->pixel_num);
+        return OPRT_INVALID_PARM;
+    }
+
+    matrix = (PIXEL_MATRIX_T *)tal_malloc(sizeof(PIXEL_MATRIX_T));
+    if (NULL == matrix) {
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(matrix, 0, sizeof(PIXEL_MATRIX_T));
+
+    matrix->device = device;
+    matrix->width = cfg->width;
+    matrix->height = cfg->height;
+    matrix->frame_size = pixel_cnt * PIXEL_MATRIX_BPP;
+    matrix->gamma = (cfg->gamma > 0.0f) ? cfg->gamma : 1.0f;
+    matrix->brightness = cfg->brightness;
+
+    TUYA_CALL_ERR_GOTO(__tdl_pixel_matrix_build_map(matrix, cfg->start_index, cfg->layout), __ERR);
+    __tdl_pixel_matrix_build_lut(matrix);
+
+    for (uint8_t i = 0; i < PIXEL_MATRIX_FRAME_NUM; i++) {
+        matrix->frame[i] = (uint8_t *)tal_malloc(matrix->frame_size);
+        if (NULL == matrix->frame[i]) {
+            rt = OPRT_MALLOC_FAILED;
+            goto __ERR;
+        }
+        memset(matrix->frame[i], 0, matrix->frame_size);
+    }
+
+    TUYA_CALL_ERR_GOTO(tal_semaphore_create_init(&matrix->frame_sem, 0, 1), __ERR);
+    TUYA_CALL_ERR_GOTO(tal_semaphore_create_init(&matrix->idle_sem, 1, 1), __ERR);
+
+    THREAD_CFG_T thread_cfg = {
+        .stackDepth = PIXEL_MATRIX_THREAD_STACK,
+        .priority = THREAD_PRIO_1,
+        .thrdname = "pixel_matrix",
+    };
+    TUYA_CALL_ERR_GOTO(
+        tal_thread_create_and_start(&matrix->thread, NULL, NULL, __tdl_pixel_matrix_task, matrix, &thread_cfg), __ERR);
+
+    *handle = (PIXEL_MATRIX_HANDLE_T)matrix;
+
+    return OPRT_OK;
+
+__ERR:
+    __tdl_pixel_matrix_free(matrix);
+
+    return rt;
+}
+
+/**
+ * @brief        Destroy a matrix frame buffer, waiting for the frame in flight
+ *
+ * @param[in]    handle           Matrix handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_matrix_destroy(PIXEL_MATRIX_HANDLE_T handle)
+{
+    PIXEL_MATRIX_T *matrix = (PIXEL_MATRIX_T *)handle;
+
+    if (NULL == matrix) {
+        return OPRT_INVALID_PARM;
+    }
+
+    // wait for the frame in flight, then let the thread leave its loop
+    tal_semaphore_wait(matrix->idle_sem, SEM_WAIT_FOREVER);
+    matrix->is_stop = TRUE;
+    tal_semaphore_post(matrix->frame_sem);
+    tal_semaphore_wait(matrix->idle_sem, SEM_WAIT_FOREVER);
+
+    tal_thread_delete(matrix->thread);
+    __tdl_pixel_matrix_free(matrix);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief        Get the frame buffer being drawn
+ *
+ * @param[in]    handle           Matrix handle
+ *
+ * @return frame buffer, NULL on error
+ */
+uint8_t *tdl_pixel_matrix_get_frame(PIXEL_MATRIX_HANDLE_T handle)
+{
+    PIXEL_MATRIX_T *matrix = (PIXEL_MATRIX_T *)handle;
+
+    if (NULL == matrix) {
+        return NULL;
+    }
+
+    return matrix->frame[matrix->draw_idx];
+}
+
+/**
+ * @brief        Set a pixel of the frame being drawn
+ *
+ * @param[in]    handle           Matrix handle
+ * @param[in]    x                Column
+ * @param[in]    y                Row
+ * @param[in]    red              Red value (0-255)
+ * @param[in]    green            Green value (0-255)
+ * @param[in]    blue             Blue value (0-255)
+ *
+ * @return none
+ */
+void tdl_pixel_matrix_set_pixel(PIXEL_MATRIX_HANDLE_T handle, int32_t x, int32_t y, uint8_t red, uint8_t green,
+                                uint8_t blue)
+{
+    PIXEL_MATRIX_T *matrix = (PIXEL_MATRIX_T *)handle;
+    uint8_t *pixel = NULL;
+
+    if (NULL == matrix || x < 0 || y < 0 || x >= matrix->width || y >= matrix->height) {
+        return;
+    }
+
+    pixel = matrix->frame[matrix->draw_idx] + (y * matrix->width + x) * PIXEL_MATRIX_BPP;
+    pixel[0] = red;
+    pixel[1] = green;
+    pixel[2] = blue;
+}
+
+/**
+ * @brief        Fill the frame being drawn with one color
+ *
+ * @param[in]    handle           Matrix handle
+ * @param[in]    red              Red value (0-255)
+ * @param[in]    green            Green value (0-255)
+ * @param[in]    blue             Blue value (0-255)
+ *
+ * @return none
+ */
+void tdl_pixel_matrix_fill(PIXEL_MATRIX_HANDLE_T handle, uint8_t red, uint8_t green, uint8_t blue)
+{
+    PIXEL_MATRIX_T *matrix = (PIXEL_MATRIX_T *)handle;
+    uint8_t *pixel = NULL;
+
+    if (NULL == matrix) {
+        return;
+    }
+
+    if (red == green && green == blue) {
+        memset(matrix->frame[matrix->draw_idx], red, matrix->frame_size);
+        return;
+    }
+
+    pixel = matrix->frame[matrix->draw_idx];
+    for (uint32_t i = 0; i < matrix->frame_size; i += PIXEL_MATRIX_BPP) {
+        pixel[i] = red;
+        pixel[i + 1] = green;
+        pixel[i + 2] = blue;
+    }
+}
+
+/**
+ * @brief        Hand the drawn frame over for display
+ *
+ * @param[in]    handle           Matrix handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_matrix_present(PIXEL_MATRIX_HANDLE_T handle)
+{
+    PIXEL_MATRIX_T *matrix = (PIXEL_MATRIX_T *)handle;
+    uint8_t *sent = NULL;
+
+    if (NULL == matrix) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_semaphore_wait(matrix->idle_sem, SEM_WAIT_FOREVER);
+
+    sent = matrix->frame[matrix->draw_idx];
+    matrix->draw_idx ^= 0x01;
+    // keep drawing on top of the presented frame, the thread only reads it
+    memcpy(matrix->frame[matrix->draw_idx], sent, matrix->frame_size);
+
+    tal_semaphore_post(matrix->frame_sem);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief        Set the brightness, effective from the next presented frame
+ *
+ * @param[in]    handle           Matrix handle
+ * @param[in]    brightness       Brightness (0-255)
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_matrix_set_brightness(PIXEL_MATRIX_HANDLE_T handle, uint8_t brightness)
+{
+    PIXEL_MATRIX_T *matrix = (PIXEL_MATRIX_T *)handle;
+
+    if (NULL == matrix) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_semaphore_wait(matrix->idle_sem, SEM_WAIT_FOREVER);
+    matrix->brightness = brightness;
+    __tdl_pixel_matrix_build_lut(matrix);
+    tal_semaphore_post(matrix->idle_sem);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief        Set the gamma, effective from the next presented frame
+ *
+ * @param[in]    handle           Matrix handle
+ * @param[in]    gamma            Gamma exponent, 1.0 for linear output
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_matrix_set_gamma(PIXEL_MATRIX_HANDLE_T handle, float gamma)
+{
+    PIXEL_MATRIX_T *matrix = (PIXEL_MATRIX_T *)handle;
+
+    if (NULL == matrix || gamma <= 0.0f) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_semaphore_wait(matrix->idle_sem, SEM_WAIT_FOREVER);
+    matrix->gamma = gamma;
+    __tdl_pixel_matrix_build_lut(matrix);
+    tal_semaphore_post(matrix->idle_sem);
+
+    return OPRT_OK;
+}
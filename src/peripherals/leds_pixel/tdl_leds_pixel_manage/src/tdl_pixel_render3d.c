@@ -0,0 +1,444 @@
+/**
+ * @file tdl_pixel_render3d.c
+ * @brief TDL layer fixed-point 3D point renderer for LED pixel matrices
+ *
+ * This source file implements the integer 3D pipeline: an interpolated quarter wave
+ * Q15 sine table, rotation matrices and batched point transforms in Q15, and a splat
+ * pass that projects points, orders them by depth with a counting sort and draws them
+ * far to near with palette colors and a per-depth shade table.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+#include <string.h>
+
+#include "tal_log.h"
+#include "tal_memory.h"
+#include "tdl_pixel_render3d.h"
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define PIXEL_R3D_SIN_STEPS     256 // table steps per quarter turn
+#define PIXEL_R3D_DEPTH_BUCKETS 256 // one bucket per pixel of depth, z = 0 at the middle
+#define PIXEL_R3D_CLIPPED       0xFFFF
+
+#define PIXEL_R3D_Q15_MUL(a, b) ((int16_t)(((int32_t)(a) * (b) + (1 << 14)) >> 15))
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint32_t point_max;
+
+    PIXEL_R3D_VIEW_T view;
+    uint8_t shade_lut[PIXEL_R3D_DEPTH_BUCKETS];
+    uint32_t bucket_start[PIXEL_R3D_DEPTH_BUCKETS];
+
+    uint16_t *pixel; // frame pixel of every point, PIXEL_R3D_CLIPPED when not drawn
+    uint8_t *depth;  // depth bucket of every point
+    uint16_t *order; // drawn points, far to near
+} PIXEL_R3D_T;
+
+/***********************************************************
+***********************const define*************************
+***********************************************************/
+// sin(i * pi / 512) in Q15, one quarter turn
+static const int16_t sg_sin_lut[PIXEL_R3D_SIN_STEPS + 1] = {
+    0,     201,   402,   603,   804,   1005,  1206,  1407,  1608,  1809,  2009,  2210,  2410,  2611,  2811,
+    3012,  3212,  3412,  3612,  3811,  4011,  4210,  4410,  4609,  4808,  5007,  5205,  5404,  5602,  5800,
+    5998,  6195,  6393,  6590,  6786,  6983,  7179,  7375,  7571,  7767,  7962,  8157,  8351,  8545,  8739,
+    8933,  9126,  9319,  9512,  9704,  9896,  10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828, 14010, 14191, 14372,
+    14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976, 16151, 16325, 16499, 16673, 16846, 17018,
+    17189, 17360, 17530, 17700, 17869, 18037, 18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519,
+    19680, 19841, 20000, 20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+    22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592, 23731, 23870, 24007,
+    24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201, 25329, 25456, 25582, 25708, 25832, 25955,
+    26077, 26198, 26319, 26438, 26556, 26674, 26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683,
+    27790, 27896, 28001, 28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+    29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195, 30273, 30349, 30424,
+    30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050, 31113, 31176, 31237, 31297, 31356, 31414,
+    31470, 31526, 31580, 31633, 31685, 31736, 31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137,
+    32176, 32213, 32250, 32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+    32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752, 32757, 32761, 32765,
+    32766, 32767,
+};
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static int16_t __tdl_pixel_r3d_clamp_q15(int32_t value)
+{
+    if (value > PIXEL_R3D_Q15_ONE) {
+        return PIXEL_R3D_Q15_ONE;
+    }
+    if (value < -PIXEL_R3D_Q15_ONE) {
+        return -PIXEL_R3D_Q15_ONE;
+    }
+    return (int16_t)value;
+}
+
+// pos is the angle within the first quarter turn, 0 - PIXEL_R3D_ANGLE_TURN / 4 inclusive
+static int16_t __tdl_pixel_r3d_sin_quarter(uint32_t pos)
+{
+    uint32_t idx = pos >> 6; // 64 binary angle units per table step
+    int32_t frac = pos & 0x3F;
+
+    if (idx >= PIXEL_R3D_SIN_STEPS) {
+        return sg_sin_lut[PIXEL_R3D_SIN_STEPS];
+    }
+
+    return (int16_t)(sg_sin_lut[idx] + (((sg_sin_lut[idx + 1] - sg_sin_lut[idx]) * frac + 32) >> 6));
+}
+
+static void __tdl_pixel_r3d_build_shade(PIXEL_R3D_T *r3d)
+{
+    PIXEL_R3D_VIEW_T *view = &r3d->view;
+    int32_t z_near = view->depth_near >> PIXEL_R3D_COORD_SHIFT;
+    int32_t z_far = view->depth_far >> PIXEL_R3D_COORD_SHIFT;
+    int32_t z = 0, shade = 0;
+
+    for (uint32_t i = 0; i < PIXEL_R3D_DEPTH_BUCKETS; i++) {
+        z = (int32_t)i - PIXEL_R3D_DEPTH_BUCKETS / 2;
+
+        if (z_near == z_far || 255 == view->shade_far) {
+            shade = 255;
+        } else {
+            // linear from shade_far at depth_far to 255 at depth_near, clamped outside
+            shade = view->shade_far + (255 - view->shade_far) * (z - z_far) / (z_near - z_far);
+            if (shade < view->shade_far) {
+                shade = view->shade_far;
+            } else if (shade > 255) {
+                shade = 255;
+            }
+        }
+        r3d->shade_lut[i] = (uint8_t)shade;
+    }
+}
+
+static void __tdl_pixel_r3d_free(PIXEL_R3D_T *r3d)
+{
+    if (NULL == r3d) {
+        return;
+    }
+
+    if (r3d->pixel) {
+        tal_free(r3d->pixel);
+    }
+    if (r3d->depth) {
+        tal_free(r3d->depth);
+    }
+    if (r3d->order) {
+        tal_free(r3d->order);
+    }
+    tal_free(r3d);
+}
+
+/**
+ * @brief        Sine of a binary angle
+ *
+ * @param[in]    angle            Angle, PIXEL_R3D_ANGLE_TURN per turn
+ *
+ * @return sine in Q15
+ */
+int16_t tdl_pixel_r3d_sin(uint16_t angle)
+{
+    uint32_t pos = angle & (PIXEL_R3D_ANGLE_TURN / 4 - 1);
+
+    switch (angle >> 14) {
+    case 0:
+        return __tdl_pixel_r3d_sin_quarter(pos);
+    case 1:
+        return __tdl_pixel_r3d_sin_quarter(PIXEL_R3D_ANGLE_TURN / 4 - pos);
+    case 2:
+        return -__tdl_pixel_r3d_sin_quarter(pos);
+    default:
+        return -__tdl_pixel_r3d_sin_quarter(PIXEL_R3D_ANGLE_TURN / 4 - pos);
+    }
+}
+
+/**
+ * @brief        Cosine of a binary angle
+ *
+ * @param[in]    angle            Angle, PIXEL_R3D_ANGLE_TURN per turn
+ *
+ * @return cosine in Q15
+ */
+int16_t tdl_pixel_r3d_cos(uint16_t angle)
+{
+    return tdl_pixel_r3d_sin((uint16_t)(angle + PIXEL_R3D_ANGLE_TURN / 4));
+}
+
+/**
+ * @brief        Build a rotation around the X, then Y, then Z axis, without translation
+ *
+ * @param[out]   mat              Rotation matrix
+ * @param[in]    angle_x          Angle around the X axis
+ * @param[in]    angle_y          Angle around the Y axis
+ * @param[in]    angle_z          Angle around the Z axis
+ *
+ * @return none
+ */
+void tdl_pixel_r3d_rotation(PIXEL_R3D_MAT_T *mat, uint16_t angle_x, uint16_t angle_y, uint16_t angle_z)
+{
+    int16_t sx = 0, cx = 0, sy = 0, cy = 0, sz = 0, cz = 0;
+    int16_t sy_sx = 0, sy_cx = 0;
+
+    if (NULL == mat) {
+        return;
+    }
+
+    sx = tdl_pixel_r3d_sin(angle_x), cx = tdl_pixel_r3d_cos(angle_x);
+    sy = tdl_pixel_r3d_sin(angle_y), cy = tdl_pixel_r3d_cos(angle_y);
+    sz = tdl_pixel_r3d_sin(angle_z), cz = tdl_pixel_r3d_cos(angle_z);
+    sy_sx = PIXEL_R3D_Q15_MUL(sy, sx);
+    sy_cx = PIXEL_R3D_Q15_MUL(sy, cx);
+
+    // Rz * Ry * Rx
+    mat->m[0][0] = PIXEL_R3D_Q15_MUL(cz, cy);
+    mat->m[0][1] = __tdl_pixel_r3d_clamp_q15(PIXEL_R3D_Q15_MUL(cz, sy_sx) - PIXEL_R3D_Q15_MUL(sz, cx));
+    mat->m[0][2] = __tdl_pixel_r3d_clamp_q15(PIXEL_R3D_Q15_MUL(cz, sy_cx) + PIXEL_R3D_Q15_MUL(sz, sx));
+    mat->m[1][0] = PIXEL_R3D_Q15_MUL(sz, cy);
+    mat->m[1][1] = __tdl_pixel_r3d_clamp_q15(PIXEL_R3D_Q15_MUL(sz, sy_sx) + PIXEL_R3D_Q15_MUL(cz, cx));
+    mat->m[1][2] = __tdl_pixel_r3d_clamp_q15(PIXEL_R3D_Q15_MUL(sz, sy_cx) - PIXEL_R3D_Q15_MUL(cz, sx));
+    mat->m[2][0] = -sy;
+    mat->m[2][1] = PIXEL_R3D_Q15_MUL(cy, sx);
+    mat->m[2][2] = PIXEL_R3D_Q15_MUL(cy, cx);
+
+    mat->t[0] = 0;
+    mat->t[1] = 0;
+    mat->t[2] = 0;
+}
+
+/**
+ * @brief        Transform a batch of points
+ *
+ * @param[in]    mat              Transform matrix
+ * @param[in]    in               Source points
+ * @param[out]   out              Transformed points, may be the same array as in
+ * @param[in]    num              Number of points
+ *
+ * @return none
+ */
+void tdl_pixel_r3d_transform(const PIXEL_R3D_MAT_T *mat, const PIXEL_R3D_VEC_T *in, PIXEL_R3D_VEC_T *out,
+                             uint32_t num)
+{
+    int32_t m00, m01, m02, m10, m11, m12, m20, m21, m22;
+    int32_t x = 0, y = 0, z = 0;
+
+    if (NULL == mat || NULL == in || NULL == out) {
+        return;
+    }
+
+    m00 = mat->m[0][0], m01 = mat->m[0][1], m02 = mat->m[0][2];
+    m10 = mat->m[1][0], m11 = mat->m[1][1], m12 = mat->m[1][2];
+    m20 = mat->m[2][0], m21 = mat->m[2][1], m22 = mat->m[2][2];
+
+    for (uint32_t i = 0; i < num; i++) {
+        x = in[i].x, y = in[i].y, z = in[i].z;
+
+        out[i].x = (int16_t)(((m00 * x + m01 * y + m02 * z + (1 << 14)) >> 15) + mat->t[0]);
+        out[i].y = (int16_t)(((m10 * x + m11 * y + m12 * z + (1 << 14)) >> 15) + mat->t[1]);
+        out[i].z = (int16_t)(((m20 * x + m21 * y + m22 * z + (1 << 14)) >> 15) + mat->t[2]);
+    }
+}
+
+/**
+ * @brief        Create a point renderer
+ *
+ * @param[in]    cfg              Renderer configuration
+ * @param[out]   handle           Renderer handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_r3d_create(PIXEL_R3D_CFG_T *cfg, PIXEL_R3D_HANDLE_T *handle)
+{
+    PIXEL_R3D_T *r3d = NULL;
+
+    if (NULL == cfg || NULL == handle || 0 == cfg->width || 0 == cfg->height || 0 == cfg->point_max ||
+        cfg->point_max > PIXEL_R3D_POINT_MAX || cfg->width * cfg->height >= PIXEL_R3D_CLIPPED) {
+        return OPRT_INVALID_PARM;
+    }
+
+    r3d = (PIXEL_R3D_T *)tal_malloc(sizeof(PIXEL_R3D_T));
+    if (NULL == r3d) {
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(r3d, 0, sizeof(PIXEL_R3D_T));
+
+    r3d->width = cfg->width;
+    r3d->height = cfg->height;
+    r3d->point_max = cfg->point_max;
+
+    r3d->pixel = (uint16_t *)tal_malloc(cfg->point_max * sizeof(uint16_t));
+    r3d->depth = (uint8_t *)tal_malloc(cfg->point_max * sizeof(uint8_t));
+    r3d->order = (uint16_t *)tal_malloc(cfg->point_max * sizeof(uint16_t));
+    if (NULL == r3d->pixel || NULL == r3d->depth || NULL == r3d->order) {
+        __tdl_pixel_r3d_free(r3d);
+        return OPRT_MALLOC_FAILED;
+    }
+
+    // orthographic, origin at the frame center, no depth shading
+    r3d->view.center_x = (int16_t)((cfg->width << PIXEL_R3D_COORD_SHIFT) / 2);
+    r3d->view.center_y = (int16_t)((cfg->height << PIXEL_R3D_COORD_SHIFT) / 2);
+    r3d->view.scale = PIXEL_R3D_COORD_ONE;
+    r3d->view.shade_far = 255;
+    r3d->view.blend = PIXEL_R3D_BLEND_REPLACE;
+    __tdl_pixel_r3d_build_shade(r3d);
+
+    *handle = (PIXEL_R3D_HANDLE_T)r3d;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief        Destroy a point renderer
+ *
+ * @param[in]    handle           Renderer handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_r3d_destroy(PIXEL_R3D_HANDLE_T handle)
+{
+    if (NULL == handle) {
+        return OPRT_INVALID_PARM;
+    }
+
+    __tdl_pixel_r3d_free((PIXEL_R3D_T *)handle);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief        Set the projection, depth shading and blending used by the next splats
+ *
+ * @param[in]    handle           Renderer handle
+ * @param[in]    view             View configuration
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_r3d_set_view(PIXEL_R3D_HANDLE_T handle, PIXEL_R3D_VIEW_T *view)
+{
+    PIXEL_R3D_T *r3d = (PIXEL_R3D_T *)handle;
+    BOOL_T shade_changed = FALSE;
+
+    if (NULL == r3d || NULL == view) {
+        return OPRT_INVALID_PARM;
+    }
+
+    shade_changed = (view->depth_near != r3d->view.depth_near || view->depth_far != r3d->view.depth_far ||
+                     view->shade_far != r3d->view.shade_far);
+
+    r3d->view = *view;
+    if (shade_changed) {
+        __tdl_pixel_r3d_build_shade(r3d);
+    }
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief        Project points and draw them far to near into a frame
+ *
+ * @param[in]    handle           Renderer handle
+ * @param[inout] frame            RGB888 frame, width * height * PIXEL_MATRIX_BPP bytes
+ * @param[in]    point            Points in view space
+ * @param[in]    color_idx        Palette index of every point
+ * @param[in]    num              Number of points, at most point_max
+ * @param[in]    palette          PIXEL_R3D_PALETTE_SIZE colors
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_r3d_splat(PIXEL_R3D_HANDLE_T handle, uint8_t *frame, const PIXEL_R3D_VEC_T *point,
+                                const uint8_t *color_idx, uint32_t num, const PIXEL_R3D_COLOR_T *palette)
+{
+    PIXEL_R3D_T *r3d = (PIXEL_R3D_T *)handle;
+    const PIXEL_R3D_VIEW_T *view = NULL;
+    int32_t focal = 0, dist = 0, sx = 0, sy = 0, bucket = 0;
+    uint32_t visible = 0, sum = 0, cnt = 0, idx = 0;
+    uint32_t shade = 0;
+    const PIXEL_R3D_COLOR_T *color = NULL;
+    uint8_t *dst = NULL;
+
+    if (NULL == r3d || NULL == frame || NULL == point || NULL == color_idx || NULL == palette ||
+        num > r3d->point_max) {
+        return OPRT_INVALID_PARM;
+    }
+
+    view = &r3d->view;
+    focal = (int32_t)view->focal << PIXEL_R3D_COORD_SHIFT;
+    memset(r3d->bucket_start, 0, sizeof(r3d->bucket_start));
+
+    // project and count the points of every depth bucket
+    for (uint32_t i = 0; i < num; i++) {
+        sx = (int32_t)(((int64_t)point[i].x * view->scale) >> PIXEL_R3D_COORD_SHIFT);
+        sy = (int32_t)(((int64_t)point[i].y * view->scale) >> PIXEL_R3D_COORD_SHIFT);
+
+        if (focal) {
+            dist = focal - point[i].z;
+            if (dist <= 0) {
+                r3d->pixel[i] = PIXEL_R3D_CLIPPED;
+                continue;
+            }
+            sx = (int32_t)((int64_t)sx * focal / dist);
+            sy = (int32_t)((int64_t)sy * focal / dist);
+        }
+
+        sx = (sx + view->center_x + (PIXEL_R3D_COORD_ONE / 2)) >> PIXEL_R3D_COORD_SHIFT;
+        sy = (sy + view->center_y + (PIXEL_R3D_COORD_ONE / 2)) >> PIXEL_R3D_COORD_SHIFT;
+        if (sx < 0 || sy < 0 || sx >= r3d->width || sy >= r3d->height) {
+            r3d->pixel[i] = PIXEL_R3D_CLIPPED;
+            continue;
+        }
+
+        bucket = (point[i].z >> PIXEL_R3D_COORD_SHIFT) + PIXEL_R3D_DEPTH_BUCKETS / 2;
+        if (bucket < 0) {
+            bucket = 0;
+        } else if (bucket >= PIXEL_R3D_DEPTH_BUCKETS) {
+            bucket = PIXEL_R3D_DEPTH_BUCKETS - 1;
+        }
+
+        r3d->pixel[i] = (uint16_t)(sy * r3d->width + sx);
+        r3d->depth[i] = (uint8_t)bucket;
+        r3d->bucket_start[bucket]++;
+    }
+
+    // counting sort, far (low z) first
+    for (uint32_t b = 0; b < PIXEL_R3D_DEPTH_BUCKETS; b++) {
+        cnt = r3d->bucket_start[b];
+        r3d->bucket_start[b] = sum;
+        sum += cnt;
+    }
+    visible = sum;
+
+    for (uint32_t i = 0; i < num; i++) {
+        if (PIXEL_R3D_CLIPPED != r3d->pixel[i]) {
+            r3d->order[r3d->bucket_start[r3d->depth[i]]++] = (uint16_t)i;
+        }
+    }
+
+    for (uint32_t k = 0; k < visible; k++) {
+        idx = r3d->order[k];
+        color = &palette[color_idx[idx]];
+        shade = r3d->shade_lut[r3d->depth[idx]] + 1;
+        dst = &frame[r3d->pixel[idx] * PIXEL_MATRIX_BPP];
+
+        if (PIXEL_R3D_BLEND_ADD == view->blend) {
+            cnt = dst[0] + ((color->red * shade) >> 8);
+            dst[0] = (cnt > 255) ? 255 : (uint8_t)cnt;
+            cnt = dst[1] + ((color->green * shade) >> 8);
+            dst[1] = (cnt > 255) ? 255 : (uint8_t)cnt;
+            cnt = dst[2] + ((color->blue * shade) >> 8);
+            dst[2] = (cnt > 255) ? 255 : (uint8_t)cnt;
+        } else {
+            dst[0] = (uint8_t)((color->red * shade) >> 8);
+            dst[1] = (uint8_t)((color->green * shade) >> 8);
+            dst[2] = (uint8_t)((color->blue * shade) >> 8);
+        }
+    }
+
+    return OPRT_OK;
+}
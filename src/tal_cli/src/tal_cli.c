@@ -15,6 +15,7 @@
  */
 
 /*============================ INCLUDES ======================================*/
+#include <stdio.h>
 #include <string.h>
 #include "tuya_slist.h"
 #include "tal_uart.h"
@@ -95,6 +96,7 @@ typedef struct {
 
 /*============================ PROTOTYPES ====================================*/
 static void cli_hello(int argc, char *argv[]);
+static void cli_thread(int argc, char *argv[]);
 static void cli_print_prompt(cli_t *cli);
 
 /*============================ LOCAL VARIABLES ===============================*/
@@ -102,11 +104,18 @@ static cli_t *s_cli_handle = NULL;
 static SLIST_HEAD s_cli_dynamic_table;
 static cli_cmd_table_t s_cli_static_table[CLI_CMD_TABLE_NUM];
 
-static const cli_cmd_t s_cli_cmd[] = {{
-    .name = "hello",
-    .help = "print helo world",
-    .func = cli_hello,
-}};
+static const cli_cmd_t s_cli_cmd[] = {
+    {
+        .name = "hello",
+        .help = "print helo world",
+        .func = cli_hello,
+    },
+    {
+        .name = "thread",
+        .help = "thread stack and cpu usage: thread [reset]",
+        .func = cli_thread,
+    },
+};
 
 /*============================ IMPLEMENTATION ================================*/
 static int32_t cli_out_put(TUYA_UART_NUM_E port_id, char *out_str, uint32_t len)
@@ -127,6 +136,54 @@ static void cli_hello(int argc, char *argv[])
     cli_print_string(s_cli_handle, "helo world");
 }
 
+static void cli_thread(int argc, char *argv[])
+{
+    THREAD_USAGE_T *usage = NULL;
+    uint32_t num = 0, i;
+    char line[80];
+
+    if (argc > 1 && 0 == strcmp(argv[1], "reset")) {
+        tal_thread_reset_usage();
+        cli_print_string(s_cli_handle, "thread usage reset");
+        return;
+    }
+
+    if (OPRT_OK != tal_thread_get_usage(NULL, &num) || 0 == num) {
+        cli_print_string(s_cli_handle, "no thread");
+        return;
+    }
+    usage = tal_malloc(num * sizeof(THREAD_USAGE_T));
+    if (NULL == usage) {
+        cli_print_string(s_cli_handle, "malloc fail");
+        return;
+    }
+    tal_thread_get_usage(usage, &num);
+
+    cli_print_string(s_cli_handle, "name              stack   free     cpu_ms    cpu");
+    for (i = 0; i < num; i++) {
+        // unknown fields print as -
+        snprintf(line, sizeof(line), "%-16s %6u ", usage[i].name, (unsigned)usage[i].stack_size);
+        if (THREAD_USAGE_UNKNOWN == usage[i].stack_free) {
+            snprintf(line + strlen(line), sizeof(line) - strlen(line), "%6s ", "-");
+        } else {
+            snprintf(line + strlen(line), sizeof(line) - strlen(line), "%6u ", (unsigned)usage[i].stack_free);
+        }
+        if (THREAD_USAGE_UNKNOWN == usage[i].cpu_ms) {
+            snprintf(line + strlen(line), sizeof(line) - strlen(line), "%10s %6s", "-", "-");
+        } else {
+            snprintf(line + strlen(line), sizeof(line) - strlen(line), "%10u %3u.%u%%", (unsigned)usage[i].cpu_ms,
+                     (unsigned)(usage[i].cpu_permille / 10), (unsigned)(usage[i].cpu_permille % 10));
+        }
+        cli_print_string(s_cli_handle, line);
+    }
+    if (tal_thread_get_usage_lost()) {
+        snprintf(line, sizeof(line), "profiler table full, %u samples lost", (unsigned)tal_thread_get_usage_lost());
+        cli_print_string(s_cli_handle, line);
+    }
+
+    tal_free(usage);
+}
+
 static cli_cmd_t *cli_cmd_find_with_name(char *name)
 {
     int i, j;
@@ -776,7 +833,7 @@ int tal_cli_init_with_uart(uint8_t uart_num)
         PR_ERR("uart init failed", result);
         goto __exit;
     }
-    tal_cli_cmd_register((cli_cmd_t *)&s_cli_cmd, 1);
+    tal_cli_cmd_register((cli_cmd_t *)&s_cli_cmd, CNTSOF(s_cli_cmd));
 
     THREAD_CFG_T param;
 
@@ -86,21 +86,65 @@ typedef struct {
     char desc[EVENT_DESC_MAX_LEN + 1]; // description, used to record the subscribe info
     SUBSCRIBE_TYPE_E type;             // the subscribe type
     EVENT_SUBSCRIBE_CB cb;             // the subscribe callback function
+    uint32_t id;                       // unique id, used to find the subscriber from the dispatch array
     struct tuya_list_head node;        // list node, used to attch to the event node
 } SUBSCRIBE_NODE_T;
 
 /**
- * @brief the event node
+ * @brief the subscriber copied into the dispatch array
+ *
+ */
+typedef struct {
+    EVENT_SUBSCRIBE_CB cb;
+    SUBSCRIBE_TYPE_E type;
+    uint32_t id;
+} EVENT_SUBSCRIBER_T;
+
+/**
+ * @brief the dispatch array, rebuilt on every subscriber change and never modified
+ * while published, except clearing cb of a removed subscriber so publishes still
+ * using the array skip it
  *
  */
 typedef struct {
-    MUTEX_HANDLE mutex; // mutex, protection the event publish and subscribe
+    uint32_t ref; // publishers using the array, plus one while it is the current array
+    uint32_t num;
+    EVENT_SUBSCRIBER_T sub[0];
+} EVENT_SUBSCRIBE_ARRAY_T;
+
+/**
+ * @brief a publish in progress, on the stack of the publisher
+ *
+ */
+typedef struct EVENT_DISPATCH {
+    struct EVENT_DISPATCH *next;     // next publish in progress of the same event
+    EVENT_SUBSCRIBE_ARRAY_T *array;  // dispatch array held by the publish
+    void *thread;                    // publishing thread
+    uint32_t calling;                // id of the subscriber being called, 0 between calls
+} EVENT_DISPATCH_T;
+
+/**
+ * @brief the event node
+ *
+ */
+typedef struct EVENT_NODE {
+    MUTEX_HANDLE mutex; // mutex, protection the event subscribe and the dispatch array update
 
     char name[EVENT_NAME_MAX_LEN + 1];    // name, the event name
+    uint32_t hash;                        // hash of the name
+    struct EVENT_NODE *hash_next;         // next event in the same hash bucket
     struct tuya_list_head node;           // list node, used to attach to the event manage module
     struct tuya_list_head subscribe_root; // subscibe root, used to manage the subscriber
+    EVENT_SUBSCRIBE_ARRAY_T *subscriber;  // dispatch array, NULL when there is no subscriber
+    EVENT_DISPATCH_T *dispatch;           // publishes in progress, unsubscribe waits for their calls
 } EVENT_NODE_T;
 
+/**
+ * @brief hash bucket number of the event manage node, power of 2
+ *
+ */
+#define EVENT_HASH_BUCKET_NUM (16)
+
 /**
  * @brief the event manage node
  *
@@ -109,11 +153,19 @@ typedef struct {
     int inited;
     MUTEX_HANDLE mutex;                        // mutex, used to protection event manage node
     int event_cnt;                             // current event number
+    uint32_t subscribe_id;                     // last subscriber id
     struct tuya_list_head event_root;          // event root, used to manage the event
     struct tuya_list_head free_subscribe_root; // free subscriber list, used to manage the
                                                // subscribe which not found the event
+    EVENT_NODE_T *bucket[EVENT_HASH_BUCKET_NUM]; // event hash buckets, used to find the event by name
 } EVENT_MANAGE_T;
 
+/**
+ * @brief interned event id, valid until reboot since events are never removed
+ *
+ */
+typedef EVENT_NODE_T *EVENT_ID_T;
+
 /**
  * @brief event initialization
  *
@@ -132,6 +184,48 @@ OPERATE_RET tal_event_init(void);
  */
 OPERATE_RET tal_event_publish(const char *name, void *data);
 
+/**
+ * @brief: get the id of an event, creating the event if needed
+ *
+ * Publishing by id skips the name lookup, modules publishing on a hot path
+ * should get the id once and keep it.
+ *
+ * @param[in] name: event name
+ * @return the event id, NULL when the name is invalid or out of memory
+ */
+EVENT_ID_T tal_event_get_id(const char *name);
+
+/**
+ * @brief: publish event by id
+ *
+ * Subscribers run in the publisher thread without any lock held, so a slow
+ * subscriber only delays its own publisher. A running publish does not call a
+ * subscriber once it is unsubscribed, and tal_event_unsubscribe() waits for a
+ * call already running in another thread, so the subscriber context can be freed
+ * when it returns. Unsubscribing from inside a callback of the same event does
+ * not wait for that callback and does not block.
+ *
+ * @param[in] id: event id
+ * @param[in] data: event data
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_event_publish_id(EVENT_ID_T id, void *data);
+
+/**
+ * @brief: publish event by id, subscribers run later in the system workqueue
+ *
+ * The data is copied, the publisher does not need to keep it. Requires
+ * tal_workq_init().
+ *
+ * @param[in] id: event id
+ * @param[in] data: event data, NULL to publish NULL
+ * @param[in] len: event data length
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_event_publish_async(EVENT_ID_T id, const void *data, uint32_t len);
+
 /**
  * @brief: subscribe event
  *
@@ -145,7 +239,8 @@ OPERATE_RET tal_event_publish(const char *name, void *data);
 OPERATE_RET tal_event_subscribe(const char *name, const char *desc, const EVENT_SUBSCRIBE_CB cb, SUBSCRIBE_TYPE_E type);
 
 /**
- * @brief: unsubscribe event
+ * @brief: unsubscribe event, waiting for the callback to return from the
+ * publishes of other threads
  *
  * @param[in] name: event name
  * @param[in] desc: subscribe description
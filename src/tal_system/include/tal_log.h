@@ -379,6 +379,41 @@ void tal_log_color_set(const TAL_LOG_LEVEL_E level, TAL_LOG_DISPLAY_MODE_E displ
 OPERATE_RET tal_log_color_print_raw(TAL_LOG_DISPLAY_MODE_E display_mode, TAL_LOG_FONT_COLOR_E font_color,
                                     TAL_LOG_BACKGROUND_COLOR_E background_color, const char *pFmt, ...);
 
+#if defined(ENABLE_LOG_DEFERRED) && (ENABLE_LOG_DEFERRED == 1)
+/**
+ * @brief Definition of deferred log statistics
+ */
+typedef struct {
+    uint32_t records;   // records queued
+    uint32_t dropped;   // records lost because the ring was full
+    uint32_t truncated; // messages or string arguments cut to fit a record
+    uint32_t used_max;  // most ring bytes in use at once
+} TAL_LOG_DEFERRED_STATS_T;
+
+/**
+ * @brief output the queued deferred log records in the caller context
+ *
+ * @param[in] in_crash, TRUE from a crash or exception hook, the records are
+ * output without taking any lock, other threads are expected to be stopped
+ *
+ * @note Logs are queued by the callers and formatted by a low priority thread
+ * when ENABLE_LOG_DEFERRED is set. Platforms should call this from their crash
+ * handler so the last records before the crash are not lost.
+ *
+ * @return NONE
+ */
+void tal_log_deferred_flush(BOOL_T in_crash);
+
+/**
+ * @brief get the deferred log statistics
+ *
+ * @param[out] stats, statistics since the log initialization
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tal_log_deferred_get_stats(TAL_LOG_DEFERRED_STATS_T *stats);
+#endif
+
 #ifdef __cplusplus
 }
 #endif /* __TAL_LOG_H__ */
@@ -41,9 +41,30 @@ extern "C" {
 
 #define Free(ptr) tal_free(ptr)
 
+#if defined(ENABLE_MEM_SLAB) && (ENABLE_MEM_SLAB == 1)
+#define TAL_MEM_SLAB_CLASS_NUM 5 // 16, 32, 64, 128 and 256 byte objects
+#endif
+
 /***********************************************************************
  ********************* struct ******************************************
  **********************************************************************/
+#if defined(ENABLE_MEM_SLAB) && (ENABLE_MEM_SLAB == 1)
+typedef struct {
+    uint16_t obj_size;     // object size of the class
+    uint16_t pages;        // arena pages owned by the class
+    uint32_t in_use;       // objects allocated now
+    uint32_t in_use_max;   // most objects allocated at once
+    uint32_t alloc_cnt;    // allocations served by the class
+    uint32_t fallback_cnt; // allocations sent to the heap because the arena was full
+} TAL_MEM_SLAB_CLASS_STATS_T;
+
+typedef struct {
+    uint32_t page_size;  // bytes per arena page
+    uint16_t page_num;   // pages in the arena
+    uint16_t page_free;  // pages not owned by any class
+    TAL_MEM_SLAB_CLASS_STATS_T cls[TAL_MEM_SLAB_CLASS_NUM];
+} TAL_MEM_SLAB_STATS_T;
+#endif
 
 /***********************************************************************
  ********************* variable ****************************************
@@ -103,6 +124,22 @@ void *tal_psram_calloc(size_t nitems, size_t size);
 void *tal_psram_realloc(void *ptr, size_t size);
 #endif
 
+#if defined(ENABLE_MEM_SLAB) && (ENABLE_MEM_SLAB == 1)
+/**
+ * @brief Get the statistics of the small object slab
+ *
+ * @note With ENABLE_MEM_SLAB set, tal_malloc serves requests up to 256 bytes
+ * from size classes carved out of a fixed arena, so small and short-lived
+ * objects do not fragment the system heap.
+ *
+ * @param[out] stats: the slab statistics
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_mem_slab_get_stats(TAL_MEM_SLAB_STATS_T *stats);
+#endif
+
 /**
  * @brief Get system free heap size
  *
@@ -91,8 +91,30 @@ typedef struct {
 #if defined(ENABLE_EXT_RAM) && (ENABLE_EXT_RAM == 1)
     uint8_t psram_mode : 1; // run in psram
 #endif
+#if defined(ENABLE_SMP) && (ENABLE_SMP == 1)
+    uint8_t smp_pin : 1;  // run on core smp_core only
+    uint8_t smp_core : 7; // core the thread is pinned to
+#endif
 } THREAD_CFG_T;
 
+/**
+ * @brief value of a thread usage field the platform does not report
+ *
+ */
+#define THREAD_USAGE_UNKNOWN 0xFFFFFFFF
+
+/**
+ * @brief thread stack and cpu usage
+ *
+ */
+typedef struct {
+    char name[TAL_THREAD_MAX_NAME_LEN]; // thread name
+    uint32_t stack_size;                // stack size
+    uint32_t stack_free;                // lowest free stack so far
+    uint32_t cpu_ms;                    // cpu time since the last usage reset
+    uint32_t cpu_permille;              // share of the cpu since the last usage reset
+} THREAD_USAGE_T;
+
 /**
  * @brief create and start a tuya sdk thread
  *
@@ -144,6 +166,44 @@ THREAD_STATE_E tal_thread_get_state(const THREAD_HANDLE handle);
  * tuya_error_code.h
  */
 OPERATE_RET tal_thread_diagnose(const THREAD_HANDLE handle);
+
+/**
+ * @brief get the stack and cpu usage of every tuya sdk thread
+ *
+ * @param[out] usage: one entry per thread, can be null to count the threads
+ * @param[inout] num: entries in usage, returns the entries filled or the thread count
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ *
+ * @note cpu usage is measured on linux, elsewhere it needs ENABLE_THREAD_PROFILER
+ * and is estimated from periodic samples of the running thread
+ */
+OPERATE_RET tal_thread_get_usage(THREAD_USAGE_T *usage, uint32_t *num);
+
+/**
+ * @brief restart the cpu usage measurement of every tuya sdk thread
+ *
+ * @return none
+ */
+void tal_thread_reset_usage(void);
+
+/**
+ * @brief get the cpu samples the thread profiler could not give to a thread since
+ * the last usage reset, its thread table was full
+ *
+ * @return the samples lost, 0 without ENABLE_THREAD_PROFILER
+ *
+ * @note while samples are lost, threads the profiler does not track report
+ * THREAD_USAGE_UNKNOWN cpu usage instead of 0
+ */
+uint32_t tal_thread_get_usage_lost(void);
+
+/**
+ * @brief print the stack and cpu usage of every tuya sdk thread to the log
+ *
+ * @return none
+ */
+void tal_thread_dump_watermark(void);
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
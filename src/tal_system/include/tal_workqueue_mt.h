@@ -0,0 +1,155 @@
+/**
+ * @file tal_workqueue_mt.h
+ * @brief Multi-worker work queue with work stealing and ordering keys.
+ *
+ * A multi-worker workqueue runs its work items on several threads. Every worker
+ * owns two queues: a shared one that idle workers may steal from, and a keyed
+ * one for items scheduled with an ordering key. Items with the same key always
+ * land on the same worker and are never stolen, so they run one after the other
+ * in the order they were scheduled. Items without a key go to an idle worker
+ * when there is one and may be stolen by any worker that runs out of work.
+ *
+ * The queue keeps depth, scheduling latency and run time statistics, read with
+ * tal_workqueue_mt_get_stats().
+ *
+ * With ENABLE_SMP the workers can be pinned to cores with core_num, otherwise
+ * placing them on cores is left to the scheduler of the platform.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __TAL_WORKQUEUE_MT_H__
+#define __TAL_WORKQUEUE_MT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "tuya_cloud_types.h"
+#include "tal_thread.h"
+#include "tal_workqueue.h"
+
+#define WORKQUEUE_MT_WORKER_MAX 8 // workers per queue at most
+#define WORKQUEUE_MT_KEY_NONE   0 // items without ordering, may run on any worker
+
+typedef void *WORKQUEUE_MT_HANDLE;
+
+typedef struct {
+    uint8_t worker_num;      // 1 - WORKQUEUE_MT_WORKER_MAX
+    uint16_t queue_len;      // items each worker can hold, for the shared and the keyed queue each
+    THREAD_CFG_T thread_cfg; // used by every worker, the worker index is appended to thrdname
+#if defined(ENABLE_SMP) && (ENABLE_SMP == 1)
+    uint8_t core_num; // 0 leaves the workers to the scheduler, else worker i runs on core i % core_num
+#endif
+} WORKQUEUE_MT_CFG_T;
+
+typedef struct {
+    uint32_t scheduled;   // items accepted
+    uint32_t executed;    // items run, cancelled items included
+    uint32_t stolen;      // items run by a worker that did not own them
+    uint32_t depth;       // items waiting now
+    uint32_t depth_max;   // most items waiting at once
+    uint32_t latency_avg; // ms from schedule to start of the callback
+    uint32_t latency_max;
+    uint32_t run_avg;     // ms spent in the callback
+    uint32_t run_max;
+} WORKQUEUE_MT_STATS_T;
+
+/**
+ * @brief create a workqueue served by several worker threads
+ *
+ * @param[in] cfg the workqueue configuration
+ * @param[out] handle the workqueue handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_mt_create(const WORKQUEUE_MT_CFG_T *cfg, WORKQUEUE_MT_HANDLE *handle);
+
+/**
+ * @brief put work task in workqueue, it may run on any worker
+ *
+ * @param[in] handle the workqueue handle
+ * @param[in] cb the work callback
+ * @param[in] data the work data
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_mt_schedule(WORKQUEUE_MT_HANDLE handle, WORKQUEUE_CB cb, void *data);
+
+/**
+ * @brief put work task in workqueue, ahead of the unkeyed tasks waiting on its worker
+ *
+ * @param[in] handle the workqueue handle
+ * @param[in] cb the work callback
+ * @param[in] data the work data
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_mt_schedule_instant(WORKQUEUE_MT_HANDLE handle, WORKQUEUE_CB cb, void *data);
+
+/**
+ * @brief put work task in workqueue, serialized with the other tasks of the same key
+ *
+ * @param[in] handle the workqueue handle
+ * @param[in] key the ordering key, WORKQUEUE_MT_KEY_NONE behaves as tal_workqueue_mt_schedule
+ * @param[in] cb the work callback
+ * @param[in] data the work data
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_mt_schedule_keyed(WORKQUEUE_MT_HANDLE handle, uint32_t key, WORKQUEUE_CB cb,
+                                            void *data);
+
+/**
+ * @brief cancel work tasks in workqueue which match cb or data
+ *
+ * @param[in] handle the workqueue handle
+ * @param[in] cb the work callback
+ * @param[in] data the work data
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_mt_cancel(WORKQUEUE_MT_HANDLE handle, WORKQUEUE_CB cb, void *data);
+
+/**
+ * @brief get the workqueue item number
+ *
+ * @param[in] handle the workqueue handle
+ *
+ * @return the current item counts of all workers
+ */
+uint32_t tal_workqueue_mt_get_num(WORKQUEUE_MT_HANDLE handle);
+
+/**
+ * @brief get the workqueue statistics
+ *
+ * @param[in] handle the workqueue handle
+ * @param[out] stats the statistics since creation or the last reset
+ * @param[in] reset restart the counters after reading them
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_mt_get_stats(WORKQUEUE_MT_HANDLE handle, WORKQUEUE_MT_STATS_T *stats, BOOL_T reset);
+
+/**
+ * @brief release the workqueue, waiting for the running callbacks to return
+ *
+ * @param[in] handle the workqueue handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_mt_release(WORKQUEUE_MT_HANDLE handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TAL_WORKQUEUE_MT_H__ */
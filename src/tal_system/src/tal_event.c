@@ -18,8 +18,13 @@
  * - Event name and description validation
  * - Event node creation and initialization
  * - Subscription management (addition, deletion, retrieval)
- * - Event dispatching to subscribed listeners
- * - Thread-safe operations through mutex locking
+ * - Event lookup through a hash of the name, or directly by event id
+ * - Event dispatching to subscribed listeners from a copy-on-write array, so
+ *   publishing takes no mutex and subscribers run without any lock held
+ * - Unsubscribe waiting for the calls of the removed subscriber still running in
+ *   other publishes, so it is never called once unsubscribe returns
+ * - Asynchronous publishing through the system workqueue
+ * - Thread-safe subscription changes through mutex locking
  * - Debugging utilities for event and subscription dumping
  *
  * This implementation leverages the Tuya IoT SDK's infrastructure, including
@@ -33,6 +38,8 @@
 #include "tuya_cloud_types.h"
 #include "tal_event.h"
 #include "tal_api.h"
+#include "tkl_thread.h"
+#include "tuya_atomic.h"
 
 static EVENT_MANAGE_T g_event_manager = {0};
 
@@ -62,8 +69,213 @@ BOOL_T _event_desc_is_valid(const char *desc)
     return TRUE;
 }
 
+uint32_t _event_name_hash(const char *name)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+uint32_t _event_subscribe_id_new(void)
+{
+    uint32_t id;
+
+    TAL_ENTER_CRITICAL();
+    id = ++g_event_manager.subscribe_id;
+    TAL_EXIT_CRITICAL();
+
+    return id;
+}
+
+EVENT_SUBSCRIBE_ARRAY_T *_event_node_dispatch_begin(EVENT_NODE_T *event, EVENT_DISPATCH_T *dispatch)
+{
+    // hold the current array and make the publish visible to unsubscribe
+    memset(dispatch, 0, sizeof(EVENT_DISPATCH_T));
+    tkl_thread_get_id(&dispatch->thread);
+
+    TAL_ENTER_CRITICAL();
+    dispatch->array = event->subscriber;
+    if (dispatch->array) {
+        dispatch->array->ref++;
+        dispatch->next = event->dispatch;
+        event->dispatch = dispatch;
+    }
+    TAL_EXIT_CRITICAL();
+
+    return dispatch->array;
+}
+
+void _event_node_dispatch_end(EVENT_NODE_T *event, EVENT_DISPATCH_T *dispatch)
+{
+    EVENT_DISPATCH_T **pos = NULL;
+    BOOL_T is_last = FALSE;
+
+    TAL_ENTER_CRITICAL();
+    for (pos = &event->dispatch; *pos; pos = &(*pos)->next) {
+        if (*pos == dispatch) {
+            *pos = dispatch->next;
+            break;
+        }
+    }
+    is_last = (0 == --dispatch->array->ref);
+    TAL_EXIT_CRITICAL();
+
+    if (is_last) {
+        tal_free(dispatch->array);
+    }
+}
+
+EVENT_SUBSCRIBE_CB _event_node_dispatch_call_begin(EVENT_DISPATCH_T *dispatch, uint32_t i)
+{
+    EVENT_SUBSCRIBE_CB cb = NULL;
+
+    // read cb and mark the call under the same lock unsubscribe clears cb with
+    TAL_ENTER_CRITICAL();
+    cb = dispatch->array->sub[i].cb;
+    dispatch->calling = cb ? dispatch->array->sub[i].id : 0;
+    TAL_EXIT_CRITICAL();
+
+    return cb;
+}
+
+void _event_node_dispatch_call_end(EVENT_DISPATCH_T *dispatch)
+{
+    TAL_ENTER_CRITICAL();
+    dispatch->calling = 0;
+    TAL_EXIT_CRITICAL();
+}
+
+void _event_node_dispatch_wait(EVENT_NODE_T *event, uint32_t id)
+{
+    // wait for the calls of a removed subscriber still running in other threads, the
+    // calls made by this thread are the callers of unsubscribe and cannot be waited for
+    EVENT_DISPATCH_T *pos = NULL;
+    void *self = NULL;
+    BOOL_T is_calling = FALSE;
+
+    tkl_thread_get_id(&self);
+
+    do {
+        TAL_ENTER_CRITICAL();
+        is_calling = FALSE;
+        for (pos = event->dispatch; pos; pos = pos->next) {
+            if (pos->calling == id && pos->thread != self) {
+                is_calling = TRUE;
+                break;
+            }
+        }
+        TAL_EXIT_CRITICAL();
+
+        if (is_calling) {
+            tal_system_sleep(1);
+        }
+    } while (is_calling);
+}
+
+OPERATE_RET _event_node_subscriber_update(EVENT_NODE_T *event)
+{
+    // rebuild the dispatch array from the subscribe list, called with the event mutex
+    // locked or before the event is visible
+    EVENT_SUBSCRIBE_ARRAY_T *array = NULL;
+    EVENT_SUBSCRIBE_ARRAY_T *old = NULL;
+    struct tuya_list_head *pos = NULL;
+    SUBSCRIBE_NODE_T *entry = NULL;
+    uint32_t num = 0;
+
+    tuya_list_for_each(pos, &event->subscribe_root)
+    {
+        num++;
+    }
+
+    if (num) {
+        array = tal_malloc(sizeof(EVENT_SUBSCRIBE_ARRAY_T) + num * sizeof(EVENT_SUBSCRIBER_T));
+        TUYA_CHECK_NULL_RETURN(array, OPRT_MALLOC_FAILED);
+        array->ref = 1;
+        array->num = 0;
+        tuya_list_for_each(pos, &event->subscribe_root)
+        {
+            entry = tuya_list_entry(pos, SUBSCRIBE_NODE_T, node);
+            array->sub[array->num].cb = entry->cb;
+            array->sub[array->num].type = entry->type;
+            array->sub[array->num].id = entry->id;
+            array->num++;
+        }
+    }
+
+    // publishers still using the old array free it when they are done
+    TAL_ENTER_CRITICAL();
+    old = event->subscriber;
+    event->subscriber = array;
+    if (old && (0 != --old->ref)) {
+        old = NULL;
+    }
+    TAL_EXIT_CRITICAL();
+
+    if (old) {
+        tal_free(old);
+    }
+
+    return OPRT_OK;
+}
+
+void _event_node_subscriber_clear(EVENT_SUBSCRIBE_ARRAY_T *array, uint32_t id)
+{
+    uint32_t i;
+
+    for (i = 0; i < array->num; i++) {
+        if (array->sub[i].id == id) {
+            array->sub[i].cb = NULL;
+        }
+    }
+}
+
+void _event_node_subscriber_remove(EVENT_NODE_T *event, SUBSCRIBE_NODE_T *entry)
+{
+    EVENT_DISPATCH_T *pos = NULL;
+
+    tuya_list_del(&entry->node);
+
+    // the new array leaves the subscriber out, the arrays of the publishes in progress
+    // and, when out of memory for the new array, the current one still hold it
+    _event_node_subscriber_update(event);
+
+    TAL_ENTER_CRITICAL();
+    if (event->subscriber) {
+        _event_node_subscriber_clear(event->subscriber, entry->id);
+    }
+    for (pos = event->dispatch; pos; pos = pos->next) {
+        _event_node_subscriber_clear(pos->array, entry->id);
+    }
+    TAL_EXIT_CRITICAL();
+
+    tal_free(entry);
+}
+
+EVENT_NODE_T *_event_node_find(const char *name, uint32_t hash)
+{
+    // the head is published with release, the chain behind it never changes
+    EVENT_NODE_T *entry = TUYA_ATOMIC_LOAD_ACQ(&g_event_manager.bucket[hash & (EVENT_HASH_BUCKET_NUM - 1)]);
+
+    while (entry) {
+        if (entry->hash == hash && 0 == strcmp(entry->name, name)) {
+            return entry;
+        }
+        entry = entry->hash_next;
+    }
+
+    return NULL;
+}
+
 EVENT_NODE_T *_event_node_create_init(const char *name)
 {
+    uint32_t hash = _event_name_hash(name);
+
     // allocate memory
     EVENT_NODE_T *event = tal_malloc(sizeof(EVENT_NODE_T));
     TUYA_CHECK_NULL_RETURN(event, NULL);
@@ -72,11 +284,21 @@ EVENT_NODE_T *_event_node_create_init(const char *name)
     // initialze the event node
     memcpy(event->name, name, strlen(name));
     event->name[strlen(name)] = '\0';
+    event->hash = hash;
     INIT_LIST_HEAD(&event->subscribe_root);
     tal_mutex_create_init(&event->mutex);
 
     tal_mutex_lock(g_event_manager.mutex);
 
+    // another publisher or subscriber may have created it meanwhile
+    EVENT_NODE_T *exist = _event_node_find(name, hash);
+    if (exist) {
+        tal_mutex_unlock(g_event_manager.mutex);
+        tal_mutex_release(event->mutex);
+        tal_free(event);
+        return exist;
+    }
+
     // need check if there have free subscriber which subscribe this event
     struct tuya_list_head *free_pos = NULL;
     struct tuya_list_head *free_next = NULL;
@@ -98,8 +320,25 @@ EVENT_NODE_T *_event_node_create_init(const char *name)
         }
     }
 
-    // at last, need add this event to event manage root
+    if (OPRT_OK != _event_node_subscriber_update(event)) {
+        // give the subscribers back to the free list, they move again on the next try
+        tuya_list_for_each_safe(free_pos, free_next, &event->subscribe_root)
+        {
+            free_entry = tuya_list_entry(free_pos, SUBSCRIBE_NODE_T, node);
+            tuya_list_del(&free_entry->node);
+            tuya_list_add_tail(&free_entry->node, &g_event_manager.free_subscribe_root);
+        }
+        tal_mutex_unlock(g_event_manager.mutex);
+        tal_mutex_release(event->mutex);
+        tal_free(event);
+        return NULL;
+    }
+
+    // at last, need add this event to event manage root, the bucket is read without
+    // the manage mutex, so the event is linked only once fully initialized
     tuya_list_add_tail(&event->node, &g_event_manager.event_root);
+    event->hash_next = g_event_manager.bucket[hash & (EVENT_HASH_BUCKET_NUM - 1)];
+    TUYA_ATOMIC_STORE_REL(&g_event_manager.bucket[hash & (EVENT_HASH_BUCKET_NUM - 1)], event);
     g_event_manager.event_cnt++;
 
     tal_mutex_unlock(g_event_manager.mutex);
@@ -109,19 +348,8 @@ EVENT_NODE_T *_event_node_create_init(const char *name)
 
 EVENT_NODE_T *_event_node_get(const char *name)
 {
-    // try to get event from event root
-    EVENT_NODE_T *entry = NULL;
-    struct tuya_list_head *pos = NULL;
-    tuya_list_for_each(pos, &g_event_manager.event_root)
-    {
-        // find by name
-        entry = tuya_list_entry(pos, EVENT_NODE_T, node);
-        if (0 == strcmp(entry->name, name)) {
-            return entry;
-        }
-    }
-
-    return NULL;
+    // try to get event from the hash bucket of the name
+    return _event_node_find(name, _event_name_hash(name));
 }
 
 SUBSCRIBE_NODE_T *_event_node_get_free_subscribe(SUBSCRIBE_NODE_T *subscribe)
@@ -157,30 +385,60 @@ SUBSCRIBE_NODE_T *_event_node_get_subscribe(EVENT_NODE_T *event, SUBSCRIBE_NODE_
     return NULL;
 }
 
+BOOL_T _event_node_claim_onetime(EVENT_NODE_T *event, uint32_t id)
+{
+    // only the publisher which removes the subscriber calls it
+    BOOL_T claimed = FALSE;
+    struct tuya_list_head *pos = NULL;
+    SUBSCRIBE_NODE_T *entry = NULL;
+
+    tal_mutex_lock(event->mutex);
+    tuya_list_for_each(pos, &event->subscribe_root)
+    {
+        entry = tuya_list_entry(pos, SUBSCRIBE_NODE_T, node);
+        if (entry->id == id) {
+            _event_node_subscriber_remove(event, entry);
+            claimed = TRUE;
+            break;
+        }
+    }
+    tal_mutex_unlock(event->mutex);
+
+    return claimed;
+}
+
 OPERATE_RET _event_node_dispatch(EVENT_NODE_T *event, void *data)
 {
     OPERATE_RET rt = OPRT_OK;
+    EVENT_DISPATCH_T dispatch;
+    EVENT_SUBSCRIBE_ARRAY_T *array = NULL;
+    EVENT_SUBSCRIBE_CB cb = NULL;
+    uint32_t i;
+
+    // hold the current array, subscribe changes meanwhile build a new one
+    array = _event_node_dispatch_begin(event, &dispatch);
+    if (NULL == array) {
+        return OPRT_OK;
+    }
 
     // dispatch in order
-    struct tuya_list_head *p = NULL;
-    struct tuya_list_head *n = NULL;
-    SUBSCRIBE_NODE_T *entry = NULL;
-    tuya_list_for_each_safe(p, n, &event->subscribe_root)
-    {
-        // find and call cb one by one
-        entry = tuya_list_entry(p, SUBSCRIBE_NODE_T, node);
-        if (entry->cb) {
-            TUYA_CALL_ERR_LOG(entry->cb(data));
+    for (i = 0; i < array->num; i++) {
+        cb = _event_node_dispatch_call_begin(&dispatch, i);
+
+        // one-time event should be removed before dispatch, so it runs only once,
+        // removing it clears cb in the array so cb is taken before the claim
+        if (cb && array->sub[i].type == SUBSCRIBE_TYPE_ONETIME && !_event_node_claim_onetime(event, array->sub[i].id)) {
+            cb = NULL;
         }
 
-        // one-time event should be removed after dispatch
-        if (entry->type == SUBSCRIBE_TYPE_ONETIME) {
-            tuya_list_del(&entry->node);
-            tal_free(entry);
-            entry = NULL;
+        if (cb) {
+            TUYA_CALL_ERR_LOG(cb(data));
         }
+        _event_node_dispatch_call_end(&dispatch);
     }
 
+    _event_node_dispatch_end(event, &dispatch);
+
     return rt;
 }
 
@@ -198,6 +456,7 @@ OPERATE_RET _event_node_add_free_subscribe(SUBSCRIBE_NODE_T *subscribe)
     new_entry = (SUBSCRIBE_NODE_T *)tal_malloc(sizeof(SUBSCRIBE_NODE_T));
     TUYA_CHECK_NULL_RETURN(new_entry, OPRT_MALLOC_FAILED);
     memcpy(new_entry, subscribe, sizeof(SUBSCRIBE_NODE_T));
+    new_entry->id = _event_subscribe_id_new();
 
     tuya_list_add_tail(&new_entry->node, &g_event_manager.free_subscribe_root);
     return rt;
@@ -217,6 +476,7 @@ OPERATE_RET _event_node_add_subscribe(EVENT_NODE_T *event, SUBSCRIBE_NODE_T *sub
     new_entry = (SUBSCRIBE_NODE_T *)tal_malloc(sizeof(SUBSCRIBE_NODE_T));
     TUYA_CHECK_NULL_RETURN(new_entry, OPRT_MALLOC_FAILED);
     memcpy(new_entry, subscribe, sizeof(SUBSCRIBE_NODE_T));
+    new_entry->id = _event_subscribe_id_new();
 
     // try to add, if emergence, add to first, otherwise, add to tail
     if (subscribe->type == SUBSCRIBE_TYPE_EMERGENCY) {
@@ -225,6 +485,13 @@ OPERATE_RET _event_node_add_subscribe(EVENT_NODE_T *event, SUBSCRIBE_NODE_T *sub
         tuya_list_add_tail(&new_entry->node, &event->subscribe_root);
     }
 
+    // publish the new dispatch array, undo the add if there is no memory for it
+    rt = _event_node_subscriber_update(event);
+    if (OPRT_OK != rt) {
+        tuya_list_del(&new_entry->node);
+        tal_free(new_entry);
+    }
+
     return rt;
 }
 
@@ -245,7 +512,7 @@ OPERATE_RET _event_node_del_free_subscribe(SUBSCRIBE_NODE_T *subscribe)
     return rt;
 }
 
-OPERATE_RET _event_node_del_subscribe(EVENT_NODE_T *event, SUBSCRIBE_NODE_T *subscribe)
+OPERATE_RET _event_node_del_subscribe(EVENT_NODE_T *event, SUBSCRIBE_NODE_T *subscribe, uint32_t *id)
 {
     OPERATE_RET rt = OPRT_OK;
     SUBSCRIBE_NODE_T *new_entry = NULL;
@@ -255,9 +522,9 @@ OPERATE_RET _event_node_del_subscribe(EVENT_NODE_T *event, SUBSCRIBE_NODE_T *sub
         return OPRT_OK;
     }
 
-    // dont forget remove and free
-    tuya_list_del(&new_entry->node);
-    tal_free(new_entry);
+    // dont forget remove from the dispatch array and free
+    *id = new_entry->id;
+    _event_node_subscriber_remove(event, new_entry);
     new_entry = NULL;
     return rt;
 }
@@ -374,7 +641,6 @@ OPERATE_RET tal_event_publish(const char *name, void *data)
         return OPRT_BASE_EVENT_INVALID_EVENT_NAME;
     }
 
-    OPERATE_RET rt = OPRT_OK;
     // try to get event, if not exist, create and init.
     EVENT_NODE_T *event = _event_node_get(name);
     if (!event) {
@@ -382,14 +648,115 @@ OPERATE_RET tal_event_publish(const char *name, void *data)
         TUYA_CHECK_NULL_RETURN(event, OPRT_MALLOC_FAILED);
     }
 
-    // to keep the consistency, dispatch will done in mutex lock
-    tal_mutex_lock(event->mutex);
+    return tal_event_publish_id(event, data);
+}
+
+/**
+ * @brief Gets the id of an event, creating the event if it does not exist.
+ *
+ * Events are never removed, so the id stays valid and can be kept by the
+ * publisher to skip the name lookup on every publish.
+ *
+ * @param[in] name The name of the event.
+ * @return The event id, or NULL if the name is invalid or memory runs out.
+ */
+EVENT_ID_T tal_event_get_id(const char *name)
+{
+    if (g_event_manager.inited != TRUE) {
+        tal_event_init();
+    }
+
+    if (!_event_name_is_valid(name)) {
+        return NULL;
+    }
+
+    EVENT_NODE_T *event = _event_node_get(name);
+    if (!event) {
+        event = _event_node_create_init(name);
+    }
+
+    return event;
+}
+
+/**
+ * @brief Publishes an event by id.
+ *
+ * The subscribers are called from the dispatch array current when the publish
+ * starts, without any lock held, so subscribers can be slow, publish or change
+ * subscriptions without blocking other publishers. If any of the subscribers
+ * fail, the function continues dispatching the event.
+ *
+ * @param[in] id The event id, from tal_event_get_id().
+ * @param[in] data The data associated with the event.
+ * @return The operation result. Returns OPRT_OK on success, or an error code on
+ * failure.
+ */
+OPERATE_RET tal_event_publish_id(EVENT_ID_T id, void *data)
+{
+    OPERATE_RET rt = OPRT_OK;
+
+    if (NULL == id) {
+        return OPRT_INVALID_PARM;
+    }
+
     // try to dispatch event to all subscribe
     // if one of the subscribe failed, it will continue but will return failed
     // to record the execute status
-    TUYA_CALL_ERR_LOG(_event_node_dispatch(event, data));
+    TUYA_CALL_ERR_LOG(_event_node_dispatch(id, data));
 
-    tal_mutex_unlock(event->mutex);
+    return rt;
+}
+
+typedef struct {
+    EVENT_NODE_T *event;
+    uint32_t len;
+    uint8_t data[0];
+} EVENT_ASYNC_MSG_T;
+
+static void _event_async_dispatch(void *data)
+{
+    EVENT_ASYNC_MSG_T *msg = (EVENT_ASYNC_MSG_T *)data;
+
+    _event_node_dispatch(msg->event, msg->len ? msg->data : NULL);
+    tal_free(msg);
+}
+
+/**
+ * @brief Publishes an event by id, dispatching it from the system workqueue.
+ *
+ * The data is copied into the queued message, so the publisher returns at once
+ * and may release the data. Subscribers see the copy.
+ *
+ * @param[in] id The event id, from tal_event_get_id().
+ * @param[in] data The data associated with the event, NULL to dispatch NULL.
+ * @param[in] len The data length.
+ * @return The operation result. Returns OPRT_OK on success, or an error code on
+ * failure.
+ */
+OPERATE_RET tal_event_publish_async(EVENT_ID_T id, const void *data, uint32_t len)
+{
+    OPERATE_RET rt = OPRT_OK;
+
+    if (NULL == id || (NULL == data && len)) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (NULL == data) {
+        len = 0;
+    }
+
+    EVENT_ASYNC_MSG_T *msg = tal_malloc(sizeof(EVENT_ASYNC_MSG_T) + len);
+    TUYA_CHECK_NULL_RETURN(msg, OPRT_MALLOC_FAILED);
+    msg->event = id;
+    msg->len = len;
+    if (len) {
+        memcpy(msg->data, data, len);
+    }
+
+    rt = tal_workq_schedule(WORKQ_SYSTEM, _event_async_dispatch, msg);
+    if (OPRT_OK != rt) {
+        tal_free(msg);
+    }
 
     return rt;
 }
@@ -432,13 +799,16 @@ OPERATE_RET tal_event_subscribe(const char *name, const char *desc, const EVENT_
     memcpy(subscribe.desc, desc, strlen(desc));
     subscribe.desc[strlen(desc)] = '\0';
 
+    // look up under the manage mutex, so the event cannot be created meanwhile
+    tal_mutex_lock(g_event_manager.mutex);
     EVENT_NODE_T *event = _event_node_get(name);
     if (!event) {
         // if not found the event, add to the free list
-        tal_mutex_lock(g_event_manager.mutex);
         TUYA_CALL_ERR_LOG(_event_node_add_free_subscribe(&subscribe));
-        tal_mutex_unlock(g_event_manager.mutex);
-    } else {
+    }
+    tal_mutex_unlock(g_event_manager.mutex);
+
+    if (event) {
         // if found the event, add to the subscribe list
         tal_mutex_lock(event->mutex);
         TUYA_CALL_ERR_LOG(_event_node_add_subscribe(event, &subscribe));
@@ -457,6 +827,10 @@ OPERATE_RET tal_event_subscribe(const char *name, const char *desc, const EVENT_
  * description and name are valid before proceeding with the unsubscribe
  * operation. If the event is found, it is removed from the subscribe list. If
  * the event is not found, the subscription is removed from the free list.
+ * Calls of the callback still running in publishes of other threads are waited
+ * for, so once this returns the callback is not running and is not called again.
+ * A callback unsubscribing itself is not waited for. Two callbacks must not
+ * unsubscribe each other from different threads at the same time.
  *
  * @param[in] name The name of the event to unsubscribe from.
  * @param[in] desc The description of the event to unsubscribe from.
@@ -487,17 +861,26 @@ OPERATE_RET tal_event_unsubscribe(const char *name, const char *desc, EVENT_SUBS
     memcpy(subscribe.desc, desc, strlen(desc));
     subscribe.desc[strlen(desc)] = '\0';
 
+    // look up under the manage mutex, so the event cannot be created meanwhile
+    tal_mutex_lock(g_event_manager.mutex);
     EVENT_NODE_T *event = _event_node_get(name);
     if (!event) {
         // if not found the event, del from the free list
-        tal_mutex_lock(g_event_manager.mutex);
         TUYA_CALL_ERR_LOG(_event_node_del_free_subscribe(&subscribe));
-        tal_mutex_unlock(g_event_manager.mutex);
-    } else {
+    }
+    tal_mutex_unlock(g_event_manager.mutex);
+
+    if (event) {
         // if found the event, del from the subscribe list
+        uint32_t id = 0;
         tal_mutex_lock(event->mutex);
-        TUYA_CALL_ERR_LOG(_event_node_del_subscribe(event, &subscribe));
+        TUYA_CALL_ERR_LOG(_event_node_del_subscribe(event, &subscribe, &id));
         tal_mutex_unlock(event->mutex);
+
+        // wait without the event mutex, the running callback may subscribe or unsubscribe
+        if (id) {
+            _event_node_dispatch_wait(event, id);
+        }
     }
 
     return rt;
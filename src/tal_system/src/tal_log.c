@@ -38,6 +38,8 @@
 #include "tal_system.h"
 #include "tal_time_service.h"
 #include "tal_memory.h"
+#include "tal_thread.h"
+#include "tal_semaphore.h"
 
 /***********************************************************
 *************************micro define***********************
@@ -77,11 +79,71 @@ typedef struct {
 
 #define DEF_OUTPUT_NAME "def_output"
 
+#if defined(ENABLE_LOG_DEFERRED) && (ENABLE_LOG_DEFERRED == 1)
+#define LOG_DEFER_REC_MAX  256    // bytes per record, longer messages are truncated
+#define LOG_DEFER_SPEC_MAX 32     // bytes per conversion spec once '*' is replaced by its value
+#define LOG_DEFER_SPEC_LEN 10     // longest conversion spec kept in binary form
+#define LOG_DEFER_REC_PAD  0xFFFF // record length marking the unused space at the ring end
+#define LOG_DEFER_ALIGN(x) (((x) + 7) & ~7)
+
+typedef uint8_t LOG_REC_TYPE_E;
+#define LOG_REC_FMT  0 // format pointer and binary arguments
+#define LOG_REC_TEXT 1 // formatted message, the format may not live until the output
+#define LOG_REC_RAW  2 // formatted raw output, without prefix
+
+typedef uint8_t LOG_ARG_TYPE_E;
+#define LOG_ARG_NONE    0 // "%%"
+#define LOG_ARG_INT     1
+#define LOG_ARG_LONG    2
+#define LOG_ARG_LLONG   3
+#define LOG_ARG_SIZE    4
+#define LOG_ARG_PTRDIFF 5
+#define LOG_ARG_INTMAX  6
+#define LOG_ARG_DOUBLE  7
+#define LOG_ARG_LDOUBLE 8
+#define LOG_ARG_PTR     9
+#define LOG_ARG_STR     10
+#define LOG_ARG_UNKNOWN 11 // not kept in binary form, the message is formatted at once
+
+typedef struct {
+    const char *start; // the '%'
+    uint8_t len;       // up to and including the conversion character
+    uint8_t star;      // '*' width and precision arguments before the value
+    LOG_ARG_TYPE_E type;
+} LOG_SPEC_S;
+
+typedef struct {
+    uint16_t len; // whole record, aligned, or LOG_DEFER_REC_PAD
+    uint8_t level;
+    LOG_REC_TYPE_E type;
+    uint32_t line;
+    const char *file;
+    const char *fmt;
+    SYS_TIME_T uptime_ms;
+} LOG_DEFER_REC_S;
+
+typedef struct {
+    uint8_t *ring;
+    uint32_t size;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t used;
+    SYS_TICK_T posix_base; // posix time minus uptime, refreshed before each output batch
+    uint32_t dropped_reported;
+    THREAD_HANDLE thread;
+    SEM_HANDLE sem;
+    TAL_LOG_DEFERRED_STATS_T stats;
+} LOG_DEFER_S;
+#endif
+
 /***********************************************************
 *************************variable define********************
 ***********************************************************/
 const char *sLevelStr[] = {"E", "W", "N", "I", "D", "T"};
 P_LOG_MANAGE pLogManage = NULL;
+#if defined(ENABLE_LOG_DEFERRED) && (ENABLE_LOG_DEFERRED == 1)
+static LOG_DEFER_S *s_log_defer = NULL;
+#endif
 
 const LOG_TEXT_STYLE_S sDefaultStyle[LOG_LEVEL_MAX + 1] = {
     {TAL_LOG_DISPLAY_MODE_DEFAULT, TAL_LOG_FONT_COLOR_RED, TAL_LOG_BACKGROUND_COLOR_DEFAULT},
@@ -94,6 +156,11 @@ const LOG_TEXT_STYLE_S sDefaultStyle[LOG_LEVEL_MAX + 1] = {
 /***********************************************************
 *************************function define********************
 ***********************************************************/
+#if defined(ENABLE_LOG_DEFERRED) && (ENABLE_LOG_DEFERRED == 1)
+static void __log_defer_init(void);
+static void __log_defer_release(void);
+#endif
+
 /**
  * @brief Initializes the TAL log system.
  *
@@ -146,6 +213,11 @@ OPERATE_RET tal_log_init(const TAL_LOG_LEVEL_E level, const int buf_len, const T
             tal_free(tmp_log_mng);
             return op_ret;
         }
+
+#if defined(ENABLE_LOG_DEFERRED) && (ENABLE_LOG_DEFERRED == 1)
+        // logs stay synchronous when the deferred ring cannot be created
+        __log_defer_init();
+#endif
     } else {
         pLogManage->curLogLevel = level;
     }
@@ -407,49 +479,8 @@ OPERATE_RET tal_log_get_level(TAL_LOG_LEVEL_E *level)
     return OPRT_OK;
 }
 
-/**
- * @brief Prints a log message with the specified log level, file name, line
- * number, and format string.
- *
- * This function is used to print log messages with different log levels. It
- * takes the log level, file name, line number, format string, and a variable
- * argument list as parameters. The log level determines the severity of the log
- * message. The file name and line number indicate the location where the log
- * message is printed. The format string specifies the format of the log
- * message, and the variable argument list contains the values to be formatted
- * and printed.
- *
- * @param logLevel The log level of the message.
- * @param pFile The name of the source file where the log message is printed.
- * @param line The line number in the source file where the log message is
- * printed.
- * @param pFmt The format string for the log message.
- * @param ap The variable argument list for the format string.
- * @return The result of the log printing operation.
- *     - OPRT_OK if the log message was printed successfully.
- *     - OPRT_INVALID_PARM if the log level is invalid or the log manager is not
- * initialized.
- *     - OPRT_BASE_LOG_MNG_PRINT_LOG_LEVEL_HIGHER if the log level is higher
- * than the current log level.
- *     - OPRT_BASE_LOG_MNG_FORMAT_STRING_FAILED if there was an error formatting
- * the log message.
- */
-OPERATE_RET PrintLogV(LOG_LEVEL logLevel, char *pFile, uint32_t line, const char *pFmt, va_list ap)
+static const char *__log_file_name(const char *pFile)
 {
-    int len = 0;
-    int cnt = 0;
-
-    if (!pLogManage) {
-        return OPRT_INVALID_PARM;
-    }
-    if (logLevel < LOG_LEVEL_MIN || logLevel > LOG_LEVEL_MAX) {
-        return OPRT_INVALID_PARM;
-    }
-    LOG_LEVEL tmpLogLevel = pLogManage->curLogLevel;
-    if (logLevel > tmpLogLevel) {
-        return OPRT_BASE_LOG_MNG_PRINT_LOG_LEVEL_HIGHER;
-    }
-    const char *pTmpModuleName = "ty";
     const char *pTmpFilename = NULL;
 
     if (NULL == pFile) {
@@ -467,7 +498,22 @@ OPERATE_RET PrintLogV(LOG_LEVEL logLevel, char *pFile, uint32_t line, const char
             pTmpFilename = pFile + pos + 1;
         }
     }
-    tal_mutex_lock(pLogManage->mutex);
+
+    return pTmpFilename;
+}
+
+/**
+ * @brief write the color, time and location prefix of a log message into the
+ * log buffer, posix_ms is the time of the message, 0 for now
+ *
+ * @return the prefix length, -1 on error
+ */
+static int __log_fmt_head(LOG_LEVEL logLevel, const char *pFile, uint32_t line, SYS_TICK_T posix_ms)
+{
+    int len = 0;
+    int cnt = 0;
+    const char *pTmpModuleName = "ty";
+    const char *pTmpFilename = __log_file_name(pFile);
 
     // color prefix
     if (pLogManage->log_color.enable_color) {
@@ -476,7 +522,7 @@ OPERATE_RET PrintLogV(LOG_LEVEL logLevel, char *pFile, uint32_t line, const char
                        pLogManage->log_color.style[logLevel].font_color,
                        pLogManage->log_color.style[logLevel].background_color);
         if (cnt <= 0) {
-            goto ERR_EXIT;
+            return -1;
         }
         len += cnt;
     }
@@ -485,12 +531,12 @@ OPERATE_RET PrintLogV(LOG_LEVEL logLevel, char *pFile, uint32_t line, const char
     memset(&tm, 0, sizeof(tm));
 
     if (pLogManage->ms_level == FALSE) {
-        tal_time_get_local_time_custom(0, &tm);
+        tal_time_get_local_time_custom((TIME_T)(posix_ms / 1000), &tm);
         cnt = snprintf(pLogManage->log_buf + len, pLogManage->log_buf_len - len,
                        "[%02d-%02d %02d:%02d:%02d %s %s][%s:%" PRIu32 "] ", tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
                        tm.tm_min, tm.tm_sec, pTmpModuleName, sLevelStr[logLevel], pTmpFilename, line);
     } else {
-        SYS_TICK_T time_ms = tal_time_get_posix_ms();
+        SYS_TICK_T time_ms = posix_ms ? posix_ms : tal_time_get_posix_ms();
         TIME_T sec = (TIME_T)(time_ms / 1000);
         uint32_t ms = (uint32_t)(time_ms % 1000);
         tal_time_get_local_time_custom(sec, &tm);
@@ -499,16 +545,673 @@ OPERATE_RET PrintLogV(LOG_LEVEL logLevel, char *pFile, uint32_t line, const char
                        tm.tm_hour, tm.tm_min, tm.tm_sec, ms, pTmpModuleName, sLevelStr[logLevel], pTmpFilename, line);
     }
     if (cnt <= 0) {
-        goto ERR_EXIT;
+        return -1;
     }
     len += cnt;
 
     // Check if there's enough space left for the formatted message
-    int remaining = pLogManage->log_buf_len - len;
-    if (remaining <= 0) {
+    if (pLogManage->log_buf_len - len <= 0) {
+        return -1;
+    }
+
+    return len;
+}
+
+/**
+ * @brief append the color reset and line end to the log buffer holding len bytes
+ *
+ * @return the message length, -1 on error
+ */
+static int __log_fmt_tail(int len)
+{
+    int cnt = 0;
+
+    char *p_suffix = (pLogManage->log_color.enable_color) ? "\033[0m\r\n" : "\r\n";
+    if (len > (int)(pLogManage->log_buf_len - strlen(p_suffix) - 1)) { // 1 -> "\0"
+        len = pLogManage->log_buf_len - strlen(p_suffix) - 1;
+    }
+    cnt = snprintf(pLogManage->log_buf + len, pLogManage->log_buf_len - len, "%s", p_suffix);
+    if (cnt <= 0) {
+        return -1;
+    }
+    len += cnt;
+    pLogManage->log_buf[len] = '\0';
+
+    return len;
+}
+
+#if defined(ENABLE_LOG_DEFERRED) && (ENABLE_LOG_DEFERRED == 1)
+/**
+ * @brief find the next conversion spec of a format string and the argument it takes
+ *
+ * @return the spec start, NULL when there is none left
+ */
+static const char *__log_spec_next(const char *fmt, LOG_SPEC_S *spec)
+{
+    const char *p = strchr(fmt, '%');
+    char lmod = 0;
+    BOOL_T is_double_l = FALSE;
+
+    if (NULL == p) {
+        return NULL;
+    }
+
+    spec->start = p++;
+    spec->star = 0;
+    if (*p == '%') {
+        spec->len = 2;
+        spec->type = LOG_ARG_NONE;
+        return spec->start;
+    }
+
+    while (*p && strchr(" #+-0'", *p)) {
+        p++;
+    }
+    if (*p == '*') {
+        spec->star++;
+        p++;
+    }
+    while (isdigit((unsigned char)(*p))) {
+        p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->star++;
+            p++;
+        }
+        while (isdigit((unsigned char)(*p))) {
+            p++;
+        }
+    }
+    if (*p && strchr("hljztL", *p)) {
+        lmod = *p++;
+        if ((lmod == 'h' || lmod == 'l') && *p == lmod) {
+            is_double_l = (lmod == 'l');
+            p++;
+        }
+    }
+
+    switch (*p) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+    case 'c':
+        if (lmod == 'l' && *p == 'c') {
+            spec->type = LOG_ARG_UNKNOWN;
+        } else if (is_double_l) {
+            spec->type = LOG_ARG_LLONG;
+        } else if (lmod == 'l') {
+            spec->type = LOG_ARG_LONG;
+        } else if (lmod == 'z') {
+            spec->type = LOG_ARG_SIZE;
+        } else if (lmod == 't') {
+            spec->type = LOG_ARG_PTRDIFF;
+        } else if (lmod == 'j') {
+            spec->type = LOG_ARG_INTMAX;
+        } else {
+            spec->type = LOG_ARG_INT;
+        }
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        spec->type = (lmod == 'L') ? LOG_ARG_LDOUBLE : LOG_ARG_DOUBLE;
+        break;
+    case 'p':
+        spec->type = LOG_ARG_PTR;
+        break;
+    case 's':
+        spec->type = (lmod == 'l') ? LOG_ARG_UNKNOWN : LOG_ARG_STR;
+        break;
+    default:
+        spec->type = LOG_ARG_UNKNOWN;
+        break;
+    }
+
+    spec->len = (uint8_t)(p - spec->start + (*p ? 1 : 0));
+    if (spec->len > LOG_DEFER_SPEC_LEN) {
+        spec->type = LOG_ARG_UNKNOWN;
+    }
+
+    return spec->start;
+}
+
+#define LOG_DEFER_ARG_PUT(type)                                                                                        \
+    do {                                                                                                               \
+        type __v = va_arg(ap, type);                                                                                   \
+        if (len + (int)sizeof(type) > size) {                                                                          \
+            return -1;                                                                                                 \
+        }                                                                                                              \
+        memcpy(out + len, &__v, sizeof(type));                                                                         \
+        len += sizeof(type);                                                                                           \
+    } while (0)
+
+#define LOG_DEFER_ARG_PRINT(type)                                                                                      \
+    do {                                                                                                               \
+        type __v;                                                                                                      \
+        if (pos + (int)sizeof(type) > arg_len) {                                                                       \
+            goto __EXIT;                                                                                               \
+        }                                                                                                              \
+        memcpy(&__v, arg + pos, sizeof(type));                                                                         \
+        pos += sizeof(type);                                                                                           \
+        cnt = snprintf(buf + len, size - len, spec_buf, __v);                                                          \
+    } while (0)
+
+/**
+ * @brief copy the arguments of a format string into a record payload
+ *
+ * @return the payload length, -1 when the format has a conversion not kept in
+ * binary form or the arguments do not fit, strings included
+ */
+static int __log_defer_encode(uint8_t *out, int size, const char *fmt, va_list ap)
+{
+    LOG_SPEC_S spec;
+    const char *str = NULL;
+    int len = 0;
+    int n = 0;
+    uint8_t i;
+
+    while (NULL != __log_spec_next(fmt, &spec)) {
+        fmt = spec.start + spec.len;
+
+        for (i = 0; i < spec.star; i++) {
+            LOG_DEFER_ARG_PUT(int);
+        }
+
+        switch (spec.type) {
+        case LOG_ARG_NONE:
+            break;
+        case LOG_ARG_INT:
+            LOG_DEFER_ARG_PUT(int);
+            break;
+        case LOG_ARG_LONG:
+            LOG_DEFER_ARG_PUT(long);
+            break;
+        case LOG_ARG_LLONG:
+            LOG_DEFER_ARG_PUT(long long);
+            break;
+        case LOG_ARG_SIZE:
+            LOG_DEFER_ARG_PUT(size_t);
+            break;
+        case LOG_ARG_PTRDIFF:
+            LOG_DEFER_ARG_PUT(ptrdiff_t);
+            break;
+        case LOG_ARG_INTMAX:
+            LOG_DEFER_ARG_PUT(intmax_t);
+            break;
+        case LOG_ARG_DOUBLE:
+            LOG_DEFER_ARG_PUT(double);
+            break;
+        case LOG_ARG_LDOUBLE:
+            LOG_DEFER_ARG_PUT(long double);
+            break;
+        case LOG_ARG_PTR:
+            LOG_DEFER_ARG_PUT(void *);
+            break;
+        case LOG_ARG_STR:
+            // the string may be gone by the output, keep a whole copy in the space left
+            str = va_arg(ap, const char *);
+            if (NULL == str) {
+                str = "(null)";
+            }
+            for (n = 0; len + n < size - 1 && str[n]; n++) {
+            }
+            if (str[n] || len + n + 1 > size) {
+                return -1;
+            }
+            memcpy(out + len, str, n);
+            out[len + n] = '\0';
+            len += n + 1;
+            break;
+        default:
+            return -1;
+        }
+    }
+
+    return len;
+}
+
+/**
+ * @brief format a record payload with its format string into buf
+ *
+ * @return the message length
+ */
+static int __log_defer_format(char *buf, int size, const char *fmt, const uint8_t *arg, int arg_len)
+{
+    LOG_SPEC_S spec;
+    char spec_buf[LOG_DEFER_SPEC_MAX];
+    const char *next = NULL;
+    int len = 0;
+    int pos = 0;
+    int cnt = 0;
+    int n = 0;
+    int star = 0;
+    uint8_t i;
+
+    while (len < size - 1) {
+        // literal text up to the next conversion
+        next = __log_spec_next(fmt, &spec);
+        n = next ? (int)(next - fmt) : (int)strlen(fmt);
+        if (n > size - 1 - len) {
+            n = size - 1 - len;
+        }
+        memcpy(buf + len, fmt, n);
+        len += n;
+        if (NULL == next || len >= size - 1) {
+            break;
+        }
+        fmt = spec.start + spec.len;
+
+        if (LOG_ARG_NONE == spec.type) {
+            buf[len++] = '%';
+            continue;
+        }
+
+        // the spec with the stored width and precision in place of '*'
+        n = 0;
+        for (i = 0; i < spec.len; i++) {
+            if (spec.start[i] != '*') {
+                spec_buf[n++] = spec.start[i];
+                continue;
+            }
+            if (pos + (int)sizeof(int) > arg_len) {
+                goto __EXIT;
+            }
+            memcpy(&star, arg + pos, sizeof(int));
+            pos += sizeof(int);
+            n += snprintf(spec_buf + n, sizeof(spec_buf) - n, "%d", star);
+        }
+        spec_buf[n] = '\0';
+
+        switch (spec.type) {
+        case LOG_ARG_INT:
+            LOG_DEFER_ARG_PRINT(int);
+            break;
+        case LOG_ARG_LONG:
+            LOG_DEFER_ARG_PRINT(long);
+            break;
+        case LOG_ARG_LLONG:
+            LOG_DEFER_ARG_PRINT(long long);
+            break;
+        case LOG_ARG_SIZE:
+            LOG_DEFER_ARG_PRINT(size_t);
+            break;
+        case LOG_ARG_PTRDIFF:
+            LOG_DEFER_ARG_PRINT(ptrdiff_t);
+            break;
+        case LOG_ARG_INTMAX:
+            LOG_DEFER_ARG_PRINT(intmax_t);
+            break;
+        case LOG_ARG_DOUBLE:
+            LOG_DEFER_ARG_PRINT(double);
+            break;
+        case LOG_ARG_LDOUBLE:
+            LOG_DEFER_ARG_PRINT(long double);
+            break;
+        case LOG_ARG_PTR:
+            LOG_DEFER_ARG_PRINT(void *);
+            break;
+        case LOG_ARG_STR:
+            if (pos >= arg_len) {
+                goto __EXIT;
+            }
+            cnt = snprintf(buf + len, size - len, spec_buf, (const char *)(arg + pos));
+            pos += strlen((const char *)(arg + pos)) + 1;
+            break;
+        default:
+            goto __EXIT;
+        }
+
+        if (cnt < 0) {
+            break;
+        }
+        len += (cnt >= size - len) ? (size - len - 1) : cnt;
+    }
+
+__EXIT:
+    buf[len] = '\0';
+    return len;
+}
+
+static OPERATE_RET __log_defer_write(LOG_DEFER_REC_S *rec, uint32_t truncated)
+{
+    LOG_DEFER_S *defer = s_log_defer;
+    uint32_t irq_mask = 0;
+    uint32_t pad = 0;
+    BOOL_T was_empty = FALSE;
+    BOOL_T is_queued = FALSE;
+
+    irq_mask = tal_system_enter_critical();
+    // a record never wraps, the space left at the ring end is skipped
+    if (defer->head + rec->len > defer->size) {
+        pad = defer->size - defer->head;
+    }
+    if (defer->used + pad + rec->len <= defer->size) {
+        was_empty = (0 == defer->used);
+        if (pad) {
+            ((LOG_DEFER_REC_S *)(defer->ring + defer->head))->len = LOG_DEFER_REC_PAD;
+            defer->head = 0;
+        }
+        memcpy(defer->ring + defer->head, rec, rec->len);
+        defer->head += rec->len;
+        if (defer->head == defer->size) {
+            defer->head = 0;
+        }
+        defer->used += pad + rec->len;
+
+        defer->stats.records++;
+        defer->stats.truncated += truncated;
+        if (defer->used > defer->stats.used_max) {
+            defer->stats.used_max = defer->used;
+        }
+        is_queued = TRUE;
+    } else {
+        defer->stats.dropped++;
+    }
+    tal_system_exit_critical(irq_mask);
+
+    if (was_empty) {
+        tal_semaphore_post(defer->sem);
+    }
+
+    return is_queued ? OPRT_OK : OPRT_BUFFER_NOT_ENOUGH;
+}
+
+/**
+ * @brief queue a log message, keeping the format and binary arguments when the
+ * format string is constant, the formatted message otherwise
+ */
+static OPERATE_RET __log_defer_push(LOG_LEVEL logLevel, const char *pFile, uint32_t line, const char *pFmt,
+                                    va_list ap, LOG_REC_TYPE_E type)
+{
+    uint64_t rec_buf[LOG_DEFER_REC_MAX / sizeof(uint64_t)];
+    LOG_DEFER_REC_S *rec = (LOG_DEFER_REC_S *)rec_buf;
+    uint8_t *payload = (uint8_t *)(rec + 1);
+    int size = LOG_DEFER_REC_MAX - sizeof(LOG_DEFER_REC_S);
+    uint32_t truncated = 0;
+    int len = -1;
+
+    rec->level = logLevel;
+    rec->type = type;
+    rec->line = line;
+    rec->file = pFile;
+    rec->fmt = pFmt;
+    rec->uptime_ms = tal_system_get_millisecond();
+
+    if (LOG_REC_FMT == type) {
+        va_list ap_copy;
+        va_copy(ap_copy, ap);
+        len = __log_defer_encode(payload, size, pFmt, ap_copy);
+        va_end(ap_copy);
+    }
+
+    if (len < 0) {
+        rec->type = (LOG_REC_RAW == type) ? LOG_REC_RAW : LOG_REC_TEXT;
+        len = vsnprintf((char *)payload, size, pFmt, ap);
+        if (len < 0) {
+            return OPRT_BASE_LOG_MNG_FORMAT_STRING_FAILED;
+        }
+        if (len >= size) {
+            len = size - 1;
+            truncated++;
+        }
+        len++; // the terminator
+    }
+    rec->len = LOG_DEFER_ALIGN(sizeof(LOG_DEFER_REC_S) + len);
+
+    return __log_defer_write(rec, truncated);
+}
+
+static void __log_defer_output(LOG_DEFER_REC_S *rec)
+{
+    const uint8_t *payload = (const uint8_t *)(rec + 1);
+    int arg_len = rec->len - sizeof(LOG_DEFER_REC_S);
+    int len = 0;
+    int cnt = 0;
+
+    if (LOG_REC_RAW == rec->type) {
+        cnt = snprintf(pLogManage->log_buf, pLogManage->log_buf_len, "%s", (const char *)payload);
+        if (cnt <= 0) {
+            return;
+        }
+        __output_logManage_buf();
+        return;
+    }
+
+    len = __log_fmt_head(rec->level, rec->file, rec->line, s_log_defer->posix_base + rec->uptime_ms);
+    if (len < 0) {
+        return;
+    }
+
+    if (LOG_REC_FMT == rec->type) {
+        len += __log_defer_format(pLogManage->log_buf + len, pLogManage->log_buf_len - len, rec->fmt, payload,
+                                  arg_len);
+    } else {
+        cnt = snprintf(pLogManage->log_buf + len, pLogManage->log_buf_len - len, "%s", (const char *)payload);
+        if (cnt < 0) {
+            return;
+        }
+        len += (cnt >= pLogManage->log_buf_len - len) ? (pLogManage->log_buf_len - len - 1) : cnt;
+    }
+
+    if (__log_fmt_tail(len) < 0) {
+        return;
+    }
+
+    __output_logManage_buf();
+}
+
+/**
+ * @brief output the queued records, is_locked FALSE in crash context
+ */
+static void __log_defer_drain(BOOL_T is_locked)
+{
+    LOG_DEFER_S *defer = s_log_defer;
+    LOG_DEFER_REC_S *rec = NULL;
+    uint32_t irq_mask = 0;
+    uint32_t dropped = 0;
+    int len = 0;
+
+    // the time service takes a lock, not refreshed in crash context
+    if (is_locked) {
+        defer->posix_base = tal_time_get_posix_ms() - tal_system_get_millisecond();
+    }
+
+    do {
+        if (is_locked) {
+            tal_mutex_lock(pLogManage->mutex);
+        }
+
+        irq_mask = tal_system_enter_critical();
+        if (defer->used && LOG_DEFER_REC_PAD == ((LOG_DEFER_REC_S *)(defer->ring + defer->tail))->len) {
+            defer->used -= defer->size - defer->tail;
+            defer->tail = 0;
+        }
+        rec = defer->used ? (LOG_DEFER_REC_S *)(defer->ring + defer->tail) : NULL;
+        tal_system_exit_critical(irq_mask);
+
+        // the record space is released only once output, writers cannot reuse it
+        if (rec) {
+            __log_defer_output(rec);
+
+            irq_mask = tal_system_enter_critical();
+            defer->tail += rec->len;
+            if (defer->tail == defer->size) {
+                defer->tail = 0;
+            }
+            defer->used -= rec->len;
+            tal_system_exit_critical(irq_mask);
+        }
+
+        if (is_locked) {
+            tal_mutex_unlock(pLogManage->mutex);
+        }
+    } while (rec);
+
+    dropped = defer->stats.dropped;
+    if (dropped != defer->dropped_reported) {
+        if (is_locked) {
+            tal_mutex_lock(pLogManage->mutex);
+        }
+        len = __log_fmt_head(TAL_LOG_LEVEL_WARN, __FILE__, __LINE__, defer->posix_base + tal_system_get_millisecond());
+        if (len >= 0) {
+            len += snprintf(pLogManage->log_buf + len, pLogManage->log_buf_len - len, "%" PRIu32 " log records dropped",
+                            dropped - defer->dropped_reported);
+            if (len < pLogManage->log_buf_len && __log_fmt_tail(len) >= 0) {
+                __output_logManage_buf();
+            }
+        }
+        if (is_locked) {
+            tal_mutex_unlock(pLogManage->mutex);
+        }
+        defer->dropped_reported = dropped;
+    }
+}
+
+static void __log_defer_thread(void *arg)
+{
+    while (THREAD_STATE_RUNNING == tal_thread_get_state(s_log_defer->thread)) {
+        tal_semaphore_wait(s_log_defer->sem, SEM_WAIT_FOREVER);
+        __log_defer_drain(TRUE);
+    }
+}
+
+static void __log_defer_init(void)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    uint32_t size = LOG_DEFERRED_BUF_SIZE & ~7;
+    THREAD_CFG_T thread_cfg = {
+        .stackDepth = STACK_SIZE_LOG_DEFERRED,
+        .priority = THREAD_PRIO_6,
+        .thrdname = "log_defer",
+    };
+
+    LOG_DEFER_S *defer = (LOG_DEFER_S *)tal_calloc(1, sizeof(LOG_DEFER_S) + size);
+    if (NULL == defer) {
+        return;
+    }
+    defer->ring = (uint8_t *)LOG_DEFER_ALIGN((uintptr_t)(defer + 1));
+    defer->size = (uint32_t)(((uint8_t *)(defer + 1) + size - defer->ring)) & ~7;
+
+    op_ret = tal_semaphore_create_init(&defer->sem, 0, 1);
+    if (OPRT_OK != op_ret) {
+        tal_free(defer);
+        return;
+    }
+
+    s_log_defer = defer;
+    op_ret = tal_thread_create_and_start(&defer->thread, NULL, NULL, __log_defer_thread, NULL, &thread_cfg);
+    if (OPRT_OK != op_ret) {
+        s_log_defer = NULL;
+        tal_semaphore_release(defer->sem);
+        tal_free(defer);
+    }
+}
+
+static void __log_defer_release(void)
+{
+    LOG_DEFER_S *defer = s_log_defer;
+
+    if (NULL == defer) {
+        return;
+    }
+
+    if (OPRT_OK == tal_thread_delete(defer->thread)) {
+        tal_semaphore_post(defer->sem);
+        while (THREAD_STATE_DELETE != tal_thread_get_state(defer->thread)) {
+            tal_system_sleep(10);
+        }
+    }
+
+    // later logs are synchronous, flush the queued ones first
+    __log_defer_drain(TRUE);
+    s_log_defer = NULL;
+
+    tal_semaphore_release(defer->sem);
+    tal_free(defer);
+}
+
+/**
+ * @brief Outputs the queued deferred log records in the caller context.
+ *
+ * From a crash or exception hook, in_crash skips every lock: the records are
+ * formatted into the log buffer and written to the output terminals directly.
+ *
+ * @param in_crash TRUE when called from a crash or exception hook.
+ */
+void tal_log_deferred_flush(BOOL_T in_crash)
+{
+    if (NULL == pLogManage || NULL == s_log_defer) {
+        return;
+    }
+
+    __log_defer_drain(!in_crash);
+}
+
+/**
+ * @brief Gets the deferred log statistics.
+ *
+ * @param[out] stats The statistics since the log initialization.
+ * @return OPRT_OK on success, OPRT_INVALID_PARM if deferred logging is not
+ * running.
+ */
+OPERATE_RET tal_log_deferred_get_stats(TAL_LOG_DEFERRED_STATS_T *stats)
+{
+    uint32_t irq_mask = 0;
+
+    if (NULL == stats || NULL == s_log_defer) {
+        return OPRT_INVALID_PARM;
+    }
+
+    irq_mask = tal_system_enter_critical();
+    *stats = s_log_defer->stats;
+    tal_system_exit_critical(irq_mask);
+
+    return OPRT_OK;
+}
+#endif
+
+static OPERATE_RET __print_log_v(LOG_LEVEL logLevel, char *pFile, uint32_t line, const char *pFmt, va_list ap,
+                                 BOOL_T is_const_fmt)
+{
+    int len = 0;
+    int cnt = 0;
+
+    if (!pLogManage) {
+        return OPRT_INVALID_PARM;
+    }
+    if (logLevel < LOG_LEVEL_MIN || logLevel > LOG_LEVEL_MAX) {
+        return OPRT_INVALID_PARM;
+    }
+    LOG_LEVEL tmpLogLevel = pLogManage->curLogLevel;
+    if (logLevel > tmpLogLevel) {
+        return OPRT_BASE_LOG_MNG_PRINT_LOG_LEVEL_HIGHER;
+    }
+
+#if defined(ENABLE_LOG_DEFERRED) && (ENABLE_LOG_DEFERRED == 1)
+    // the format pointer is only kept when the string is constant
+    if (s_log_defer) {
+        return __log_defer_push(logLevel, pFile, line, pFmt, ap, is_const_fmt ? LOG_REC_FMT : LOG_REC_TEXT);
+    }
+#endif
+
+    tal_mutex_lock(pLogManage->mutex);
+
+    len = __log_fmt_head(logLevel, pFile, line, 0);
+    if (len < 0) {
         goto ERR_EXIT;
     }
 
+    int remaining = pLogManage->log_buf_len - len;
     cnt = vsnprintf(pLogManage->log_buf + len, remaining, pFmt, ap);
     if (cnt < 0) {
         goto ERR_EXIT;
@@ -521,16 +1224,10 @@ OPERATE_RET PrintLogV(LOG_LEVEL logLevel, char *pFile, uint32_t line, const char
     }
     len += cnt;
 
-    char *p_suffix = (pLogManage->log_color.enable_color) ? "\033[0m\r\n" : "\r\n";
-    if (len > (int)(pLogManage->log_buf_len - strlen(p_suffix) - 1)) { // 1 -> "\0"
-        len = pLogManage->log_buf_len - strlen(p_suffix) - 1;
-    }
-    cnt = snprintf(pLogManage->log_buf + len, pLogManage->log_buf_len - len, "%s", p_suffix);
-    if (cnt <= 0) {
+    len = __log_fmt_tail(len);
+    if (len < 0) {
         goto ERR_EXIT;
     }
-    len += cnt;
-    pLogManage->log_buf[len] = '\0';
 
     __output_logManage_buf();
     tal_mutex_unlock(pLogManage->mutex);
@@ -542,6 +1239,38 @@ ERR_EXIT:
     return OPRT_BASE_LOG_MNG_FORMAT_STRING_FAILED;
 }
 
+/**
+ * @brief Prints a log message with the specified log level, file name, line
+ * number, and format string.
+ *
+ * This function is used to print log messages with different log levels. It
+ * takes the log level, file name, line number, format string, and a variable
+ * argument list as parameters. The log level determines the severity of the log
+ * message. The file name and line number indicate the location where the log
+ * message is printed. The format string specifies the format of the log
+ * message, and the variable argument list contains the values to be formatted
+ * and printed.
+ *
+ * @param logLevel The log level of the message.
+ * @param pFile The name of the source file where the log message is printed.
+ * @param line The line number in the source file where the log message is
+ * printed.
+ * @param pFmt The format string for the log message.
+ * @param ap The variable argument list for the format string.
+ * @return The result of the log printing operation.
+ *     - OPRT_OK if the log message was printed successfully.
+ *     - OPRT_INVALID_PARM if the log level is invalid or the log manager is not
+ * initialized.
+ *     - OPRT_BASE_LOG_MNG_PRINT_LOG_LEVEL_HIGHER if the log level is higher
+ * than the current log level.
+ *     - OPRT_BASE_LOG_MNG_FORMAT_STRING_FAILED if there was an error formatting
+ * the log message.
+ */
+OPERATE_RET PrintLogV(LOG_LEVEL logLevel, char *pFile, uint32_t line, const char *pFmt, va_list ap)
+{
+    return __print_log_v(logLevel, pFile, line, pFmt, ap, FALSE);
+}
+
 /**
  * @brief Prints a log message with the specified log level, file, line number,
  * and format string.
@@ -592,7 +1321,7 @@ OPERATE_RET tal_log_print_secure(BOOL_T is_const_fmt, const TAL_LOG_LEVEL_E leve
         }
         va_list ap;
         va_start(ap, fmt);
-        OPERATE_RET ret = PrintLogV(level, (char *)file, line, fmt, ap);
+        OPERATE_RET ret = __print_log_v(level, (char *)file, line, fmt, ap, TRUE);
         va_end(ap);
         return ret;
     }
@@ -639,6 +1368,16 @@ OPERATE_RET tal_log_print_raw(const char *pFmt, ...)
     OPERATE_RET opRet = 0;
     va_list ap;
 
+#if defined(ENABLE_LOG_DEFERRED) && (ENABLE_LOG_DEFERRED == 1)
+    // queued as well, so it keeps its place among the deferred messages
+    if (s_log_defer) {
+        va_start(ap, pFmt);
+        opRet = __log_defer_push(TAL_LOG_LEVEL_ERR, NULL, 0, pFmt, ap, LOG_REC_RAW);
+        va_end(ap);
+        return opRet;
+    }
+#endif
+
     tal_mutex_lock(pLogManage->mutex);
     va_start(ap, pFmt);
     opRet = __PrintLogVRaw(pFmt, ap);
@@ -704,9 +1443,13 @@ void tal_log_release(void)
         return;
     }
 
+#if defined(ENABLE_LOG_DEFERRED) && (ENABLE_LOG_DEFERRED == 1)
+    __log_defer_release();
+#endif
+
     while (!tuya_list_empty(&(pLogManage->log_list))) {
         LOG_OUT_NODE_S *log_out_nd = NULL;
-        log_out_nd = tuya_list_entry(&(pLogManage->log_list.next), LOG_OUT_NODE_S, node);
+        log_out_nd = tuya_list_entry(pLogManage->log_list.next, LOG_OUT_NODE_S, node);
         tuya_list_del(&(log_out_nd->node));
         if (log_out_nd->name) {
             tal_free(log_out_nd->name);
@@ -744,6 +1487,8 @@ void tal_log_hex_dump(const TAL_LOG_LEVEL_E level, const char *file, const int l
                       uint8_t *buf, uint16_t size)
 {
     uint16_t i = 0, j = 0;
+    char dump[128];
+    int len = 0;
 
     if (!pLogManage || level > pLogManage->curLogLevel) {
         return;
@@ -754,28 +1499,34 @@ void tal_log_hex_dump(const TAL_LOG_LEVEL_E level, const char *file, const int l
     }
     tal_log_print(level, file, line, "%s %d <%p>", title, size, buf);
 
+    // a line is printed in one go, not one raw print per byte
     for (i = 0; i < size; i += width) {
-        tal_log_print_raw("%04lX | ", i);
+        len = snprintf(dump, sizeof(dump), "%04X | ", i);
 
         for (j = i; j < i + width; j++) {
+            if (len > (int)sizeof(dump) - 4) {
+                tal_log_print_raw("%s", dump);
+                len = 0;
+            }
             if (j < size) {
-                tal_log_print_raw("%02X ", buf[j]);
+                len += snprintf(dump + len, sizeof(dump) - len, "%02X ", buf[j]);
             } else {
-                tal_log_print_raw("   ");
+                len += snprintf(dump + len, sizeof(dump) - len, "   ");
             }
         }
 
-        tal_log_print_raw("| ");
+        len += snprintf(dump + len, sizeof(dump) - len, "| ");
 
         for (j = i; j < i + width && j < size; j++) {
-            if (isprint(buf[j])) {
-                tal_log_print_raw("%c", buf[j]);
-            } else {
-                tal_log_print_raw(".");
+            if (len > (int)sizeof(dump) - 4) {
+                tal_log_print_raw("%s", dump);
+                len = 0;
             }
+            dump[len++] = isprint(buf[j]) ? buf[j] : '.';
         }
 
-        tal_log_print_raw("\r\n");
+        snprintf(dump + len, sizeof(dump) - len, "\r\n");
+        tal_log_print_raw("%s", dump);
     }
     tal_log_print_raw("\r\n");
 }
@@ -12,6 +12,20 @@
 #define STACK_SIZE_TIMERQ (4 * 1024)
 #endif
 
+/**
+ * running timers live in a hierarchical timing wheel keyed by their expire time in ms.
+ * level 0 has one slot per ms, every higher level one slot per whole lower level, so
+ * start and stop are O(1). when the dispatcher passes the end of a lower level the next
+ * slot of the level above is cascaded down. timers further out than the wheel span
+ * are parked at the span end and re-inserted when they get there.
+ */
+#define TW_LEVEL_BITS 6
+#define TW_LEVEL_SIZE (1 << TW_LEVEL_BITS)
+#define TW_LEVEL_MASK (TW_LEVEL_SIZE - 1)
+#define TW_LEVEL_NUM  5
+#define TW_SPAN_MAX   ((1ULL << (TW_LEVEL_BITS * TW_LEVEL_NUM)) - 1) // ms, about 12 days
+#define TW_LEVEL_NONE 0xFF                                           // not in the wheel
+
 typedef struct {
     LIST_HEAD node;
 
@@ -23,10 +37,20 @@ typedef struct {
     BOOL_T is_running;
     TIMER_ID timer_id;
     TIMER_TYPE type;
+
+    uint8_t level;
+    uint8_t slot;
 } TIMER_T;
 
 typedef struct {
-    LIST_HEAD list_active;
+    LIST_HEAD slot[TW_LEVEL_SIZE];
+    uint64_t bitmap; // non-empty slots
+} TIMER_WHEEL_LEVEL_T;
+
+typedef struct {
+    TIMER_WHEEL_LEVEL_T level[TW_LEVEL_NUM];
+    uint64_t base; // next ms to be processed
+    LIST_HEAD list_expired;
     LIST_HEAD list_standby;
     MUTEX_HANDLE mutex;
     uint16_t total_cnt;
@@ -40,53 +64,253 @@ typedef struct {
 
 static SW_TIMER_MGR_T s_timer_mgr;
 
-static void __timer_attach(TIMER_T *timer)
+static uint64_t __timer_now(void)
+{
+    TIME_S sec = 0;
+    TIME_MS ms = 0;
+
+    tal_time_get_system_time(&sec, &ms);
+
+    return (uint64_t)sec * 1000 + (uint64_t)ms;
+}
+
+static uint32_t __bit_lowest(uint64_t bits)
+{
+    uint32_t n = 0;
+
+    if (0 == (bits & 0xFFFFFFFF)) {
+        n += 32;
+        bits >>= 32;
+    }
+    if (0 == (bits & 0xFFFF)) {
+        n += 16;
+        bits >>= 16;
+    }
+    if (0 == (bits & 0xFF)) {
+        n += 8;
+        bits >>= 8;
+    }
+    if (0 == (bits & 0xF)) {
+        n += 4;
+        bits >>= 4;
+    }
+    if (0 == (bits & 0x3)) {
+        n += 2;
+        bits >>= 2;
+    }
+    if (0 == (bits & 0x1)) {
+        n += 1;
+    }
+
+    return n;
+}
+
+// distance from slot start to the first non-empty slot, going round the level
+static uint32_t __wheel_distance(uint64_t bitmap, uint32_t start)
+{
+    if (start) {
+        bitmap = (bitmap >> start) | (bitmap << (TW_LEVEL_SIZE - start));
+    }
+
+    return __bit_lowest(bitmap);
+}
+
+static void __wheel_add(TIMER_T *timer)
+{
+    uint64_t key = timer->expire_time;
+    uint64_t delta = 0;
+    uint8_t level = 0;
+
+    if (key < s_timer_mgr.base) {
+        key = s_timer_mgr.base;
+    }
+
+    delta = key - s_timer_mgr.base;
+    if (delta > TW_SPAN_MAX) {
+        delta = TW_SPAN_MAX;
+        key = s_timer_mgr.base + TW_SPAN_MAX;
+    }
+
+    while (delta >> (TW_LEVEL_BITS * (level + 1))) {
+        level++;
+    }
+
+    timer->level = level;
+    timer->slot = (key >> (TW_LEVEL_BITS * level)) & TW_LEVEL_MASK;
+    tuya_list_add_tail(&(timer->node), &(s_timer_mgr.level[level].slot[timer->slot]));
+    s_timer_mgr.level[level].bitmap |= (1ULL << timer->slot);
+}
+
+static void __timer_detach(TIMER_T *timer)
 {
     tuya_list_del(&(timer->node));
 
-    if (tuya_list_empty(&(s_timer_mgr.list_active))) {
-        tuya_list_add_tail(&(timer->node), &(s_timer_mgr.list_active));
-    } else {
-        TIMER_T *timer_tmp = NULL;
-        struct tuya_list_head *p = NULL;
-        tuya_list_for_each(p, &(s_timer_mgr.list_active))
-        {
-            timer_tmp = tuya_list_entry(p, TIMER_T, node);
-
-            if (timer_tmp->expire_time >= timer->expire_time) {
-                tuya_list_add(&(timer->node), (&(timer_tmp->node))->prev);
-                break;
+    if (TW_LEVEL_NONE != timer->level) {
+        TIMER_WHEEL_LEVEL_T *level = &(s_timer_mgr.level[timer->level]);
+        if (tuya_list_empty(&(level->slot[timer->slot]))) {
+            level->bitmap &= ~(1ULL << timer->slot);
+        }
+        timer->level = TW_LEVEL_NONE;
+    }
+}
+
+static void __timer_attach(TIMER_T *timer)
+{
+    __timer_detach(timer);
+    __wheel_add(timer);
+}
+
+// take every timer out of a slot, re-inserting them or collecting the due ones
+static void __wheel_take_slot(uint32_t level, uint32_t slot, uint64_t now)
+{
+    TIMER_WHEEL_LEVEL_T *lv = &(s_timer_mgr.level[level]);
+    LIST_HEAD list;
+    TIMER_T *timer = NULL;
+    struct tuya_list_head *p = NULL;
+    struct tuya_list_head *n = NULL;
+
+    if (0 == (lv->bitmap & (1ULL << slot))) {
+        return;
+    }
+
+    INIT_LIST_HEAD(&list);
+    tuya_list_splice(&(lv->slot[slot]), &list);
+    INIT_LIST_HEAD(&(lv->slot[slot]));
+    lv->bitmap &= ~(1ULL << slot);
+
+    tuya_list_for_each_safe(p, n, &list)
+    {
+        timer = tuya_list_entry(p, TIMER_T, node);
+        tuya_list_del(&(timer->node));
+        timer->level = TW_LEVEL_NONE;
+
+        if (0 == level && timer->expire_time <= now) {
+            tuya_list_add_tail(&(timer->node), &(s_timer_mgr.list_expired));
+        } else {
+            __wheel_add(timer);
+        }
+    }
+}
+
+// tick where the first non-empty slot of a level gets processed: expiry on level 0, cascade above it
+static uint64_t __wheel_level_next(uint32_t level, uint32_t *slot)
+{
+    uint32_t shift = TW_LEVEL_BITS * level;
+    uint32_t distance = 0;
+    uint64_t first = 0;
+
+    // first slot boundary of this level at or after base
+    first = ((s_timer_mgr.base + (1ULL << shift) - 1) >> shift) << shift;
+    distance = __wheel_distance(s_timer_mgr.level[level].bitmap, (first >> shift) & TW_LEVEL_MASK);
+    *slot = ((first >> shift) + distance) & TW_LEVEL_MASK;
+
+    return first + ((uint64_t)distance << shift);
+}
+
+static uint64_t __wheel_next_tick(void)
+{
+    uint64_t tick = 0;
+    uint64_t next = UINT64_MAX;
+    uint32_t level = 0;
+    uint32_t slot = 0;
+
+    for (level = 0; level < TW_LEVEL_NUM; level++) {
+        if (s_timer_mgr.level[level].bitmap) {
+            tick = __wheel_level_next(level, &slot);
+            if (tick < next) {
+                next = tick;
+            }
+        }
+    }
+
+    return next;
+}
+
+// move the wheel up to now, collecting all due timers into list_expired in one pass.
+// ticks without work are skipped, so a long sleep costs one step per non-empty slot
+static void __wheel_advance(uint64_t now)
+{
+    uint64_t next = 0;
+    uint32_t index = 0;
+    uint32_t level = 0;
+
+    while (s_timer_mgr.base <= now) {
+        if (0 == (s_timer_mgr.base & TW_LEVEL_MASK)) {
+            for (level = 1; level < TW_LEVEL_NUM; level++) {
+                index = (s_timer_mgr.base >> (TW_LEVEL_BITS * level)) & TW_LEVEL_MASK;
+                __wheel_take_slot(level, index, now);
+                if (index) {
+                    break;
+                }
             }
         }
 
-        if (p == &(s_timer_mgr.list_active)) {
-            tuya_list_add_tail(&(timer->node), &(s_timer_mgr.list_active));
+        next = __wheel_next_tick();
+        if (next > now) {
+            s_timer_mgr.base = now + 1;
+        } else if (next > s_timer_mgr.base) {
+            s_timer_mgr.base = next;
+        } else {
+            __wheel_take_slot(0, s_timer_mgr.base & TW_LEVEL_MASK, now);
+            s_timer_mgr.base++;
         }
     }
 }
 
-static void __timer_dump(void)
+// ms until the next timer expires. below the top level the earliest slot holds the earliest
+// timers, so its shortest expiry is exact and the thread does not wake up for cascades.
+// the top level also parks timers beyond the span, there the cascade time is used
+static SYS_TIME_T __wheel_next_wait(uint64_t now)
 {
+    uint64_t tick = 0;
+    uint64_t next = UINT64_MAX;
+    uint32_t level = 0;
+    uint32_t slot = 0;
     struct tuya_list_head *p = NULL;
     TIMER_T *timer = NULL;
-    TAL_TIMER_CB *cb = NULL;
-    TIMER_ID *timer_id = NULL;
 
-    TIME_S nowSecTime = 0;
-    TIME_MS nowMsTime = 0;
+    for (level = 0; level < TW_LEVEL_NUM; level++) {
+        if (0 == s_timer_mgr.level[level].bitmap) {
+            continue;
+        }
 
-    tal_time_get_system_time(&nowSecTime, &nowMsTime);
+        // timers of a slot never expire before it is processed
+        tick = __wheel_level_next(level, &slot);
+        if (tick >= next) {
+            continue;
+        }
 
-    if (nowSecTime < 30) {
-        return;
+        if (level && level < TW_LEVEL_NUM - 1) {
+            tick = UINT64_MAX;
+            tuya_list_for_each(p, &(s_timer_mgr.level[level].slot[slot]))
+            {
+                timer = tuya_list_entry(p, TIMER_T, node);
+                if (timer->expire_time < tick) {
+                    tick = timer->expire_time;
+                }
+            }
+        }
+
+        if (tick < next) {
+            next = tick;
+        }
     }
 
-    PR_NOTICE("current time:%d%03d", nowSecTime, nowMsTime);
+    if (next <= now) {
+        return 0;
+    }
 
-    tal_mutex_lock(s_timer_mgr.mutex);
+    return (next - now < SEM_WAIT_FOREVER) ? (SYS_TIME_T)(next - now) : SEM_WAIT_FOREVER;
+}
 
-    PR_NOTICE("running timers count:%d", s_timer_mgr.running_cnt);
-    tuya_list_for_each(p, &(s_timer_mgr.list_active))
+static void __timer_dump_list(LIST_HEAD *list)
+{
+    struct tuya_list_head *p = NULL;
+    TIMER_T *timer = NULL;
+    TAL_TIMER_CB *cb = NULL;
+    TIMER_ID *timer_id = NULL;
+
+    tuya_list_for_each(p, list)
     {
         timer = tuya_list_entry(p, TIMER_T, node);
         cb = &(timer->cb);
@@ -98,75 +322,83 @@ static void __timer_dump(void)
         }
         PR_NOTICE("%08x %d %d %p", timer->timer_id, timer->type, timer->interval, *cb);
     }
+}
 
-    PR_NOTICE("standby timers count:%d", s_timer_mgr.total_cnt - s_timer_mgr.running_cnt);
-    tuya_list_for_each(p, &(s_timer_mgr.list_standby))
-    {
-        timer = tuya_list_entry(p, TIMER_T, node);
-        cb = &(timer->cb);
-        if (timer->data) {
-            timer_id = timer->data;
-            if (*timer_id == timer->timer_id) {
-                cb = (TAL_TIMER_CB *)((char *)timer->data + sizeof(TIMER_ID));
-            }
+static void __timer_dump(void)
+{
+    uint32_t level = 0;
+    uint32_t slot = 0;
+
+    TIME_S nowSecTime = 0;
+    TIME_MS nowMsTime = 0;
+
+    tal_time_get_system_time(&nowSecTime, &nowMsTime);
+
+    if (nowSecTime < 30) {
+        return;
+    }
+
+    PR_NOTICE("current time:%d%03d", nowSecTime, nowMsTime);
+
+    tal_mutex_lock(s_timer_mgr.mutex);
+
+    PR_NOTICE("running timers count:%d", s_timer_mgr.running_cnt);
+    __timer_dump_list(&(s_timer_mgr.list_expired));
+    for (level = 0; level < TW_LEVEL_NUM; level++) {
+        for (slot = 0; slot < TW_LEVEL_SIZE; slot++) {
+            __timer_dump_list(&(s_timer_mgr.level[level].slot[slot]));
         }
-        PR_NOTICE("%08x %d %d %p", timer->timer_id, timer->type, timer->interval, *cb);
     }
 
+    PR_NOTICE("standby timers count:%d", s_timer_mgr.total_cnt - s_timer_mgr.running_cnt);
+    __timer_dump_list(&(s_timer_mgr.list_standby));
+
     tal_mutex_unlock(s_timer_mgr.mutex);
 }
 
 static void __timer_dispatch(SYS_TIME_T *next_expired)
 {
-    TIME_S nowSecTime = 0;
-    TIME_MS nowMsTime = 0;
     uint64_t nowMS = 0;
     TIMER_T *timer = NULL;
     TAL_TIMER_CB timer_cb = NULL;
-    struct tuya_list_head *p = NULL;
-
-    *next_expired = SEM_WAIT_FOREVER;
+    TIMER_ID timer_id = NULL;
+    void *timer_data = NULL;
 
     do {
-        tal_time_get_system_time(&nowSecTime, &nowMsTime);
-        nowMS = (uint64_t)nowSecTime * 1000 + (uint64_t)nowMsTime;
+        nowMS = __timer_now();
 
         tal_mutex_lock(s_timer_mgr.mutex);
 
-        timer_cb = NULL;
-        tuya_list_for_each(p, &(s_timer_mgr.list_active))
-        {
-            timer = tuya_list_entry(p, TIMER_T, node);
+        __wheel_advance(nowMS);
 
-            if (timer->expire_time > nowMS) {
-                p = &(s_timer_mgr.list_active);
-                *next_expired = timer->expire_time - nowMS;
+        timer_cb = NULL;
+        if (tuya_list_empty(&(s_timer_mgr.list_expired))) {
+            *next_expired = __wheel_next_wait(nowMS);
+        } else {
+            timer = tuya_list_entry(s_timer_mgr.list_expired.next, TIMER_T, node);
+            timer_cb = timer->cb;
+            timer_id = timer->timer_id;
+            timer_data = timer->data;
+
+            if (TAL_TIMER_ONCE == timer->type) {
+                timer->is_running = FALSE;
+                s_timer_mgr.running_cnt--;
+                tuya_list_del(&(timer->node));
+                tuya_list_add_tail(&(timer->node), &(s_timer_mgr.list_standby));
             } else {
-                timer_cb = timer->cb;
-
-                if (TAL_TIMER_ONCE == timer->type) {
-                    timer->is_running = FALSE;
-                    s_timer_mgr.running_cnt--;
-                    tuya_list_del(&(timer->node));
-                    tuya_list_add_tail(&(timer->node), &(s_timer_mgr.list_standby));
-                } else {
-                    timer->expire_time = nowMS + timer->interval;
-                    __timer_attach(timer);
-                }
+                timer->expire_time = nowMS + timer->interval;
+                __timer_attach(timer);
             }
-
-            break;
         }
 
         tal_mutex_unlock(s_timer_mgr.mutex);
 
         if (timer_cb) {
             s_timer_mgr.last_cb = timer_cb;
-            timer_cb(timer->timer_id, timer->data);
-            timer_cb = NULL;
+            timer_cb(timer_id, timer_data);
             s_timer_mgr.last_cb = NULL;
         }
-    } while (p != &(s_timer_mgr.list_active));
+    } while (timer_cb);
 }
 
 static void __timer_thread_cb(void *data)
@@ -201,8 +433,14 @@ OPERATE_RET tal_sw_timer_init(void)
     tal_mutex_create_init(&s_timer_mgr.mutex);
     tal_semaphore_create_init(&s_timer_mgr.sem, 0, 2);
 
-    INIT_LIST_HEAD(&(s_timer_mgr.list_active));
+    for (uint32_t level = 0; level < TW_LEVEL_NUM; level++) {
+        for (uint32_t slot = 0; slot < TW_LEVEL_SIZE; slot++) {
+            INIT_LIST_HEAD(&(s_timer_mgr.level[level].slot[slot]));
+        }
+    }
+    INIT_LIST_HEAD(&(s_timer_mgr.list_expired));
     INIT_LIST_HEAD(&(s_timer_mgr.list_standby));
+    s_timer_mgr.base = __timer_now();
 
     THREAD_CFG_T thread_cfg = {.stackDepth = STACK_SIZE_TIMERQ, .priority = THREAD_PRIO_0, .thrdname = "sys_timer"};
 
@@ -240,6 +478,7 @@ OPERATE_RET tal_sw_timer_create(TAL_TIMER_CB func, void *arg, TIMER_ID *timer_id
     timer->cb = func;
     timer->data = arg;
     timer->timer_id = (TIMER_ID)timer;
+    timer->level = TW_LEVEL_NONE;
 
     tal_mutex_lock(s_timer_mgr.mutex);
     s_timer_mgr.total_cnt++;
@@ -270,7 +509,7 @@ OPERATE_RET tal_sw_timer_delete(TIMER_ID timer_id)
     TIMER_T *timer = (TIMER_T *)timer_id;
 
     tal_mutex_lock(s_timer_mgr.mutex);
-    tuya_list_del(&(timer->node));
+    __timer_detach(timer);
     s_timer_mgr.total_cnt--;
     if (timer->is_running) {
         s_timer_mgr.running_cnt--;
@@ -305,7 +544,7 @@ OPERATE_RET tal_sw_timer_stop(TIMER_ID timer_id)
         timer->is_running = FALSE;
 
         s_timer_mgr.running_cnt--;
-        tuya_list_del(&(timer->node));
+        __timer_detach(timer);
         tuya_list_add_tail(&(timer->node), &(s_timer_mgr.list_standby));
     }
     tal_mutex_unlock(s_timer_mgr.mutex);
@@ -354,11 +593,7 @@ OPERATE_RET tal_sw_timer_remain_time_get(TIMER_ID timer_id, uint32_t *remain_tim
         return OPRT_INVALID_PARM;
     }
 
-    uint64_t nowMS = 0;
-    TIME_S secTime = 0;
-    TIME_MS msTime = 0;
-    tal_time_get_system_time(&secTime, &msTime);
-    nowMS = (uint64_t)secTime * 1000 + (uint64_t)msTime;
+    uint64_t nowMS = __timer_now();
 
     TIMER_T *timer = (TIMER_T *)timer_id;
     if (!timer->is_running) {
@@ -395,10 +630,7 @@ OPERATE_RET tal_sw_timer_start(TIMER_ID timer_id, TIME_MS time_ms, TIMER_TYPE ti
     }
 
     TIMER_T *timer = (TIMER_T *)timer_id;
-
-    TIME_S secTime = 0;
-    TIME_MS msTime = 0;
-    tal_time_get_system_time(&secTime, &msTime);
+    uint64_t nowMS = __timer_now();
 
     tal_mutex_lock(s_timer_mgr.mutex);
 
@@ -412,7 +644,7 @@ OPERATE_RET tal_sw_timer_start(TIMER_ID timer_id, TIME_MS time_ms, TIMER_TYPE ti
     }
 
     timer->type = timer_type;
-    timer->expire_time = (uint64_t)secTime * 1000 + (uint64_t)msTime + timer->interval;
+    timer->expire_time = nowMS + timer->interval;
     __timer_attach(timer);
 
     tal_mutex_unlock(s_timer_mgr.mutex);
@@ -442,8 +674,7 @@ OPERATE_RET tal_sw_timer_trigger(TIMER_ID timer_id)
     tal_mutex_lock(s_timer_mgr.mutex);
     timer->expire_time = 0;
     if (timer->is_running) {
-        tuya_list_del(&(timer->node));
-        tuya_list_add(&(timer->node), &(s_timer_mgr.list_active));
+        __timer_attach(timer);
     }
     tal_mutex_unlock(s_timer_mgr.mutex);
     tal_semaphore_post(s_timer_mgr.sem);
@@ -27,6 +27,7 @@
  *
  */
 
+#include <string.h>
 #include "tkl_system.h"
 #include "tkl_memory.h"
 #include "tal_system.h"
@@ -75,6 +76,230 @@ void tal_system_exit_critical(uint32_t irq_mask)
     tkl_system_exit_critical(irq_mask);
 }
 
+#if defined(ENABLE_MEM_SLAB) && (ENABLE_MEM_SLAB == 1)
+#define MEM_SLAB_PAGE_SIZE 1024
+#define MEM_SLAB_PAGE_NUM  (MEM_SLAB_ARENA_SIZE / MEM_SLAB_PAGE_SIZE)
+#define MEM_SLAB_OBJ_MAX   256
+#define MEM_SLAB_NONE      0xFFFF
+#define MEM_SLAB_PAGE_OBJS (MEM_SLAB_PAGE_SIZE / 16) // objects of the smallest class per page
+
+#define MEM_SLAB_LIVE_TEST(page, n) ((page)->live[(n) / 32] & (1UL << ((n) % 32)))
+#define MEM_SLAB_LIVE_SET(page, n)  ((page)->live[(n) / 32] |= (1UL << ((n) % 32)))
+#define MEM_SLAB_LIVE_CLR(page, n)  ((page)->live[(n) / 32] &= ~(1UL << ((n) % 32)))
+
+typedef struct {
+    void *free;    // freed objects of the page
+    uint16_t prev; // neighbours in the partial list of the class, or the free page list
+    uint16_t next;
+    uint8_t cls;    // owning class + 1, 0 when the page is free
+    uint8_t used;   // objects allocated
+    uint8_t carved; // objects handed out at least once, the rest were never touched
+    uint32_t live[MEM_SLAB_PAGE_OBJS / 32]; // one bit per object, set while it is allocated
+} MEM_SLAB_PAGE_S;
+
+typedef struct {
+    uint16_t partial; // pages with room, first one serves the next allocation
+    TAL_MEM_SLAB_CLASS_STATS_T stats;
+} MEM_SLAB_CLASS_S;
+
+static const uint16_t sc_slab_obj_size[TAL_MEM_SLAB_CLASS_NUM] = {16, 32, 64, 128, 256};
+
+// in .bss, the address range alone tells slab objects from heap blocks
+static uint64_t s_slab_arena[MEM_SLAB_ARENA_SIZE / sizeof(uint64_t)];
+static MEM_SLAB_PAGE_S s_slab_page[MEM_SLAB_PAGE_NUM];
+static MEM_SLAB_CLASS_S s_slab_cls[TAL_MEM_SLAB_CLASS_NUM] = {
+    {MEM_SLAB_NONE, {16}}, {MEM_SLAB_NONE, {32}}, {MEM_SLAB_NONE, {64}}, {MEM_SLAB_NONE, {128}}, {MEM_SLAB_NONE, {256}},
+};
+static uint16_t s_slab_page_free = MEM_SLAB_NONE; // pages given back by the classes
+static uint16_t s_slab_page_fresh = 0;            // pages from here on were never used
+
+#define MEM_SLAB_IN_ARENA(ptr)                                                                                         \
+    ((uint8_t *)(ptr) >= (uint8_t *)s_slab_arena && (uint8_t *)(ptr) < (uint8_t *)s_slab_arena + sizeof(s_slab_arena))
+#define MEM_SLAB_PAGE_ADDR(idx) ((uint8_t *)s_slab_arena + (idx) * MEM_SLAB_PAGE_SIZE)
+
+static uint8_t __slab_cls_get(size_t size)
+{
+    uint8_t cls = 0;
+
+    while (sc_slab_obj_size[cls] < size) {
+        cls++;
+    }
+
+    return cls;
+}
+
+static void __slab_list_del(uint16_t *head, uint16_t idx)
+{
+    MEM_SLAB_PAGE_S *page = &s_slab_page[idx];
+
+    if (MEM_SLAB_NONE != page->prev) {
+        s_slab_page[page->prev].next = page->next;
+    } else {
+        *head = page->next;
+    }
+    if (MEM_SLAB_NONE != page->next) {
+        s_slab_page[page->next].prev = page->prev;
+    }
+}
+
+static void __slab_list_add(uint16_t *head, uint16_t idx)
+{
+    MEM_SLAB_PAGE_S *page = &s_slab_page[idx];
+
+    page->prev = MEM_SLAB_NONE;
+    page->next = *head;
+    if (MEM_SLAB_NONE != *head) {
+        s_slab_page[*head].prev = idx;
+    }
+    *head = idx;
+}
+
+/**
+ * @brief take an object of the class, a free page is assigned to the class
+ * when all of its pages are full
+ *
+ * @return the object, NULL when the arena is full
+ */
+static void *__slab_malloc(uint8_t cls)
+{
+    MEM_SLAB_CLASS_S *slab = &s_slab_cls[cls];
+    MEM_SLAB_PAGE_S *page = NULL;
+    uint16_t obj_size = sc_slab_obj_size[cls];
+    uint16_t idx = 0;
+    void *ptr = NULL;
+
+    uint32_t irq_mask = tal_system_enter_critical();
+
+    idx = slab->partial;
+    if (MEM_SLAB_NONE == idx) {
+        if (MEM_SLAB_NONE != s_slab_page_free) {
+            idx = s_slab_page_free;
+            __slab_list_del(&s_slab_page_free, idx);
+        } else if (s_slab_page_fresh < MEM_SLAB_PAGE_NUM) {
+            idx = s_slab_page_fresh++;
+        } else {
+            slab->stats.fallback_cnt++;
+            tal_system_exit_critical(irq_mask);
+            return NULL;
+        }
+        page = &s_slab_page[idx];
+        page->free = NULL;
+        page->cls = cls + 1;
+        page->used = 0;
+        page->carved = 0;
+        memset(page->live, 0, sizeof(page->live));
+        __slab_list_add(&slab->partial, idx);
+        slab->stats.pages++;
+    }
+    page = &s_slab_page[idx];
+
+    if (page->free) {
+        ptr = page->free;
+        page->free = *(void **)ptr;
+    } else {
+        ptr = MEM_SLAB_PAGE_ADDR(idx) + page->carved * obj_size;
+        page->carved++;
+    }
+    MEM_SLAB_LIVE_SET(page, ((uint8_t *)ptr - MEM_SLAB_PAGE_ADDR(idx)) / obj_size);
+    page->used++;
+    if (page->used == MEM_SLAB_PAGE_SIZE / obj_size) {
+        __slab_list_del(&slab->partial, idx);
+    }
+
+    slab->stats.alloc_cnt++;
+    slab->stats.in_use++;
+    if (slab->stats.in_use > slab->stats.in_use_max) {
+        slab->stats.in_use_max = slab->stats.in_use;
+    }
+
+    tal_system_exit_critical(irq_mask);
+
+    return ptr;
+}
+
+/**
+ * @brief give an object back to its page, a page left empty goes back to the
+ * arena so other classes can use it
+ *
+ * @return OPRT_OK on success, OPRT_INVALID_PARM when ptr is not a live
+ * object, e.g. a double free or a pointer into the middle of an object
+ */
+static OPERATE_RET __slab_free(void *ptr)
+{
+    uint16_t idx = ((uint8_t *)ptr - (uint8_t *)s_slab_arena) / MEM_SLAB_PAGE_SIZE;
+    MEM_SLAB_PAGE_S *page = &s_slab_page[idx];
+    MEM_SLAB_CLASS_S *slab = NULL;
+    uint16_t obj_size = 0;
+    uint16_t obj = 0;
+
+    uint32_t irq_mask = tal_system_enter_critical();
+
+    if (0 == page->cls || 0 == page->used) {
+        tal_system_exit_critical(irq_mask);
+        return OPRT_INVALID_PARM;
+    }
+    slab = &s_slab_cls[page->cls - 1];
+    obj_size = sc_slab_obj_size[page->cls - 1];
+    if (((uint8_t *)ptr - MEM_SLAB_PAGE_ADDR(idx)) % obj_size) {
+        tal_system_exit_critical(irq_mask);
+        return OPRT_INVALID_PARM;
+    }
+    obj = ((uint8_t *)ptr - MEM_SLAB_PAGE_ADDR(idx)) / obj_size;
+    if (!MEM_SLAB_LIVE_TEST(page, obj)) {
+        tal_system_exit_critical(irq_mask);
+        return OPRT_INVALID_PARM;
+    }
+    MEM_SLAB_LIVE_CLR(page, obj);
+
+    if (page->used == MEM_SLAB_PAGE_SIZE / obj_size) {
+        __slab_list_add(&slab->partial, idx);
+    }
+    *(void **)ptr = page->free;
+    page->free = ptr;
+    page->used--;
+    slab->stats.in_use--;
+
+    if (0 == page->used) {
+        __slab_list_del(&slab->partial, idx);
+        page->cls = 0;
+        __slab_list_add(&s_slab_page_free, idx);
+        slab->stats.pages--;
+    }
+
+    tal_system_exit_critical(irq_mask);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Get the statistics of the small object slab.
+ *
+ * @param[out] stats The slab statistics.
+ * @return OPRT_OK on success, OPRT_INVALID_PARM if stats is NULL.
+ */
+OPERATE_RET tal_mem_slab_get_stats(TAL_MEM_SLAB_STATS_T *stats)
+{
+    uint8_t i = 0;
+
+    if (NULL == stats) {
+        return OPRT_INVALID_PARM;
+    }
+
+    stats->page_size = MEM_SLAB_PAGE_SIZE;
+    stats->page_num = MEM_SLAB_PAGE_NUM;
+
+    uint32_t irq_mask = tal_system_enter_critical();
+    stats->page_free = MEM_SLAB_PAGE_NUM;
+    for (i = 0; i < TAL_MEM_SLAB_CLASS_NUM; i++) {
+        stats->cls[i] = s_slab_cls[i].stats;
+        stats->page_free -= s_slab_cls[i].stats.pages;
+    }
+    tal_system_exit_critical(irq_mask);
+
+    return OPRT_OK;
+}
+#endif
+
 /**
  * @brief Allocates a block of memory of the specified size.
  *
@@ -91,6 +316,14 @@ void *tal_malloc(size_t size)
     }
 
     void *ptr = NULL;
+#if defined(ENABLE_MEM_SLAB) && (ENABLE_MEM_SLAB == 1)
+    if (size <= MEM_SLAB_OBJ_MAX) {
+        ptr = __slab_malloc(__slab_cls_get(size));
+        if (ptr) {
+            return ptr;
+        }
+    }
+#endif
     ptr = tkl_system_malloc(size);
     if (NULL == ptr) {
         PR_ERR("0x%x malloc failed:0x%x free:0x%x", __builtin_return_address(0), size, tal_system_get_free_heap_size());
@@ -114,6 +347,15 @@ void tal_free(void *ptr)
         return;
     }
 
+#if defined(ENABLE_MEM_SLAB) && (ENABLE_MEM_SLAB == 1)
+    if (MEM_SLAB_IN_ARENA(ptr)) {
+        if (OPRT_OK != __slab_free(ptr)) {
+            PR_ERR("0x%x free invalid slab ptr:%p", __builtin_return_address(0), ptr);
+        }
+        return;
+    }
+#endif
+
     tkl_system_free(ptr);
 }
 
@@ -129,6 +371,15 @@ void tal_free(void *ptr)
  */
 void *tal_calloc(size_t nitems, size_t size)
 {
+#if defined(ENABLE_MEM_SLAB) && (ENABLE_MEM_SLAB == 1)
+    if (size && nitems <= MEM_SLAB_OBJ_MAX / size) {
+        void *ptr = tal_malloc(nitems * size);
+        if (ptr) {
+            memset(ptr, 0, nitems * size);
+        }
+        return ptr;
+    }
+#endif
     return tkl_system_calloc(nitems, size);
 }
 
@@ -143,6 +394,36 @@ void *tal_calloc(size_t nitems, size_t size)
  */
 void *tal_realloc(void *ptr, size_t size)
 {
+#if defined(ENABLE_MEM_SLAB) && (ENABLE_MEM_SLAB == 1)
+    if (NULL == ptr) {
+        return tal_malloc(size);
+    }
+    if (MEM_SLAB_IN_ARENA(ptr)) {
+        uint16_t idx = ((uint8_t *)ptr - (uint8_t *)s_slab_arena) / MEM_SLAB_PAGE_SIZE;
+        uint16_t obj_size = 0;
+        void *new_ptr = NULL;
+
+        if (0 == s_slab_page[idx].cls) {
+            PR_ERR("0x%x realloc invalid slab ptr:%p", __builtin_return_address(0), ptr);
+            return NULL;
+        }
+        obj_size = sc_slab_obj_size[s_slab_page[idx].cls - 1];
+        if (0 == size) {
+            tal_free(ptr);
+            return NULL;
+        }
+        // a smaller size fits the same object
+        if (size <= obj_size) {
+            return ptr;
+        }
+        new_ptr = tal_malloc(size);
+        if (new_ptr) {
+            memcpy(new_ptr, ptr, obj_size);
+            tal_free(ptr);
+        }
+        return new_ptr;
+    }
+#endif
     return tkl_system_realloc(ptr, size);
 }
 
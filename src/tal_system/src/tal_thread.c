@@ -38,6 +38,23 @@
 #include "tal_log.h"
 #include "tal_memory.h"
 #include "tal_system.h"
+
+/*
+ * cpu usage comes from the per-thread cpu clocks on linux. Other kernels do not
+ * expose run time through tkl, there a hardware timer samples the running thread
+ * and every hit counts one sampling period.
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <pthread.h>
+#include <time.h>
+#define THREAD_USAGE_CPU_CLOCK 1
+#elif defined(ENABLE_THREAD_PROFILER) && (ENABLE_THREAD_PROFILER == 1)
+#include "tkl_timer.h"
+#define THREAD_USAGE_CPU_SAMPLE 1
+#define THREAD_PROF_SLOT_NUM    32 // threads told apart by the sampler, power of 2
+#define THREAD_PROF_SLOT_HOME(id) (((uintptr_t)(id) >> 3) & (THREAD_PROF_SLOT_NUM - 1))
+#endif
+
 typedef struct {
     THREAD_HANDLE thrdID;
     int thrdRunSta;
@@ -47,9 +64,34 @@ typedef struct {
     THREAD_ENTER_CB enter;
     THREAD_EXIT_CB exit;
     char thread_name[TAL_THREAD_MAX_NAME_LEN];
+#if defined(THREAD_USAGE_CPU_CLOCK)
+    clockid_t cpu_clock;
+    BOOL_T cpu_clock_valid;
+#endif
+    uint32_t cpu_base; // cpu ms or sampler hits at the last usage reset
     LIST_HEAD node;
 } THRD_MANAGE, *P_THRD_MANAGE;
 
+#if defined(THREAD_USAGE_CPU_SAMPLE)
+typedef struct {
+    TKL_THREAD_HANDLE id;
+    uint32_t hits;
+} THRD_PROF_SLOT_T;
+
+typedef struct {
+    BOOL_T started;
+    uint32_t total;      // all samples, idle and unknown threads included
+    uint32_t total_base; // total at the last usage reset
+    uint32_t lost;       // samples of threads found with the table full
+    uint32_t lost_base;  // lost at the last usage reset
+    THRD_PROF_SLOT_T slot[THREAD_PROF_SLOT_NUM];
+} THRD_PROF_T;
+
+static THRD_PROF_T s_thrd_prof;
+#endif
+
+static uint32_t s_usage_reset_ms = 0;
+
 typedef struct {
     LIST_HEAD list;
     MUTEX_HANDLE mutex;
@@ -60,6 +102,9 @@ static LIST_HEAD s_all_thrd_mag;
 
 static void __WrapRunFunc(void *pArg);
 static void __inner_del_thread(THREAD_HANDLE thrdID);
+#if defined(THREAD_USAGE_CPU_SAMPLE)
+static void __thread_prof_release(TKL_THREAD_HANDLE id);
+#endif
 
 static OPERATE_RET __cr_and_init_del_thrd_mag(void)
 {
@@ -101,6 +146,10 @@ static void __add_del_thrd_node(THRD_MANAGE *thrd)
 static void __inner_del_thread(THREAD_HANDLE thrdID)
 {
     PR_DEBUG("real delete thread:%p", thrdID);
+#if defined(THREAD_USAGE_CPU_SAMPLE)
+    // before the release, it does not return when the thread deletes itself
+    __thread_prof_release(thrdID);
+#endif
     // delete thread process
     tkl_thread_release(thrdID);
 }
@@ -151,6 +200,138 @@ static void __free_all_del_thrd_node(void)
     }
 }
 
+#if defined(THREAD_USAGE_CPU_SAMPLE)
+// runs in the timer isr, it only touches the sampler table
+static void __thread_prof_sample(void *args)
+{
+    TKL_THREAD_HANDLE id = NULL;
+    uint32_t i, idx;
+
+    s_thrd_prof.total++;
+    if (OPRT_OK != tkl_thread_get_id(&id) || NULL == id) {
+        return;
+    }
+
+    idx = THREAD_PROF_SLOT_HOME(id);
+    for (i = 0; i < THREAD_PROF_SLOT_NUM; i++) {
+        if (s_thrd_prof.slot[idx].id == id) {
+            s_thrd_prof.slot[idx].hits++;
+            return;
+        }
+        if (NULL == s_thrd_prof.slot[idx].id) {
+            s_thrd_prof.slot[idx].hits = 1;
+            s_thrd_prof.slot[idx].id = id;
+            return;
+        }
+        idx = (idx + 1) & (THREAD_PROF_SLOT_NUM - 1);
+    }
+    s_thrd_prof.lost++;
+}
+
+// slot of the thread in the sampler table, THREAD_PROF_SLOT_NUM when it has none
+static uint32_t __thread_prof_find(TKL_THREAD_HANDLE id)
+{
+    uint32_t i, idx;
+
+    idx = THREAD_PROF_SLOT_HOME(id);
+    for (i = 0; i < THREAD_PROF_SLOT_NUM; i++) {
+        if (s_thrd_prof.slot[idx].id == id) {
+            return idx;
+        }
+        if (NULL == s_thrd_prof.slot[idx].id) {
+            break;
+        }
+        idx = (idx + 1) & (THREAD_PROF_SLOT_NUM - 1);
+    }
+
+    return THREAD_PROF_SLOT_NUM;
+}
+
+// hits of the thread, THREAD_USAGE_UNKNOWN when it has no slot and samples were lost
+static uint32_t __thread_prof_hits(TKL_THREAD_HANDLE id)
+{
+    uint32_t idx, hits = 0;
+
+    uint32_t irq_mask = tal_system_enter_critical();
+    idx = __thread_prof_find(id);
+    if (idx < THREAD_PROF_SLOT_NUM) {
+        hits = s_thrd_prof.slot[idx].hits;
+    } else if (s_thrd_prof.lost != s_thrd_prof.lost_base) {
+        hits = THREAD_USAGE_UNKNOWN;
+    }
+    tal_system_exit_critical(irq_mask);
+
+    return hits;
+}
+
+// give the slot of a deleted thread back, the slots probed after it move up to
+// close the gap so every thread stays reachable from its home slot
+static void __thread_prof_release(TKL_THREAD_HANDLE id)
+{
+    uint32_t idx, next, home;
+
+    uint32_t irq_mask = tal_system_enter_critical();
+    idx = __thread_prof_find(id);
+    if (idx < THREAD_PROF_SLOT_NUM) {
+        next = idx;
+        while (1) {
+            next = (next + 1) & (THREAD_PROF_SLOT_NUM - 1);
+            if (NULL == s_thrd_prof.slot[next].id) {
+                break;
+            }
+            home = THREAD_PROF_SLOT_HOME(s_thrd_prof.slot[next].id);
+            if (((next - home) & (THREAD_PROF_SLOT_NUM - 1)) >= ((next - idx) & (THREAD_PROF_SLOT_NUM - 1))) {
+                s_thrd_prof.slot[idx] = s_thrd_prof.slot[next];
+                idx = next;
+            }
+        }
+        s_thrd_prof.slot[idx].id = NULL;
+        s_thrd_prof.slot[idx].hits = 0;
+    }
+    tal_system_exit_critical(irq_mask);
+}
+
+static void __thread_prof_start(void)
+{
+    TUYA_TIMER_BASE_CFG_T cfg = {0};
+    OPERATE_RET rt = OPRT_OK;
+
+    if (s_thrd_prof.started) {
+        return;
+    }
+    s_thrd_prof.started = TRUE;
+
+    cfg.mode = TUYA_TIMER_MODE_PERIOD;
+    cfg.cb = __thread_prof_sample;
+    cfg.args = NULL;
+    rt = tkl_timer_init(THREAD_PROFILER_TIMER_ID, &cfg);
+    if (OPRT_OK == rt) {
+        rt = tkl_timer_start(THREAD_PROFILER_TIMER_ID, THREAD_PROFILER_PERIOD_US);
+    }
+    if (OPRT_OK != rt) {
+        PR_ERR("thread profiler timer %d start fail:%d", THREAD_PROFILER_TIMER_ID, rt);
+    }
+}
+#endif
+
+// cpu ms on linux, sampler hits with the profiler, 0 otherwise. THREAD_USAGE_UNKNOWN
+// for a thread the profiler does not track while its samples are lost
+static uint32_t __thread_cpu_get(THRD_MANAGE *thrd)
+{
+#if defined(THREAD_USAGE_CPU_CLOCK)
+    struct timespec ts;
+
+    if (!thrd->cpu_clock_valid || 0 != clock_gettime(thrd->cpu_clock, &ts)) {
+        return thrd->cpu_base;
+    }
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+#elif defined(THREAD_USAGE_CPU_SAMPLE)
+    return __thread_prof_hits(thrd->thrdID);
+#else
+    return 0;
+#endif
+}
+
 /**
  * @brief Creates and starts a new thread.
  *
@@ -173,6 +354,10 @@ OPERATE_RET tal_thread_create_and_start(THREAD_HANDLE *handle, const THREAD_ENTE
         PR_TRACE("Init Thread Del Mgr");
         __cr_and_init_del_thrd_mag();
         INIT_LIST_HEAD(&s_all_thrd_mag);
+        s_usage_reset_ms = tal_system_get_millisecond();
+#if defined(THREAD_USAGE_CPU_SAMPLE)
+        __thread_prof_start();
+#endif
     }
 
     if (!handle || !func) {
@@ -201,6 +386,12 @@ OPERATE_RET tal_thread_create_and_start(THREAD_HANDLE *handle, const THREAD_ENTE
     tal_mutex_unlock(s_del_thrd_mag->mutex);
 
     int opRet;
+#if defined(ENABLE_SMP) && (ENABLE_SMP == 1)
+    if (cfg->smp_pin == 1) {
+        opRet = tkl_thread_smp_create(&(pMgr->thrdID), cfg->smp_core, cfg->thrdname, cfg->stackDepth, cfg->priority,
+                                      __WrapRunFunc, pMgr);
+    } else
+#endif
 #if defined(ENABLE_EXT_RAM) && (ENABLE_EXT_RAM == 1)
     if (cfg->psram_mode == 1) {
         opRet = tkl_thread_create_in_psram(&(pMgr->thrdID), cfg->thrdname, cfg->stackDepth, cfg->priority,
@@ -209,7 +400,9 @@ OPERATE_RET tal_thread_create_and_start(THREAD_HANDLE *handle, const THREAD_ENTE
         opRet = tkl_thread_create(&(pMgr->thrdID), cfg->thrdname, cfg->stackDepth, cfg->priority, __WrapRunFunc, pMgr);
     }
 #else
-    opRet = tkl_thread_create(&(pMgr->thrdID), cfg->thrdname, cfg->stackDepth, cfg->priority, __WrapRunFunc, pMgr);
+    {
+        opRet = tkl_thread_create(&(pMgr->thrdID), cfg->thrdname, cfg->stackDepth, cfg->priority, __WrapRunFunc, pMgr);
+    }
 #endif
     if (opRet != 0) {
         PR_ERR("Create Thrd Fail:%d", opRet);
@@ -237,6 +430,17 @@ static void __WrapRunFunc(void *pArg)
 
 #if OPERATING_SYSTEM == SYSTEM_LINUX
     tkl_thread_set_self_name(pThrdManage->thread_name);
+#endif
+#if defined(THREAD_USAGE_CPU_CLOCK)
+    pThrdManage->cpu_clock_valid = (0 == pthread_getcpuclockid(pthread_self(), &pThrdManage->cpu_clock));
+#elif defined(THREAD_USAGE_CPU_SAMPLE)
+    // samples may have hit the handle before the thread got here, start from them
+    TKL_THREAD_HANDLE self_id = NULL;
+    tkl_thread_get_id(&self_id);
+    pThrdManage->cpu_base = __thread_prof_hits(self_id);
+    if (THREAD_USAGE_UNKNOWN == pThrdManage->cpu_base) {
+        pThrdManage->cpu_base = 0;
+    }
 #endif
     if (pThrdManage->enter) {
         PR_DEBUG("enter Thread:%s func call", pThrdManage->thread_name);
@@ -378,33 +582,167 @@ OPERATE_RET tal_thread_diagnose(const THREAD_HANDLE handle)
 }
 
 /**
- * @brief Dumps the watermark information for each thread managed by the system.
- *        The watermark represents the amount of free stack space available for
- * each thread. This function iterates through all the threads and prints the
- * thread name, stack depth, and watermark. Note: This function requires the
- * thread management system to be initialized.
+ * @brief Get the stack and cpu usage of every tuya sdk thread.
+ *
+ * Stack figures come from tkl_thread_get_watermark(). CPU time is measured with
+ * the thread cpu clocks on Linux and estimated from the thread profiler samples
+ * on other systems when ENABLE_THREAD_PROFILER is set, otherwise it is unknown.
+ *
+ * @param usage Array receiving one entry per thread, NULL to only count threads.
+ * @param num In: number of entries in usage. Out: number of entries filled, or
+ * the number of threads when usage is NULL.
+ *
+ * @return OPERATE_RET Returns OPRT_OK on success, or an error code on failure.
  */
-void tal_thread_dump_watermark(void)
+OPERATE_RET tal_thread_get_usage(THREAD_USAGE_T *usage, uint32_t *num)
 {
+    LIST_HEAD *pos = NULL;
+    THRD_MANAGE *tmp_node = NULL;
+    THREAD_USAGE_T *item = NULL;
+    uint32_t cnt = 0, watermark = 0;
+#if defined(THREAD_USAGE_CPU_CLOCK) || defined(THREAD_USAGE_CPU_SAMPLE)
+    uint32_t elapsed = 0, cpu = 0;
+#endif
+
+    if (NULL == num || (NULL != usage && 0 == *num)) {
+        return OPRT_INVALID_PARM;
+    }
     if (!s_del_thrd_mag) {
-        return;
+        *num = 0;
+        return OPRT_OK;
     }
 
+#if defined(THREAD_USAGE_CPU_CLOCK)
+    elapsed = tal_system_get_millisecond() - s_usage_reset_ms;
+#elif defined(THREAD_USAGE_CPU_SAMPLE)
+    elapsed = s_thrd_prof.total - s_thrd_prof.total_base;
+#endif
+
+    tal_mutex_lock(s_del_thrd_mag->mutex);
+    tuya_list_for_each(pos, &s_all_thrd_mag)
+    {
+        if (NULL == usage) {
+            cnt++;
+            continue;
+        }
+        if (cnt >= *num) {
+            break;
+        }
+
+        tmp_node = tuya_list_entry(pos, THRD_MANAGE, node);
+        item = &usage[cnt++];
+        memset(item, 0, sizeof(THREAD_USAGE_T));
+        strncpy(item->name, tmp_node->thread_name, TAL_THREAD_MAX_NAME_LEN - 1);
+        item->stack_size = tmp_node->stackDepth;
+        item->stack_free = THREAD_USAGE_UNKNOWN;
+        if (OPRT_OK == tkl_thread_get_watermark(tmp_node->thrdID, &watermark)) {
+            item->stack_free = watermark;
+        }
+
+        item->cpu_ms = THREAD_USAGE_UNKNOWN;
+        item->cpu_permille = THREAD_USAGE_UNKNOWN;
+#if defined(THREAD_USAGE_CPU_CLOCK) || defined(THREAD_USAGE_CPU_SAMPLE)
+        cpu = __thread_cpu_get(tmp_node);
+        if (THREAD_USAGE_UNKNOWN == cpu) {
+            continue;
+        }
+        cpu -= tmp_node->cpu_base;
+        item->cpu_permille = elapsed ? (uint32_t)((uint64_t)cpu * 1000 / elapsed) : 0;
+#if defined(THREAD_USAGE_CPU_SAMPLE)
+        cpu = (uint32_t)((uint64_t)cpu * THREAD_PROFILER_PERIOD_US / 1000);
+#endif
+        item->cpu_ms = cpu;
+#endif
+    }
+    tal_mutex_unlock(s_del_thrd_mag->mutex);
+
+    *num = cnt;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Restart the cpu usage measurement of every tuya sdk thread.
+ */
+void tal_thread_reset_usage(void)
+{
     LIST_HEAD *pos = NULL;
     THRD_MANAGE *tmp_node = NULL;
-    uint32_t watermark = 0;
-    int op_ret;
+
+    if (!s_del_thrd_mag) {
+        return;
+    }
 
     tal_mutex_lock(s_del_thrd_mag->mutex);
+#if defined(THREAD_USAGE_CPU_SAMPLE)
+    s_thrd_prof.total_base = s_thrd_prof.total;
+    s_thrd_prof.lost_base = s_thrd_prof.lost;
+#endif
     tuya_list_for_each(pos, &s_all_thrd_mag)
     {
         tmp_node = tuya_list_entry(pos, THRD_MANAGE, node);
-        op_ret = tkl_thread_get_watermark(tmp_node->thrdID, &watermark);
-        if (OPRT_OK == op_ret) {
-            PR_DEBUG("thread[%-16s] stack[%5d] free[%5d]", tmp_node->thread_name, tmp_node->stackDepth, watermark);
-        } else {
-            break;
+        tmp_node->cpu_base = __thread_cpu_get(tmp_node);
+        // a thread without a sampler slot counts from 0 once it gets one
+        if (THREAD_USAGE_UNKNOWN == tmp_node->cpu_base) {
+            tmp_node->cpu_base = 0;
         }
     }
+    s_usage_reset_ms = tal_system_get_millisecond();
     tal_mutex_unlock(s_del_thrd_mag->mutex);
 }
+
+/**
+ * @brief Get the cpu samples the thread profiler lost since the last usage reset.
+ *
+ * The profiler tells THREAD_PROF_SLOT_NUM threads apart, samples of further
+ * threads are counted here. Slots of deleted threads are given back.
+ *
+ * @return the samples lost, 0 without ENABLE_THREAD_PROFILER.
+ */
+uint32_t tal_thread_get_usage_lost(void)
+{
+#if defined(THREAD_USAGE_CPU_SAMPLE)
+    return s_thrd_prof.lost - s_thrd_prof.lost_base;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Dumps the watermark information for each thread managed by the system.
+ *        The watermark represents the amount of free stack space available for
+ * each thread. This function iterates through all the threads and prints the
+ * thread name, stack depth, watermark and the cpu usage when it is measured.
+ * Note: This function requires the thread management system to be initialized.
+ */
+void tal_thread_dump_watermark(void)
+{
+    THREAD_USAGE_T *usage = NULL;
+    uint32_t num = 0, i;
+
+    if (OPRT_OK != tal_thread_get_usage(NULL, &num) || 0 == num) {
+        return;
+    }
+
+    usage = tal_malloc(num * sizeof(THREAD_USAGE_T));
+    if (NULL == usage) {
+        return;
+    }
+
+    tal_thread_get_usage(usage, &num);
+    for (i = 0; i < num; i++) {
+        if (THREAD_USAGE_UNKNOWN == usage[i].cpu_ms) {
+            PR_DEBUG("thread[%-16s] stack[%5d] free[%5d]", usage[i].name, usage[i].stack_size,
+                     (int)usage[i].stack_free);
+        } else {
+            PR_DEBUG("thread[%-16s] stack[%5d] free[%5d] cpu[%8u ms %3u.%u%%]", usage[i].name, usage[i].stack_size,
+                     (int)usage[i].stack_free, usage[i].cpu_ms, usage[i].cpu_permille / 10,
+                     usage[i].cpu_permille % 10);
+        }
+    }
+    if (tal_thread_get_usage_lost()) {
+        PR_DEBUG("thread profiler table full, %u samples lost", tal_thread_get_usage_lost());
+    }
+
+    tal_free(usage);
+}
@@ -0,0 +1,578 @@
+/**
+ * @file tal_workqueue_mt.c
+ * @brief Implements the multi-worker work queue for Tuya IoT applications.
+ *
+ * Every worker thread owns a shared queue and a keyed queue, both tuya_queue
+ * rings, and a binary wake semaphore posted when an item is put in its queues.
+ * The worker drains its queues before waiting again, so a post that finds the
+ * semaphore already given loses nothing and is ignored. A worker takes
+ * the oldest item of its own two queues; when both are empty it steals the
+ * oldest item from the shared queue of another worker before going back to
+ * sleep. Keyed items are only taken by their owner, which keeps the items of a
+ * key serialized without any per-key state.
+ *
+ * Unkeyed items are given to the first idle worker found, round robin, or to the
+ * next worker in turn when all of them are busy. Statistics are kept per worker
+ * by the worker itself so running items takes no lock shared between workers.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "tuya_queue.h"
+#include "tal_log.h"
+#include "tal_memory.h"
+#include "tal_mutex.h"
+#include "tal_thread.h"
+#include "tal_system.h"
+#include "tal_semaphore.h"
+#include "tal_workqueue_mt.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define WORKQUEUE_MT_NAME_LEN 16
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    WORKQUEUE_CB cb;
+    void *data;
+    SYS_TIME_T sched_time;
+} WORK_MT_ITEM_T;
+
+typedef struct {
+    uint32_t executed;
+    uint32_t stolen;
+    uint32_t latency_sum;
+    uint32_t latency_max;
+    uint32_t run_sum;
+    uint32_t run_max;
+} WORKER_STATS_T;
+
+typedef struct {
+    THREAD_HANDLE thread;
+    SEM_HANDLE sem;
+    TUYA_QUEUE_HANDLE shared; // unkeyed items, other workers may steal them
+    TUYA_QUEUE_HANDLE keyed;  // keyed items, only run by this worker
+    volatile BOOL_T busy;
+    volatile BOOL_T stats_reset; // set by the reader, the worker clears its stats
+    WORKER_STATS_T stats;
+    WORKQUEUE_CB last_cb; // used to debug which cb is blocked
+    struct TAL_WORKQUEUE_MT *workqueue;
+    char name[WORKQUEUE_MT_NAME_LEN];
+} WORKQUEUE_MT_WORKER_T;
+
+typedef struct TAL_WORKQUEUE_MT {
+    MUTEX_HANDLE mutex; // protects next and the schedule side statistics
+    uint8_t worker_num;
+    uint8_t next;
+    uint32_t scheduled;
+    uint32_t depth_max;
+    WORKQUEUE_MT_WORKER_T worker[WORKQUEUE_MT_WORKER_MAX];
+} TAL_WORKQUEUE_MT_T;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint32_t __workqueue_mt_depth(TAL_WORKQUEUE_MT_T *workqueue)
+{
+    uint32_t depth = 0;
+    uint8_t i;
+
+    for (i = 0; i < workqueue->worker_num; i++) {
+        depth += tuya_queue_get_used_num(workqueue->worker[i].shared);
+        depth += tuya_queue_get_used_num(workqueue->worker[i].keyed);
+    }
+
+    return depth;
+}
+
+static OPERATE_RET __worker_pop(WORKQUEUE_MT_WORKER_T *worker, WORK_MT_ITEM_T *item)
+{
+    WORK_MT_ITEM_T keyed, shared;
+    BOOL_T has_keyed, has_shared;
+
+    has_keyed = (OPRT_OK == tuya_queue_peek(worker->keyed, &keyed));
+    has_shared = (OPRT_OK == tuya_queue_peek(worker->shared, &shared));
+
+    // take the older head, a thief may empty the shared queue after the peek
+    if (has_shared && (!has_keyed || (int32_t)(keyed.sched_time - shared.sched_time) > 0)) {
+        if (OPRT_OK == tuya_queue_output(worker->shared, item)) {
+            return OPRT_OK;
+        }
+    }
+
+    if (has_keyed) {
+        return tuya_queue_output(worker->keyed, item);
+    }
+
+    return OPRT_COM_ERROR;
+}
+
+static OPERATE_RET __worker_steal(WORKQUEUE_MT_WORKER_T *worker, WORK_MT_ITEM_T *item)
+{
+    TAL_WORKQUEUE_MT_T *workqueue = worker->workqueue;
+    uint8_t self = worker - workqueue->worker;
+    uint8_t i, victim;
+
+    for (i = 1; i < workqueue->worker_num; i++) {
+        victim = (self + i) % workqueue->worker_num;
+        if (OPRT_OK == tuya_queue_output(workqueue->worker[victim].shared, item)) {
+            return OPRT_OK;
+        }
+    }
+
+    return OPRT_COM_ERROR;
+}
+
+static void __worker_run(WORKQUEUE_MT_WORKER_T *worker, WORK_MT_ITEM_T *item, BOOL_T stolen)
+{
+    WORKER_STATS_T *stats = &worker->stats;
+    SYS_TIME_T start;
+    uint32_t latency, run = 0;
+
+    start = tal_system_get_millisecond();
+    latency = (uint32_t)(start - item->sched_time);
+
+    if (item->cb) {
+        worker->last_cb = item->cb;
+        item->cb(item->data);
+        worker->last_cb = NULL;
+        run = (uint32_t)(tal_system_get_millisecond() - start);
+    }
+
+    if (worker->stats_reset) {
+        memset(stats, 0, sizeof(WORKER_STATS_T));
+        worker->stats_reset = FALSE;
+    }
+
+    stats->executed++;
+    stats->stolen += stolen ? 1 : 0;
+    stats->latency_sum += latency;
+    stats->run_sum += run;
+    if (latency > stats->latency_max) {
+        stats->latency_max = latency;
+    }
+    if (run > stats->run_max) {
+        stats->run_max = run;
+    }
+}
+
+static void __worker_thread_cb(void *data)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    WORKQUEUE_MT_WORKER_T *worker = (WORKQUEUE_MT_WORKER_T *)data;
+    WORK_MT_ITEM_T item;
+
+    while (THREAD_STATE_RUNNING == tal_thread_get_state(worker->thread)) {
+        worker->busy = FALSE;
+        op_ret = tal_semaphore_wait(worker->sem, SEM_WAIT_FOREVER);
+        worker->busy = TRUE;
+        if (OPRT_OK != op_ret) {
+            tal_system_sleep(10);
+            continue;
+        }
+
+        // drain the own queues, then help the other workers before sleeping again,
+        // an item queued while draining either is seen here or leaves the semaphore given
+        while (THREAD_STATE_RUNNING == tal_thread_get_state(worker->thread)) {
+            if (OPRT_OK == __worker_pop(worker, &item)) {
+                __worker_run(worker, &item, FALSE);
+            } else if (OPRT_OK == __worker_steal(worker, &item)) {
+                __worker_run(worker, &item, TRUE);
+            } else {
+                break;
+            }
+        }
+    }
+}
+
+static void __workqueue_mt_free(TAL_WORKQUEUE_MT_T *workqueue)
+{
+    WORKQUEUE_MT_WORKER_T *worker = NULL;
+    uint32_t count = 1;
+    uint8_t i;
+
+    for (i = 0; i < workqueue->worker_num; i++) {
+        worker = &workqueue->worker[i];
+        if (worker->thread && OPRT_OK == tal_thread_delete(worker->thread)) {
+            tal_semaphore_post(worker->sem);
+        }
+    }
+
+    // running workers steal from the queues of the others, release nothing before all have stopped
+    for (i = 0; i < workqueue->worker_num; i++) {
+        worker = &workqueue->worker[i];
+        while (worker->thread && THREAD_STATE_DELETE != tal_thread_get_state(worker->thread)) {
+            tal_system_sleep(10);
+            if ((count++) % 500 == 0) {
+                PR_NOTICE("%p still running, last_cb %p", worker->thread, worker->last_cb);
+            }
+        }
+    }
+
+    for (i = 0; i < workqueue->worker_num; i++) {
+        worker = &workqueue->worker[i];
+        if (worker->shared) {
+            tuya_queue_release(worker->shared);
+        }
+        if (worker->keyed) {
+            tuya_queue_release(worker->keyed);
+        }
+        if (worker->sem) {
+            tal_semaphore_release(worker->sem);
+        }
+    }
+
+    if (workqueue->mutex) {
+        tal_mutex_release(workqueue->mutex);
+    }
+    tal_free(workqueue);
+}
+
+static OPERATE_RET __workqueue_mt_input(TAL_WORKQUEUE_MT_T *workqueue, uint32_t key, BOOL_T instant,
+                                        WORKQUEUE_CB cb, void *data)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    WORKQUEUE_MT_WORKER_T *worker = NULL;
+    WORK_MT_ITEM_T item = {.cb = cb, .data = data};
+    uint32_t depth;
+    uint8_t i, idx;
+
+    tal_mutex_lock(workqueue->mutex);
+
+    if (WORKQUEUE_MT_KEY_NONE != key) {
+        worker = &workqueue->worker[key % workqueue->worker_num];
+    } else {
+        // first idle worker from the round robin position, the next one when all are busy
+        for (i = 0; i < workqueue->worker_num; i++) {
+            idx = (workqueue->next + i) % workqueue->worker_num;
+            if (!workqueue->worker[idx].busy) {
+                break;
+            }
+        }
+        if (i == workqueue->worker_num) {
+            idx = workqueue->next;
+        }
+        workqueue->next = (idx + 1) % workqueue->worker_num;
+        worker = &workqueue->worker[idx];
+    }
+
+    item.sched_time = tal_system_get_millisecond();
+    if (WORKQUEUE_MT_KEY_NONE != key) {
+        op_ret = tuya_queue_input(worker->keyed, &item);
+    } else if (instant) {
+        op_ret = tuya_queue_input_instant(worker->shared, &item);
+    } else {
+        op_ret = tuya_queue_input(worker->shared, &item);
+    }
+
+    if (OPRT_OK == op_ret) {
+        workqueue->scheduled++;
+        depth = __workqueue_mt_depth(workqueue);
+        if (depth > workqueue->depth_max) {
+            workqueue->depth_max = depth;
+        }
+    }
+
+    tal_mutex_unlock(workqueue->mutex);
+
+    // the item is queued, a failed post only means the worker is already woken
+    if (OPRT_OK == op_ret) {
+        tal_semaphore_post(worker->sem);
+    }
+
+    return op_ret;
+}
+
+static BOOL_T __work_mt_cancel_traverse(void *item, void *ctx)
+{
+    BOOL_T is_same = FALSE;
+    WORK_MT_ITEM_T *src = (WORK_MT_ITEM_T *)item;
+    WORK_ITEM_T *dst = (WORK_ITEM_T *)ctx;
+
+    if (src && dst) {
+        if (dst->cb && (dst->cb == src->cb)) {
+            is_same = TRUE;
+        }
+
+        if (dst->data && (dst->data == src->data)) {
+            is_same = TRUE;
+        }
+    }
+
+    if (is_same) {
+        src->cb = NULL; // stop exe
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief create a workqueue served by several worker threads
+ *
+ * @param[in] cfg the workqueue configuration
+ * @param[out] handle the workqueue handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_mt_create(const WORKQUEUE_MT_CFG_T *cfg, WORKQUEUE_MT_HANDLE *handle)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    TAL_WORKQUEUE_MT_T *workqueue = NULL;
+    WORKQUEUE_MT_WORKER_T *worker = NULL;
+    THREAD_CFG_T thread_cfg;
+    uint8_t i;
+
+    if ((NULL == cfg) || (NULL == handle) || (0 == cfg->queue_len) || (0 == cfg->worker_num) ||
+        (cfg->worker_num > WORKQUEUE_MT_WORKER_MAX)) {
+        return OPRT_INVALID_PARM;
+    }
+
+    workqueue = (TAL_WORKQUEUE_MT_T *)tal_calloc(1, sizeof(TAL_WORKQUEUE_MT_T));
+    if (NULL == workqueue) {
+        return OPRT_MALLOC_FAILED;
+    }
+    workqueue->worker_num = cfg->worker_num;
+
+    op_ret = tal_mutex_create_init(&workqueue->mutex);
+    if (OPRT_OK != op_ret) {
+        __workqueue_mt_free(workqueue);
+        return op_ret;
+    }
+
+    for (i = 0; i < workqueue->worker_num; i++) {
+        worker = &workqueue->worker[i];
+        worker->workqueue = workqueue;
+
+        op_ret = tuya_queue_create(cfg->queue_len, sizeof(WORK_MT_ITEM_T), &worker->shared);
+        if (OPRT_OK != op_ret) {
+            break;
+        }
+        op_ret = tuya_queue_create(cfg->queue_len, sizeof(WORK_MT_ITEM_T), &worker->keyed);
+        if (OPRT_OK != op_ret) {
+            break;
+        }
+        op_ret = tal_semaphore_create_init(&worker->sem, 0, 1);
+        if (OPRT_OK != op_ret) {
+            break;
+        }
+    }
+
+    // start the workers once every queue exists, they steal from each other
+    for (i = 0; (OPRT_OK == op_ret) && (i < workqueue->worker_num); i++) {
+        worker = &workqueue->worker[i];
+        snprintf(worker->name, sizeof(worker->name), "%s%d",
+                 cfg->thread_cfg.thrdname ? cfg->thread_cfg.thrdname : "wq_mt", i);
+        thread_cfg = cfg->thread_cfg;
+        thread_cfg.thrdname = worker->name;
+#if defined(ENABLE_SMP) && (ENABLE_SMP == 1)
+        if (cfg->core_num) {
+            thread_cfg.smp_pin = 1;
+            thread_cfg.smp_core = i % cfg->core_num;
+        }
+#endif
+        op_ret = tal_thread_create_and_start(&worker->thread, NULL, NULL, __worker_thread_cb, worker, &thread_cfg);
+    }
+
+    if (OPRT_OK != op_ret) {
+        __workqueue_mt_free(workqueue);
+        return op_ret;
+    }
+
+    *handle = workqueue;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief put work task in workqueue, it may run on any worker
+ *
+ * @param[in] handle the workqueue handle
+ * @param[in] cb the work callback
+ * @param[in] data the work data
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_mt_schedule(WORKQUEUE_MT_HANDLE handle, WORKQUEUE_CB cb, void *data)
+{
+    if ((NULL == handle) || (NULL == cb)) {
+        return OPRT_INVALID_PARM;
+    }
+
+    return __workqueue_mt_input((TAL_WORKQUEUE_MT_T *)handle, WORKQUEUE_MT_KEY_NONE, FALSE, cb, data);
+}
+
+/**
+ * @brief put work task in workqueue, ahead of the unkeyed tasks waiting on its worker
+ *
+ * @param[in] handle the workqueue handle
+ * @param[in] cb the work callback
+ * @param[in] data the work data
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_mt_schedule_instant(WORKQUEUE_MT_HANDLE handle, WORKQUEUE_CB cb, void *data)
+{
+    if ((NULL == handle) || (NULL == cb)) {
+        return OPRT_INVALID_PARM;
+    }
+
+    return __workqueue_mt_input((TAL_WORKQUEUE_MT_T *)handle, WORKQUEUE_MT_KEY_NONE, TRUE, cb, data);
+}
+
+/**
+ * @brief put work task in workqueue, serialized with the other tasks of the same key
+ *
+ * @param[in] handle the workqueue handle
+ * @param[in] key the ordering key, WORKQUEUE_MT_KEY_NONE behaves as tal_workqueue_mt_schedule
+ * @param[in] cb the work callback
+ * @param[in] data the work data
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_mt_schedule_keyed(WORKQUEUE_MT_HANDLE handle, uint32_t key, WORKQUEUE_CB cb,
+                                            void *data)
+{
+    if ((NULL == handle) || (NULL == cb)) {
+        return OPRT_INVALID_PARM;
+    }
+
+    return __workqueue_mt_input((TAL_WORKQUEUE_MT_T *)handle, key, FALSE, cb, data);
+}
+
+/**
+ * @brief cancel work tasks in workqueue which match cb or data
+ *
+ * @param[in] handle the workqueue handle
+ * @param[in] cb the work callback
+ * @param[in] data the work data
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_mt_cancel(WORKQUEUE_MT_HANDLE handle, WORKQUEUE_CB cb, void *data)
+{
+    if ((NULL == handle) || ((NULL == cb) && (NULL == data))) {
+        return OPRT_INVALID_PARM;
+    }
+
+    TAL_WORKQUEUE_MT_T *workqueue = (TAL_WORKQUEUE_MT_T *)handle;
+    WORK_ITEM_T work_item = {.cb = cb, .data = data};
+    uint8_t i;
+
+    for (i = 0; i < workqueue->worker_num; i++) {
+        tuya_queue_traverse(workqueue->worker[i].shared, __work_mt_cancel_traverse, &work_item);
+        tuya_queue_traverse(workqueue->worker[i].keyed, __work_mt_cancel_traverse, &work_item);
+    }
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief get the workqueue item number
+ *
+ * @param[in] handle the workqueue handle
+ *
+ * @return the current item counts of all workers
+ */
+uint32_t tal_workqueue_mt_get_num(WORKQUEUE_MT_HANDLE handle)
+{
+    if (NULL == handle) {
+        return 0;
+    }
+
+    return __workqueue_mt_depth((TAL_WORKQUEUE_MT_T *)handle);
+}
+
+/**
+ * @brief get the workqueue statistics
+ *
+ * @param[in] handle the workqueue handle
+ * @param[out] stats the statistics since creation or the last reset
+ * @param[in] reset restart the counters after reading them
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_mt_get_stats(WORKQUEUE_MT_HANDLE handle, WORKQUEUE_MT_STATS_T *stats, BOOL_T reset)
+{
+    if ((NULL == handle) || (NULL == stats)) {
+        return OPRT_INVALID_PARM;
+    }
+
+    TAL_WORKQUEUE_MT_T *workqueue = (TAL_WORKQUEUE_MT_T *)handle;
+    WORKQUEUE_MT_WORKER_T *worker = NULL;
+    uint32_t latency_sum = 0, run_sum = 0;
+    uint8_t i;
+
+    memset(stats, 0, sizeof(WORKQUEUE_MT_STATS_T));
+
+    tal_mutex_lock(workqueue->mutex);
+    stats->scheduled = workqueue->scheduled;
+    stats->depth_max = workqueue->depth_max;
+    stats->depth = __workqueue_mt_depth(workqueue);
+    if (reset) {
+        workqueue->scheduled = 0;
+        workqueue->depth_max = stats->depth;
+    }
+    tal_mutex_unlock(workqueue->mutex);
+
+    // the worker stats are only written by their worker, a pending reset reads as zero
+    for (i = 0; i < workqueue->worker_num; i++) {
+        worker = &workqueue->worker[i];
+        if (worker->stats_reset) {
+            continue;
+        }
+
+        stats->executed += worker->stats.executed;
+        stats->stolen += worker->stats.stolen;
+        latency_sum += worker->stats.latency_sum;
+        run_sum += worker->stats.run_sum;
+        if (worker->stats.latency_max > stats->latency_max) {
+            stats->latency_max = worker->stats.latency_max;
+        }
+        if (worker->stats.run_max > stats->run_max) {
+            stats->run_max = worker->stats.run_max;
+        }
+
+        if (reset) {
+            worker->stats_reset = TRUE;
+        }
+    }
+
+    if (stats->executed) {
+        stats->latency_avg = latency_sum / stats->executed;
+        stats->run_avg = run_sum / stats->executed;
+    }
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief release the workqueue, waiting for the running callbacks to return
+ *
+ * @param[in] handle the workqueue handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_mt_release(WORKQUEUE_MT_HANDLE handle)
+{
+    if (NULL == handle) {
+        return OPRT_INVALID_PARM;
+    }
+
+    __workqueue_mt_free((TAL_WORKQUEUE_MT_T *)handle);
+
+    return OPRT_OK;
+}
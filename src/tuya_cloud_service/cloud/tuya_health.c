@@ -289,8 +289,7 @@ void tuya_health_item_dump(void)
 
 static bool __health_memory_check(void)
 {
-    // dump all active threads' wartmark
-    extern void tal_thread_dump_watermark(void);
+    // dump all active threads' stack watermark and cpu usage
     tal_workq_schedule(WORKQ_SYSTEM, (WORKQUEUE_CB)tal_thread_dump_watermark, NULL);
 
     int free_heap = 0;
@@ -0,0 +1,55 @@
+/**
+ * @file bench.h
+ * @brief helpers shared by the host benchmarks
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief abort the benchmark when a result is wrong, also with NDEBUG
+ *
+ */
+#define BENCH_CHECK(cond)                                                                                              \
+    do {                                                                                                               \
+        if (!(cond)) {                                                                                                 \
+            printf("%s:%d check failed: %s\n", __FILE__, __LINE__, #cond);                                             \
+            exit(1);                                                                                                   \
+        }                                                                                                              \
+    } while (0)
+
+/* tkl_system_malloc calls so far */
+extern uint32_t g_bench_malloc_cnt;
+
+/**
+ * @brief monotonic time in seconds
+ *
+ */
+double bench_now(void);
+
+/**
+ * @brief deterministic pseudo random number, 24 bits
+ *
+ */
+uint32_t bench_rand(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BENCH_H__ */
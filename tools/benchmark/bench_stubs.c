@@ -0,0 +1,76 @@
+/**
+ * @file bench_stubs.c
+ * @brief host implementation of the kernel layer used by the benchmarks
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "tuya_cloud_types.h"
+#include "tkl_mutex.h"
+#include "bench.h"
+
+uint32_t g_bench_malloc_cnt = 0;
+
+void *tkl_system_malloc(size_t size)
+{
+    g_bench_malloc_cnt++;
+    return malloc(size);
+}
+
+void tkl_system_free(void *ptr)
+{
+    free(ptr);
+}
+
+OPERATE_RET tkl_mutex_create_init(TKL_MUTEX_HANDLE *handle)
+{
+    pthread_mutex_t *mutex = malloc(sizeof(pthread_mutex_t));
+
+    if (NULL == mutex) {
+        return OPRT_MALLOC_FAILED;
+    }
+    pthread_mutex_init(mutex, NULL);
+    *handle = mutex;
+    return OPRT_OK;
+}
+
+OPERATE_RET tkl_mutex_lock(const TKL_MUTEX_HANDLE handle)
+{
+    pthread_mutex_lock(handle);
+    return OPRT_OK;
+}
+
+OPERATE_RET tkl_mutex_unlock(const TKL_MUTEX_HANDLE handle)
+{
+    pthread_mutex_unlock(handle);
+    return OPRT_OK;
+}
+
+OPERATE_RET tkl_mutex_release(const TKL_MUTEX_HANDLE handle)
+{
+    pthread_mutex_destroy(handle);
+    free(handle);
+    return OPRT_OK;
+}
+
+double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+uint32_t bench_rand(void)
+{
+    static uint32_t seed = 1;
+
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
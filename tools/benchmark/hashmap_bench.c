@@ -0,0 +1,251 @@
+/**
+ * @file hashmap_bench.c
+ * @brief tuya_hashmap correctness against a reference multimap, and lookup
+ * speed over the keys of a device: DP codes and MQTT topics
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include <string.h>
+
+#include "tuya_hashmap.h"
+#include "bench.h"
+
+#define HASHMAP_BENCH_DP_NUM    31
+#define HASHMAP_BENCH_TOPIC_NUM 200
+#define HASHMAP_BENCH_KEY_NUM   (HASHMAP_BENCH_DP_NUM + HASHMAP_BENCH_TOPIC_NUM)
+#define HASHMAP_BENCH_KEY_LEN   64
+#define HASHMAP_BENCH_REF_MAX   5000
+#define HASHMAP_BENCH_TEST_OPS  20000
+#define HASHMAP_BENCH_GETS      2000000
+
+typedef MAP_T (*HASHMAP_BENCH_NEW_CB)(uint32_t table_size);
+
+typedef struct {
+    const char *key;
+    long data;
+} HASHMAP_BENCH_REF_T;
+
+// older revisions have no compact backend
+extern MAP_T tuya_hashmap_new_compact(uint32_t table_size) __attribute__((weak));
+
+static const char *s_dp_code[HASHMAP_BENCH_DP_NUM] = {
+    "switch_led",  "work_mode",      "bright_value",   "temp_value",     "colour_data",        "scene_data",
+    "countdown",   "music_data",     "control_data",   "switch_1",       "switch_2",           "switch_3",
+    "switch_4",    "countdown_1",    "relay_status",   "light_mode",     "child_lock",         "cycle_time",
+    "random_time", "switch_inching", "cur_current",    "cur_power",      "cur_voltage",        "add_ele",
+    "fault",       "battery_percentage", "va_temperature", "va_humidity", "temp_unit_convert", "maxtemp_set",
+    "mintemp_set"};
+
+static char s_topic[HASHMAP_BENCH_TOPIC_NUM][HASHMAP_BENCH_KEY_LEN];
+static const char *s_key[HASHMAP_BENCH_KEY_NUM];
+
+// the reference multimap, oldest first
+static HASHMAP_BENCH_REF_T s_ref[HASHMAP_BENCH_REF_MAX];
+static uint32_t s_ref_num = 0;
+
+static void __hashmap_bench_keys(void)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < HASHMAP_BENCH_DP_NUM; i++) {
+        s_key[i] = s_dp_code[i];
+    }
+    for (i = 0; i < HASHMAP_BENCH_TOPIC_NUM; i++) {
+        snprintf(s_topic[i], HASHMAP_BENCH_KEY_LEN, "tylink/%s%06u/thing/%s", (i % 2) ? "6c1f8e" : "bf02a9",
+                 i * 7919 % 1000000, (i % 3) ? "property/report" : "action/execute");
+        s_key[HASHMAP_BENCH_DP_NUM + i] = s_topic[i];
+    }
+}
+
+/**
+ * @brief newest reference entry of a key, of a key and data when data is not 0
+ */
+static int __hashmap_bench_ref_find(const char *key, long data)
+{
+    int i = 0;
+
+    for (i = (int)s_ref_num - 1; i >= 0; i--) {
+        if (0 == strcmp(s_ref[i].key, key) && (0 == data || s_ref[i].data == data)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void __hashmap_bench_ref_del(int idx)
+{
+    memmove(&s_ref[idx], &s_ref[idx + 1], (s_ref_num - idx - 1) * sizeof(HASHMAP_BENCH_REF_T));
+    s_ref_num--;
+}
+
+/**
+ * @brief newest reference entry of a key before idx
+ */
+static int __hashmap_bench_ref_prev(const char *key, int idx)
+{
+    for (idx--; idx >= 0 && strcmp(s_ref[idx].key, key); idx--) {
+    }
+    return idx;
+}
+
+/**
+ * @brief every key gives the data of the reference, newest first
+ */
+static void __hashmap_bench_ref_check(MAP_T map)
+{
+    ANY_T *iter = NULL;
+    ANY_T data = NULL;
+    uint32_t i = 0;
+    int idx = 0;
+    int ret = 0;
+
+    for (i = 0; i < HASHMAP_BENCH_KEY_NUM; i++) {
+        idx = s_ref_num;
+        TUYA_HASHMAP_FOR_EACH_DATA(map, s_key[i], iter)
+        {
+            idx = __hashmap_bench_ref_prev(s_key[i], idx);
+            BENCH_CHECK(idx >= 0 && (long)*iter == s_ref[idx].data);
+        }
+        BENCH_CHECK(__hashmap_bench_ref_prev(s_key[i], idx) < 0);
+
+        idx = __hashmap_bench_ref_find(s_key[i], 0);
+        ret = tuya_hashmap_get(map, s_key[i], &data);
+        BENCH_CHECK((idx < 0) ? (MAP_MISSING == ret) : (MAP_OK == ret && (long)data == s_ref[idx].data));
+    }
+    BENCH_CHECK(tuya_hashmap_length(map) == (int)s_ref_num);
+}
+
+/**
+ * @brief random put and remove, by key and by key and data, checked against
+ * the reference multimap; the first half on few keys for long chains
+ */
+static void __hashmap_bench_test(const char *name, HASHMAP_BENCH_NEW_CB map_new)
+{
+    MAP_T map = map_new(4);
+    const char *key = NULL;
+    long data = 1;
+    long del = 0;
+    uint32_t op = 0, k = 0;
+    int idx = 0;
+    int ret = 0;
+
+    BENCH_CHECK(NULL != map);
+    s_ref_num = 0;
+    for (op = 0; op < HASHMAP_BENCH_TEST_OPS; op++) {
+        key = s_key[bench_rand() % ((op < HASHMAP_BENCH_TEST_OPS / 2) ? 40 : HASHMAP_BENCH_KEY_NUM)];
+        k = bench_rand() % 10;
+        if (k < 5 && s_ref_num < HASHMAP_BENCH_REF_MAX) {
+            BENCH_CHECK(MAP_OK == tuya_hashmap_put(map, key, (ANY_T)data));
+            s_ref[s_ref_num].key = key;
+            s_ref[s_ref_num].data = data++;
+            s_ref_num++;
+        } else {
+            // by key only, or by data that may or may not be there
+            del = 0;
+            if (k >= 8) {
+                del = (s_ref_num && (bench_rand() & 1)) ? s_ref[bench_rand() % s_ref_num].data : -5;
+            }
+            idx = __hashmap_bench_ref_find(key, del);
+            ret = tuya_hashmap_remove(map, (char *)key, (ANY_T)del);
+            BENCH_CHECK((idx < 0) ? (MAP_MISSING == ret) : (MAP_OK == ret));
+            if (idx >= 0) {
+                __hashmap_bench_ref_del(idx);
+            }
+        }
+        if (0 == op % 97) {
+            __hashmap_bench_ref_check(map);
+        }
+    }
+    __hashmap_bench_ref_check(map);
+    tuya_hashmap_free(map);
+    printf("%-8s %u random operations match the reference, %u entries left\n", name, HASHMAP_BENCH_TEST_OPS, s_ref_num);
+}
+
+static void __hashmap_bench_speed(const char *name, HASHMAP_BENCH_NEW_CB map_new, const char *set, const char **keys,
+                                  uint32_t num, uint32_t table_size)
+{
+    static char copy[HASHMAP_BENCH_KEY_NUM][HASHMAP_BENCH_KEY_LEN];
+    char miss[HASHMAP_BENCH_KEY_LEN];
+    MAP_T map = map_new(table_size);
+    ANY_T data = NULL;
+    uint32_t rounds = HASHMAP_BENCH_GETS / num;
+    uint32_t i = 0, r = 0;
+    long sum = 0;
+    double start = 0, put = 0, hit = 0, lost = 0, del = 0;
+
+    BENCH_CHECK(NULL != map);
+    // lookups come with keys from received messages, not the stored pointers
+    for (i = 0; i < num; i++) {
+        strcpy(copy[i], keys[i]);
+    }
+
+    start = bench_now();
+    for (i = 0; i < num; i++) {
+        tuya_hashmap_put(map, keys[i], (ANY_T)(long)(i + 1));
+    }
+    put = bench_now() - start;
+
+    start = bench_now();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < num; i++) {
+            tuya_hashmap_get(map, copy[i], &data);
+            sum += (long)data;
+        }
+    }
+    hit = bench_now() - start;
+    BENCH_CHECK(sum == (long)rounds * num * (num + 1) / 2);
+
+    // a key that differs from a stored one in its last characters
+    start = bench_now();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < num; i++) {
+            strcpy(miss, copy[i]);
+            miss[strlen(miss) - 1] ^= 0x20;
+            BENCH_CHECK(MAP_MISSING == tuya_hashmap_get(map, miss, &data));
+        }
+    }
+    lost = bench_now() - start;
+
+    start = bench_now();
+    for (i = 0; i < num; i++) {
+        tuya_hashmap_remove(map, (char *)keys[i], NULL);
+    }
+    del = bench_now() - start;
+    BENCH_CHECK(0 == tuya_hashmap_length(map));
+    tuya_hashmap_free(map);
+
+    printf("%-8s %-9s %3u keys, table %2u: put %6.1f get %6.1f miss %6.1f remove %6.1f ns\n", name, set, num,
+           table_size, put * 1e9 / num, hit * 1e9 / rounds / num, lost * 1e9 / rounds / num, del * 1e9 / num);
+}
+
+static void __hashmap_bench_run(const char *name, HASHMAP_BENCH_NEW_CB map_new, BOOL_T speed_only)
+{
+    if (!speed_only) {
+        __hashmap_bench_test(name, map_new);
+    }
+    __hashmap_bench_speed(name, map_new, "dp codes", s_key, HASHMAP_BENCH_DP_NUM, 8);
+    __hashmap_bench_speed(name, map_new, "dp codes", s_key, HASHMAP_BENCH_DP_NUM, 64);
+    __hashmap_bench_speed(name, map_new, "topics", s_key + HASHMAP_BENCH_DP_NUM, HASHMAP_BENCH_TOPIC_NUM, 16);
+}
+
+/**
+ * @brief -s skips the random test, for the numbers of revisions that fail it:
+ * before the remove of a missing entry was fixed it freed the last one seen
+ */
+int main(int argc, char **argv)
+{
+    BOOL_T speed_only = (argc > 1 && 0 == strcmp(argv[1], "-s"));
+
+    __hashmap_bench_keys();
+
+    __hashmap_bench_run("chained", tuya_hashmap_new, speed_only);
+    if (tuya_hashmap_new_compact) {
+        __hashmap_bench_run("compact", tuya_hashmap_new_compact, speed_only);
+    }
+
+    return 0;
+}
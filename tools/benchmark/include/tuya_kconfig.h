@@ -0,0 +1,16 @@
+/**
+ * @file tuya_kconfig.h
+ * @brief host configuration of the benchmarks, stands in for the generated one
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __TUYA_KCONFIG_H__
+#define __TUYA_KCONFIG_H__
+
+#define OPERATING_SYSTEM 100 // SYSTEM_LINUX
+
+#endif /* __TUYA_KCONFIG_H__ */
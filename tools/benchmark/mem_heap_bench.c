@@ -0,0 +1,156 @@
+/**
+ * @file mem_heap_bench.c
+ * @brief tuya_mem_heap latency and fragmentation under a long random workload
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "tuya_mem_heap.h"
+#include "bench.h"
+
+#define MEM_HEAP_BENCH_SIZE (8 << 20)
+#define MEM_HEAP_BENCH_LIVE 2000
+#define MEM_HEAP_BENCH_OPS  400000
+
+typedef struct {
+    uint8_t *ptr;
+    uint32_t size;
+} MEM_HEAP_BENCH_SLOT_T;
+
+static MEM_HEAP_BENCH_SLOT_T s_slot[MEM_HEAP_BENCH_LIVE];
+static uint32_t s_malloc_ns[MEM_HEAP_BENCH_OPS];
+static uint32_t s_free_ns[MEM_HEAP_BENCH_OPS];
+
+static void __mem_heap_bench_critical(void)
+{
+}
+
+static void __mem_heap_bench_output(char *format, ...)
+{
+}
+
+static int __mem_heap_bench_cmp(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void __mem_heap_bench_latency(const char *name, uint32_t *ns, uint32_t num)
+{
+    uint64_t sum = 0;
+    uint32_t i = 0;
+
+    for (i = 0; i < num; i++) {
+        sum += ns[i];
+    }
+    qsort(ns, num, sizeof(uint32_t), __mem_heap_bench_cmp);
+    printf("  %-6s avg %5llu p50 %5u p99 %5u p99.9 %6u max %7u ns\n", name, (unsigned long long)(sum / num),
+           ns[num / 2], ns[num * 99 / 100], ns[num * 999 / 1000], ns[num - 1]);
+}
+
+static void __mem_heap_bench_state(HEAP_HANDLE heap)
+{
+    heap_state_t state = {0};
+
+    tuya_mem_heap_state(heap, &state);
+    printf("  free %lu of %lu, watermark %lu", state.free_size, state.total_size, state.free_watermark);
+    // not every heap revision reports its largest block
+    if (state.max_free_block_size) {
+        printf(", largest block %lu, fragmentation %.1f%%", state.max_free_block_size,
+               100.0 * (1.0 - (double)state.max_free_block_size / state.free_size));
+    }
+    printf("\n");
+}
+
+/**
+ * @brief a size mix: seven in eight objects below 1 KiB, the rest spread over
+ * the powers of two below 1 << max_log2, the frame and audio buffers
+ */
+static uint32_t __mem_heap_bench_size(uint32_t max_log2)
+{
+    uint32_t shift = 4 + bench_rand() % (max_log2 - 4);
+    uint32_t size = (1u << shift) + bench_rand() % (1u << shift);
+
+    if (bench_rand() % 8) {
+        size &= 0x3FF;
+    }
+    return size ? size : 1;
+}
+
+static void __mem_heap_bench_run(const char *name, uint32_t max_log2)
+{
+    HEAP_HANDLE heap = NULL;
+    void *mem = malloc(MEM_HEAP_BENCH_SIZE);
+    MEM_HEAP_BENCH_SLOT_T *slot = NULL;
+    uint32_t malloc_num = 0, free_num = 0, failed = 0;
+    uint32_t i = 0, op = 0;
+    double start = 0;
+
+    BENCH_CHECK(NULL != mem);
+    memset(mem, 0, MEM_HEAP_BENCH_SIZE); // no page faults in the timed calls
+    BENCH_CHECK(0 == tuya_mem_heap_create(mem, MEM_HEAP_BENCH_SIZE, &heap));
+    memset(s_slot, 0, sizeof(s_slot));
+
+    for (op = 0; op < MEM_HEAP_BENCH_OPS; op++) {
+        i = bench_rand() % MEM_HEAP_BENCH_LIVE;
+        slot = &s_slot[i];
+        if (slot->ptr) {
+            // the block kept its content while its neighbours came and went
+            BENCH_CHECK(slot->ptr[0] == (uint8_t)i && slot->ptr[slot->size - 1] == (uint8_t)i);
+            start = bench_now();
+            tuya_mem_heap_free(heap, slot->ptr);
+            s_free_ns[free_num++] = (uint32_t)((bench_now() - start) * 1e9);
+            slot->ptr = NULL;
+        } else {
+            slot->size = __mem_heap_bench_size(max_log2);
+            start = bench_now();
+            slot->ptr = tuya_mem_heap_malloc(heap, slot->size);
+            s_malloc_ns[malloc_num++] = (uint32_t)((bench_now() - start) * 1e9);
+            if (NULL == slot->ptr) {
+                failed++;
+                continue;
+            }
+            memset(slot->ptr, (uint8_t)i, slot->size);
+        }
+    }
+
+    printf("%s: %u live slots, %u malloc (%u failed), %u free\n", name, MEM_HEAP_BENCH_LIVE, malloc_num, failed,
+           free_num);
+    __mem_heap_bench_latency("malloc", s_malloc_ns, malloc_num);
+    __mem_heap_bench_latency("free", s_free_ns, free_num);
+    __mem_heap_bench_state(heap);
+
+    for (i = 0; i < MEM_HEAP_BENCH_LIVE; i++) {
+        if (s_slot[i].ptr) {
+            tuya_mem_heap_free(heap, s_slot[i].ptr);
+        }
+    }
+    BENCH_CHECK(0 == tuya_mem_heap_diagnose(heap));
+    tuya_mem_heap_delete(heap);
+    free(mem);
+}
+
+int main(void)
+{
+    heap_context_t ctx = {
+        .enter_critical = __mem_heap_bench_critical,
+        .exit_critical = __mem_heap_bench_critical,
+        .dbg_output = __mem_heap_bench_output,
+    };
+
+    tuya_mem_heap_init(&ctx);
+
+    __mem_heap_bench_run("objects below 1 KiB", 10);
+    __mem_heap_bench_run("objects below 64 KiB", 16);
+    __mem_heap_bench_run("objects below 256 KiB", 18);
+
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file queue_bench.c
+ * @brief tuya_queue throughput, in operations per second
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include <string.h>
+
+#include "tuya_queue.h"
+#include "bench.h"
+
+#define QUEUE_BENCH_LOOPS 5000000
+
+/* same layout as the items of tal_workqueue */
+typedef struct {
+    void *cb;
+    void *data;
+} QUEUE_BENCH_ITEM_T;
+
+static void __queue_bench_report(const char *name, uint32_t ops, double sec, uint32_t mallocs)
+{
+    printf("%-32s %8.2f M ops/s  %.3f malloc/op\n", name, ops / sec / 1e6, (double)mallocs / ops);
+}
+
+/**
+ * @brief steady state of a workqueue: one input and one output per loop, with
+ * the queue holding depth items
+ */
+static void __queue_bench_input_output(uint32_t queue_len, uint32_t depth)
+{
+    TUYA_QUEUE_HANDLE queue = NULL;
+    QUEUE_BENCH_ITEM_T item = {0};
+    char name[32];
+    uint32_t mallocs = 0;
+    uint32_t i = 0;
+    double start = 0;
+
+    BENCH_CHECK(OPRT_OK == tuya_queue_create(queue_len, sizeof(QUEUE_BENCH_ITEM_T), &queue));
+    for (i = 0; i < depth; i++) {
+        BENCH_CHECK(OPRT_OK == tuya_queue_input(queue, &item));
+    }
+
+    mallocs = g_bench_malloc_cnt;
+    start = bench_now();
+    for (i = 0; i < QUEUE_BENCH_LOOPS; i++) {
+        item.data = (void *)(uintptr_t)i;
+        tuya_queue_input(queue, &item);
+        tuya_queue_output(queue, &item);
+    }
+    snprintf(name, sizeof(name), "input/output len %u depth %u", queue_len, depth);
+    __queue_bench_report(name, 2 * QUEUE_BENCH_LOOPS, bench_now() - start, g_bench_malloc_cnt - mallocs);
+
+    BENCH_CHECK(depth == tuya_queue_get_used_num(queue));
+    tuya_queue_release(queue);
+}
+
+/**
+ * @brief urgent work: insert at the front, then take it out again
+ */
+static void __queue_bench_instant(uint32_t queue_len)
+{
+    TUYA_QUEUE_HANDLE queue = NULL;
+    QUEUE_BENCH_ITEM_T item = {0};
+    uint32_t mallocs = 0;
+    uint32_t i = 0;
+    double start = 0;
+
+    BENCH_CHECK(OPRT_OK == tuya_queue_create(queue_len, sizeof(QUEUE_BENCH_ITEM_T), &queue));
+    for (i = 0; i < queue_len / 2; i++) {
+        BENCH_CHECK(OPRT_OK == tuya_queue_input(queue, &item));
+    }
+
+    mallocs = g_bench_malloc_cnt;
+    start = bench_now();
+    for (i = 0; i < QUEUE_BENCH_LOOPS; i++) {
+        item.data = (void *)(uintptr_t)i;
+        tuya_queue_input_instant(queue, &item);
+        tuya_queue_output(queue, &item);
+        BENCH_CHECK((uintptr_t)item.data == i);
+    }
+    __queue_bench_report("input_instant/output", 2 * QUEUE_BENCH_LOOPS, bench_now() - start,
+                         g_bench_malloc_cnt - mallocs);
+
+    tuya_queue_release(queue);
+}
+
+/**
+ * @brief batch consumers: peek a batch, then drop it
+ */
+static void __queue_bench_batch(uint32_t queue_len, uint32_t batch)
+{
+    TUYA_QUEUE_HANDLE queue = NULL;
+    QUEUE_BENCH_ITEM_T item = {0};
+    QUEUE_BENCH_ITEM_T items[16];
+    char name[32];
+    uint32_t mallocs = 0;
+    uint32_t loops = QUEUE_BENCH_LOOPS / batch;
+    uint32_t i = 0, j = 0;
+    double start = 0;
+
+    BENCH_CHECK(batch <= CNTSOF(items));
+    BENCH_CHECK(OPRT_OK == tuya_queue_create(queue_len, sizeof(QUEUE_BENCH_ITEM_T), &queue));
+
+    mallocs = g_bench_malloc_cnt;
+    start = bench_now();
+    for (i = 0; i < loops; i++) {
+        for (j = 0; j < batch; j++) {
+            item.data = (void *)(uintptr_t)j;
+            tuya_queue_input(queue, &item);
+        }
+        tuya_queue_get_batch(queue, 0, items, batch);
+        tuya_queue_delete_batch(queue, batch);
+    }
+    snprintf(name, sizeof(name), "input + batch of %u", batch);
+    __queue_bench_report(name, loops * (batch + 2), bench_now() - start, g_bench_malloc_cnt - mallocs);
+
+    BENCH_CHECK((uintptr_t)items[batch - 1].data == batch - 1);
+    BENCH_CHECK(0 == tuya_queue_get_used_num(queue));
+    tuya_queue_release(queue);
+}
+
+int main(void)
+{
+    __queue_bench_input_output(8, 0);
+    __queue_bench_input_output(100, 50);
+    __queue_bench_input_output(1000, 900);
+    __queue_bench_instant(100);
+    __queue_bench_batch(100, 4);
+    __queue_bench_batch(100, 16);
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+/**
+ * @file sw_timer_bench.c
+ * @brief tal_sw_timer start/stop and expiry throughput with thousands of timers
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * The timer thread runs in the benchmark thread against a simulated clock: a
+ * semaphore wait without a pending post moves the clock by its timeout, so the
+ * numbers are the cost of the timer module alone.
+ *
+ * @copyright Copyright 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include <string.h>
+
+#include "tal_sw_timer.h"
+#include "tal_time_service.h"
+#include "tal_semaphore.h"
+#include "tal_thread.h"
+#include "tal_mutex.h"
+#include "tal_memory.h"
+#include "tal_log.h"
+#include "bench.h"
+
+#define SW_TIMER_BENCH_RUN_MS (60 * 1000)
+
+typedef struct {
+    TIMER_ID id;
+    uint32_t interval;
+    uint64_t expire;
+    uint32_t fired;
+} SW_TIMER_BENCH_T;
+
+static uint64_t s_now_ms = 1000;
+static uint64_t s_end_ms = 0;
+static uint32_t s_wakeups = 0;
+static BOOL_T s_posted = FALSE;
+static THREAD_FUNC_CB s_timer_thread = NULL;
+
+static SW_TIMER_BENCH_T *s_timers = NULL;
+static uint32_t s_expiries = 0;
+static uint64_t s_late_max = 0;
+
+void tal_time_get_system_time(TIME_S *sec, TIME_MS *ms)
+{
+    if (sec) {
+        *sec = s_now_ms / 1000;
+    }
+    if (ms) {
+        *ms = s_now_ms % 1000;
+    }
+}
+
+OPERATE_RET tal_mutex_create_init(MUTEX_HANDLE *handle)
+{
+    *handle = (MUTEX_HANDLE)1;
+    return OPRT_OK;
+}
+
+OPERATE_RET tal_mutex_lock(const MUTEX_HANDLE handle)
+{
+    return OPRT_OK;
+}
+
+OPERATE_RET tal_mutex_unlock(const MUTEX_HANDLE handle)
+{
+    return OPRT_OK;
+}
+
+OPERATE_RET tal_semaphore_create_init(SEM_HANDLE *handle, const uint32_t sem_cnt, const uint32_t sem_max)
+{
+    *handle = (SEM_HANDLE)1;
+    return OPRT_OK;
+}
+
+OPERATE_RET tal_semaphore_post(const SEM_HANDLE handle)
+{
+    s_posted = TRUE;
+    return OPRT_OK;
+}
+
+OPERATE_RET tal_semaphore_wait(const SEM_HANDLE handle, const uint32_t timeout)
+{
+    if (s_posted) {
+        s_posted = FALSE;
+        return OPRT_OK;
+    }
+
+    // nothing to do before the timeout, time passes
+    s_wakeups++;
+    if (SEM_WAIT_FOREVER == timeout || s_now_ms + timeout > s_end_ms) {
+        s_now_ms = s_end_ms;
+    } else {
+        s_now_ms += timeout;
+    }
+    return OPRT_OS_ADAPTER_SEM_WAIT_FAILED;
+}
+
+OPERATE_RET tal_thread_create_and_start(THREAD_HANDLE *handle, const THREAD_ENTER_CB enter, const THREAD_EXIT_CB exit,
+                                        const THREAD_FUNC_CB func, const void *arg, const THREAD_CFG_T *cfg)
+{
+    s_timer_thread = func;
+    *handle = (THREAD_HANDLE)1;
+    return OPRT_OK;
+}
+
+THREAD_STATE_E tal_thread_get_state(const THREAD_HANDLE handle)
+{
+    return (s_now_ms < s_end_ms) ? THREAD_STATE_RUNNING : THREAD_STATE_STOP;
+}
+
+void *tal_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void *tal_calloc(size_t nitems, size_t size)
+{
+    return calloc(nitems, size);
+}
+
+void tal_free(void *ptr)
+{
+    free(ptr);
+}
+
+OPERATE_RET tal_log_print(const TAL_LOG_LEVEL_E level, const char *file, const int line, const char *fmt, ...)
+{
+    return OPRT_OK;
+}
+
+OPERATE_RET tal_log_print_secure(BOOL_T is_const_fmt, const TAL_LOG_LEVEL_E level, const char *file, const int line,
+                                 const char *fmt, ...)
+{
+    return OPRT_OK;
+}
+
+/**
+ * @brief the interval mix of a device: mostly short periodic work, some
+ * timeouts in minutes, a few in hours
+ */
+static uint32_t __sw_timer_bench_interval(void)
+{
+    uint32_t k = bench_rand() % 100;
+
+    if (k < 60) {
+        return 10 + bench_rand() % 1000;
+    }
+    if (k < 90) {
+        return 1000 + bench_rand() % 60000;
+    }
+    return 60000 + bench_rand() % (4 * 3600 * 1000);
+}
+
+static void __sw_timer_bench_cb(TIMER_ID timer_id, void *arg)
+{
+    SW_TIMER_BENCH_T *timer = arg;
+
+    BENCH_CHECK(s_now_ms >= timer->expire);
+    if (s_now_ms - timer->expire > s_late_max) {
+        s_late_max = s_now_ms - timer->expire;
+    }
+    timer->expire = s_now_ms + timer->interval;
+    timer->fired++;
+    s_expiries++;
+}
+
+static void __sw_timer_bench_start(SW_TIMER_BENCH_T *timer, uint32_t interval, TIMER_TYPE type)
+{
+    timer->interval = interval;
+    timer->expire = s_now_ms + interval;
+    tal_sw_timer_start(timer->id, interval, type);
+}
+
+static void __sw_timer_bench_run(uint32_t num)
+{
+    uint32_t rounds = 200000 / num;
+    uint32_t i = 0, r = 0;
+    double start = 0, sec = 0;
+
+    s_timers = calloc(num, sizeof(SW_TIMER_BENCH_T));
+    BENCH_CHECK(NULL != s_timers);
+    for (i = 0; i < num; i++) {
+        BENCH_CHECK(OPRT_OK == tal_sw_timer_create(__sw_timer_bench_cb, &s_timers[i], &s_timers[i].id));
+    }
+
+    // start and restart of running timers, the calls of a busy application
+    start = bench_now();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < num; i++) {
+            __sw_timer_bench_start(&s_timers[i], __sw_timer_bench_interval(), TAL_TIMER_ONCE);
+        }
+    }
+    sec = bench_now() - start;
+    BENCH_CHECK((int)num == tal_sw_timer_get_num());
+    printf("%6u timers: start %6.2f M/s", num, (double)rounds * num / sec / 1e6);
+
+    start = bench_now();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < num; i++) {
+            tal_sw_timer_stop(s_timers[i].id);
+        }
+        for (i = 0; i < num; i++) {
+            __sw_timer_bench_start(&s_timers[i], __sw_timer_bench_interval(), TAL_TIMER_ONCE);
+        }
+    }
+    sec = bench_now() - start;
+    printf(", stop+start %6.2f M/s", (double)rounds * num / sec / 1e6);
+
+    // periodic timers left to run for a while
+    for (i = 0; i < num; i++) {
+        __sw_timer_bench_start(&s_timers[i], __sw_timer_bench_interval(), TAL_TIMER_CYCLE);
+    }
+    s_expiries = 0;
+    s_wakeups = 0;
+    s_late_max = 0;
+    s_end_ms = s_now_ms + SW_TIMER_BENCH_RUN_MS;
+    start = bench_now();
+    s_timer_thread(NULL);
+    sec = bench_now() - start;
+    printf(", expiry %6.2f M/s (%u in %u s, %u wakeups, late max %llu ms)\n", s_expiries / sec / 1e6, s_expiries,
+           SW_TIMER_BENCH_RUN_MS / 1000, s_wakeups, (unsigned long long)s_late_max);
+
+    // every timer due before the end fired
+    for (i = 0; i < num; i++) {
+        BENCH_CHECK(s_timers[i].expire + s_late_max >= s_end_ms);
+        tal_sw_timer_delete(s_timers[i].id);
+    }
+    free(s_timers);
+}
+
+int main(void)
+{
+    BENCH_CHECK(OPRT_OK == tal_sw_timer_init());
+
+    __sw_timer_bench_run(100);
+    __sw_timer_bench_run(1000);
+    __sw_timer_bench_run(5000);
+    __sw_timer_bench_run(10000);
+
+    return 0;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file tuya_atomic.h
+ * @brief tuya ordered load and store of words shared between threads
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+#ifndef __TUYA_ATOMIC_H__
+#define __TUYA_ATOMIC_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Only loads and stores of aligned words up to the pointer size, every
+ * supported core does them in one access, the builtins add the barriers.
+ * There is no read-modify-write here: some supported cores have no exclusive
+ * access instructions, counters and flags changed by several threads take a
+ * critical section instead.
+ */
+
+/**
+ * @brief load a word, later accesses are not moved before it
+ *
+ */
+#define TUYA_ATOMIC_LOAD_ACQ(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+
+/**
+ * @brief store a word, earlier accesses are not moved after it
+ *
+ */
+#define TUYA_ATOMIC_STORE_REL(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TUYA_ATOMIC_H__ */
@@ -47,11 +47,26 @@ typedef ANY_T *ANY_T_ITER;
 /**
  * @brief create a new empty hashmap
  *
- * @param[in] table_size the hash table size
+ * @param[in] table_size the initial hash table size, rounded up to a power of two
  * @return a new empty hashmap
+ *
+ * @note the table doubles once the map holds more elements than buckets
  */
 MAP_T tuya_hashmap_new(uint32_t table_size);
 
+/**
+ * @brief create a new empty hashmap storing its elements in the table itself
+ *
+ * @param[in] table_size the initial hash table size, rounded up to a power of two
+ * @return a new empty hashmap
+ *
+ * @note open addressing with linear probing: no allocation per element and no
+ * list walk, suits small maps. The table doubles once it is 3/4 full. The same
+ * API applies, but putting or removing an element moves the others, an
+ * iterator of tuya_hashmap_data_traversal is only valid until then.
+ */
+MAP_T tuya_hashmap_new_compact(uint32_t table_size);
+
 /**
  * @brief Add an element to the hashmap
  *
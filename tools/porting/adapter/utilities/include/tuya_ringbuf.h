@@ -4,6 +4,11 @@
  * @version 1.0.0
  * @date 2021-06-03
  *
+ * One producer and one consumer may use a ringbuff at the same time without a
+ * lock: write, reserve and commit are the producer side, read, peek, discard and
+ * peek_contiguous the consumer side. Several producers or consumers, and reset
+ * while either side is running, still need a lock of the caller.
+ *
  * @copyright Copyright 2018-2021 Tuya Inc. All Rights Reserved.
  *
  */
@@ -45,7 +50,7 @@ OPERATE_RET tuya_ring_buff_free(TUYA_RINGBUFF_T ringbuff);
 
 /**
  * @brief ringbuff reset
- * this API not free buff
+ * this API not free buff, and must not run with a writer or reader at the same time
  *
  * @param[in]   ringbuff: ringbuff handle
  * @return  none
@@ -114,6 +119,37 @@ uint32_t tuya_ring_buff_peek(TUYA_RINGBUFF_T ringbuff, void *data, uint32_t len)
  */
 uint32_t tuya_ring_buff_write(TUYA_RINGBUFF_T ringbuff, const void *data, uint32_t len);
 
+/**
+ * @brief ringbuff contiguous free space get, for writing in place
+ * the space is not taken until tuya_ring_buff_commit
+ *
+ * @param[in]   ringbuff:     ringbuff handle
+ * @param[in]   len:          wanted len, 0 for all the contiguous space
+ * @param[out]  reserved_len: length of the space returned, may be less than len at the buffer end
+ * @return  point to the free space, NULL when the ringbuff is full
+ */
+void *tuya_ring_buff_reserve(TUYA_RINGBUFF_T ringbuff, uint32_t len, uint32_t *reserved_len);
+
+/**
+ * @brief ringbuff data commit
+ * make the data written to the reserved space readable
+ *
+ * @param[in]   ringbuff: ringbuff handle
+ * @param[in]   len:      written len, no more than the reserved len
+ * @return  length of the data committed
+ */
+uint32_t tuya_ring_buff_commit(TUYA_RINGBUFF_T ringbuff, uint32_t len);
+
+/**
+ * @brief ringbuff contiguous data get, for reading in place
+ * the data stays in the ringbuff, release it with tuya_ring_buff_discard
+ *
+ * @param[in]   ringbuff: ringbuff handle
+ * @param[out]  len:      length of the data returned, the rest of the data follows at the buffer start
+ * @return  point to the data, NULL when the ringbuff is empty
+ */
+void *tuya_ring_buff_peek_contiguous(TUYA_RINGBUFF_T ringbuff, uint32_t *len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,140 +6,134 @@
 #include "tkl_memory.h"
 #include <string.h>
 
+#define HASHMAP_TYPE_CHAIN 0 // elements in per bucket lists
+#define HASHMAP_TYPE_OPEN  1 // elements in the table itself, linear probing
+
+#define HASHMAP_OPEN_SIZE_MIN 4
+
+#define HASHMAP_PRIME32_1 0x9E3779B1U
+#define HASHMAP_PRIME32_2 0x85EBCA77U
+#define HASHMAP_PRIME32_3 0xC2B2AE3DU
+#define HASHMAP_PRIME32_4 0x27D4EB2FU
+#define HASHMAP_PRIME32_5 0x165667B1U
+
+#define HASHMAP_ROTL(x, r) (((x) << (r)) | ((x) >> (32 - (r))))
+
 /* We need to keep keys and values */
 typedef struct _hashmap_element {
     char *key;
     ANY_T data;
+    uint32_t hash;
     HLIST_NODE node;
 } HASHMAP_ELEMENT_T;
 
-/* A hashmap has some maximum size and current size,
+typedef struct {
+    char *key; // NULL when the slot is empty
+    ANY_T data;
+    uint32_t hash;
+} HASHMAP_SLOT_T;
+
+/* A hashmap has a power of two table that doubles as it fills up,
  * as well as the data to hold. */
 typedef struct _hashmap_map {
+    int type;
     int size;
-    int table_size;
-    HLIST_HEAD *list;
+    uint32_t table_size;
+    HLIST_HEAD *list;     // HASHMAP_TYPE_CHAIN
+    HASHMAP_SLOT_T *slot; // HASHMAP_TYPE_OPEN
 } HASHMAP_T;
 
-/* The implementation here was originally done by Gary S. Brown.  I have
-   borrowed the tables directly, and made some minor changes to the
-   crc32-function (including changing the interface). //ylo */
-
-/* ============================================================= */
-/*  COPYRIGHT (C) 1986 Gary S. Brown.  You may use this program, or       */
-/*  code or tables extracted from it, as desired without restriction.     */
-/*                                                                        */
-/*  First, the polynomial itself and its table of feedback terms.  The    */
-/*  polynomial is                                                         */
-/*  X^32+X^26+X^23+X^22+X^16+X^12+X^11+X^10+X^8+X^7+X^5+X^4+X^2+X^1+X^0   */
-/*                                                                        */
-/*  Note that we take it "backwards" and put the highest-order term in    */
-/*  the lowest-order bit.  The X^32 term is "implied"; the LSB is the     */
-/*  X^31 term, etc.  The X^0 term (usually shown as "+1") results in      */
-/*  the MSB being 1.                                                      */
-/*                                                                        */
-/*  Note that the usual hardware shift register implementation, which     */
-/*  is what we're using (we're merely optimizing it by doing eight-bit    */
-/*  chunks at a time) shifts bits into the lowest-order term.  In our     */
-/*  implementation, that means shifting towards the right.  Why do we     */
-/*  do it this way?  Because the calculated CRC must be transmitted in    */
-/*  order from highest-order term to lowest-order term.  UARTs transmit   */
-/*  characters in order from LSB to MSB.  By storing the CRC this way,    */
-/*  we hand it to the UART in the order low-byte to high-byte; the UART   */
-/*  sends each low-bit to hight-bit; and the result is transmission bit   */
-/*  by bit from highest- to lowest-order term without requiring any bit   */
-/*  shuffling on our part.  Reception works similarly.                    */
-/*                                                                        */
-/*  The feedback terms table consists of 256, 32-bit entries.  Notes:     */
-/*                                                                        */
-/*      The table can be generated at runtime if desired; code to do so   */
-/*      is shown later.  It might not be obvious, but the feedback        */
-/*      terms simply represent the results of eight shift/xor opera-      */
-/*      tions for all combinations of data and CRC register values.       */
-/*                                                                        */
-/*      The values must be right-shifted by eight bits by the "updcrc"    */
-/*      logic; the shift must be unsigned (bring in zeroes).  On some     */
-/*      hardware you could probably optimize the shift in assembler by    */
-/*      using byte-swap instructions.                                     */
-/*      polynomial $edb88320                                              */
-/*                                                                        */
-/*  --------------------------------------------------------------------  */
-
-static uint32_t crc32_tab[] = {
-    0x00000000L, 0x77073096L, 0xee0e612cL, 0x990951baL, 0x076dc419L, 0x706af48fL, 0xe963a535L, 0x9e6495a3L, 0x0edb8832L,
-    0x79dcb8a4L, 0xe0d5e91eL, 0x97d2d988L, 0x09b64c2bL, 0x7eb17cbdL, 0xe7b82d07L, 0x90bf1d91L, 0x1db71064L, 0x6ab020f2L,
-    0xf3b97148L, 0x84be41deL, 0x1adad47dL, 0x6ddde4ebL, 0xf4d4b551L, 0x83d385c7L, 0x136c9856L, 0x646ba8c0L, 0xfd62f97aL,
-    0x8a65c9ecL, 0x14015c4fL, 0x63066cd9L, 0xfa0f3d63L, 0x8d080df5L, 0x3b6e20c8L, 0x4c69105eL, 0xd56041e4L, 0xa2677172L,
-    0x3c03e4d1L, 0x4b04d447L, 0xd20d85fdL, 0xa50ab56bL, 0x35b5a8faL, 0x42b2986cL, 0xdbbbc9d6L, 0xacbcf940L, 0x32d86ce3L,
-    0x45df5c75L, 0xdcd60dcfL, 0xabd13d59L, 0x26d930acL, 0x51de003aL, 0xc8d75180L, 0xbfd06116L, 0x21b4f4b5L, 0x56b3c423L,
-    0xcfba9599L, 0xb8bda50fL, 0x2802b89eL, 0x5f058808L, 0xc60cd9b2L, 0xb10be924L, 0x2f6f7c87L, 0x58684c11L, 0xc1611dabL,
-    0xb6662d3dL, 0x76dc4190L, 0x01db7106L, 0x98d220bcL, 0xefd5102aL, 0x71b18589L, 0x06b6b51fL, 0x9fbfe4a5L, 0xe8b8d433L,
-    0x7807c9a2L, 0x0f00f934L, 0x9609a88eL, 0xe10e9818L, 0x7f6a0dbbL, 0x086d3d2dL, 0x91646c97L, 0xe6635c01L, 0x6b6b51f4L,
-    0x1c6c6162L, 0x856530d8L, 0xf262004eL, 0x6c0695edL, 0x1b01a57bL, 0x8208f4c1L, 0xf50fc457L, 0x65b0d9c6L, 0x12b7e950L,
-    0x8bbeb8eaL, 0xfcb9887cL, 0x62dd1ddfL, 0x15da2d49L, 0x8cd37cf3L, 0xfbd44c65L, 0x4db26158L, 0x3ab551ceL, 0xa3bc0074L,
-    0xd4bb30e2L, 0x4adfa541L, 0x3dd895d7L, 0xa4d1c46dL, 0xd3d6f4fbL, 0x4369e96aL, 0x346ed9fcL, 0xad678846L, 0xda60b8d0L,
-    0x44042d73L, 0x33031de5L, 0xaa0a4c5fL, 0xdd0d7cc9L, 0x5005713cL, 0x270241aaL, 0xbe0b1010L, 0xc90c2086L, 0x5768b525L,
-    0x206f85b3L, 0xb966d409L, 0xce61e49fL, 0x5edef90eL, 0x29d9c998L, 0xb0d09822L, 0xc7d7a8b4L, 0x59b33d17L, 0x2eb40d81L,
-    0xb7bd5c3bL, 0xc0ba6cadL, 0xedb88320L, 0x9abfb3b6L, 0x03b6e20cL, 0x74b1d29aL, 0xead54739L, 0x9dd277afL, 0x04db2615L,
-    0x73dc1683L, 0xe3630b12L, 0x94643b84L, 0x0d6d6a3eL, 0x7a6a5aa8L, 0xe40ecf0bL, 0x9309ff9dL, 0x0a00ae27L, 0x7d079eb1L,
-    0xf00f9344L, 0x8708a3d2L, 0x1e01f268L, 0x6906c2feL, 0xf762575dL, 0x806567cbL, 0x196c3671L, 0x6e6b06e7L, 0xfed41b76L,
-    0x89d32be0L, 0x10da7a5aL, 0x67dd4accL, 0xf9b9df6fL, 0x8ebeeff9L, 0x17b7be43L, 0x60b08ed5L, 0xd6d6a3e8L, 0xa1d1937eL,
-    0x38d8c2c4L, 0x4fdff252L, 0xd1bb67f1L, 0xa6bc5767L, 0x3fb506ddL, 0x48b2364bL, 0xd80d2bdaL, 0xaf0a1b4cL, 0x36034af6L,
-    0x41047a60L, 0xdf60efc3L, 0xa867df55L, 0x316e8eefL, 0x4669be79L, 0xcb61b38cL, 0xbc66831aL, 0x256fd2a0L, 0x5268e236L,
-    0xcc0c7795L, 0xbb0b4703L, 0x220216b9L, 0x5505262fL, 0xc5ba3bbeL, 0xb2bd0b28L, 0x2bb45a92L, 0x5cb36a04L, 0xc2d7ffa7L,
-    0xb5d0cf31L, 0x2cd99e8bL, 0x5bdeae1dL, 0x9b64c2b0L, 0xec63f226L, 0x756aa39cL, 0x026d930aL, 0x9c0906a9L, 0xeb0e363fL,
-    0x72076785L, 0x05005713L, 0x95bf4a82L, 0xe2b87a14L, 0x7bb12baeL, 0x0cb61b38L, 0x92d28e9bL, 0xe5d5be0dL, 0x7cdcefb7L,
-    0x0bdbdf21L, 0x86d3d2d4L, 0xf1d4e242L, 0x68ddb3f8L, 0x1fda836eL, 0x81be16cdL, 0xf6b9265bL, 0x6fb077e1L, 0x18b74777L,
-    0x88085ae6L, 0xff0f6a70L, 0x66063bcaL, 0x11010b5cL, 0x8f659effL, 0xf862ae69L, 0x616bffd3L, 0x166ccf45L, 0xa00ae278L,
-    0xd70dd2eeL, 0x4e048354L, 0x3903b3c2L, 0xa7672661L, 0xd06016f7L, 0x4969474dL, 0x3e6e77dbL, 0xaed16a4aL, 0xd9d65adcL,
-    0x40df0b66L, 0x37d83bf0L, 0xa9bcae53L, 0xdebb9ec5L, 0x47b2cf7fL, 0x30b5ffe9L, 0xbdbdf21cL, 0xcabac28aL, 0x53b39330L,
-    0x24b4a3a6L, 0xbad03605L, 0xcdd70693L, 0x54de5729L, 0x23d967bfL, 0xb3667a2eL, 0xc4614ab8L, 0x5d681b02L, 0x2a6f2b94L,
-    0xb40bbe37L, 0xc30c8ea1L, 0x5a05df1bL, 0x2d02ef8dL};
-
-/* Return a 32-bit CRC of the contents of the buffer. */
-static uint32_t __crc32_hashmap(const uint8_t *s, uint32_t len)
+static uint32_t __hashmap_read32(const uint8_t *p)
 {
-    uint32_t i;
-    uint32_t crc32val;
-
-    crc32val = 0;
-    for (i = 0; i < len; i++) {
-        crc32val = crc32_tab[(crc32val ^ s[i]) & 0xff] ^ (crc32val >> 8);
-    }
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
 
-    return crc32val;
+static uint32_t __hashmap_round(uint32_t acc, uint32_t input)
+{
+    acc += input * HASHMAP_PRIME32_2;
+    acc = HASHMAP_ROTL(acc, 13);
+    return acc * HASHMAP_PRIME32_1;
 }
 
 /*
- * Hashing function for a string
+ * Hashing function for a string, xxHash32 with seed 0, reading the key four
+ * bytes at a time
  */
-uint32_t __hashmap_hash_int(HASHMAP_T *m, char *keystring)
+static uint32_t __hashmap_hash(const char *keystring)
 {
-    uint32_t key = __crc32_hashmap((uint8_t *)(keystring), strlen(keystring));
-
-    /* Robert Jenkins' 32 bit Mix Function */
-    key += (key << 12);
-    key ^= (key >> 22);
-    key += (key << 4);
-    key ^= (key >> 9);
-    key += (key << 10);
-    key ^= (key >> 2);
-    key += (key << 7);
-    key ^= (key >> 12);
-
-    /* Knuth's Multiplicative Method */
-    key = (key >> 3) * 2654435761;
-
-    return key % m->table_size;
+    const uint8_t *p = (const uint8_t *)keystring;
+    uint32_t len = strlen(keystring);
+    const uint8_t *end = p + len;
+    uint32_t h;
+
+    if (len >= 16) {
+        const uint8_t *limit = end - 16;
+        uint32_t v1 = HASHMAP_PRIME32_1 + HASHMAP_PRIME32_2;
+        uint32_t v2 = HASHMAP_PRIME32_2;
+        uint32_t v3 = 0;
+        uint32_t v4 = 0 - HASHMAP_PRIME32_1;
+
+        do {
+            v1 = __hashmap_round(v1, __hashmap_read32(p));
+            v2 = __hashmap_round(v2, __hashmap_read32(p + 4));
+            v3 = __hashmap_round(v3, __hashmap_read32(p + 8));
+            v4 = __hashmap_round(v4, __hashmap_read32(p + 12));
+            p += 16;
+        } while (p <= limit);
+
+        h = HASHMAP_ROTL(v1, 1) + HASHMAP_ROTL(v2, 7) + HASHMAP_ROTL(v3, 12) + HASHMAP_ROTL(v4, 18);
+    } else {
+        h = HASHMAP_PRIME32_5;
+    }
+    h += len;
+
+    while (p + 4 <= end) {
+        h += __hashmap_read32(p) * HASHMAP_PRIME32_3;
+        h = HASHMAP_ROTL(h, 17) * HASHMAP_PRIME32_4;
+        p += 4;
+    }
+    while (p < end) {
+        h += (*p++) * HASHMAP_PRIME32_5;
+        h = HASHMAP_ROTL(h, 11) * HASHMAP_PRIME32_1;
+    }
+
+    h ^= h >> 15;
+    h *= HASHMAP_PRIME32_2;
+    h ^= h >> 13;
+    h *= HASHMAP_PRIME32_3;
+    h ^= h >> 16;
+
+    return h;
 }
 
+static uint32_t __hashmap_table_size(uint32_t table_size, uint32_t min)
+{
+    uint32_t size = min;
+
+    while (size < table_size && size < 0x80000000U) {
+        size <<= 1;
+    }
+
+    return size;
+}
+
+// the stored hash is compared first, most other keys never reach strcmp
+static int __hashmap_key_match(uint32_t hash, const char *key, uint32_t elem_hash, const char *elem_key)
+{
+    return (hash == elem_hash) && (strcmp(key, elem_key) == 0);
+}
+
+/* ========================= chained backend ========================= */
+
 static HASHMAP_ELEMENT_T *__hash_find_next_element(HASHMAP_ELEMENT_T *curr)
 {
     HLIST_NODE *pos = NULL;
     HASHMAP_ELEMENT_T *tmp_element = NULL;
     HLIST_FOR_EACH_ENTRY_CURR(tmp_element, HASHMAP_ELEMENT_T, pos, &(curr->node), node)
     {
-        if (strlen(curr->key) == strlen(tmp_element->key) && (strcmp(curr->key, tmp_element->key) == 0)) {
+        if (__hashmap_key_match(curr->hash, curr->key, tmp_element->hash, tmp_element->key)) {
             return tmp_element;
         }
     }
@@ -148,8 +142,8 @@ static HASHMAP_ELEMENT_T *__hash_find_next_element(HASHMAP_ELEMENT_T *curr)
 
 static HASHMAP_ELEMENT_T *__hash_find(HASHMAP_T *m, char *key)
 {
-    int curr = __hashmap_hash_int(m, key);
-    HLIST_HEAD *list = &(m->list[curr]);
+    uint32_t hash = __hashmap_hash(key);
+    HLIST_HEAD *list = &(m->list[hash & (m->table_size - 1)]);
     if (tuya_hlist_empty(list)) {
         return NULL;
     }
@@ -158,7 +152,7 @@ static HASHMAP_ELEMENT_T *__hash_find(HASHMAP_T *m, char *key)
     HASHMAP_ELEMENT_T *tmp_element = NULL;
     HLIST_FOR_EACH_ENTRY(tmp_element, HASHMAP_ELEMENT_T, pos, list, node)
     {
-        if (strlen(key) == strlen(tmp_element->key) && (strcmp(key, tmp_element->key) == 0)) {
+        if (__hashmap_key_match(hash, key, tmp_element->hash, tmp_element->key)) {
             return tmp_element;
         }
     }
@@ -166,6 +160,167 @@ static HASHMAP_ELEMENT_T *__hash_find(HASHMAP_T *m, char *key)
     return NULL;
 }
 
+/*
+ * Double the bucket table. Bucket i splits into buckets i and i + table_size,
+ * the elements keep their order so the newest of a key is still found first.
+ * The table stays as it is when out of memory.
+ */
+static void __hash_grow(HASHMAP_T *m)
+{
+    uint32_t new_size = m->table_size << 1;
+    HLIST_HEAD *new_list = NULL;
+    HLIST_NODE *tail[2];
+    HLIST_NODE *pos = NULL;
+    HLIST_NODE *n = NULL;
+    uint32_t i, j;
+
+    if (0 == new_size) {
+        return;
+    }
+
+    new_list = (HLIST_HEAD *)tkl_system_malloc(new_size * sizeof(HLIST_HEAD));
+    if (NULL == new_list) {
+        return;
+    }
+    memset(new_list, 0, new_size * sizeof(HLIST_HEAD));
+
+    for (i = 0; i < m->table_size; i++) {
+        tail[0] = NULL;
+        tail[1] = NULL;
+        HLIST_FOR_EACH_SAFE(pos, n, &(m->list[i]))
+        {
+            j = (HLIST_ENTRY(pos, HASHMAP_ELEMENT_T, node)->hash & m->table_size) ? 1 : 0;
+            if (tail[j]) {
+                tuya_hlist_add_after(tail[j], pos);
+            } else {
+                tuya_hlist_add_head(pos, &(new_list[i + (j ? m->table_size : 0)]));
+            }
+            tail[j] = pos;
+        }
+    }
+
+    tkl_system_free(m->list);
+    m->list = new_list;
+    m->table_size = new_size;
+}
+
+/* ====================== open addressing backend ====================== */
+
+static int __open_find_from(HASHMAP_T *m, uint32_t idx, uint32_t hash, const char *key, ANY_T data)
+{
+    uint32_t mask = m->table_size - 1;
+    HASHMAP_SLOT_T *slot = NULL;
+
+    // entries of a key sit in its probe run newest first, the run ends at an empty slot
+    for (slot = &m->slot[idx & mask]; slot->key; idx++, slot = &m->slot[idx & mask]) {
+        if (__hashmap_key_match(hash, key, slot->hash, slot->key) && ((NULL == data) || (slot->data == data))) {
+            return (int)(idx & mask);
+        }
+    }
+
+    return -1;
+}
+
+static void __open_append(HASHMAP_SLOT_T *table, uint32_t mask, const HASHMAP_SLOT_T *entry)
+{
+    uint32_t idx = entry->hash & mask;
+
+    while (table[idx].key) {
+        idx = (idx + 1) & mask;
+    }
+    table[idx] = *entry;
+}
+
+/*
+ * Double the slot table. The old table is read cluster by cluster from an
+ * empty slot, so the entries of a key keep their newest first order.
+ */
+static int __open_grow(HASHMAP_T *m)
+{
+    uint32_t new_size = m->table_size << 1;
+    uint32_t mask = m->table_size - 1;
+    HASHMAP_SLOT_T *new_slot = NULL;
+    uint32_t start = 0;
+    uint32_t i, idx;
+
+    if (0 == new_size) {
+        return MAP_OMEM;
+    }
+
+    new_slot = (HASHMAP_SLOT_T *)tkl_system_malloc(new_size * sizeof(HASHMAP_SLOT_T));
+    if (NULL == new_slot) {
+        return MAP_OMEM;
+    }
+    memset(new_slot, 0, new_size * sizeof(HASHMAP_SLOT_T));
+
+    while (m->slot[start].key) {
+        start++;
+    }
+    for (i = 1; i <= m->table_size; i++) {
+        idx = (start + i) & mask;
+        if (m->slot[idx].key) {
+            __open_append(new_slot, new_size - 1, &m->slot[idx]);
+        }
+    }
+
+    tkl_system_free(m->slot);
+    m->slot = new_slot;
+    m->table_size = new_size;
+
+    return MAP_OK;
+}
+
+static int __open_put(HASHMAP_T *m, const char *key, const ANY_T data)
+{
+    HASHMAP_SLOT_T carry, tmp;
+    uint32_t mask = 0;
+    uint32_t idx = 0;
+
+    // keep at least a quarter of the slots empty, probe runs stay short
+    if ((uint32_t)(m->size + 1) * 4 > m->table_size * 3) {
+        if (MAP_OK != __open_grow(m)) {
+            return MAP_OMEM;
+        }
+    }
+
+    carry.key = (char *)key;
+    carry.data = data;
+    carry.hash = __hashmap_hash(key);
+    mask = m->table_size - 1;
+
+    // the new entry takes the place of the first one of its key, the older
+    // ones move one place of the key further, the oldest to the empty slot
+    for (idx = carry.hash & mask; m->slot[idx].key; idx = (idx + 1) & mask) {
+        if (__hashmap_key_match(carry.hash, carry.key, m->slot[idx].hash, m->slot[idx].key)) {
+            tmp = m->slot[idx];
+            m->slot[idx] = carry;
+            carry = tmp;
+        }
+    }
+    m->slot[idx] = carry;
+    m->size++;
+
+    return MAP_OK;
+}
+
+static void __open_remove_at(HASHMAP_T *m, uint32_t hole)
+{
+    uint32_t mask = m->table_size - 1;
+    uint32_t idx = hole;
+    uint32_t home = 0;
+
+    // shift back the following entries of the run that may live in the hole
+    for (idx = (idx + 1) & mask; m->slot[idx].key; idx = (idx + 1) & mask) {
+        home = m->slot[idx].hash & mask;
+        if (((idx - home) & mask) >= ((idx - hole) & mask)) {
+            m->slot[hole] = m->slot[idx];
+            hole = idx;
+        }
+    }
+    m->slot[hole].key = NULL;
+    m->size--;
+}
+
 /**
  * @brief create a new empty hashmap
  *
@@ -183,7 +338,9 @@ MAP_T tuya_hashmap_new(uint32_t table_size)
         goto err;
     }
     memset(m, 0, sizeof(HASHMAP_T));
+    m->type = HASHMAP_TYPE_CHAIN;
 
+    table_size = __hashmap_table_size(table_size, 1);
     m->list = (HLIST_HEAD *)tkl_system_malloc(table_size * sizeof(HLIST_HEAD));
     if (!m->list) {
         goto err;
@@ -201,6 +358,43 @@ err:
     return NULL;
 }
 
+/**
+ * @brief create a new empty hashmap storing its elements in the table itself
+ *
+ * @param[in] table_size the initial hash table size
+ * @return a new empty hashmap
+ */
+MAP_T tuya_hashmap_new_compact(uint32_t table_size)
+{
+    if (0 == table_size) {
+        return NULL;
+    }
+
+    HASHMAP_T *m = (HASHMAP_T *)tkl_system_malloc(sizeof(HASHMAP_T));
+    if (!m) {
+        goto err;
+    }
+    memset(m, 0, sizeof(HASHMAP_T));
+    m->type = HASHMAP_TYPE_OPEN;
+
+    table_size = __hashmap_table_size(table_size, HASHMAP_OPEN_SIZE_MIN);
+    m->slot = (HASHMAP_SLOT_T *)tkl_system_malloc(table_size * sizeof(HASHMAP_SLOT_T));
+    if (!m->slot) {
+        goto err;
+    }
+
+    memset(m->slot, 0, sizeof(HASHMAP_SLOT_T) * table_size);
+    m->table_size = table_size;
+
+    return m;
+
+err:
+    if (m) {
+        tuya_hashmap_free(m);
+    }
+    return NULL;
+}
+
 /**
  * @brief Add an element to the hashmap
  *
@@ -213,6 +407,11 @@ err:
  */
 int tuya_hashmap_put(MAP_T in, const char *key, const ANY_T data)
 {
+    HASHMAP_T *m = (HASHMAP_T *)in;
+    if (HASHMAP_TYPE_OPEN == m->type) {
+        return __open_put(m, key, data);
+    }
+
     HASHMAP_ELEMENT_T *element = (HASHMAP_ELEMENT_T *)tkl_system_malloc(sizeof(HASHMAP_ELEMENT_T));
     if (NULL == element) {
         return MAP_OMEM;
@@ -220,11 +419,14 @@ int tuya_hashmap_put(MAP_T in, const char *key, const ANY_T data)
     memset(element, 0, sizeof(HASHMAP_ELEMENT_T));
     element->key = (char *)key;
     element->data = data;
+    element->hash = __hashmap_hash(key);
 
-    int curr = 0;
-    HASHMAP_T *m = (HASHMAP_T *)in;
-    curr = __hashmap_hash_int(m, element->key);
-    tuya_hlist_add_head(&(element->node), &(m->list[curr]));
+    // grows past one element per bucket, a failed growth only costs longer lists
+    if ((uint32_t)m->size >= m->table_size) {
+        __hash_grow(m);
+    }
+
+    tuya_hlist_add_head(&(element->node), &(m->list[element->hash & (m->table_size - 1)]));
     m->size++;
 
     return MAP_OK;
@@ -241,6 +443,18 @@ int tuya_hashmap_put(MAP_T in, const char *key, const ANY_T data)
 int tuya_hashmap_get(MAP_T in, const char *key, ANY_T *arg)
 {
     HASHMAP_T *m = (HASHMAP_T *)in;
+    if (HASHMAP_TYPE_OPEN == m->type) {
+        uint32_t hash = __hashmap_hash(key);
+        int idx = __open_find_from(m, hash, hash, key, NULL);
+        if (idx < 0) {
+            *arg = NULL;
+            return MAP_MISSING;
+        }
+
+        *arg = m->slot[idx].data;
+        return MAP_OK;
+    }
+
     HASHMAP_ELEMENT_T *element = __hash_find(m, (char *)key);
     if (NULL == element) {
         *arg = NULL;
@@ -266,6 +480,25 @@ int tuya_hashmap_data_traversal(MAP_T in, const char *key, ANY_T_ITER *arg_itera
     HASHMAP_T *m = (HASHMAP_T *)in;
     HASHMAP_ELEMENT_T *element = NULL;
 
+    if (HASHMAP_TYPE_OPEN == m->type) {
+        int idx = -1;
+        if (NULL == *arg_iterator) {
+            uint32_t hash = __hashmap_hash(key);
+            idx = __open_find_from(m, hash, hash, key, NULL);
+        } else {
+            HASHMAP_SLOT_T *curr = CNTR_OF((*arg_iterator), HASHMAP_SLOT_T, data);
+            idx = __open_find_from(m, (uint32_t)(curr - m->slot) + 1, curr->hash, curr->key, NULL);
+        }
+
+        if (idx < 0) {
+            *arg_iterator = NULL;
+            return MAP_MISSING;
+        }
+
+        *arg_iterator = &(m->slot[idx].data);
+        return MAP_OK;
+    }
+
     if (NULL == *arg_iterator) {
         element = __hash_find(m, (char *)key);
     } else {
@@ -296,8 +529,19 @@ int tuya_hashmap_data_traversal(MAP_T in, const char *key, ANY_T_ITER *arg_itera
 int tuya_hashmap_remove(MAP_T in, char *key, ANY_T data)
 {
     HASHMAP_T *m = (HASHMAP_T *)in;
-    int curr = __hashmap_hash_int(m, key);
-    HLIST_HEAD *list = &(m->list[curr]);
+    uint32_t hash = __hashmap_hash(key);
+
+    if (HASHMAP_TYPE_OPEN == m->type) {
+        int idx = __open_find_from(m, hash, hash, key, data);
+        if (idx < 0) {
+            return MAP_MISSING;
+        }
+
+        __open_remove_at(m, (uint32_t)idx);
+        return MAP_OK;
+    }
+
+    HLIST_HEAD *list = &(m->list[hash & (m->table_size - 1)]);
 
     if (tuya_hlist_empty(list)) {
         return MAP_MISSING;
@@ -307,14 +551,15 @@ int tuya_hashmap_remove(MAP_T in, char *key, ANY_T data)
     HASHMAP_ELEMENT_T *tmp_element = NULL;
     HLIST_FOR_EACH_ENTRY(tmp_element, HASHMAP_ELEMENT_T, pos, list, node)
     {
-        if (strlen(key) == strlen(tmp_element->key) && (strcmp(key, tmp_element->key) == 0)) {
+        if (__hashmap_key_match(hash, key, tmp_element->hash, tmp_element->key)) {
             if ((NULL == data) || ((unsigned long)(tmp_element->data) == (unsigned long)data)) {
                 break;
             }
         }
     }
 
-    if (NULL == tmp_element) {
+    // the loop leaves tmp_element on the last node when nothing matched
+    if (NULL == pos) {
         return MAP_MISSING;
     }
 
@@ -338,6 +583,9 @@ void tuya_hashmap_free(MAP_T in)
     if (m->list) {
         tkl_system_free(m->list);
     }
+    if (m->slot) {
+        tkl_system_free(m->slot);
+    }
     tkl_system_free(m);
 
     return;
@@ -10,35 +10,50 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stddef.h>
 #include <string.h>
 #include "tuya_iot_config.h"
 #include "tuya_mem_heap.h"
 
 #define MEM_DEBUG_ASSERT_ON (0)
 #define MEM_BLOCK_STATIC    (0)
-#define MEM_ANTI_FRAGMENT   (1)
 #define MEM_DEBUG_FREE_FILL (0)
 
 #define MEM_DEBUG_FILL_VAL (0xF7)
-#define MEM_BLOCK_MIN_SIZE (24)
 #if defined(OPERATING_SYSTEM) && (SYSTEM_LINUX == OPERATING_SYSTEM)
-#define MEM_ALIGN_NUM (8)
+#define MEM_ALIGN_NUM  (8)
+#define MEM_ALIGN_LOG2 (3)
 #else
-#define MEM_ALIGN_NUM (4)
+#define MEM_ALIGN_NUM  (4)
+#define MEM_ALIGN_LOG2 (2)
 #endif
-#define FIT_FIND_DEPTH (3)
 
-#if MEM_BLOCK_MIN_SIZE < MEM_ALIGN_NUM
-#error "MEM_BLOCK_MIN_SIZE < MEM_ALIGN_NUM"
-#endif
+/*
+ * Free blocks are kept in two-level segregated fit lists: the first level
+ * splits sizes by power of two, the second splits each power of two into
+ * MEM_SL_COUNT linear ranges. Blocks below MEM_SMALL_BLOCK_SIZE share the
+ * first list of the first level. A bitmap of the non-empty lists finds a
+ * fitting block with two bit scans, so malloc and free take bounded time
+ * whatever the fragmentation.
+ */
+#define MEM_SL_LOG2          (3)
+#define MEM_SL_COUNT         (1 << MEM_SL_LOG2)
+#define MEM_FL_SHIFT         (MEM_SL_LOG2 + MEM_ALIGN_LOG2)
+#define MEM_SMALL_BLOCK_SIZE (1 << MEM_FL_SHIFT)
 
 typedef struct MEM_HeapBlock_s {
-    unsigned long size;
-    struct MEM_HeapBlock_s *next;
+    struct MEM_HeapBlock_s *prev_phys; // previous block in memory, valid when that one is free
+    unsigned long size;                // block size with the head, low bits hold MEM_BLOCK_xxx_BIT
+    struct MEM_HeapBlock_s *next_free; // free blocks only, neighbours in the size class list
+    struct MEM_HeapBlock_s *prev_free;
 } MEM_HeapBlock_t;
 
 typedef struct {
-    MEM_HeapBlock_t *free_list;
+    MEM_HeapBlock_t **free_list; // fl_count * MEM_SL_COUNT lists, kept at the start of the heap
+    unsigned char *sl_bitmap;    // non-empty second level lists of each first level
+    unsigned long fl_bitmap;     // first levels with a non-empty list
+    unsigned long fl_count;
+    MEM_HeapBlock_t *first; // first block, blocks end with a zero size sentinel
     unsigned char *base;
     unsigned long size;
     unsigned long free;
@@ -78,23 +93,116 @@ typedef struct {
 #define MEM_ASSERT(x)
 #endif
 
-#define MEM_BLOCK_HEAD_SIZE (sizeof(MEM_HeapBlock_t) - sizeof(unsigned long))
+#define MEM_BLOCK_HEAD_SIZE (offsetof(MEM_HeapBlock_t, next_free))
+#define MEM_BLOCK_MIN_SIZE  (ALIGN_UP(sizeof(MEM_HeapBlock_t) + 1))
 #define MEM_HEAP_MIN_SIZE   (MEM_BLOCK_MIN_SIZE + MEM_BLOCK_HEAD_SIZE)
 
+#define MEM_BLOCK_FREE_BIT      (0x1UL)
+#define MEM_BLOCK_PREV_FREE_BIT (0x2UL)
+#define MEM_BLOCK_SIZE(block)   ((block)->size & ~(MEM_BLOCK_FREE_BIT | MEM_BLOCK_PREV_FREE_BIT))
+#define MEM_BLOCK_NEXT(block)   ((MEM_HeapBlock_t *)((unsigned char *)(block) + MEM_BLOCK_SIZE(block)))
+
 #define MEM_BLOCK_STAT_USE  0x55
 #define MEM_BLOCK_STAT_FREE 0xaa
 
-#define MEM_DOG_ADDR(block) ((unsigned char *)block + block->size - 1)
+#define MEM_DOG_ADDR(block) ((unsigned char *)block + MEM_BLOCK_SIZE(block) - 1)
 #define MEM_LEAK_DBG_ADDR(block)                                                                                       \
-    (MEM_DbgLeak_t *)((unsigned long)(intptr_t)block + block->size - sizeof(MEM_DbgLeak_t) - MEM_ALIGN_NUM)
+    (MEM_DbgLeak_t *)((unsigned long)(intptr_t)block + MEM_BLOCK_SIZE(block) - sizeof(MEM_DbgLeak_t) - MEM_ALIGN_NUM)
 
 static MEM_Heap_t mem_heap_list[MEM_HEAP_LIST_NUM] = {0};
 static unsigned long s_heap_free_size = 0;
 static unsigned long s_heap_free_size_watermark = 0; // minimum free size ever
 static heap_context_t s_heap_ctx;
 
+static inline int mem_fls(unsigned long x)
+{
+    return (int)(sizeof(unsigned long) * 8) - 1 - __builtin_clzl(x);
+}
+
+static inline int mem_ffs(unsigned long x)
+{
+    return __builtin_ctzl(x);
+}
+
+static void mem_mapping_insert(unsigned long size, int *fl, int *sl)
+{
+    if (size < MEM_SMALL_BLOCK_SIZE) {
+        *fl = 0;
+        *sl = (int)(size / (MEM_SMALL_BLOCK_SIZE / MEM_SL_COUNT));
+    } else {
+        *fl = mem_fls(size);
+        *sl = (int)(size >> (*fl - MEM_SL_LOG2)) ^ MEM_SL_COUNT;
+        *fl -= MEM_FL_SHIFT - 1;
+    }
+}
+
+// the list found holds blocks no smaller than size, rounding up to the next list
+static void mem_mapping_search(unsigned long size, int *fl, int *sl)
+{
+    if (size >= MEM_SMALL_BLOCK_SIZE) {
+        size += (1UL << (mem_fls(size) - MEM_SL_LOG2)) - 1;
+    }
+    mem_mapping_insert(size, fl, sl);
+}
+
+static void mem_block_insert(MEM_Heap_t *heap, MEM_HeapBlock_t *block)
+{
+    int fl, sl;
+    MEM_HeapBlock_t **head;
+
+    mem_mapping_insert(MEM_BLOCK_SIZE(block), &fl, &sl);
+    head = &heap->free_list[fl * MEM_SL_COUNT + sl];
+
+    block->prev_free = NULL;
+    block->next_free = *head;
+    if (*head) {
+        (*head)->prev_free = block;
+    }
+    *head = block;
+
+    heap->sl_bitmap[fl] |= (unsigned char)(1U << sl);
+    heap->fl_bitmap |= 1UL << fl;
+}
+
+static void mem_block_remove(MEM_Heap_t *heap, MEM_HeapBlock_t *block)
+{
+    int fl, sl;
+
+    if (block->next_free) {
+        block->next_free->prev_free = block->prev_free;
+    }
+    if (block->prev_free) {
+        block->prev_free->next_free = block->next_free;
+        return;
+    }
+
+    mem_mapping_insert(MEM_BLOCK_SIZE(block), &fl, &sl);
+    heap->free_list[fl * MEM_SL_COUNT + sl] = block->next_free;
+    if (NULL == block->next_free) {
+        heap->sl_bitmap[fl] &= (unsigned char)~(1U << sl);
+        if (0 == heap->sl_bitmap[fl]) {
+            heap->fl_bitmap &= ~(1UL << fl);
+        }
+    }
+}
+
+// mark a block free and tell its next neighbour, the block is not put in a list
+static void mem_block_set_free(MEM_HeapBlock_t *block)
+{
+    MEM_HeapBlock_t *next_block = MEM_BLOCK_NEXT(block);
+
+    block->size |= MEM_BLOCK_FREE_BIT;
+    *MEM_DOG_ADDR(block) = MEM_BLOCK_STAT_FREE;
+    next_block->prev_phys = block;
+    next_block->size |= MEM_BLOCK_PREV_FREE_BIT;
+}
+
 static int mem_heap_init(MEM_Heap_t *heap, void *ptr, unsigned long size)
 {
+    unsigned char *top;
+    MEM_HeapBlock_t *sentinel;
+    int fl, sl;
+
 #if defined(MEM_DEBUG_FREE_FILL) && (MEM_DEBUG_FREE_FILL == 1)
     memset(ptr, MEM_DEBUG_FILL_VAL, size);
 #endif
@@ -105,95 +213,86 @@ static int mem_heap_init(MEM_Heap_t *heap, void *ptr, unsigned long size)
     ptr = (void *)(intptr_t)ALIGN_UP((intptr_t)ptr);
     size -= (unsigned long)(intptr_t)ptr - (unsigned long)(intptr_t)heap->base;
     size = ALIGN_DOWN(size);
+    top = (unsigned char *)ptr + size;
+
+    // the lists cover every size up to the heap size, they live in the heap itself
+    mem_mapping_insert(size, &fl, &sl);
+    heap->fl_count = fl + 1;
+    heap->fl_bitmap = 0;
+    heap->free_list = (MEM_HeapBlock_t **)ptr;
+    heap->sl_bitmap = (unsigned char *)(heap->free_list + heap->fl_count * MEM_SL_COUNT);
+    heap->first = (MEM_HeapBlock_t *)(intptr_t)ALIGN_UP((intptr_t)(heap->sl_bitmap + heap->fl_count));
 
-    if (size < MEM_HEAP_MIN_SIZE) {
+    if ((unsigned char *)heap->first + MEM_HEAP_MIN_SIZE > top) {
         return -1;
     }
 
-    heap->free_list = (MEM_HeapBlock_t *)ptr;
-    heap->free_list->next = NULL;
-    heap->free_list->size = size;
+    memset(heap->free_list, 0, (unsigned char *)heap->first - (unsigned char *)heap->free_list);
 
-    heap->free = size;
-    heap->free_watermark = size;
-    s_heap_free_size += size;
-    s_heap_free_size_watermark = s_heap_free_size;
+    sentinel = (MEM_HeapBlock_t *)(top - MEM_BLOCK_HEAD_SIZE);
+    sentinel->size = 0;
+
+    heap->first->size = (unsigned long)((unsigned char *)sentinel - (unsigned char *)heap->first);
+    mem_block_set_free(heap->first);
+    mem_block_insert(heap, heap->first);
 
-    *MEM_DOG_ADDR(heap->free_list) = MEM_BLOCK_STAT_FREE;
+    heap->free = MEM_BLOCK_SIZE(heap->first);
+    heap->free_watermark = heap->free;
+    s_heap_free_size += heap->free;
+    s_heap_free_size_watermark = s_heap_free_size;
 
-    MEM_ASSERT((unsigned long)heap->free_list >= (unsigned long)heap->base);
-    MEM_ASSERT((unsigned long)heap->free_list + heap->free_list->size <= (unsigned long)heap->base + heap->size);
+    MEM_ASSERT((unsigned long)heap->first >= (unsigned long)heap->base);
+    MEM_ASSERT((unsigned long)sentinel + MEM_BLOCK_HEAD_SIZE <= (unsigned long)heap->base + heap->size);
 
     return 0;
 }
 
 static MEM_HeapBlock_t *mem_chunk_get(MEM_Heap_t *heap, unsigned long size)
 {
-    MEM_HeapBlock_t *pre_block;
     MEM_HeapBlock_t *this_block;
     MEM_HeapBlock_t *new_block;
+    unsigned long sl_map;
+    unsigned long fl_map;
+    int fl, sl;
 
-#if defined(MEM_ANTI_FRAGMENT) && (MEM_ANTI_FRAGMENT == 1)
-    MEM_HeapBlock_t *pre_block_bak;
-    MEM_HeapBlock_t *this_block_bak;
-    long find_num = 0;
-#endif
-
-    pre_block = NULL;
-    this_block = heap->free_list;
-
-    while (this_block) {
-        MEM_ASSERT((unsigned long)this_block >= ALIGN_UP(heap->base));
-        MEM_ASSERT((unsigned long)this_block + this_block->size <= ALIGN_DOWN(heap->base + heap->size));
-
-        if (this_block->size >= size) {
-#if defined(MEM_ANTI_FRAGMENT) && (MEM_ANTI_FRAGMENT == 1)
-            pre_block_bak = this_block;
-            this_block_bak = this_block->next;
-            while (this_block_bak) {
-                if ((this_block_bak->size >= size) && (this_block_bak->size <= this_block->size)) {
-                    this_block = this_block_bak;
-                    pre_block = pre_block_bak;
-                    find_num++;
-                }
-
-                if (find_num >= FIT_FIND_DEPTH) {
-                    break;
-                }
-
-                pre_block_bak = this_block_bak;
-                this_block_bak = this_block_bak->next;
-            }
-#endif
-
-            if ((this_block->size - size) >= MEM_HEAP_MIN_SIZE) {
-                this_block->size -= size;
-
-                *MEM_DOG_ADDR(this_block) = MEM_BLOCK_STAT_FREE;
-                new_block = (MEM_HeapBlock_t *)(intptr_t)((unsigned long)(intptr_t)this_block + this_block->size);
-                new_block->size = size;
-
-                *MEM_DOG_ADDR(new_block) = MEM_BLOCK_STAT_USE;
-                return new_block;
-            } else {
-                if (pre_block) {
-                    pre_block->next = this_block->next;
-                } else {
-                    heap->free_list = this_block->next;
-                }
+    mem_mapping_search(size, &fl, &sl);
+    if ((unsigned long)fl >= heap->fl_count) {
+        return (NULL);
+    }
 
-                *MEM_DOG_ADDR(this_block) = MEM_BLOCK_STAT_USE;
-                return this_block;
-            }
+    // the first non-empty list from (fl, sl) on
+    sl_map = heap->sl_bitmap[fl] & (~0UL << sl);
+    if (!sl_map) {
+        fl_map = (fl + 1 < (int)(sizeof(unsigned long) * 8)) ? (heap->fl_bitmap & (~0UL << (fl + 1))) : 0;
+        if (!fl_map) {
+            return (NULL);
         }
+        fl = mem_ffs(fl_map);
+        sl_map = heap->sl_bitmap[fl];
+    }
+    sl = mem_ffs(sl_map);
+
+    this_block = heap->free_list[fl * MEM_SL_COUNT + sl];
+    MEM_ASSERT(this_block && MEM_BLOCK_SIZE(this_block) >= size);
+    mem_block_remove(heap, this_block);
 
-        pre_block = this_block;
-        this_block = this_block->next;
+    if ((MEM_BLOCK_SIZE(this_block) - size) >= MEM_BLOCK_MIN_SIZE) {
+        // the remainder after the block stays free, its next neighbour still sees a free block before it
+        new_block = (MEM_HeapBlock_t *)(intptr_t)((unsigned long)(intptr_t)this_block + size);
+        new_block->size = MEM_BLOCK_SIZE(this_block) - size;
+        mem_block_set_free(new_block);
+        mem_block_insert(heap, new_block);
 
-        MEM_ASSERT((!this_block) || (this_block > pre_block));
+        this_block->size = size | (this_block->size & MEM_BLOCK_PREV_FREE_BIT);
+        new_block->prev_phys = this_block;
+        new_block->size &= ~MEM_BLOCK_PREV_FREE_BIT;
+    } else {
+        this_block->size &= ~MEM_BLOCK_FREE_BIT;
+        MEM_BLOCK_NEXT(this_block)->size &= ~MEM_BLOCK_PREV_FREE_BIT;
     }
 
-    return (NULL);
+    *MEM_DOG_ADDR(this_block) = MEM_BLOCK_STAT_USE;
+    return this_block;
 }
 
 static MEM_Heap_t *MEM_HeapCreate(void *ptr, unsigned long size)
@@ -262,16 +361,19 @@ static void *MEM_Allocate(MEM_Heap_t *heap, unsigned long size)
     if (new_size < size) {
         return (NULL);
     }
+    if (new_size < MEM_BLOCK_MIN_SIZE) {
+        new_size = MEM_BLOCK_MIN_SIZE;
+    }
 
     s_heap_ctx.enter_critical();
     block = mem_chunk_get(heap, new_size);
     if (block) {
-        heap->free -= block->size;
+        heap->free -= MEM_BLOCK_SIZE(block);
         if (heap->free_watermark > heap->free) {
             heap->free_watermark = heap->free;
         }
 
-        s_heap_free_size -= block->size;
+        s_heap_free_size -= MEM_BLOCK_SIZE(block);
         if (s_heap_free_size_watermark > s_heap_free_size) {
             s_heap_free_size_watermark = s_heap_free_size;
         }
@@ -322,8 +424,9 @@ static void MEM_Deallocate(MEM_Heap_t *heap, void *ptr)
 
     pdog = MEM_DOG_ADDR(free_block);
 
-    if (*pdog != MEM_BLOCK_STAT_USE) {
-        s_heap_ctx.dbg_output("[MEM DBG] MEM_Deallocate MEM_DEBUG_DOG_TAG err %p,size=%d\r\n", ptr, free_block->size);
+    if (*pdog != MEM_BLOCK_STAT_USE || (free_block->size & MEM_BLOCK_FREE_BIT)) {
+        s_heap_ctx.dbg_output("[MEM DBG] MEM_Deallocate MEM_DEBUG_DOG_TAG err %p,size=%d\r\n", ptr,
+                              MEM_BLOCK_SIZE(free_block));
 
         if (*pdog == MEM_BLOCK_STAT_FREE) {
             s_heap_ctx.dbg_output("[MEM DBG] mem %p might be freed yet\r\n", ptr);
@@ -333,80 +436,80 @@ static void MEM_Deallocate(MEM_Heap_t *heap, void *ptr)
     }
 
 #if defined(MEM_DEBUG_FREE_FILL) && (MEM_DEBUG_FREE_FILL == 1)
-    memset(ptr, MEM_DEBUG_FILL_VAL, free_block->size - MEM_BLOCK_HEAD_SIZE);
+    memset(ptr, MEM_DEBUG_FILL_VAL, MEM_BLOCK_SIZE(free_block) - MEM_BLOCK_HEAD_SIZE);
 #endif
 
     s_heap_ctx.enter_critical();
 
+    // the tag stays in place once the block is merged, a second free of ptr still sees it
     *pdog = MEM_BLOCK_STAT_FREE;
 
-    MEM_ASSERT((unsigned long)free_block >= (unsigned long)heap->base);
-    MEM_ASSERT((unsigned long)free_block + free_block->size <= (unsigned long)heap->base + heap->size);
-
-    heap->free += free_block->size;
-    s_heap_free_size += free_block->size;
-
-    next_block = heap->free_list;
-    pre_block = NULL;
-    while (next_block && (next_block < free_block)) {
-        MEM_ASSERT((unsigned long)next_block >= ALIGN_UP(heap->base));
-        MEM_ASSERT((unsigned long)next_block + next_block->size <= ALIGN_DOWN(heap->base + heap->size));
+    MEM_ASSERT((unsigned long)free_block >= (unsigned long)heap->first);
+    MEM_ASSERT((unsigned long)free_block + MEM_BLOCK_SIZE(free_block) <= (unsigned long)heap->base + heap->size);
 
-        pre_block = next_block;
-        next_block = next_block->next;
+    heap->free += MEM_BLOCK_SIZE(free_block);
+    s_heap_free_size += MEM_BLOCK_SIZE(free_block);
 
-        MEM_ASSERT((!next_block) || (next_block > pre_block));
-    }
-
-    MEM_ASSERT((!next_block) || (next_block > free_block));
-    MEM_ASSERT((!pre_block) || (pre_block < free_block));
-
-    free_block->next = next_block;
-    if (!pre_block) {
-        heap->free_list = free_block;
-        pre_block = free_block;
-    } else {
-        if (((char *)pre_block + pre_block->size) == (char *)free_block) {
+    // merge with the free neighbours, the heads tell them without walking any list
+    if (free_block->size & MEM_BLOCK_PREV_FREE_BIT) {
+        pre_block = free_block->prev_phys;
+        MEM_ASSERT(pre_block->size & MEM_BLOCK_FREE_BIT);
+        mem_block_remove(heap, pre_block);
+        pre_block->size += MEM_BLOCK_SIZE(free_block);
 #if defined(MEM_DEBUG_FREE_FILL) && (MEM_DEBUG_FREE_FILL == 1)
-            *MEM_DOG_ADDR(pre_block) = MEM_DEBUG_FILL_VAL;
+        memset(free_block, MEM_DEBUG_FILL_VAL, MEM_BLOCK_HEAD_SIZE);
 #endif
+        free_block = pre_block;
+    }
 
-            pre_block->size += free_block->size;
-
+    next_block = MEM_BLOCK_NEXT(free_block);
+    if (next_block->size & MEM_BLOCK_FREE_BIT) {
+        mem_block_remove(heap, next_block);
+        free_block->size += MEM_BLOCK_SIZE(next_block);
 #if defined(MEM_DEBUG_FREE_FILL) && (MEM_DEBUG_FREE_FILL == 1)
-            memset(free_block, MEM_DEBUG_FILL_VAL, MEM_BLOCK_HEAD_SIZE);
+        memset(next_block, MEM_DEBUG_FILL_VAL, sizeof(MEM_HeapBlock_t));
 #endif
-        } else {
-            pre_block->next = free_block;
-            pre_block = free_block;
-        }
     }
 
-    if (next_block) {
-        if (((char *)pre_block + pre_block->size) == (char *)next_block) {
-#if defined(MEM_DEBUG_FREE_FILL) && (MEM_DEBUG_FREE_FILL == 1)
-            *MEM_DOG_ADDR(pre_block) = MEM_DEBUG_FILL_VAL;
-#endif
-            pre_block->size += next_block->size;
-            pre_block->next = next_block->next;
+    mem_block_set_free(free_block);
+    mem_block_insert(heap, free_block);
 
-#if defined(MEM_DEBUG_FREE_FILL) && (MEM_DEBUG_FREE_FILL == 1)
-            memset(next_block, MEM_DEBUG_FILL_VAL, sizeof(MEM_HeapBlock_t));
-#endif
+    s_heap_ctx.exit_critical();
+}
+
+// the largest free block, found in the highest non-empty list
+static unsigned long mem_free_largest(MEM_Heap_t *heap)
+{
+    MEM_HeapBlock_t *block;
+    unsigned long largest = 0;
+    int fl, sl;
+
+    if (0 == heap->fl_bitmap) {
+        return 0;
+    }
+
+    fl = mem_fls(heap->fl_bitmap);
+    sl = mem_fls(heap->sl_bitmap[fl]);
+    for (block = heap->free_list[fl * MEM_SL_COUNT + sl]; block; block = block->next_free) {
+        if (MEM_BLOCK_SIZE(block) > largest) {
+            largest = MEM_BLOCK_SIZE(block);
         }
     }
-    s_heap_ctx.exit_critical();
+
+    return largest - MEM_BLOCK_HEAD_SIZE - 1;
 }
 
 static void MEM_HeapStatus(MEM_Heap_t *heap, MEM_HeapStatus_t *status)
 {
-    MEM_HeapBlock_t *freeBlockp = NULL;
     MEM_HeapBlock_t *thisBlockp = NULL;
+    MEM_HeapBlock_t *nextBlockp = NULL;
+    MEM_HeapBlock_t *listBlockp = NULL;
     MEM_DbgLeak_t *leak = NULL;
     unsigned long result = 0;
-    unsigned long addr = 0;
     unsigned long top_addr = 0;
     unsigned long thisSize = 0;
+    unsigned long listNum = 0;
+    unsigned long i = 0;
 
     if (heap == NULL || status == NULL) {
         return;
@@ -415,22 +518,25 @@ static void MEM_HeapStatus(MEM_Heap_t *heap, MEM_HeapStatus_t *status)
     memset(status, 0, sizeof(MEM_HeapStatus_t));
     status->size = heap->size;
 
-    addr = ALIGN_UP((intptr_t)heap->base);
-    top_addr = ALIGN_DOWN((intptr_t)heap->base + heap->size);
+    top_addr = ALIGN_DOWN((intptr_t)heap->base + heap->size) - MEM_BLOCK_HEAD_SIZE;
 
     s_heap_ctx.enter_critical();
 
-    freeBlockp = heap->free_list;
-    while (addr < top_addr) {
-        thisBlockp = (MEM_HeapBlock_t *)(intptr_t)addr;
-
-        MEM_ASSERT(thisBlockp);
+    thisBlockp = heap->first;
+    while ((unsigned long)(intptr_t)thisBlockp < top_addr) {
         MEM_ASSERT((unsigned long)thisBlockp >= (unsigned long)heap->base);
-        MEM_ASSERT((unsigned long)thisBlockp + thisBlockp->size <= (unsigned long)heap->base + heap->size);
+        MEM_ASSERT((unsigned long)thisBlockp + MEM_BLOCK_SIZE(thisBlockp) <= (unsigned long)heap->base + heap->size);
 
-        if (*MEM_DOG_ADDR(thisBlockp) == MEM_BLOCK_STAT_USE) {
-            if (thisBlockp == freeBlockp) {
-                result = 1;
+        if (MEM_BLOCK_SIZE(thisBlockp) < MEM_BLOCK_MIN_SIZE ||
+            (unsigned long)(intptr_t)thisBlockp + MEM_BLOCK_SIZE(thisBlockp) > top_addr) {
+            result = 3;
+            goto EXIT;
+        }
+        nextBlockp = MEM_BLOCK_NEXT(thisBlockp);
+
+        if (*MEM_DOG_ADDR(thisBlockp) == MEM_BLOCK_STAT_USE && !(thisBlockp->size & MEM_BLOCK_FREE_BIT)) {
+            if (nextBlockp->size & MEM_BLOCK_PREV_FREE_BIT) {
+                result = 2;
                 goto EXIT;
             }
 
@@ -443,17 +549,15 @@ static void MEM_HeapStatus(MEM_Heap_t *heap, MEM_HeapStatus_t *status)
             }
 
             status->used_block++;
-        } else if (*MEM_DOG_ADDR(thisBlockp) == MEM_BLOCK_STAT_FREE) {
-            MEM_ASSERT(freeBlockp);
-            MEM_ASSERT((unsigned long)freeBlockp >= ALIGN_UP(heap->base));
-            MEM_ASSERT((unsigned long)freeBlockp + freeBlockp->size <= ALIGN_DOWN(heap->base + heap->size));
-
-            if (thisBlockp != freeBlockp) {
-                result = 2;
+        } else if (*MEM_DOG_ADDR(thisBlockp) == MEM_BLOCK_STAT_FREE && (thisBlockp->size & MEM_BLOCK_FREE_BIT)) {
+            // free neighbours are always merged
+            if ((nextBlockp->size & MEM_BLOCK_FREE_BIT) || !(nextBlockp->size & MEM_BLOCK_PREV_FREE_BIT) ||
+                nextBlockp->prev_phys != thisBlockp) {
+                result = 1;
                 goto EXIT;
             }
 
-            thisSize = thisBlockp->size - MEM_BLOCK_HEAD_SIZE - 1;
+            thisSize = MEM_BLOCK_SIZE(thisBlockp) - MEM_BLOCK_HEAD_SIZE - 1;
 
             status->free += thisSize;
 
@@ -461,20 +565,31 @@ static void MEM_HeapStatus(MEM_Heap_t *heap, MEM_HeapStatus_t *status)
                 status->free_largest = thisSize;
             }
 
-            freeBlockp = freeBlockp->next;
             status->free_block++;
         } else {
             result = 3;
             goto EXIT;
         }
 
-        addr += thisBlockp->size;
+        thisBlockp = nextBlockp;
+    }
+
+    // every free block must sit in a list
+    for (i = 0; i < heap->fl_count * MEM_SL_COUNT; i++) {
+        for (listBlockp = heap->free_list[i]; listBlockp; listBlockp = listBlockp->next_free) {
+            if (++listNum > status->free_block) {
+                break;
+            }
+        }
+    }
+    if (listNum != status->free_block) {
+        result = 2;
+        goto EXIT;
     }
 
-    MEM_ASSERT(addr == top_addr);
-    MEM_ASSERT(!freeBlockp);
+    MEM_ASSERT((unsigned long)(intptr_t)thisBlockp == top_addr);
 
-    if ((addr == top_addr) && (!freeBlockp)) {
+    if ((unsigned long)(intptr_t)thisBlockp == top_addr) {
         status->valid = 1;
     }
 
@@ -483,13 +598,13 @@ EXIT:
 
     if (0 != result) {
         if (1 == result) {
-            s_heap_ctx.dbg_output("[MEM DBG] [ERROR]thisBlockp == freeBlockp,addr=%p,size=%d\r\n", thisBlockp,
-                                  thisBlockp->size);
+            s_heap_ctx.dbg_output("[MEM DBG] [ERROR]free block not merged,addr=%p,size=%d\r\n", thisBlockp,
+                                  MEM_BLOCK_SIZE(thisBlockp));
         } else if (2 == result) {
-            s_heap_ctx.dbg_output("[MEM DBG] [ERROR]thisBlockp != freeBlockp,addr=%p,size=%d\r\n", thisBlockp,
-                                  thisBlockp->size);
+            s_heap_ctx.dbg_output("[MEM DBG] [ERROR]free list mismatch,addr=%p,size=%d\r\n", thisBlockp,
+                                  MEM_BLOCK_SIZE(thisBlockp));
         } else if (3 == result) {
-            s_heap_ctx.dbg_output("[MEM DBG] DOG TAG ERR:addr=%p,size=%d\r\n", thisBlockp, thisBlockp->size);
+            s_heap_ctx.dbg_output("[MEM DBG] DOG TAG ERR:addr=%p,size=%d\r\n", thisBlockp, MEM_BLOCK_SIZE(thisBlockp));
         }
     }
 }
@@ -578,7 +693,8 @@ void *tuya_mem_heap_realloc(HEAP_HANDLE handle, void *ptr, unsigned int size)
     unsigned char *pdog = MEM_DOG_ADDR(old_block);
 
     if (*pdog != MEM_BLOCK_STAT_USE) {
-        s_heap_ctx.dbg_output("[MEM DBG] realloc MEM_DEBUG_DOG_TAG err %p,size=%d\r\n", ptr, old_block->size);
+        s_heap_ctx.dbg_output("[MEM DBG] realloc MEM_DEBUG_DOG_TAG err %p,size=%d\r\n", ptr,
+                              MEM_BLOCK_SIZE(old_block));
         return NULL;
     }
 
@@ -586,7 +702,7 @@ void *tuya_mem_heap_realloc(HEAP_HANDLE handle, void *ptr, unsigned int size)
     size = size < 4 ? 4 : size;
 
     new_size = ALIGN_UP(size + 1) + MEM_BLOCK_HEAD_SIZE;
-    if (new_size <= old_block->size) { // old buffer is big enough
+    if (new_size <= MEM_BLOCK_SIZE(old_block)) { // old buffer is big enough
         return ptr;
     }
 
@@ -596,7 +712,7 @@ void *tuya_mem_heap_realloc(HEAP_HANDLE handle, void *ptr, unsigned int size)
         return NULL;
     }
 
-    memcpy(tmp, ptr, old_block->size - MEM_BLOCK_HEAD_SIZE);
+    memcpy(tmp, ptr, MEM_BLOCK_SIZE(old_block) - MEM_BLOCK_HEAD_SIZE);
     tuya_mem_heap_free(handle, ptr);
     return tmp;
 }
@@ -643,13 +759,22 @@ void tuya_mem_heap_state(HEAP_HANDLE handle, heap_state_t *state)
     if (0 == handle) {
         long idx = 0;
 
+        unsigned long largest = 0;
+
         state->free_size = s_heap_free_size;
         state->free_watermark = s_heap_free_size_watermark;
+        state->max_free_block_size = 0;
 
         for (idx = 0; idx < MEM_HEAP_LIST_NUM; idx++) {
             pHeap = &mem_heap_list[idx];
             if (pHeap->size > 0) {
                 state->total_size += pHeap->size;
+                s_heap_ctx.enter_critical();
+                largest = mem_free_largest(pHeap);
+                s_heap_ctx.exit_critical();
+                if (largest > state->max_free_block_size) {
+                    state->max_free_block_size = largest;
+                }
             } else {
                 break;
             }
@@ -658,6 +783,9 @@ void tuya_mem_heap_state(HEAP_HANDLE handle, heap_state_t *state)
         state->total_size = pHeap->size;
         state->free_size = pHeap->free;
         state->free_watermark = pHeap->free_watermark;
+        s_heap_ctx.enter_critical();
+        state->max_free_block_size = mem_free_largest(pHeap);
+        s_heap_ctx.exit_critical();
     }
 }
 
@@ -11,7 +11,6 @@
 #include "tkl_system.h"
 #include "tkl_memory.h"
 
-#include "tuya_list.h"
 #include "tuya_queue.h"
 
 #if defined(OPERATING_SYSTEM) && (SYSTEM_NON_OS == OPERATING_SYSTEM)
@@ -30,11 +29,10 @@
 
 typedef enum { POLICY_SEND_TO_BACK, POLICY_SEND_TO_FRONT, POLICY_MAX } ENQUEUE_POLICY_E;
 
-typedef struct {
-    LIST_HEAD node;
-    uint8_t data[];
-} QUEUE_ITEM_T;
-
+/**
+ * the items live in a ring of queue_len slots allocated together with the queue,
+ * so enqueue and dequeue only copy the item and move an index
+ */
 typedef struct {
 #if defined(OPERATING_SYSTEM) && (SYSTEM_NON_OS != OPERATING_SYSTEM)
     TKL_MUTEX_HANDLE mutex;
@@ -44,12 +42,43 @@ typedef struct {
     uint32_t queue_len;
     uint32_t queue_free;
 
-    LIST_HEAD head;
+    uint32_t head; // slot of the first item
+    uint8_t data[];
 } TUYA_QUEUE_T;
 
+// slot of the item at position pos from the head, pos <= queue_len
+static inline uint32_t __slot(TUYA_QUEUE_T *queue, uint32_t pos)
+{
+    uint32_t slot = queue->head + pos;
+
+    return (slot >= queue->queue_len) ? (slot - queue->queue_len) : slot;
+}
+
+static inline uint8_t *__slot_addr(TUYA_QUEUE_T *queue, uint32_t slot)
+{
+    return queue->data + slot * queue->item_size;
+}
+
+// copy num items starting at position pos, in at most two runs when the range wraps
+static void __copy_out(TUYA_QUEUE_T *queue, uint32_t pos, uint8_t *dst, uint32_t num)
+{
+    uint32_t slot = __slot(queue, pos);
+    uint32_t run = queue->queue_len - slot;
+
+    if (run > num) {
+        run = num;
+    }
+
+    memcpy(dst, __slot_addr(queue, slot), run * queue->item_size);
+    if (num > run) {
+        memcpy(dst + run * queue->item_size, queue->data, (num - run) * queue->item_size);
+    }
+}
+
 static OPERATE_RET __enqueue(TUYA_QUEUE_HANDLE handle, const void *item, ENQUEUE_POLICY_E policy)
 {
     OPERATE_RET op_ret = OPRT_OK;
+    uint32_t slot = 0;
 
     if (NULL == handle || NULL == item || policy >= POLICY_MAX) {
         return OPRT_INVALID_PARM;
@@ -57,24 +86,17 @@ static OPERATE_RET __enqueue(TUYA_QUEUE_HANDLE handle, const void *item, ENQUEUE
 
     TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
 
-    QUEUE_ITEM_T *queue_item = (QUEUE_ITEM_T *)tkl_system_malloc(sizeof(QUEUE_ITEM_T) + queue->item_size);
-    if (NULL == queue_item) {
-        return OPRT_MALLOC_FAILED;
-    }
-
-    INIT_LIST_HEAD(&(queue_item->node));
-    memcpy(queue_item->data, (void *)item, queue->item_size);
-
     QUEUE_LOCK(queue);
     if (queue->queue_free > 0) {
         if (POLICY_SEND_TO_BACK == policy) {
-            tuya_list_add_tail(&(queue_item->node), &(queue->head));
-        } else if (POLICY_SEND_TO_FRONT == policy) {
-            tuya_list_add(&(queue_item->node), &(queue->head));
+            slot = __slot(queue, queue->queue_len - queue->queue_free);
+        } else {
+            queue->head = (0 == queue->head) ? (queue->queue_len - 1) : (queue->head - 1);
+            slot = queue->head;
         }
+        memcpy(__slot_addr(queue, slot), item, queue->item_size);
         queue->queue_free--;
     } else {
-        tkl_system_free(queue_item);
         op_ret = OPRT_EXCEED_UPPER_LIMIT;
     }
     QUEUE_UNLOCK(queue);
@@ -102,7 +124,11 @@ OPERATE_RET tuya_queue_create(const uint32_t queue_len, const uint32_t item_size
         return OPRT_INVALID_PARM;
     }
 
-    queue = (TUYA_QUEUE_T *)tkl_system_malloc(sizeof(TUYA_QUEUE_T));
+    if (queue_len > (UINT32_MAX - sizeof(TUYA_QUEUE_T)) / item_size) {
+        return OPRT_INVALID_PARM;
+    }
+
+    queue = (TUYA_QUEUE_T *)tkl_system_malloc(sizeof(TUYA_QUEUE_T) + queue_len * item_size);
     if (!queue) {
         return OPRT_MALLOC_FAILED;
     }
@@ -116,7 +142,7 @@ OPERATE_RET tuya_queue_create(const uint32_t queue_len, const uint32_t item_size
     queue->item_size = item_size;
     queue->queue_len = queue_len;
     queue->queue_free = queue_len;
-    INIT_LIST_HEAD(&(queue->head));
+    queue->head = 0;
 
     *handle = (TUYA_QUEUE_HANDLE)queue;
 
@@ -169,12 +195,10 @@ OPERATE_RET tuya_queue_output(TUYA_QUEUE_HANDLE handle, const void *item)
 
     QUEUE_LOCK(queue);
     if (queue->queue_free < queue->queue_len) {
-        QUEUE_ITEM_T *queue_item = tuya_list_entry(queue->head.next, QUEUE_ITEM_T, node);
         if (item) {
-            memcpy((void *)item, queue_item->data, queue->item_size);
+            memcpy((void *)item, __slot_addr(queue, queue->head), queue->item_size);
         }
-        tuya_list_del(&(queue_item->node));
-        tkl_system_free(queue_item);
+        queue->head = __slot(queue, 1);
         queue->queue_free++;
     } else {
         op_ret = OPRT_NOT_FOUND;
@@ -204,8 +228,7 @@ OPERATE_RET tuya_queue_peek(TUYA_QUEUE_HANDLE handle, const void *item)
 
     QUEUE_LOCK(queue);
     if (queue->queue_free < queue->queue_len) {
-        QUEUE_ITEM_T *queue_item = tuya_list_entry(queue->head.next, QUEUE_ITEM_T, node);
-        memcpy((void *)item, queue_item->data, queue->item_size);
+        memcpy((void *)item, __slot_addr(queue, queue->head), queue->item_size);
     } else {
         op_ret = OPRT_NOT_FOUND;
     }
@@ -228,14 +251,11 @@ OPERATE_RET tuya_queue_traverse(TUYA_QUEUE_HANDLE handle, TRAVERSE_CB cb, void *
     }
 
     TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
-    struct tuya_list_head *p = NULL;
-    QUEUE_ITEM_T *queue_item = NULL;
+    uint32_t pos = 0;
 
     QUEUE_LOCK(queue);
-    tuya_list_for_each(p, &(queue->head))
-    {
-        queue_item = tuya_list_entry(p, QUEUE_ITEM_T, node);
-        if (!cb(queue_item->data, ctx)) {
+    for (pos = 0; pos < queue->queue_len - queue->queue_free; pos++) {
+        if (!cb(__slot_addr(queue, __slot(queue, pos)), ctx)) {
             break;
         }
     }
@@ -258,17 +278,9 @@ OPERATE_RET tuya_queue_clear(TUYA_QUEUE_HANDLE handle)
     }
 
     TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
-    struct tuya_list_head *p = NULL;
-    struct tuya_list_head *n = NULL;
-    QUEUE_ITEM_T *queue_item = NULL;
 
     QUEUE_LOCK(queue);
-    tuya_list_for_each_safe(p, n, &(queue->head))
-    {
-        queue_item = tuya_list_entry(p, QUEUE_ITEM_T, node);
-        tuya_list_del(&queue_item->node);
-        tkl_system_free(queue_item);
-    }
+    queue->head = 0;
     queue->queue_free = queue->queue_len;
     QUEUE_UNLOCK(queue);
 
@@ -292,30 +304,18 @@ OPERATE_RET tuya_queue_get_batch(TUYA_QUEUE_HANDLE handle, const uint32_t start,
     }
 
     TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
-    struct tuya_list_head *p = NULL;
-    QUEUE_ITEM_T *queue_item = NULL;
-    uint32_t index = 0;
+    uint32_t used = 0;
     uint32_t count = 0;
 
     QUEUE_LOCK(queue);
-    tuya_list_for_each(p, &(queue->head))
-    {
-        if (index < start) {
-            index++;
-            continue;
-        }
-
-        if (count >= num) {
-            break;
-        }
-
-        queue_item = tuya_list_entry(p, QUEUE_ITEM_T, node);
-        memcpy((uint8_t *)items + count * queue->item_size, queue_item->data, queue->item_size);
-        count++;
+    used = queue->queue_len - queue->queue_free;
+    if (start < used) {
+        count = (num < used - start) ? num : (used - start);
+        __copy_out(queue, start, (uint8_t *)items, count);
     }
     QUEUE_UNLOCK(queue);
 
-    if (index != start || count != num) {
+    if (count != num) {
         return OPRT_NOT_FOUND;
     }
 
@@ -332,18 +332,27 @@ OPERATE_RET tuya_queue_get_batch(TUYA_QUEUE_HANDLE handle, const uint32_t start,
  */
 OPERATE_RET tuya_queue_delete_batch(TUYA_QUEUE_HANDLE handle, const uint32_t num)
 {
-    OPERATE_RET op_ret = OPRT_OK;
-    uint32_t count = num;
-
     if (NULL == handle || 0 == num) {
         return OPRT_INVALID_PARM;
     }
 
-    while ((count-- > 0) && (OPRT_OK == op_ret)) {
-        op_ret = tuya_queue_output(handle, NULL);
+    TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
+    uint32_t used = 0;
+    uint32_t count = 0;
+
+    // as many items as there are get deleted, a short queue still reports not found
+    QUEUE_LOCK(queue);
+    used = queue->queue_len - queue->queue_free;
+    count = (num < used) ? num : used;
+    queue->head = __slot(queue, count);
+    queue->queue_free += count;
+    QUEUE_UNLOCK(queue);
+
+    if (count != num) {
+        return OPRT_NOT_FOUND;
     }
 
-    return op_ret;
+    return OPRT_OK;
 }
 
 /**
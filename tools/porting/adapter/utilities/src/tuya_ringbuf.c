@@ -1,5 +1,6 @@
 #include "tkl_memory.h"
 #include "tuya_ringbuf.h"
+#include "tuya_atomic.h"
 
 #define RINGBUFF_FREE   tkl_system_free
 #define RINGBUFF_MALLOC tkl_system_malloc
@@ -7,13 +8,22 @@
 #define GET_MIN(x, y) ((x) < (y) ? (x) : (y))
 #define GET_MAX(x, y) ((x) > (y) ? (x) : (y))
 
+/*
+ * in is only written by the producer and out only by the consumer. Each side
+ * loads the index of the other with acquire and publishes its own with release
+ * once the data is copied, so one writer and one reader need no lock. Load an
+ * index once into a local, GET_MIN evaluates its arguments twice.
+ */
+#define RINGBUFF_LOAD_ACQ(p)     TUYA_ATOMIC_LOAD_ACQ(p)
+#define RINGBUFF_STORE_REL(p, v) TUYA_ATOMIC_STORE_REL(p, v)
+
 /*
  * ringbuff structure
  */
 typedef struct {
     RINGBUFF_TYPE_E type; ///< ringbuff type
-    uint32_t in;          ///< position of input
-    uint32_t out;         ///< position of output
+    uint32_t in;          ///< position of input, owned by the producer
+    uint32_t out;         ///< position of output, owned by the consumer
     uint32_t len;         ///< length of buff data
     uint8_t buff[];       ///< ring buff
 } __RINGBUFF_T;
@@ -22,9 +32,40 @@ typedef struct {
 
 static void __ringbuff_init(__RINGBUFF_T *ringbuff, uint32_t len)
 {
-    ringbuff->in = 0;
-    ringbuff->out = 0;
     ringbuff->len = len;
+    RINGBUFF_STORE_REL(&ringbuff->out, 0);
+    RINGBUFF_STORE_REL(&ringbuff->in, 0);
+}
+
+static uint32_t __ringbuff_free_len(__RINGBUFF_T *rbuff, uint32_t in, uint32_t out)
+{
+    // one byte always stays empty so that in == out means empty
+    return (out > in) ? (out - in - 1) : (rbuff->len - (in - out) - 1);
+}
+
+static uint32_t __ringbuff_used_len(__RINGBUFF_T *rbuff, uint32_t in, uint32_t out)
+{
+    return (in >= out) ? (in - out) : (rbuff->len - (out - in));
+}
+
+static uint32_t __ringbuff_contig_free_len(__RINGBUFF_T *rbuff, uint32_t in, uint32_t out)
+{
+    // free bytes up to the end of the buffer, or up to out when it is ahead
+    if (out > in) {
+        return out - in - 1;
+    }
+
+    return rbuff->len - in - ((out == 0) ? 1 : 0);
+}
+
+static uint32_t __ringbuff_advance(__RINGBUFF_T *rbuff, uint32_t pos, uint32_t len)
+{
+    pos += len;
+    if (pos >= rbuff->len) {
+        pos -= rbuff->len;
+    }
+
+    return pos;
 }
 
 OPERATE_RET tuya_ring_buff_create(uint32_t len, RINGBUFF_TYPE_E type, TUYA_RINGBUFF_T *ringbuff)
@@ -77,52 +118,29 @@ OPERATE_RET tuya_ring_buff_reset(TUYA_RINGBUFF_T ringbuff)
 
 uint32_t tuya_ring_buff_free_size_get(TUYA_RINGBUFF_T ringbuff)
 {
-    uint32_t size, in, out;
     __RINGBUFF_T *rbuff = (__RINGBUFF_T *)ringbuff;
 
     if (rbuff == NULL) {
         return 0;
     }
 
-    in = rbuff->in;
-    out = rbuff->out;
-    if (in == out) {
-        size = rbuff->len;
-    } else if (out > in) {
-        size = out - in;
-    } else {
-        size = rbuff->len - (in - out);
-    }
-
-    return size - 1;
+    return __ringbuff_free_len(rbuff, RINGBUFF_LOAD_ACQ(&rbuff->in), RINGBUFF_LOAD_ACQ(&rbuff->out));
 }
 
 uint32_t tuya_ring_buff_used_size_get(TUYA_RINGBUFF_T ringbuff)
 {
-    uint32_t size, in, out;
     __RINGBUFF_T *rbuff = (__RINGBUFF_T *)ringbuff;
 
     if (rbuff == NULL) {
         return 0;
     }
 
-    in = rbuff->in;
-    out = rbuff->out;
-    if (in == out) {
-        size = 0;
-    } else if (in > out) {
-        size = in - out;
-    } else {
-        size = rbuff->len - (out - in);
-    }
-
-    return size;
+    return __ringbuff_used_len(rbuff, RINGBUFF_LOAD_ACQ(&rbuff->in), RINGBUFF_LOAD_ACQ(&rbuff->out));
 }
 
 uint32_t tuya_ring_buff_write(TUYA_RINGBUFF_T ringbuff, const void *data, uint32_t len)
 {
-    uint32_t tmp_len;
-    uint32_t free_len;
+    uint32_t in, out, tmp_len;
     const uint8_t *pdata = data;
     __RINGBUFF_T *rbuff = (__RINGBUFF_T *)ringbuff;
 
@@ -130,130 +148,163 @@ uint32_t tuya_ring_buff_write(TUYA_RINGBUFF_T ringbuff, const void *data, uint32
         return 0;
     }
     // overwriting unread parts is not supported when the write is full
-    free_len = tuya_ring_buff_free_size_get(rbuff);
-    len = GET_MIN(free_len, len);
+    in = rbuff->in;
+    out = RINGBUFF_LOAD_ACQ(&rbuff->out);
+    len = GET_MIN(__ringbuff_free_len(rbuff, in, out), len);
     if (len == 0) {
         return 0;
     }
 
-    // write data to remaining buff
-    tmp_len = GET_MIN(rbuff->len - rbuff->in, len);
-    memcpy(&rbuff->buff[rbuff->in], pdata, tmp_len);
-    rbuff->in += tmp_len;
-    len -= tmp_len;
-
-    // write remaining data to beginning of buffer
-    if (len > 0) {
-        memcpy(rbuff->buff, &pdata[tmp_len], len);
-        rbuff->in = len;
+    // write data to remaining buff, then the rest to beginning of buffer
+    tmp_len = GET_MIN(rbuff->len - in, len);
+    memcpy(&rbuff->buff[in], pdata, tmp_len);
+    if (len > tmp_len) {
+        memcpy(rbuff->buff, &pdata[tmp_len], len - tmp_len);
     }
 
-    // buff loopback check
-    if (rbuff->in >= rbuff->len) {
-        rbuff->in = 0;
-    }
+    // publish the data to the reader in one store
+    RINGBUFF_STORE_REL(&rbuff->in, __ringbuff_advance(rbuff, in, len));
 
-    return tmp_len + len;
+    return len;
 }
 
 uint32_t tuya_ring_buff_read(TUYA_RINGBUFF_T ringbuff, void *data, uint32_t len)
 {
-    uint32_t tmp_len;
-    uint32_t used_len;
-    uint8_t *pdata = data;
+    uint32_t out;
     __RINGBUFF_T *rbuff = (__RINGBUFF_T *)ringbuff;
 
     if (rbuff == NULL || data == NULL || len == 0) {
         return 0;
     }
 
-    used_len = tuya_ring_buff_used_size_get(rbuff);
-    len = GET_MIN(used_len, len);
-    if (len == 0) {
-        return 0;
+    // the consumer is the only writer of out, the peek copies from this same position
+    out = rbuff->out;
+    len = tuya_ring_buff_peek(rbuff, data, len);
+    if (len) {
+        RINGBUFF_STORE_REL(&rbuff->out, __ringbuff_advance(rbuff, out, len));
     }
 
-    // read data from linear part of buffer
-    tmp_len = GET_MIN(rbuff->len - rbuff->out, len);
-    memcpy(pdata, &rbuff->buff[rbuff->out], tmp_len);
-    rbuff->out += tmp_len;
-    len -= tmp_len;
+    return len;
+}
+
+uint32_t tuya_ring_buff_discard(TUYA_RINGBUFF_T ringbuff, uint32_t len)
+{
+    uint32_t in, out;
+    __RINGBUFF_T *rbuff = (__RINGBUFF_T *)ringbuff;
 
-    // read data from beginning of buffer (overflow part)
-    if (len > 0) {
-        memcpy(&pdata[tmp_len], rbuff->buff, len);
-        rbuff->out = len;
+    if (rbuff == NULL || len == 0) {
+        return 0;
     }
 
-    // check end of buffer
-    if (rbuff->out >= rbuff->len) {
-        rbuff->out = 0;
+    in = RINGBUFF_LOAD_ACQ(&rbuff->in);
+    out = rbuff->out;
+    len = GET_MIN(__ringbuff_used_len(rbuff, in, out), len);
+    if (len == 0) {
+        return 0;
     }
 
-    return tmp_len + len;
+    // hand the space back to the writer in one store
+    RINGBUFF_STORE_REL(&rbuff->out, __ringbuff_advance(rbuff, out, len));
+
+    return len;
 }
 
-uint32_t tuya_ring_buff_discard(TUYA_RINGBUFF_T ringbuff, uint32_t len)
+uint32_t tuya_ring_buff_peek(TUYA_RINGBUFF_T ringbuff, void *data, uint32_t len)
 {
+    uint32_t in, out;
     uint32_t tmp_len;
-    uint32_t used_len;
+    uint8_t *pdata = data;
     __RINGBUFF_T *rbuff = (__RINGBUFF_T *)ringbuff;
 
-    if(rbuff == NULL || len == 0) {
+    if (rbuff == NULL || data == NULL || len == 0) {
         return 0;
     }
 
-    used_len = tuya_ring_buff_used_size_get(rbuff);
-    len = GET_MIN(used_len, len);
+    in = RINGBUFF_LOAD_ACQ(&rbuff->in);
+    out = rbuff->out;
+    len = GET_MIN(__ringbuff_used_len(rbuff, in, out), len);
     if (len == 0) {
         return 0;
     }
 
-    // discard data from linear part of buffer
-    tmp_len = GET_MIN(rbuff->len - rbuff->out, len);
-    rbuff->out += tmp_len;
-    len -= tmp_len;
+    // read data from linear part of buffer, then from beginning of buffer
+    tmp_len = GET_MIN(rbuff->len - out, len);
+    memcpy(pdata, &rbuff->buff[out], tmp_len);
+    if (len > tmp_len) {
+        memcpy(&pdata[tmp_len], rbuff->buff, len - tmp_len);
+    }
+
+    return len;
+}
+
+void *tuya_ring_buff_reserve(TUYA_RINGBUFF_T ringbuff, uint32_t len, uint32_t *reserved_len)
+{
+    uint32_t in, out, contig;
+    __RINGBUFF_T *rbuff = (__RINGBUFF_T *)ringbuff;
 
-    // discard data from beginning of buffer (overflow part)
-    if (len > 0) {
-        rbuff->out = len;
+    if (reserved_len) {
+        *reserved_len = 0;
+    }
+    if (rbuff == NULL || reserved_len == NULL) {
+        return NULL;
     }
 
-    // check end of buffer
-    if (rbuff->out >= rbuff->len) {
-        rbuff->out = 0;
+    in = rbuff->in;
+    out = RINGBUFF_LOAD_ACQ(&rbuff->out);
+    contig = __ringbuff_contig_free_len(rbuff, in, out);
+
+    if (len) {
+        contig = GET_MIN(contig, len);
+    }
+    if (contig == 0) {
+        return NULL;
     }
 
-    return tmp_len + len;
+    *reserved_len = contig;
+    return &rbuff->buff[in];
 }
 
-uint32_t tuya_ring_buff_peek(TUYA_RINGBUFF_T ringbuff, void *data, uint32_t len)
+uint32_t tuya_ring_buff_commit(TUYA_RINGBUFF_T ringbuff, uint32_t len)
 {
-    uint32_t out;
-    uint32_t tmp_len;
-    uint32_t used_len;
-    uint8_t *pdata = data;
+    uint32_t in, out;
     __RINGBUFF_T *rbuff = (__RINGBUFF_T *)ringbuff;
 
-    if (rbuff == NULL || data == NULL || len == 0) {
+    if (rbuff == NULL || len == 0) {
         return 0;
     }
 
-    out = rbuff->out;
-    used_len = tuya_ring_buff_used_size_get(rbuff);
-
-    len = GET_MIN(len, used_len);
+    in = rbuff->in;
+    out = RINGBUFF_LOAD_ACQ(&rbuff->out);
+    len = GET_MIN(__ringbuff_contig_free_len(rbuff, in, out), len);
     if (len == 0) {
         return 0;
     }
 
-    tmp_len = GET_MIN(rbuff->len - out, len);
-    memcpy(pdata, &rbuff->buff[out], tmp_len);
-    len -= tmp_len;
+    RINGBUFF_STORE_REL(&rbuff->in, __ringbuff_advance(rbuff, in, len));
+
+    return len;
+}
+
+void *tuya_ring_buff_peek_contiguous(TUYA_RINGBUFF_T ringbuff, uint32_t *len)
+{
+    uint32_t in, out, contig;
+    __RINGBUFF_T *rbuff = (__RINGBUFF_T *)ringbuff;
 
-    if (len > 0) {
-        memcpy(&pdata[tmp_len], rbuff->buff, len);
+    if (len) {
+        *len = 0;
+    }
+    if (rbuff == NULL || len == NULL) {
+        return NULL;
+    }
+
+    in = RINGBUFF_LOAD_ACQ(&rbuff->in);
+    out = rbuff->out;
+    // used bytes up to in, or up to the end of the buffer when in has wrapped
+    contig = (in >= out) ? (in - out) : (rbuff->len - out);
+    if (contig == 0) {
+        return NULL;
     }
 
-    return tmp_len + len;
+    *len = contig;
+    return &rbuff->buff[out];
 }